@@ -0,0 +1,250 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+/**
+ * Bump-pointer arena. Allocating moves a cursor forward inside the current block, freeing
+ * a single allocation does nothing; memory comes back all at once with reset(), or partly by
+ * rewinding to a mark() taken earlier (see ArenaScope).
+ *
+ * Blocks are chained newest first. A request bigger than the block size gets a block sized to fit.
+ * With ArenaGrowth::Double every new block is twice the size of the one before.
+ *
+ * Objects living in the arena are not destroyed by it; containers using ArenaAllocator still run
+ * their destructors, they just don't give memory back.
+ */
+enum class ArenaGrowth
+{
+	Fixed,
+	Double,
+};
+
+class Arena final
+{
+public:
+	static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+	struct Marker
+	{
+		void* block{ nullptr };
+		std::byte* cursor{ nullptr };
+	};
+
+public:
+	explicit Arena(size_t blockSize = DefaultBlockSize, ArenaGrowth growth = ArenaGrowth::Fixed)
+		: blockSize_{ blockSize }, initialBlockSize_{ blockSize }, growth_{ growth } {}
+	~Arena() { release(); }
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	[[nodiscard]] void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+	/** Forgets every allocation but keeps the oldest block for what comes next. */
+	void reset() noexcept;
+
+	/** Gives every block back to the heap; the next block has the initial size again. */
+	void release() noexcept;
+
+	[[nodiscard]] Marker mark() const noexcept { return Marker{ current_, cursor_ }; }
+
+	/** Forgets everything allocated after `marker` was taken. */
+	void rewind(const Marker& marker) noexcept;
+
+	/** The size of the next block. */
+	[[nodiscard]] size_t blockSize() const noexcept { return blockSize_; }
+
+	[[nodiscard]] size_t blockCount() const noexcept;
+
+	/** Bytes taken from the blocks since the last reset, counting padding and the unused tails of filled blocks. */
+	[[nodiscard]] size_t bytesUsed() const noexcept;
+
+	/** `p` rounded up to `alignment`, a power of two. */
+	static std::byte* alignUp(std::byte* p, size_t alignment) noexcept;
+
+private:
+	struct Block
+	{
+		Block* previous;
+		size_t size;
+
+		std::byte* begin() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+		std::byte* end() noexcept { return begin() + size; }
+	};
+
+	static constexpr size_t BlockAlignment = alignof(std::max_align_t);
+
+	void addBlock(size_t minSize);
+	void freeBlock(Block* block) noexcept;
+
+private:
+	Block* current_{ nullptr };
+	std::byte* cursor_{ nullptr };
+	std::byte* end_{ nullptr };
+
+	size_t blockSize_{ DefaultBlockSize };
+	size_t initialBlockSize_{ DefaultBlockSize };
+	ArenaGrowth growth_{ ArenaGrowth::Fixed };
+};
+
+
+/** Rewinds the arena to where it was when the scope was entered. */
+class ArenaScope final
+{
+public:
+	explicit ArenaScope(Arena& arena) : arena_{ arena }, marker_{ arena.mark() } {}
+	~ArenaScope() { arena_.rewind(marker_); }
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+	Arena& arena_;
+	Arena::Marker marker_;
+};
+
+
+/**
+ * Allocator handing out memory of an Arena; deallocate() is a no-op. Copies and rebinds share
+ * the arena, so a container and its nodes draw from the same one. Two allocators are equal
+ * when they use the same arena.
+ *
+ *   Arena arena;
+ *   {
+ *       ArenaScope scope(arena);
+ *       Vector<int, ArenaAllocator<int>> vec{ ArenaAllocator<int>(arena) };
+ *       ...
+ *   } // everything vec allocated is reclaimed at once
+ */
+template<typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	explicit ArenaAllocator(Arena& arena) noexcept : arena_{ &arena } {}
+
+	template<typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_{ other.arena() } {}
+
+	[[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) noexcept {}
+
+	[[nodiscard]] Arena* arena() const noexcept { return arena_; }
+
+private:
+	Arena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept
+{
+	return lhs.arena() == rhs.arena();
+}
+
+
+inline std::byte* Arena::alignUp(std::byte* p, size_t alignment) noexcept
+{
+	assert((alignment & (alignment - 1)) == 0);
+
+	const auto address = reinterpret_cast<std::uintptr_t>(p);
+	return p + ((alignment - address % alignment) % alignment);
+}
+
+inline void* Arena::allocate(size_t bytes, size_t alignment)
+{
+	std::byte* p = cursor_ ? alignUp(cursor_, alignment) : nullptr;
+
+	if (!p || p > end_ || bytes > static_cast<size_t>(end_ - p))
+	{
+		addBlock(bytes + alignment);
+		p = alignUp(cursor_, alignment);
+	}
+
+	cursor_ = p + bytes;
+	return p;
+}
+
+inline void Arena::addBlock(size_t minSize)
+{
+	const size_t size = minSize > blockSize_ ? minSize : blockSize_;
+
+	void* memory = ::operator new(sizeof(Block) + size, std::align_val_t{ BlockAlignment });
+	Block* block = new (memory) Block{ current_, size };
+
+	if (growth_ == ArenaGrowth::Double)
+	{
+		blockSize_ = size * 2;
+	}
+
+	current_ = block;
+	cursor_ = block->begin();
+	end_ = block->end();
+}
+
+inline void Arena::freeBlock(Block* block) noexcept
+{
+	::operator delete(block, std::align_val_t{ BlockAlignment });
+}
+
+inline void Arena::rewind(const Marker& marker) noexcept
+{
+	Block* const target = static_cast<Block*>(marker.block);
+
+	while (current_ != target)
+	{
+		assert(current_ && "Arena: the marker belongs to a block that is already gone");
+
+		Block* previous = current_->previous;
+		freeBlock(current_);
+		current_ = previous;
+	}
+
+	cursor_ = marker.cursor;
+	end_ = current_ ? current_->end() : nullptr;
+}
+
+inline void Arena::reset() noexcept
+{
+	if (!current_)
+	{
+		return;
+	}
+
+	Block* oldest = current_;
+	while (oldest->previous)
+	{
+		oldest = oldest->previous;
+	}
+
+	rewind(Marker{ oldest, oldest->begin() });
+}
+
+inline void Arena::release() noexcept
+{
+	rewind(Marker{});
+	blockSize_ = initialBlockSize_;
+}
+
+inline size_t Arena::blockCount() const noexcept
+{
+	size_t count = 0;
+	for (Block* block = current_; block; block = block->previous)
+	{
+		++count;
+	}
+	return count;
+}
+
+inline size_t Arena::bytesUsed() const noexcept
+{
+	size_t used = 0;
+	for (Block* block = current_; block; block = block->previous)
+	{
+		used += block == current_ ? static_cast<size_t>(cursor_ - block->begin()) : block->size;
+	}
+	return used;
+}
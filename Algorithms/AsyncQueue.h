@@ -0,0 +1,258 @@
+#pragma once
+#include <coroutine>
+#include <optional>
+#include <utility>
+
+#include "AsyncTask.h"
+#include "Queue.h"
+
+/**
+ * Unbounded FIFO for coroutines: `co_await queue.pop()` suspends the consumer while the queue is
+ * empty instead of blocking a thread, and yields std::nullopt once the queue is closed and drained.
+ *
+ * A push with consumers waiting doesn't go through the queue at all: the value is handed to the
+ * oldest waiter, which is then resumed right inside push() or, when the queue was given an
+ * executor, posted to it. Waiters are served strictly in the order they started waiting.
+ *
+ * Like SingleThreadExecutor it is meant for one thread; there is no locking. Suspended consumers
+ * reference the queue, so it has to outlive them.
+ */
+template<typename T>
+class AsyncQueue final
+{
+public:
+	using size_type = size_t;
+
+	class PopAwaiter
+	{
+	public:
+		explicit PopAwaiter(AsyncQueue& queue) : queue_{ queue } {}
+
+		/** Only happens while waiting when the suspended coroutine is destroyed; it then leaves the line. */
+		~PopAwaiter() { queue_.unlinkWaiter(this); }
+
+		PopAwaiter(const PopAwaiter&) = delete;
+		PopAwaiter& operator=(const PopAwaiter&) = delete;
+
+		bool await_ready() const noexcept { return !queue_.items_.isEmpty() || queue_.bClosed_; }
+		void await_suspend(std::coroutine_handle<> handle) noexcept;
+		std::optional<T> await_resume();
+
+	private:
+		friend AsyncQueue;
+
+		AsyncQueue& queue_;
+		std::coroutine_handle<> handle_{ nullptr };
+
+		// Filled in by push() when it hands the value over directly.
+		std::optional<T> value_;
+
+		PopAwaiter* previous_{ nullptr };
+		PopAwaiter* next_{ nullptr };
+		bool bWaiting_{ false };
+	};
+
+public:
+	/** Without an executor, waiting consumers are resumed inside push() and close(). */
+	explicit AsyncQueue(SingleThreadExecutor* executor = nullptr) : executor_{ executor } {}
+
+	AsyncQueue(const AsyncQueue&) = delete;
+	AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+	/** Returns false if the queue is closed. */
+	bool push(const T& val);
+	bool push(T&& val);
+
+	/** Awaitable yielding std::optional<T>; empty only when the queue is closed and drained. */
+	[[nodiscard]] PopAwaiter pop() { return PopAwaiter(*this); }
+
+	/** Doesn't suspend: the front element, or nullopt if there is none. */
+	std::optional<T> tryPop();
+
+	/** Rejects further pushes and wakes every waiting consumer with std::nullopt. */
+	void close();
+
+	[[nodiscard]] bool isClosed() const noexcept { return bClosed_; }
+	[[nodiscard]] bool isEmpty() const noexcept { return items_.isEmpty(); }
+	[[nodiscard]] size_type size() const noexcept { return items_.size(); }
+	[[nodiscard]] bool hasWaiters() const noexcept { return waitersHead_ != nullptr; }
+
+private:
+	template<typename ValType>
+	bool pushImpl(ValType&& val);
+
+	PopAwaiter* takeWaiter() noexcept;
+	void unlinkWaiter(PopAwaiter* waiter) noexcept;
+	void relinkWaiterAtHead(PopAwaiter* waiter) noexcept;
+
+	void wake(PopAwaiter* waiter);
+
+private:
+	Queue<T> items_;
+
+	// Intrusive FIFO of suspended consumers, the nodes live in their coroutine frames.
+	PopAwaiter* waitersHead_{ nullptr };
+	PopAwaiter* waitersTail_{ nullptr };
+
+	SingleThreadExecutor* executor_{ nullptr };
+	bool bClosed_{ false };
+};
+
+
+template<typename T>
+void AsyncQueue<T>::PopAwaiter::await_suspend(std::coroutine_handle<> handle) noexcept
+{
+	handle_ = handle;
+	bWaiting_ = true;
+
+	previous_ = queue_.waitersTail_;
+	if (previous_)
+	{
+		previous_->next_ = this;
+	}
+	else
+	{
+		queue_.waitersHead_ = this;
+	}
+	queue_.waitersTail_ = this;
+}
+
+template<typename T>
+std::optional<T> AsyncQueue<T>::PopAwaiter::await_resume()
+{
+	/**
+	 * 1. woken by push() - the value is already ours
+	 * 2. didn't suspend because something was queued - take the front
+	 * 3. woken by close() or found it closed and drained - nothing
+	 */
+
+	if (value_)
+	{
+		return std::move(value_);
+	}
+
+	return queue_.tryPop();
+}
+
+template<typename T>
+bool AsyncQueue<T>::push(const T& val)
+{
+	return pushImpl(val);
+}
+
+template<typename T>
+bool AsyncQueue<T>::push(T&& val)
+{
+	return pushImpl(std::move(val));
+}
+
+template<typename T>
+template<typename ValType>
+bool AsyncQueue<T>::pushImpl(ValType&& val)
+{
+	if (bClosed_)
+	{
+		return false;
+	}
+
+	if (PopAwaiter* waiter = waitersHead_)
+	{
+		// Build the value while the waiter is still in line, so a throwing constructor leaves it waiting.
+		waiter->value_.emplace(std::forward<ValType>(val));
+		takeWaiter();
+		wake(waiter);
+	}
+	else
+	{
+		items_.push(std::forward<ValType>(val));
+	}
+
+	return true;
+}
+
+template<typename T>
+std::optional<T> AsyncQueue<T>::tryPop()
+{
+	if (items_.isEmpty())
+	{
+		return std::nullopt;
+	}
+
+	std::optional<T> result(std::move(items_.front()));
+	items_.pop();
+
+	return result;
+}
+
+template<typename T>
+void AsyncQueue<T>::close()
+{
+	bClosed_ = true;
+
+	// Waiters only exist while the queue is empty, so none of them misses an element.
+	while (PopAwaiter* waiter = takeWaiter())
+	{
+		wake(waiter);
+	}
+}
+
+template<typename T>
+typename AsyncQueue<T>::PopAwaiter* AsyncQueue<T>::takeWaiter() noexcept
+{
+	PopAwaiter* waiter = waitersHead_;
+	if (waiter)
+	{
+		unlinkWaiter(waiter);
+	}
+	return waiter;
+}
+
+template<typename T>
+void AsyncQueue<T>::unlinkWaiter(PopAwaiter* waiter) noexcept
+{
+	if (!waiter->bWaiting_)
+	{
+		return;
+	}
+
+	(waiter->previous_ ? waiter->previous_->next_ : waitersHead_) = waiter->next_;
+	(waiter->next_ ? waiter->next_->previous_ : waitersTail_) = waiter->previous_;
+
+	waiter->previous_ = nullptr;
+	waiter->next_ = nullptr;
+	waiter->bWaiting_ = false;
+}
+
+template<typename T>
+void AsyncQueue<T>::relinkWaiterAtHead(PopAwaiter* waiter) noexcept
+{
+	waiter->previous_ = nullptr;
+	waiter->next_ = waitersHead_;
+	waiter->bWaiting_ = true;
+
+	(waitersHead_ ? waitersHead_->previous_ : waitersTail_) = waiter;
+	waitersHead_ = waiter;
+}
+
+template<typename T>
+void AsyncQueue<T>::wake(PopAwaiter* waiter)
+{
+	if (executor_)
+	{
+		try
+		{
+			executor_->post(waiter->handle_);
+		}
+		catch (...)
+		{
+			// Nothing would ever resume it otherwise; it goes back to the front of the line, empty-handed.
+			waiter->value_.reset();
+			relinkWaiterAtHead(waiter);
+			throw;
+		}
+	}
+	else
+	{
+		waiter->handle_.resume();
+	}
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "Queue.h"
+
+/**
+ * Fire-and-forget coroutine. It starts running right away, up to its first real suspension,
+ * and keeps its frame after finishing so isDone() and rethrowIfFailed() can still be asked.
+ * The frame is destroyed with the AsyncTask object, so it has to outlive the coroutine's work.
+ */
+class AsyncTask final
+{
+public:
+	struct promise_type
+	{
+		std::exception_ptr exception;
+
+		AsyncTask get_return_object() noexcept { return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+		std::suspend_never initial_suspend() const noexcept { return {}; }
+		std::suspend_always final_suspend() const noexcept { return {}; }
+
+		void return_void() const noexcept {}
+		void unhandled_exception() noexcept { exception = std::current_exception(); }
+	};
+
+public:
+	AsyncTask() = default;
+	AsyncTask(AsyncTask&& other) noexcept : handle_{ std::exchange(other.handle_, nullptr) } {}
+	~AsyncTask() { reset(); }
+
+	AsyncTask& operator=(AsyncTask&& other) noexcept;
+
+	AsyncTask(const AsyncTask&) = delete;
+	AsyncTask& operator=(const AsyncTask&) = delete;
+
+	[[nodiscard]] bool isDone() const noexcept { return !handle_ || handle_.done(); }
+
+	/** Rethrows what escaped the coroutine body, if anything did. */
+	void rethrowIfFailed() const;
+
+private:
+	explicit AsyncTask(std::coroutine_handle<promise_type> handle) : handle_{ handle } {}
+
+	void reset() noexcept;
+
+private:
+	std::coroutine_handle<promise_type> handle_{ nullptr };
+};
+
+
+/**
+ * Runs coroutines one after another on the thread that calls run(). Nothing here is thread-safe:
+ * it is the event loop of one thread, and a test can drive it step by step with runOne().
+ *
+ *   AsyncTask task = [](SingleThreadExecutor& executor) -> AsyncTask
+ *   {
+ *       co_await executor.schedule();
+ *       ...
+ *   }(executor);
+ *   executor.run();
+ */
+class SingleThreadExecutor final
+{
+public:
+	class ScheduleAwaiter
+	{
+	public:
+		explicit ScheduleAwaiter(SingleThreadExecutor& executor) : executor_{ executor } {}
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) { executor_.post(handle); }
+		void await_resume() const noexcept {}
+
+	private:
+		SingleThreadExecutor& executor_;
+	};
+
+public:
+	SingleThreadExecutor() = default;
+
+	SingleThreadExecutor(const SingleThreadExecutor&) = delete;
+	SingleThreadExecutor& operator=(const SingleThreadExecutor&) = delete;
+
+	/** Queues `handle` to be resumed by run(). */
+	void post(std::coroutine_handle<> handle) { ready_.push(handle); }
+
+	/** `co_await executor.schedule()` moves the rest of the coroutine onto the executor. */
+	[[nodiscard]] ScheduleAwaiter schedule() noexcept { return ScheduleAwaiter(*this); }
+
+	/** Resumes the oldest ready coroutine. False if there was none. */
+	bool runOne();
+
+	/** Runs until nothing is ready, including work that the resumed coroutines post. Returns how many resumptions that took. */
+	size_t run();
+
+	[[nodiscard]] bool hasReadyWork() const noexcept { return !ready_.isEmpty(); }
+
+private:
+	Queue<std::coroutine_handle<>> ready_;
+};
+
+
+inline AsyncTask& AsyncTask::operator=(AsyncTask&& other) noexcept
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	reset();
+	handle_ = std::exchange(other.handle_, nullptr);
+
+	return *this;
+}
+
+inline void AsyncTask::rethrowIfFailed() const
+{
+	if (handle_ && handle_.promise().exception)
+	{
+		std::rethrow_exception(handle_.promise().exception);
+	}
+}
+
+inline void AsyncTask::reset() noexcept
+{
+	if (handle_)
+	{
+		handle_.destroy();
+		handle_ = nullptr;
+	}
+}
+
+inline bool SingleThreadExecutor::runOne()
+{
+	if (ready_.isEmpty())
+	{
+		return false;
+	}
+
+	std::coroutine_handle<> handle = ready_.front();
+	ready_.pop();
+	handle.resume();
+
+	return true;
+}
+
+inline size_t SingleThreadExecutor::run()
+{
+	size_t resumed = 0;
+	while (runOne())
+	{
+		++resumed;
+	}
+	return resumed;
+}
@@ -0,0 +1,278 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#include "Queue.h"
+#include "Vector.h"
+
+/**
+ * Bounded FIFO for handing work between threads: a Queue guarded by a mutex plus two
+ * condition variables, so consumers sleep while it is empty and producers while it is full.
+ *
+ * After close() every push fails, while pops keep returning what is left and fail only once
+ * the queue is also empty. This is how a consumer loop `while (queue.pop(item))` ends.
+ */
+template<
+	typename T,
+	template<typename> typename Container = RingBuffer
+>
+class BlockingQueue final
+{
+public:
+	using size_type = size_t;
+
+public:
+	explicit BlockingQueue(size_type capacity);
+
+	BlockingQueue(const BlockingQueue&) = delete;
+	BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+	/** Waits while the queue is full. Returns false if it is (or gets) closed. */
+	bool push(const T& val);
+	bool push(T&& val);
+
+	/** Returns false right away if the queue is full or closed. */
+	bool tryPush(const T& val);
+	bool tryPush(T&& val);
+
+	/** Waits for an element. Returns false once the queue is closed and empty. */
+	bool pop(T& out);
+
+	bool tryPop(T& out);
+
+	/** Like pop, but also gives up after `timeout`. */
+	template<typename Rep, typename Period>
+	bool popFor(T& out, const std::chrono::duration<Rep, Period>& timeout);
+
+	/** Moves up to `maxCount` elements to the end of `out` under one lock. Doesn't wait, returns how many were moved. */
+	template<typename VecAllocator>
+	size_type drainTo(Vector<T, VecAllocator>& out, size_type maxCount);
+
+	/** Wakes up everyone waiting. Not reversible. */
+	void close();
+
+	[[nodiscard]] bool isClosed() const;
+	[[nodiscard]] bool isEmpty() const;
+	[[nodiscard]] size_type size() const;
+
+	constexpr size_type capacity() const noexcept { return capacity_; }
+
+private:
+	template<typename ValType>
+	bool pushImpl(ValType&& val, bool bWait);
+
+	/** Expects the lock to be held and the queue to be non-empty. */
+	void popLocked(T& out);
+
+private:
+	mutable std::mutex mutex_;
+	std::condition_variable notEmpty_;
+	std::condition_variable notFull_;
+
+	Queue<T, Container> queue_;
+
+	const size_type capacity_;
+	bool bClosed_{ false };
+};
+
+
+template<typename T, template<typename> typename Container>
+BlockingQueue<T, Container>::BlockingQueue(size_type capacity)
+	: capacity_{ capacity }
+{
+	assert(capacity > 0);
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::push(const T& val)
+{
+	return pushImpl(val, true);
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::push(T&& val)
+{
+	return pushImpl(std::move(val), true);
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::tryPush(const T& val)
+{
+	return pushImpl(val, false);
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::tryPush(T&& val)
+{
+	return pushImpl(std::move(val), false);
+}
+
+template<typename T, template<typename> typename Container>
+template<typename ValType>
+bool BlockingQueue<T, Container>::pushImpl(ValType&& val, bool bWait)
+{
+	{
+		std::unique_lock lock(mutex_);
+
+		if (bWait)
+		{
+			notFull_.wait(lock, [this] { return bClosed_ || queue_.size() < capacity_; });
+		}
+
+		if (bClosed_ || queue_.size() >= capacity_)
+		{
+			return false;
+		}
+
+		queue_.push(std::forward<ValType>(val));
+	}
+
+	// Notifying after unlocking spares the woken consumer from blocking on the mutex right away.
+	notEmpty_.notify_one();
+
+	return true;
+}
+
+template<typename T, template<typename> typename Container>
+void BlockingQueue<T, Container>::popLocked(T& out)
+{
+	out = std::move(queue_.front());
+	queue_.pop();
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::pop(T& out)
+{
+	{
+		std::unique_lock lock(mutex_);
+		notEmpty_.wait(lock, [this] { return bClosed_ || !queue_.isEmpty(); });
+
+		if (queue_.isEmpty())
+		{
+			return false;
+		}
+
+		popLocked(out);
+	}
+
+	notFull_.notify_one();
+
+	return true;
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::tryPop(T& out)
+{
+	{
+		std::lock_guard lock(mutex_);
+
+		if (queue_.isEmpty())
+		{
+			return false;
+		}
+
+		popLocked(out);
+	}
+
+	notFull_.notify_one();
+
+	return true;
+}
+
+template<typename T, template<typename> typename Container>
+template<typename Rep, typename Period>
+bool BlockingQueue<T, Container>::popFor(T& out, const std::chrono::duration<Rep, Period>& timeout)
+{
+	{
+		std::unique_lock lock(mutex_);
+		notEmpty_.wait_for(lock, timeout, [this] { return bClosed_ || !queue_.isEmpty(); });
+
+		if (queue_.isEmpty())
+		{
+			return false;
+		}
+
+		popLocked(out);
+	}
+
+	notFull_.notify_one();
+
+	return true;
+}
+
+template<typename T, template<typename> typename Container>
+template<typename VecAllocator>
+typename BlockingQueue<T, Container>::size_type BlockingQueue<T, Container>::drainTo(Vector<T, VecAllocator>& out, size_type maxCount)
+{
+	size_type drained = 0;
+
+	{
+		std::lock_guard lock(mutex_);
+
+		const size_type count = std::min(maxCount, queue_.size());
+		if (out.size() + count > out.capacity())
+		{
+			// Keep doubling, or a loop of small drains would reallocate on every call.
+			out.reserve(std::max(out.size() + count, out.capacity() * 2));
+		}
+
+		for (; drained < count; ++drained)
+		{
+			out.pushBack(std::move(queue_.front()));
+			queue_.pop();
+		}
+	}
+
+	/**
+	 * 1. nothing drained - nobody can make progress because of us
+	 * 2. one slot freed - one producer is enough
+	 * 3. several slots freed - wake them all, the extra ones just go back to sleep
+	 */
+	if (drained == 1)
+	{
+		notFull_.notify_one();
+	}
+	else if (drained > 1)
+	{
+		notFull_.notify_all();
+	}
+
+	return drained;
+}
+
+template<typename T, template<typename> typename Container>
+void BlockingQueue<T, Container>::close()
+{
+	{
+		std::lock_guard lock(mutex_);
+		bClosed_ = true;
+	}
+
+	notEmpty_.notify_all();
+	notFull_.notify_all();
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::isClosed() const
+{
+	std::lock_guard lock(mutex_);
+	return bClosed_;
+}
+
+template<typename T, template<typename> typename Container>
+bool BlockingQueue<T, Container>::isEmpty() const
+{
+	std::lock_guard lock(mutex_);
+	return queue_.isEmpty();
+}
+
+template<typename T, template<typename> typename Container>
+typename BlockingQueue<T, Container>::size_type BlockingQueue<T, Container>::size() const
+{
+	std::lock_guard lock(mutex_);
+	return queue_.size();
+}
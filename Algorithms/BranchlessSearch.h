@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * std::lower_bound over [first, first + n) without a data-dependent branch: every step halves the
+ * range and picks the half with a conditional move, so the loop runs exactly ceil(log2(n)) times
+ * and a random key costs no branch mispredictions. On tables that fit the cache that is the bulk
+ * of a binary search's time.
+ *
+ * Returns the index of the first element not less than `key`, or n if there is none. `key` may be
+ * of any type `less` can compare with the elements.
+ */
+template<typename T, typename K, typename Compare>
+size_t branchlessLowerBound(const T* first, size_t n, const K& key, const Compare& less)
+{
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	const T* base = first;
+	while (n > 1)
+	{
+		const size_t half = n / 2;
+		base = less(base[half], key) ? base + half : base;
+		n -= half;
+	}
+
+	return static_cast<size_t>(base - first) + (less(*base, key) ? 1 : 0);
+}
@@ -0,0 +1,729 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "Types.h"
+#include "Vector.h"
+
+/**
+ * A doubly linked list whose nodes live in one contiguous Vector ("slab").
+ * Links are 32-bit indices into the slab instead of pointers, so a node costs
+ * 8 bytes of links instead of 16, neighbours tend to sit in the same cache lines,
+ * and the whole state (slab + a few indices) can be copied or serialised as is,
+ * without any pointer fix-ups.
+ *
+ * Removed nodes are not given back to the allocator; they are chained into a free list
+ * (through their `next` index) and reused by the following insertions.
+ */
+
+template<typename T, typename Allocator>
+class CompactListIterator;
+
+template<typename T, typename Allocator>
+class CompactListConstIterator;
+
+template<typename ValType>
+struct CompactListNode final
+{
+	using index_type = uint32;
+
+	static constexpr index_type NullIndex = std::numeric_limits<index_type>::max();
+
+	// `previous` of a node sitting in the free list. Such node holds no value.
+	static constexpr index_type FreeMark = NullIndex - 1;
+
+	union
+	{
+		ValType value;
+	};
+	index_type previous{ FreeMark };
+	index_type next{ NullIndex };
+
+	CompactListNode() {}
+
+	CompactListNode(const CompactListNode& other)
+		: previous(other.previous), next(other.next)
+	{
+		if (other.isLive())
+		{
+			new (&value) ValType(other.value);
+		}
+	}
+
+	CompactListNode(CompactListNode&& other) noexcept(std::is_nothrow_move_constructible_v<ValType>)
+		: previous(other.previous), next(other.next)
+	{
+		if (other.isLive())
+		{
+			new (&value) ValType(std::move(other.value));
+		}
+	}
+
+	CompactListNode& operator=(const CompactListNode&) = delete;
+	CompactListNode& operator=(CompactListNode&&) = delete;
+
+	~CompactListNode()
+	{
+		if (isLive())
+		{
+			value.~ValType();
+		}
+	}
+
+	constexpr bool isLive() const noexcept { return previous != FreeMark; }
+
+	template<typename... Args>
+	void emplaceValue(index_type previousIndex, index_type nextIndex, Args&&... args)
+	{
+		assert(!isLive());
+		new (&value) ValType(std::forward<Args>(args)...);
+		previous = previousIndex;
+		next = nextIndex;
+	}
+
+	void releaseValue(index_type nextFree)
+	{
+		assert(isLive());
+		value.~ValType();
+		previous = FreeMark;
+		next = nextFree;
+	}
+};
+
+
+template<typename T, typename Allocator = std::allocator<T>>
+class CompactList final
+{
+public:
+	using Node = CompactListNode<T>;
+	using Iterator = CompactListIterator<T, Allocator>;
+	using ConstIterator = CompactListConstIterator<T, Allocator>;
+	using ReverseIterator = std::reverse_iterator<Iterator>;
+	using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+	using index_type = typename Node::index_type;
+	using allocator_type = Allocator;
+	using node_alloc_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using Slab = Vector<Node, node_alloc_type>;
+
+	static constexpr bool bNothrowMoveAssign = Slab::bNothrowMoveAssign;
+
+	static constexpr index_type NullIndex = Node::NullIndex;
+
+public:
+	CompactList() = default;
+	explicit CompactList(const Allocator& allocator) : nodes_{ node_alloc_type(allocator) } {}
+	CompactList(std::initializer_list<T> vals, const Allocator& allocator = Allocator());
+	CompactList(const CompactList& other) = default;
+	CompactList(CompactList&& other) noexcept;
+	~CompactList() = default;
+
+	void pushFront(const T& val);
+	void pushFront(T&& val);
+
+	void pushBack(const T& val);
+	void pushBack(T&& val);
+
+	/** Appends [first, last) in order. For forward iterators the storage grows once up front. */
+	template<std::input_iterator InputIt>
+	void pushBackRange(InputIt first, InputIt last);
+
+	void popFront();
+	void popBack();
+
+	void clear();
+
+	void remove(Iterator where);
+
+	/** Makes room for `n` nodes in the slab, so that the next insertions won't relocate it. */
+	void reserve(size_t n);
+
+	constexpr size_t size() const noexcept;
+	constexpr size_t capacity() const noexcept;
+	constexpr bool isEmpty() const noexcept;
+
+	/** Allocator handling is the slab's, see Vector. */
+	CompactList& operator=(const CompactList& other);
+	CompactList& operator=(CompactList&& other) noexcept(bNothrowMoveAssign);
+
+	void swap(CompactList& other) noexcept;
+
+	T& front();
+	const T& front() const;
+
+	T& back();
+	const T& back() const;
+
+	Iterator begin();
+	Iterator end();
+
+	ConstIterator begin() const;
+	ConstIterator end() const;
+
+	ConstIterator cbegin() const;
+	ConstIterator cend() const;
+
+	ReverseIterator rbegin();
+	ReverseIterator rend();
+
+	ConstReverseIterator rbegin() const;
+	ConstReverseIterator rend() const;
+
+	ConstReverseIterator crbegin() const;
+	ConstReverseIterator crend() const;
+
+	allocator_type getAllocator() const { return allocator_type(nodes_.getAllocator()); }
+
+	/** Nodes never come from the allocator one by one; what there is to count is the slab growing. */
+	ContainerStats stats() const noexcept { return nodes_.stats(); }
+	void resetStats() noexcept { nodes_.resetStats(); }
+
+private:
+	template<typename... Args>
+	index_type allocateNode(index_type previous, index_type next, Args&&... args);
+
+	/** Appends an unused node to the slab and returns its index. */
+	index_type appendNode();
+
+	/** Builds the value in the unused node `index`; if that throws, the node goes on the free list. */
+	template<typename... Args>
+	void constructNode(index_type index, index_type previous, index_type next, Args&&... args);
+
+	void freeNode(index_type index);
+
+	template<typename ValType>
+	void insertAtBeginning(ValType&& val);
+
+	template<typename ValType>
+	void insertAtEnd(ValType&& val);
+
+	void moveFromAnother(CompactList&& other);
+
+private:
+	Slab nodes_;
+
+	index_type head_{ NullIndex };
+	index_type tail_{ NullIndex };
+	index_type freeHead_{ NullIndex };
+	size_t size_{ 0 };
+
+	friend Iterator;
+	friend ConstIterator;
+};
+
+
+template<typename T, typename Allocator>
+class CompactListIterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	using index_type = uint32;
+	using Iterator = CompactListIterator;
+
+	using MyList = CompactList<T, Allocator>;
+public:
+	CompactListIterator() = default;
+	CompactListIterator(MyList* owner, index_type index) : owner_{ owner }, index_{ index } {}
+
+	reference operator*() const { return owner_->nodes_[index_].value; }
+	pointer operator->() const { return &owner_->nodes_[index_].value; }
+
+	Iterator& operator++() { index_ = owner_->nodes_[index_].next; return *this; }
+	Iterator operator++(int) { Iterator old(owner_, index_); ++(*this); return old; }
+
+	Iterator& operator--() { index_ = index_ == MyList::NullIndex ? owner_->tail_ : owner_->nodes_[index_].previous; return *this; }
+	Iterator operator--(int) { Iterator old(owner_, index_); --(*this); return old; }
+
+	constexpr bool operator==(const Iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+private:
+	MyList* owner_{ nullptr };
+	index_type index_{ MyList::NullIndex };
+
+	friend MyList;
+	friend CompactListConstIterator<T, Allocator>;
+};
+
+template<typename T, typename Allocator>
+class CompactListConstIterator
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+	using index_type = uint32;
+	using ConstIterator = CompactListConstIterator;
+
+	using MyList = CompactList<T, Allocator>;
+public:
+	CompactListConstIterator() = default;
+	CompactListConstIterator(const MyList* owner, index_type index) : owner_{ owner }, index_{ index } {}
+	CompactListConstIterator(const CompactListIterator<T, Allocator>& it) : owner_{ it.owner_ }, index_{ it.index_ } {}
+
+	reference operator*() const { return owner_->nodes_[index_].value; }
+	pointer operator->() const { return &owner_->nodes_[index_].value; }
+
+	ConstIterator& operator++() { index_ = owner_->nodes_[index_].next; return *this; }
+	ConstIterator operator++(int) { ConstIterator old(owner_, index_); ++(*this); return old; }
+
+	ConstIterator& operator--() { index_ = index_ == MyList::NullIndex ? owner_->tail_ : owner_->nodes_[index_].previous; return *this; }
+	ConstIterator operator--(int) { ConstIterator old(owner_, index_); --(*this); return old; }
+
+	constexpr bool operator==(const ConstIterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const ConstIterator& other) const { return !(*this == other); }
+
+private:
+	const MyList* owner_{ nullptr };
+	index_type index_{ MyList::NullIndex };
+};
+
+
+template <typename T, typename Allocator>
+constexpr size_t CompactList<T, Allocator>::size() const noexcept
+{
+	return size_;
+}
+
+template <typename T, typename Allocator>
+constexpr size_t CompactList<T, Allocator>::capacity() const noexcept
+{
+	return nodes_.capacity();
+}
+
+template <typename T, typename Allocator>
+constexpr bool CompactList<T, Allocator>::isEmpty() const noexcept
+{
+	return size_ == 0;
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::CompactList(std::initializer_list<T> vals, const Allocator& allocator)
+	: nodes_{ node_alloc_type(allocator) }
+{
+	reserve(vals.size());
+	for (auto& val : vals)
+	{
+		insertAtEnd(val);
+	}
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>::CompactList(CompactList&& other) noexcept
+	: nodes_{ std::move(other.nodes_) }
+{
+	head_ = std::exchange(other.head_, NullIndex);
+	tail_ = std::exchange(other.tail_, NullIndex);
+	freeHead_ = std::exchange(other.freeHead_, NullIndex);
+	size_ = std::exchange(other.size_, 0);
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+typename CompactList<T, Allocator>::index_type CompactList<T, Allocator>::allocateNode(index_type previous, index_type next, Args&&... args)
+{
+	/**
+	 * 1. there is a freed node - reuse it
+	 * 2. the slab has room - append a new node to it
+	 * 3. the slab is full - build the value first, since growing moves the slab and `args` may
+	 *    point into it (list.pushBack(list.front())), then append
+	 */
+
+	index_type index = freeHead_;
+	if (index != NullIndex)
+	{
+		freeHead_ = nodes_[index].next;
+	}
+	else if (nodes_.size() < nodes_.capacity())
+	{
+		index = appendNode();
+	}
+	else
+	{
+		T value(std::forward<Args>(args)...);
+		index = appendNode();
+		constructNode(index, previous, next, std::move(value));
+		return index;
+	}
+
+	constructNode(index, previous, next, std::forward<Args>(args)...);
+	return index;
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+void CompactList<T, Allocator>::constructNode(index_type index, index_type previous, index_type next, Args&&... args)
+{
+	try
+	{
+		nodes_[index].emplaceValue(previous, next, std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		// emplaceValue leaves the node marked free; it only has to be chained back in.
+		nodes_[index].next = freeHead_;
+		freeHead_ = index;
+		throw;
+	}
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::index_type CompactList<T, Allocator>::appendNode()
+{
+	assert(nodes_.size() < Node::FreeMark && "CompactList: out of 32-bit indices");
+	nodes_.pushBack(Node{});
+	return static_cast<index_type>(nodes_.size() - 1);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::freeNode(index_type index)
+{
+	nodes_[index].releaseValue(freeHead_);
+	freeHead_ = index;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::pushFront(const T& val)
+{
+	insertAtBeginning(val);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::pushFront(T&& val)
+{
+	insertAtBeginning(std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <typename ValType>
+void CompactList<T, Allocator>::insertAtBeginning(ValType&& val)
+{
+	index_type newIndex = allocateNode(NullIndex, head_, std::forward<ValType>(val));
+
+	if (isEmpty())
+	{
+		tail_ = newIndex;
+	}
+	else
+	{
+		nodes_[head_].previous = newIndex;
+	}
+
+	head_ = newIndex;
+	++size_;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::pushBack(const T& val)
+{
+	insertAtEnd(val);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::pushBack(T&& val)
+{
+	insertAtEnd(std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+void CompactList<T, Allocator>::pushBackRange(InputIt first, InputIt last)
+{
+	if constexpr (std::forward_iterator<InputIt>)
+	{
+		// Free nodes get reused first, so this may reserve a little more than needed.
+		const size_t needed = nodes_.size() + static_cast<size_t>(std::distance(first, last));
+		if (needed > nodes_.capacity())
+		{
+			reserve(std::max(needed, nodes_.capacity() * 2));
+		}
+	}
+
+	for (; first != last; ++first)
+	{
+		insertAtEnd(*first);
+	}
+}
+
+template <typename T, typename Allocator>
+template <typename ValType>
+void CompactList<T, Allocator>::insertAtEnd(ValType&& val)
+{
+	index_type newIndex = allocateNode(tail_, NullIndex, std::forward<ValType>(val));
+
+	if (isEmpty())
+	{
+		head_ = newIndex;
+	}
+	else
+	{
+		nodes_[tail_].next = newIndex;
+	}
+
+	tail_ = newIndex;
+	++size_;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::popFront()
+{
+	assert(!isEmpty());
+
+	index_type next = nodes_[head_].next;
+	freeNode(head_);
+
+	if (next == NullIndex)
+	{
+		tail_ = NullIndex;
+	}
+	else
+	{
+		nodes_[next].previous = NullIndex;
+	}
+
+	head_ = next;
+	--size_;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::popBack()
+{
+	assert(!isEmpty());
+
+	index_type previous = nodes_[tail_].previous;
+	freeNode(tail_);
+
+	if (previous == NullIndex)
+	{
+		head_ = NullIndex;
+	}
+	else
+	{
+		nodes_[previous].next = NullIndex;
+	}
+
+	tail_ = previous;
+	--size_;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::clear()
+{
+	nodes_.reset();
+
+	head_ = NullIndex;
+	tail_ = NullIndex;
+	freeHead_ = NullIndex;
+	size_ = 0;
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::remove(Iterator where)
+{
+	assert(where.owner_ == this);
+	assert(where != end());
+
+	index_type index = where.index_;
+	index_type previous = nodes_[index].previous;
+	index_type next = nodes_[index].next;
+
+	if (index == head_)
+	{
+		popFront();
+	}
+	else if (index == tail_)
+	{
+		popBack();
+	}
+	else
+	{
+		nodes_[previous].next = next;
+		nodes_[next].previous = previous;
+		freeNode(index);
+		--size_;
+	}
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::reserve(size_t n)
+{
+	nodes_.reserve(n);
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>& CompactList<T, Allocator>::operator=(const CompactList& other)
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	// Indices stay valid in a copy of the slab, so there is nothing to relink.
+	nodes_ = other.nodes_;
+	head_ = other.head_;
+	tail_ = other.tail_;
+	freeHead_ = other.freeHead_;
+	size_ = other.size_;
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+CompactList<T, Allocator>& CompactList<T, Allocator>::operator=(CompactList&& other) noexcept(bNothrowMoveAssign)
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+	moveFromAnother(std::move(other));
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+T& CompactList<T, Allocator>::front()
+{
+	return const_cast<T&>(static_cast<const CompactList&>(*this).front());
+}
+
+template <typename T, typename Allocator>
+const T& CompactList<T, Allocator>::front() const
+{
+	assert(!isEmpty());
+	return nodes_[head_].value;
+}
+
+template <typename T, typename Allocator>
+T& CompactList<T, Allocator>::back()
+{
+	return const_cast<T&>(static_cast<const CompactList&>(*this).back());
+}
+
+template <typename T, typename Allocator>
+const T& CompactList<T, Allocator>::back() const
+{
+	assert(!isEmpty());
+	return nodes_[tail_].value;
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::Iterator CompactList<T, Allocator>::begin()
+{
+	return Iterator(this, head_);
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::Iterator CompactList<T, Allocator>::end()
+{
+	return Iterator(this, NullIndex);
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstIterator CompactList<T, Allocator>::begin() const
+{
+	return ConstIterator(this, head_);
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstIterator CompactList<T, Allocator>::end() const
+{
+	return ConstIterator(this, NullIndex);
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstIterator CompactList<T, Allocator>::cbegin() const
+{
+	return begin();
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstIterator CompactList<T, Allocator>::cend() const
+{
+	return end();
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ReverseIterator CompactList<T, Allocator>::rbegin()
+{
+	return ReverseIterator(end());
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ReverseIterator CompactList<T, Allocator>::rend()
+{
+	return ReverseIterator(begin());
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstReverseIterator CompactList<T, Allocator>::rbegin() const
+{
+	return ConstReverseIterator(end());
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstReverseIterator CompactList<T, Allocator>::rend() const
+{
+	return ConstReverseIterator(begin());
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstReverseIterator CompactList<T, Allocator>::crbegin() const
+{
+	return rbegin();
+}
+
+template <typename T, typename Allocator>
+typename CompactList<T, Allocator>::ConstReverseIterator CompactList<T, Allocator>::crend() const
+{
+	return rend();
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::moveFromAnother(CompactList&& other)
+{
+	nodes_ = std::move(other.nodes_);
+
+	head_ = std::exchange(other.head_, NullIndex);
+	tail_ = std::exchange(other.tail_, NullIndex);
+	freeHead_ = std::exchange(other.freeHead_, NullIndex);
+	size_ = std::exchange(other.size_, 0);
+}
+
+template <typename T, typename Allocator>
+void CompactList<T, Allocator>::swap(CompactList& other) noexcept
+{
+	// Indices are relative to the slab, so they simply travel with it.
+	nodes_.swap(other.nodes_);
+	std::swap(head_, other.head_);
+	std::swap(tail_, other.tail_);
+	std::swap(freeHead_, other.freeHead_);
+	std::swap(size_, other.size_);
+}
+
+
+/** CompactList drawing from a std::pmr::memory_resource. */
+template<typename T>
+using PmrCompactList = CompactList<T, std::pmr::polymorphic_allocator<T>>;
@@ -0,0 +1,94 @@
+#pragma once
+#include "Types.h"
+
+/**
+ * What a container spent on its expensive paths, to pick containers from real traffic
+ * rather than from guesses. Read it with stats() on any container.
+ */
+struct ContainerStats
+{
+	/** Times the element buffer was allocated to grow, the first allocation included. */
+	uint64 reallocations{ 0 };
+
+	/** Elements moved to another slot: by growth, and by Vector shifting for pushFront/popFront. */
+	uint64 relocations{ 0 };
+
+	/** Nodes taken from the allocator by the linked lists. */
+	uint64 nodeAllocations{ 0 };
+
+	/** O(n) searches: index lookups, and the predecessor searches of SingleLinkedList. */
+	uint64 linearWalks{ 0 };
+
+	/** Nodes those searches stepped over. */
+	uint64 walkSteps{ 0 };
+
+	/** Adds up the counters of containers built from several, like FlatMap's two arrays. */
+	ContainerStats& operator+=(const ContainerStats& other) noexcept
+	{
+		reallocations += other.reallocations;
+		relocations += other.relocations;
+		nodeAllocations += other.nodeAllocations;
+		linearWalks += other.linearWalks;
+		walkSteps += other.walkSteps;
+		return *this;
+	}
+};
+
+
+/**
+ * The counters a container embeds. The real ones exist only with ALGORITHMS_ENABLE_STATS defined;
+ * without it the member is empty (and takes no space under NO_UNIQUE_ADDRESS), every count is an
+ * empty inline call and stats() reads zeros, so a release build pays nothing.
+ *
+ * The define changes the containers' layout, so it has to be the same in every translation unit
+ * of a program.
+ */
+template<bool bEnabled>
+class ContainerStatsRecorderImpl;
+
+template<>
+class ContainerStatsRecorderImpl<true>
+{
+public:
+	void countReallocation(uint64 relocated) noexcept
+	{
+		++stats_.reallocations;
+		stats_.relocations += relocated;
+	}
+
+	void countRelocations(uint64 relocated) noexcept { stats_.relocations += relocated; }
+	void countNodeAllocation() noexcept { ++stats_.nodeAllocations; }
+
+	void countWalk(uint64 steps) noexcept
+	{
+		++stats_.linearWalks;
+		stats_.walkSteps += steps;
+	}
+
+	ContainerStats snapshot() const noexcept { return stats_; }
+	void reset() noexcept { stats_ = ContainerStats{}; }
+
+private:
+	ContainerStats stats_;
+};
+
+template<>
+class ContainerStatsRecorderImpl<false>
+{
+public:
+	void countReallocation(uint64) noexcept {}
+	void countRelocations(uint64) noexcept {}
+	void countNodeAllocation() noexcept {}
+	void countWalk(uint64) noexcept {}
+
+	ContainerStats snapshot() const noexcept { return ContainerStats{}; }
+	void reset() noexcept {}
+};
+
+#if defined(ALGORITHMS_ENABLE_STATS)
+inline constexpr bool bContainerStatsEnabled = true;
+#else
+inline constexpr bool bContainerStatsEnabled = false;
+#endif
+
+using ContainerStatsRecorder = ContainerStatsRecorderImpl<bContainerStatsEnabled>;
@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+/**
+ * Allocation counters: how many allocations and frees, live and peak bytes, and a histogram of
+ * request sizes in power-of-two buckets. Bucket `b` counts requests of up to 2^b bytes that don't
+ * fit bucket b - 1; the last bucket takes everything bigger.
+ *
+ * The counters are relaxed atomics, so several threads may record into one instance; reading
+ * while they do gives numbers that are each right but not necessarily taken at the same instant.
+ */
+class AllocationStats final
+{
+public:
+	static constexpr size_t BucketCount = 32;
+
+public:
+	AllocationStats() = default;
+
+	AllocationStats(const AllocationStats&) = delete;
+	AllocationStats& operator=(const AllocationStats&) = delete;
+
+	void recordAllocation(size_t bytes) noexcept;
+	void recordDeallocation(size_t bytes) noexcept;
+
+	[[nodiscard]] size_t allocations() const noexcept { return allocations_.load(std::memory_order_relaxed); }
+	[[nodiscard]] size_t deallocations() const noexcept { return deallocations_.load(std::memory_order_relaxed); }
+	[[nodiscard]] size_t liveAllocations() const noexcept { return liveAtReset_.load(std::memory_order_relaxed) + allocations() - deallocations(); }
+
+	[[nodiscard]] size_t liveBytes() const noexcept { return liveBytes_.load(std::memory_order_relaxed); }
+	[[nodiscard]] size_t peakBytes() const noexcept { return peakBytes_.load(std::memory_order_relaxed); }
+	[[nodiscard]] size_t totalBytes() const noexcept { return totalBytes_.load(std::memory_order_relaxed); }
+
+	/** Allocations that fell into the bucket. */
+	[[nodiscard]] size_t histogram(size_t bucket) const noexcept { return histogram_[bucket].load(std::memory_order_relaxed); }
+
+	static constexpr size_t bucketOf(size_t bytes) noexcept;
+	static constexpr size_t bucketLimit(size_t bucket) noexcept { return size_t{ 1 } << bucket; }
+
+	/**
+	 * Starts counting afresh: the counts, total bytes and histogram go to zero and the peak drops to
+	 * what is live now. Live allocations and bytes stay, since their frees are still to come.
+	 */
+	void reset() noexcept;
+
+	/** One shared instance per tag type, for counting a whole group of containers together. */
+	template<typename Tag>
+	static AllocationStats& forTag() noexcept;
+
+private:
+	std::atomic<size_t> allocations_{ 0 };
+	std::atomic<size_t> deallocations_{ 0 };
+
+	/** What was live at the last reset(), which zeroed the two counts above. */
+	std::atomic<size_t> liveAtReset_{ 0 };
+
+	// Every free is of a block whose allocation was recorded first, so this never goes below zero.
+	std::atomic<size_t> liveBytes_{ 0 };
+	std::atomic<size_t> peakBytes_{ 0 };
+	std::atomic<size_t> totalBytes_{ 0 };
+
+	std::atomic<size_t> histogram_[BucketCount]{};
+};
+
+
+/**
+ * Allocator adaptor that forwards to `Inner` and records every allocation into an AllocationStats.
+ *
+ * Given a stats object, it counts for whoever holds it: a container and its rebound node
+ * allocator share it, so one stats object per container gives per-instance numbers.
+ * Default-constructed, it records into AllocationStats::forTag<Tag>(), summing up every container
+ * using the same tag.
+ *
+ *   AllocationStats stats;
+ *   DoubleLinkedList<int, CountingAllocator<int>> list{ CountingAllocator<int>(stats) };
+ *   ...
+ *   EXPECT_EQ(stats.liveAllocations(), list.size());
+ */
+template<typename T, typename Inner = std::allocator<T>, typename Tag = void>
+class CountingAllocator
+{
+	using inner_traits = std::allocator_traits<Inner>;
+
+public:
+	using value_type = T;
+	using inner_allocator_type = Inner;
+
+	using propagate_on_container_copy_assignment = typename inner_traits::propagate_on_container_copy_assignment;
+	using propagate_on_container_move_assignment = typename inner_traits::propagate_on_container_move_assignment;
+	using propagate_on_container_swap = typename inner_traits::propagate_on_container_swap;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = CountingAllocator<U, typename inner_traits::template rebind_alloc<U>, Tag>;
+	};
+
+public:
+	CountingAllocator() : stats_{ &AllocationStats::forTag<Tag>() } {}
+	explicit CountingAllocator(AllocationStats& stats, const Inner& inner = Inner()) : inner_{ inner }, stats_{ &stats } {}
+
+	template<typename U, typename OtherInner>
+	CountingAllocator(const CountingAllocator<U, OtherInner, Tag>& other) : inner_{ other.inner() }, stats_{ &other.stats() } {}
+
+	[[nodiscard]] T* allocate(size_t n);
+	void deallocate(T* p, size_t n);
+
+	CountingAllocator select_on_container_copy_construction() const;
+
+	[[nodiscard]] const Inner& inner() const noexcept { return inner_; }
+	[[nodiscard]] AllocationStats& stats() const noexcept { return *stats_; }
+
+private:
+	Inner inner_{};
+	AllocationStats* stats_;
+};
+
+template<typename T, typename InnerT, typename U, typename InnerU, typename Tag>
+bool operator==(const CountingAllocator<T, InnerT, Tag>& lhs, const CountingAllocator<U, InnerU, Tag>& rhs) noexcept
+{
+	return &lhs.stats() == &rhs.stats() && lhs.inner() == rhs.inner();
+}
+
+
+inline void AllocationStats::recordAllocation(size_t bytes) noexcept
+{
+	allocations_.fetch_add(1, std::memory_order_relaxed);
+	totalBytes_.fetch_add(bytes, std::memory_order_relaxed);
+	histogram_[bucketOf(bytes)].fetch_add(1, std::memory_order_relaxed);
+
+	const size_t live = liveBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+	size_t peak = peakBytes_.load(std::memory_order_relaxed);
+	while (live > peak && !peakBytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+}
+
+inline void AllocationStats::recordDeallocation(size_t bytes) noexcept
+{
+	deallocations_.fetch_add(1, std::memory_order_relaxed);
+	liveBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+constexpr size_t AllocationStats::bucketOf(size_t bytes) noexcept
+{
+	const size_t bucket = bytes <= 1 ? 0 : static_cast<size_t>(std::bit_width(bytes - 1));
+	return std::min(bucket, BucketCount - 1);
+}
+
+inline void AllocationStats::reset() noexcept
+{
+	liveAtReset_.store(liveAllocations(), std::memory_order_relaxed);
+	allocations_.store(0, std::memory_order_relaxed);
+	deallocations_.store(0, std::memory_order_relaxed);
+	peakBytes_.store(liveBytes(), std::memory_order_relaxed);
+	totalBytes_.store(0, std::memory_order_relaxed);
+
+	for (auto& bucket : histogram_)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+template<typename Tag>
+AllocationStats& AllocationStats::forTag() noexcept
+{
+	static AllocationStats stats;
+	return stats;
+}
+
+template<typename T, typename Inner, typename Tag>
+T* CountingAllocator<T, Inner, Tag>::allocate(size_t n)
+{
+	T* p = inner_traits::allocate(inner_, n);
+	stats_->recordAllocation(n * sizeof(T));
+	return p;
+}
+
+template<typename T, typename Inner, typename Tag>
+void CountingAllocator<T, Inner, Tag>::deallocate(T* p, size_t n)
+{
+	stats_->recordDeallocation(n * sizeof(T));
+	inner_traits::deallocate(inner_, p, n);
+}
+
+template<typename T, typename Inner, typename Tag>
+CountingAllocator<T, Inner, Tag> CountingAllocator<T, Inner, Tag>::select_on_container_copy_construction() const
+{
+	// A copied container keeps counting into the same stats.
+	return CountingAllocator(*stats_, inner_traits::select_on_container_copy_construction(inner_));
+}
@@ -1,6 +1,14 @@
 #pragma once
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "ContainerStats.h"
+#include "Types.h"
 
 template<typename T, typename Allocator>
 class DoubleLinkedListIterator;
@@ -30,6 +38,12 @@ struct DoubleLinkedListNode final
 	{
 	}
 
+	template<typename... Args>
+	explicit DoubleLinkedListNode(std::in_place_t, Args&&... args)
+		: value(std::forward<Args>(args)...)
+	{
+	}
+
 	template<typename Alloc>
 	void freeNode(Alloc& allocator)
 	{
@@ -49,16 +63,24 @@ public:
 	using NodePtr = Node*;
 	using Iterator = DoubleLinkedListIterator<T, Allocator>;
 	using ConstIterator = DoubleLinkedListConstIterator<T, Allocator>;
+	using ReverseIterator = std::reverse_iterator<Iterator>;
+	using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
 
 	using AllocType = Allocator;
 	using AllocTypeTraits = std::allocator_traits<AllocType>;
 	using AllocNode = typename AllocTypeTraits::template rebind_alloc<Node>;
 	using AllocNodeTraits = std::allocator_traits<AllocNode>;
 
+	static constexpr bool bNothrowMoveAssign = AllocNodeTraits::propagate_on_container_move_assignment::value || AllocNodeTraits::is_always_equal::value;
+
 public:
 	DoubleLinkedList();
-	DoubleLinkedList(std::initializer_list<T> vals);
+	explicit DoubleLinkedList(const Allocator& allocator);
+	DoubleLinkedList(std::initializer_list<T> vals, const Allocator& allocator = Allocator());
+
+	/** The copy gets the allocator that select_on_container_copy_construction picks. */
 	DoubleLinkedList(const DoubleLinkedList& other);
+	DoubleLinkedList(const DoubleLinkedList& other, const Allocator& allocator);
 	DoubleLinkedList(DoubleLinkedList&& other) noexcept;
 	~DoubleLinkedList();
 
@@ -68,18 +90,53 @@ public:
 	void pushBack(const T& val);
 	void pushBack(T&& val);
 
+	/** Appends [first, last) in order. */
+	template<std::input_iterator InputIt>
+	void pushBackRange(InputIt first, InputIt last);
+
 	void popFront();
 	void popBack();
 
 	void clear();
 
+	/** Inserts before `where` and returns an iterator to the new element. */
+	Iterator insert(Iterator where, const T& val);
+	Iterator insert(Iterator where, T&& val);
+
+	template<typename... Args>
+	Iterator emplace(Iterator where, Args&&... args);
+
 	void remove(Iterator where);
 
+	/** Removes the element(s) and returns an iterator to the element that followed them. */
+	Iterator erase(Iterator where);
+	Iterator erase(Iterator first, Iterator last);
+
+	/**
+	 * Moves nodes of `other` in front of `where`. Nothing is allocated, copied or moved,
+	 * the nodes are only relinked, so references and iterators to them still reach the same elements.
+	 * Such an iterator still names `other` as its list, though: re-obtain it from this list before
+	 * comparing it with this list's iterators, or the ownership assert fires.
+	 * Relinking is O(1); when `other` is another list the moved range still has to be counted
+	 * to keep both sizes right, so that overload is linear in the length of the range.
+	 * Both lists must have equal allocators, since the nodes are freed by the receiving one.
+	 */
+	void splice(Iterator where, DoubleLinkedList& other);
+	void splice(Iterator where, DoubleLinkedList& other, Iterator it);
+	void splice(Iterator where, DoubleLinkedList& other, Iterator first, Iterator last);
+
 	constexpr size_t size() const noexcept;
 	constexpr bool isEmpty() const noexcept;
 
+	/**
+	 * Assignments follow the allocator's propagate_on_container_* traits. When a move can't take
+	 * the allocator along and the two allocators differ, the values are moved into new nodes.
+	 */
 	DoubleLinkedList& operator=(const DoubleLinkedList& other);
-	DoubleLinkedList& operator=(DoubleLinkedList&& other) noexcept;
+	DoubleLinkedList& operator=(DoubleLinkedList&& other) noexcept(bNothrowMoveAssign);
+
+	/** Allocators are swapped only if they propagate on swap; otherwise they must be equal. */
+	void swap(DoubleLinkedList& other) noexcept;
 
 	T& front();
 	const T& front() const;
@@ -96,12 +153,32 @@ public:
 	ConstIterator cbegin() const;
 	ConstIterator cend() const;
 
+	ReverseIterator rbegin();
+	ReverseIterator rend();
+
+	ConstReverseIterator rbegin() const;
+	ConstReverseIterator rend() const;
+
+	ConstReverseIterator crbegin() const;
+	ConstReverseIterator crend() const;
+
+	AllocType getAllocator() const { return AllocType(nodeAllocator_); }
+
+	/** Node allocations and O(n) walks so far; zeros unless built with ALGORITHMS_ENABLE_STATS. */
+	ContainerStats stats() const noexcept { return stats_.snapshot(); }
+	void resetStats() noexcept { stats_.reset(); }
+
 private:
 	constexpr bool isInBounds(size_t index) const noexcept;
 
 	void copyFromAnother(const DoubleLinkedList& other);
+
+	/** Takes the nodes of `other`. Our allocator must be able to free them. */
 	void moveFromAnother(DoubleLinkedList&& other);
 
+	/** Moves the values of `other` into nodes of our own allocator. */
+	void moveElementsFrom(DoubleLinkedList&& other);
+
 	template<typename ValType>
 	void insertAtBeginning(ValType&& val);
 
@@ -111,16 +188,28 @@ private:
 	template<typename... Args>
 	NodePtr allocateAndConstruct(Args&&... args);
 
+	/** Links the already chained nodes [first, last] in front of `where` (nullptr means the end). */
+	void linkBefore(NodePtr where, NodePtr first, NodePtr last);
+
+	/** Detaches the chained nodes [first, last] from the list, without freeing them. */
+	void unlink(NodePtr first, NodePtr last);
+
 	Node* get(size_t index);
 	const Node* get(size_t index) const;
 
 private:
-	AllocType allocator_{};
-	AllocNode nodeAllocator_{};
+	// Only the node allocator is kept, AllocType is rebuilt from it on request.
+	NO_UNIQUE_ADDRESS AllocNode nodeAllocator_{};
 
 	NodePtr head_{ nullptr };
 	NodePtr tail_{ nullptr };
 	size_t size_{ 0 };
+
+	// Mutable so the const lookups can count their walks too.
+	NO_UNIQUE_ADDRESS mutable ContainerStatsRecorder stats_;
+
+	friend Iterator;
+	friend ConstIterator;
 };
 
 
@@ -128,20 +217,31 @@ template<typename T, typename Allocator>
 class DoubleLinkedListIterator
 {
 public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
 	using Node = DoubleLinkedListNode<T>;
 	using NodePtr = Node*;
 	using Iterator = DoubleLinkedListIterator;
 
 	using MyList = DoubleLinkedList<T, Allocator>;
 public:
+	DoubleLinkedListIterator() = default;
 	DoubleLinkedListIterator(const MyList* owner, Node* node) : owner_{ owner }, node_{ node } {}
 
-	T& operator*() { return node_->value; }
-	const T& operator*() const { return node_->value; }
+	reference operator*() const { return node_->value; }
+	pointer operator->() const { return &node_->value; }
 
 	Iterator& operator++() { node_ = node_->next; return *this; }
 	Iterator operator++(int) { Iterator old(owner_, node_); node_ = node_->next; return old; }
 
+	// end() holds no node, so stepping back from it lands on the tail.
+	Iterator& operator--() { node_ = node_ ? node_->previous : owner_->tail_; return *this; }
+	Iterator operator--(int) { Iterator old(owner_, node_); --(*this); return old; }
+
 	constexpr bool operator==(const Iterator& other) const
 	{
 		assert(owner_ == other.owner_);
@@ -153,26 +253,39 @@ private:
 	const MyList* owner_ = nullptr;
 	NodePtr node_{ nullptr };
 
-	friend class MyList;
+	friend MyList;
+	friend DoubleLinkedListConstIterator<T, Allocator>;
 };
 
 template<typename T, typename Allocator>
 class DoubleLinkedListConstIterator
 {
 public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
 	using Node = DoubleLinkedListNode<T>;
 	using NodePtr = Node*;
 	using ConstIterator = DoubleLinkedListConstIterator;
 
 	using MyList = DoubleLinkedList<T, Allocator>;
 public:
+	DoubleLinkedListConstIterator() = default;
 	DoubleLinkedListConstIterator(const MyList* owner, Node* node) : owner_{ owner }, node_{ node } {}
+	DoubleLinkedListConstIterator(const DoubleLinkedListIterator<T, Allocator>& it) : owner_{ it.owner_ }, node_{ it.node_ } {}
 
-	const T& operator*() const { return node_->value; }
+	reference operator*() const { return node_->value; }
+	pointer operator->() const { return &node_->value; }
 
 	ConstIterator& operator++() { node_ = node_->next; return *this; }
 	ConstIterator operator++(int) { ConstIterator old(owner_, node_); node_ = node_->next; return old; }
 
+	ConstIterator& operator--() { node_ = node_ ? node_->previous : owner_->tail_; return *this; }
+	ConstIterator operator--(int) { ConstIterator old(owner_, node_); --(*this); return old; }
+
 	constexpr bool operator==(const ConstIterator& other) const
 	{
 		assert(owner_ == other.owner_);
@@ -210,14 +323,29 @@ DoubleLinkedList<T, Allocator>::DoubleLinkedList()
 {
 }
 
+template <typename T, typename Allocator>
+DoubleLinkedList<T, Allocator>::DoubleLinkedList(const Allocator& allocator)
+	: nodeAllocator_{ allocator }
+{
+}
+
 template <typename T, typename Allocator>
 DoubleLinkedList<T, Allocator>::DoubleLinkedList(const DoubleLinkedList& other)
+	: nodeAllocator_{ AllocNodeTraits::select_on_container_copy_construction(other.nodeAllocator_) }
+{
+	copyFromAnother(other);
+}
+
+template <typename T, typename Allocator>
+DoubleLinkedList<T, Allocator>::DoubleLinkedList(const DoubleLinkedList& other, const Allocator& allocator)
+	: nodeAllocator_{ allocator }
 {
 	copyFromAnother(other);
 }
 
 template <typename T, typename Allocator>
-DoubleLinkedList<T, Allocator>::DoubleLinkedList(std::initializer_list<T> vals)
+DoubleLinkedList<T, Allocator>::DoubleLinkedList(std::initializer_list<T> vals, const Allocator& allocator)
+	: nodeAllocator_{ allocator }
 {
 	size_ = vals.size();
 	NodePtr previous = nullptr;
@@ -244,6 +372,7 @@ DoubleLinkedList<T, Allocator>::DoubleLinkedList(std::initializer_list<T> vals)
 
 template <typename T, typename Allocator>
 DoubleLinkedList<T, Allocator>::DoubleLinkedList(DoubleLinkedList&& other) noexcept
+	: nodeAllocator_{ other.nodeAllocator_ }
 {
 	moveFromAnother(std::move(other));
 }
@@ -268,6 +397,8 @@ const typename DoubleLinkedList<T, Allocator>::Node* DoubleLinkedList<T, Allocat
 		return nullptr;
 	}
 
+	stats_.countWalk(index);
+
 	Node* node = head_;
 	for (size_t i = 0; i < index; ++i)
 	{
@@ -329,6 +460,16 @@ void DoubleLinkedList<T, Allocator>::pushBack(T&& val)
 	insertAtEnd(std::move(val));
 }
 
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+void DoubleLinkedList<T, Allocator>::pushBackRange(InputIt first, InputIt last)
+{
+	for (; first != last; ++first)
+	{
+		insertAtEnd(*first);
+	}
+}
+
 template <typename T, typename Allocator>
 template <typename ValType>
 void DoubleLinkedList<T, Allocator>::insertAtEnd(ValType&& val)
@@ -362,6 +503,7 @@ typename DoubleLinkedList<T, Allocator>::NodePtr DoubleLinkedList<T, Allocator>:
 {
 	NodePtr node = AllocNodeTraits::allocate(nodeAllocator_, 1);
 	AllocNodeTraits::construct(nodeAllocator_, node, std::forward<Args>(args)...);
+	stats_.countNodeAllocation();
 	return node;
 }
 
@@ -440,39 +582,190 @@ void DoubleLinkedList<T, Allocator>::clear()
 	size_ = 0;
 }
 
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::Iterator DoubleLinkedList<T, Allocator>::insert(Iterator where, const T& val)
+{
+	return emplace(where, val);
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::Iterator DoubleLinkedList<T, Allocator>::insert(Iterator where, T&& val)
+{
+	return emplace(where, std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+typename DoubleLinkedList<T, Allocator>::Iterator DoubleLinkedList<T, Allocator>::emplace(Iterator where, Args&&... args)
+{
+	assert(where.owner_ == this);
+
+	NodePtr newNode = allocateAndConstruct(std::in_place, std::forward<Args>(args)...);
+	linkBefore(where.node_, newNode, newNode);
+	++size_;
+
+	return Iterator(this, newNode);
+}
+
 template <typename T, typename Allocator>
 void DoubleLinkedList<T, Allocator>::remove(Iterator where)
+{
+	assert(where != end());
+	erase(where);
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::Iterator DoubleLinkedList<T, Allocator>::erase(Iterator where)
+{
+	assert(where != end());
+	return erase(where, Iterator(this, where.node_->next));
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::Iterator DoubleLinkedList<T, Allocator>::erase(Iterator first, Iterator last)
+{
+	assert(first.owner_ == this && last.owner_ == this);
+
+	if (first == last)
+	{
+		return last;
+	}
+
+	NodePtr lastToDelete = last.node_ ? last.node_->previous : tail_;
+	unlink(first.node_, lastToDelete);
+
+	NodePtr node = first.node_;
+	while (node)
+	{
+		NodePtr next = node->next;
+		node->freeNode(nodeAllocator_);
+		--size_;
+		node = next;
+	}
+
+	return last;
+}
+
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::splice(Iterator where, DoubleLinkedList& other)
+{
+	assert(nodeAllocator_ == other.nodeAllocator_);
+
+	if (this == &other || other.isEmpty())
+	{
+		return;
+	}
+
+	NodePtr first = other.head_;
+	NodePtr last = other.tail_;
+	size_t count = other.size_;
+
+	other.head_ = nullptr;
+	other.tail_ = nullptr;
+	other.size_ = 0;
+
+	linkBefore(where.node_, first, last);
+	size_ += count;
+}
+
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::splice(Iterator where, DoubleLinkedList& other, Iterator it)
+{
+	assert(it != other.end());
+	splice(where, other, it, Iterator(&other, it.node_->next));
+}
+
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::splice(Iterator where, DoubleLinkedList& other, Iterator first, Iterator last)
 {
 	/**
-	 * 1. empty
-	 * 2. one elem
-	 * 3. beginning
-	 * 4. end
-	 * 5. 
+	 * 1. empty range
+	 * 2. within this list - sizes stay the same
+	 * 3. from another list - count the range to move the size over
 	 */
-	assert(where != end());
 
+	assert(where.owner_ == this);
+	assert(first.owner_ == &other && last.owner_ == &other);
+	assert(nodeAllocator_ == other.nodeAllocator_);
 
-	NodePtr previousNode = where.node_->previous;
-	NodePtr toDeleteNode = where.node_;
-	NodePtr nextNode = where.node_->next;
+	if (first == last || where.node_ == first.node_)
+	{
+		return;
+	}
 
-	if (toDeleteNode == head_)
+	NodePtr lastToMove = last.node_ ? last.node_->previous : other.tail_;
+
+	if (this != &other)
 	{
-		popFront();
+		size_t count = 1;
+		for (NodePtr node = first.node_; node != lastToMove; node = node->next)
+		{
+			++count;
+		}
+
+		other.size_ -= count;
+		size_ += count;
 	}
-	else if (toDeleteNode == tail_)
+
+	other.unlink(first.node_, lastToMove);
+	linkBefore(where.node_, first.node_, lastToMove);
+}
+
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::linkBefore(NodePtr where, NodePtr first, NodePtr last)
+{
+	NodePtr previous = where ? where->previous : tail_;
+
+	first->previous = previous;
+	last->next = where;
+
+	if (previous)
 	{
-		popBack();
+		previous->next = first;
 	}
 	else
 	{
-		previousNode->next = nextNode;
-		toDeleteNode->freeNode(nodeAllocator_);
-		--size_;
+		head_ = first;
+	}
+
+	if (where)
+	{
+		where->previous = last;
+	}
+	else
+	{
+		tail_ = last;
 	}
 }
 
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::unlink(NodePtr first, NodePtr last)
+{
+	NodePtr previous = first->previous;
+	NodePtr next = last->next;
+
+	if (previous)
+	{
+		previous->next = next;
+	}
+	else
+	{
+		head_ = next;
+	}
+
+	if (next)
+	{
+		next->previous = previous;
+	}
+	else
+	{
+		tail_ = previous;
+	}
+
+	first->previous = nullptr;
+	last->next = nullptr;
+}
+
 
 template<typename T, typename Allocator>
 DoubleLinkedList<T, Allocator>& DoubleLinkedList<T, Allocator>::operator=(const DoubleLinkedList& other)
@@ -481,6 +774,17 @@ DoubleLinkedList<T, Allocator>& DoubleLinkedList<T, Allocator>::operator=(const
 	{
 		return *this;
 	}
+
+	if constexpr (AllocNodeTraits::propagate_on_container_copy_assignment::value)
+	{
+		// Our nodes have to go back to the allocator that made them before that one is replaced.
+		if (nodeAllocator_ != other.nodeAllocator_)
+		{
+			clear();
+		}
+		nodeAllocator_ = other.nodeAllocator_;
+	}
+
 	copyFromAnother(other);
 
 	return *this;
@@ -488,13 +792,33 @@ DoubleLinkedList<T, Allocator>& DoubleLinkedList<T, Allocator>::operator=(const
 
 
 template<typename T, typename Allocator>
-DoubleLinkedList<T, Allocator>& DoubleLinkedList<T, Allocator>::operator=(DoubleLinkedList&& other) noexcept
+DoubleLinkedList<T, Allocator>& DoubleLinkedList<T, Allocator>::operator=(DoubleLinkedList&& other) noexcept(bNothrowMoveAssign)
 {
+	/**
+	 * 1. the allocator propagates - free our nodes, take the other's allocator and nodes
+	 * 2. the allocators are equal - take the nodes
+	 * 3. they differ - move the values over
+	 */
+
 	if (this == &other)
 	{
 		return *this;
 	}
-	moveFromAnother(std::move(other));
+
+	if constexpr (AllocNodeTraits::propagate_on_container_move_assignment::value)
+	{
+		clear();
+		nodeAllocator_ = std::move(other.nodeAllocator_);
+		moveFromAnother(std::move(other));
+	}
+	else if (AllocNodeTraits::is_always_equal::value || nodeAllocator_ == other.nodeAllocator_)
+	{
+		moveFromAnother(std::move(other));
+	}
+	else
+	{
+		moveElementsFrom(std::move(other));
+	}
 
 	return *this;
 }
@@ -562,6 +886,42 @@ typename DoubleLinkedList<T, Allocator>::ConstIterator DoubleLinkedList<T, Alloc
 	return end();
 }
 
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::ReverseIterator DoubleLinkedList<T, Allocator>::rbegin()
+{
+	return ReverseIterator(end());
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::ReverseIterator DoubleLinkedList<T, Allocator>::rend()
+{
+	return ReverseIterator(begin());
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::ConstReverseIterator DoubleLinkedList<T, Allocator>::rbegin() const
+{
+	return ConstReverseIterator(end());
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::ConstReverseIterator DoubleLinkedList<T, Allocator>::rend() const
+{
+	return ConstReverseIterator(begin());
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::ConstReverseIterator DoubleLinkedList<T, Allocator>::crbegin() const
+{
+	return rbegin();
+}
+
+template <typename T, typename Allocator>
+typename DoubleLinkedList<T, Allocator>::ConstReverseIterator DoubleLinkedList<T, Allocator>::crend() const
+{
+	return rend();
+}
+
 template <typename T, typename Allocator>
 void DoubleLinkedList<T, Allocator>::copyFromAnother(const DoubleLinkedList& other)
 {
@@ -608,3 +968,39 @@ void DoubleLinkedList<T, Allocator>::moveFromAnother(DoubleLinkedList&& other)
 	tail_ = std::exchange(other.tail_, nullptr);
 	size_ = std::exchange(other.size_, 0);
 }
+
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::moveElementsFrom(DoubleLinkedList&& other)
+{
+	clear();
+
+	for (NodePtr node = other.head_; node; node = node->next)
+	{
+		insertAtEnd(std::move(node->value));
+	}
+
+	other.clear();
+}
+
+template <typename T, typename Allocator>
+void DoubleLinkedList<T, Allocator>::swap(DoubleLinkedList& other) noexcept
+{
+	if constexpr (AllocNodeTraits::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(nodeAllocator_, other.nodeAllocator_);
+	}
+	else
+	{
+		assert(nodeAllocator_ == other.nodeAllocator_);
+	}
+
+	std::swap(head_, other.head_);
+	std::swap(tail_, other.tail_);
+	std::swap(size_, other.size_);
+}
+
+
+/** DoubleLinkedList drawing from a std::pmr::memory_resource. */
+template<typename T>
+using PmrDoubleLinkedList = DoubleLinkedList<T, std::pmr::polymorphic_allocator<T>>;
@@ -0,0 +1,351 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "Types.h"
+
+/**
+ * Bounded lock-free LIFO for many threads: a Treiber stack with an elimination array in front.
+ *
+ * Nodes live in one array allocated up front and link by 32-bit index. The head packs that index
+ * with a 32-bit tag bumped on every change, so a CAS can't succeed on a head that was popped and
+ * pushed back in between (ABA). Free nodes form a second stack of the same kind.
+ *
+ * When a CAS on the head fails, the thread backs off to a random slot of the elimination array
+ * instead of retrying right away. A pusher parks its node there for a moment; a popper that comes
+ * by takes it. The push and the pop cancel out without touching the head, which is what keeps the
+ * stack scaling when many threads hammer it. Slots are tagged the same way as the head.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class EliminationStack final
+{
+public:
+	using size_type = size_t;
+
+public:
+	explicit EliminationStack(size_type capacity);
+	~EliminationStack();
+
+	EliminationStack(const EliminationStack&) = delete;
+	EliminationStack& operator=(const EliminationStack&) = delete;
+
+	/** Returns false if all `capacity` nodes are in use. */
+	bool tryPush(const T& val);
+	bool tryPush(T&& val);
+
+	template<typename... Args>
+	bool tryEmplace(Args&&... args);
+
+	bool tryPop(T& out);
+
+	/** Only a snapshot while other threads are running. */
+	bool isEmptyApprox() const noexcept { return indexOf(head_.load(std::memory_order_acquire)) == NullIndex; }
+
+	constexpr size_type capacity() const noexcept { return capacity_; }
+
+private:
+	struct Node
+	{
+		std::atomic<uint32> next{ 0 };
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+	};
+
+	struct alignas(CacheLineSize) Slot
+	{
+		std::atomic<uint64> state{ 0 };
+	};
+
+	using node_alloc_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using node_alloc_traits = std::allocator_traits<node_alloc_type>;
+
+	static constexpr uint32 NullIndex = std::numeric_limits<uint32>::max();
+	static constexpr size_type SlotCount = 16;
+	static constexpr int EliminationWaits = 8;
+
+	static constexpr uint64 pack(uint32 tag, uint32 index) noexcept { return (static_cast<uint64>(tag) << 32) | index; }
+	static constexpr uint32 tagOf(uint64 word) noexcept { return static_cast<uint32>(word >> 32); }
+	static constexpr uint32 indexOf(uint64 word) noexcept { return static_cast<uint32>(word); }
+
+	/** Pops a node index off a tagged stack, NullIndex if it's empty. Retries until it wins. */
+	uint32 popIndex(std::atomic<uint64>& head);
+	void pushIndex(std::atomic<uint64>& head, uint32 index);
+
+	/** One CAS at the head of the main stack. */
+	bool tryLinkOnce(uint32 index);
+
+	/** One CAS at the head of the main stack. `taken` is NullIndex when the stack is empty. */
+	bool tryUnlinkOnce(uint32& taken);
+
+	/** Parks the node in a slot for a while. True if a popper took it. */
+	bool tryEliminatePush(uint32 index);
+
+	/** Takes a node parked by a pusher, NullIndex if the slot had none. */
+	uint32 tryEliminatePop();
+
+	Slot& randomSlot() noexcept;
+
+private:
+	alignas(CacheLineSize) std::atomic<uint64> head_{ pack(0, NullIndex) };
+	alignas(CacheLineSize) std::atomic<uint64> freeHead_{ pack(0, NullIndex) };
+
+	Slot slots_[SlotCount];
+
+	// Read-only after construction
+	alignas(CacheLineSize) node_alloc_type allocator_{};
+	Node* nodes_{ nullptr };
+	size_type capacity_{ 0 };
+};
+
+
+template<typename T, typename Allocator>
+EliminationStack<T, Allocator>::EliminationStack(size_type capacity)
+	: capacity_{ capacity }
+{
+	assert(capacity > 0 && capacity < NullIndex);
+
+	nodes_ = node_alloc_traits::allocate(allocator_, capacity_);
+	for (size_type i = 0; i < capacity_; ++i)
+	{
+		node_alloc_traits::construct(allocator_, &nodes_[i]);
+		nodes_[i].next.store(i + 1 < capacity_ ? static_cast<uint32>(i + 1) : NullIndex, std::memory_order_relaxed);
+	}
+
+	freeHead_.store(pack(0, 0), std::memory_order_relaxed);
+
+	for (Slot& slot : slots_)
+	{
+		slot.state.store(pack(0, NullIndex), std::memory_order_relaxed);
+	}
+}
+
+template<typename T, typename Allocator>
+EliminationStack<T, Allocator>::~EliminationStack()
+{
+	for (uint32 i = indexOf(head_.load(std::memory_order_relaxed)); i != NullIndex; i = nodes_[i].next.load(std::memory_order_relaxed))
+	{
+		std::destroy_at(nodes_[i].value());
+	}
+
+	for (size_type i = 0; i < capacity_; ++i)
+	{
+		node_alloc_traits::destroy(allocator_, &nodes_[i]);
+	}
+
+	node_alloc_traits::deallocate(allocator_, nodes_, capacity_);
+}
+
+template<typename T, typename Allocator>
+bool EliminationStack<T, Allocator>::tryPush(const T& val)
+{
+	return tryEmplace(val);
+}
+
+template<typename T, typename Allocator>
+bool EliminationStack<T, Allocator>::tryPush(T&& val)
+{
+	return tryEmplace(std::move(val));
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+bool EliminationStack<T, Allocator>::tryEmplace(Args&&... args)
+{
+	const uint32 index = popIndex(freeHead_);
+	if (index == NullIndex)
+	{
+		return false;
+	}
+
+	try
+	{
+		new (nodes_[index].storage) T(std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		// Otherwise the node is gone for good and the capacity shrinks by one.
+		pushIndex(freeHead_, index);
+		throw;
+	}
+
+	while (!tryLinkOnce(index))
+	{
+		if (tryEliminatePush(index))
+		{
+			return true;
+		}
+	}
+
+	return true;
+}
+
+template<typename T, typename Allocator>
+bool EliminationStack<T, Allocator>::tryPop(T& out)
+{
+	uint32 index = NullIndex;
+
+	while (!tryUnlinkOnce(index))
+	{
+		index = tryEliminatePop();
+		if (index != NullIndex)
+		{
+			break;
+		}
+	}
+
+	if (index == NullIndex)
+	{
+		return false;
+	}
+
+	T* val = nodes_[index].value();
+	out = std::move(*val);
+	std::destroy_at(val);
+
+	pushIndex(freeHead_, index);
+
+	return true;
+}
+
+template<typename T, typename Allocator>
+uint32 EliminationStack<T, Allocator>::popIndex(std::atomic<uint64>& head)
+{
+	uint64 word = head.load(std::memory_order_acquire);
+	for (;;)
+	{
+		const uint32 index = indexOf(word);
+		if (index == NullIndex)
+		{
+			return NullIndex;
+		}
+
+		// May read the link of a node somebody else just took; the tag makes the CAS fail then.
+		const uint32 next = nodes_[index].next.load(std::memory_order_relaxed);
+		if (head.compare_exchange_weak(word, pack(tagOf(word) + 1, next), std::memory_order_acquire, std::memory_order_acquire))
+		{
+			return index;
+		}
+	}
+}
+
+template<typename T, typename Allocator>
+void EliminationStack<T, Allocator>::pushIndex(std::atomic<uint64>& head, uint32 index)
+{
+	uint64 word = head.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		nodes_[index].next.store(indexOf(word), std::memory_order_relaxed);
+		if (head.compare_exchange_weak(word, pack(tagOf(word) + 1, index), std::memory_order_release, std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+}
+
+template<typename T, typename Allocator>
+bool EliminationStack<T, Allocator>::tryLinkOnce(uint32 index)
+{
+	uint64 word = head_.load(std::memory_order_relaxed);
+	nodes_[index].next.store(indexOf(word), std::memory_order_relaxed);
+
+	return head_.compare_exchange_strong(word, pack(tagOf(word) + 1, index), std::memory_order_release, std::memory_order_relaxed);
+}
+
+template<typename T, typename Allocator>
+bool EliminationStack<T, Allocator>::tryUnlinkOnce(uint32& taken)
+{
+	uint64 word = head_.load(std::memory_order_acquire);
+
+	const uint32 index = indexOf(word);
+	if (index == NullIndex)
+	{
+		taken = NullIndex;
+		return true;
+	}
+
+	const uint32 next = nodes_[index].next.load(std::memory_order_relaxed);
+	if (!head_.compare_exchange_strong(word, pack(tagOf(word) + 1, next), std::memory_order_acquire, std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	taken = index;
+	return true;
+}
+
+template<typename T, typename Allocator>
+bool EliminationStack<T, Allocator>::tryEliminatePush(uint32 index)
+{
+	/**
+	 * 1. the slot is taken by another pusher - give up on it, go back to the head
+	 * 2. parked, and a popper took the node while we waited - done
+	 * 3. parked, nobody came - take the node back; if that fails, a popper got it at the last moment
+	 */
+
+	Slot& slot = randomSlot();
+
+	uint64 word = slot.state.load(std::memory_order_relaxed);
+	if (indexOf(word) != NullIndex)
+	{
+		return false;
+	}
+
+	const uint64 offer = pack(tagOf(word) + 1, index);
+	if (!slot.state.compare_exchange_strong(word, offer, std::memory_order_release, std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < EliminationWaits; ++i)
+	{
+		if (slot.state.load(std::memory_order_relaxed) != offer)
+		{
+			return true;
+		}
+		std::this_thread::yield();
+	}
+
+	uint64 expected = offer;
+	return !slot.state.compare_exchange_strong(expected, pack(tagOf(offer) + 1, NullIndex), std::memory_order_relaxed);
+}
+
+template<typename T, typename Allocator>
+uint32 EliminationStack<T, Allocator>::tryEliminatePop()
+{
+	Slot& slot = randomSlot();
+
+	uint64 word = slot.state.load(std::memory_order_acquire);
+	const uint32 index = indexOf(word);
+	if (index == NullIndex)
+	{
+		return NullIndex;
+	}
+
+	// Acquire pairs with the pusher's release when it parked the node, so the value is visible.
+	if (!slot.state.compare_exchange_strong(word, pack(tagOf(word) + 1, NullIndex), std::memory_order_acquire, std::memory_order_relaxed))
+	{
+		return NullIndex;
+	}
+
+	return index;
+}
+
+template<typename T, typename Allocator>
+typename EliminationStack<T, Allocator>::Slot& EliminationStack<T, Allocator>::randomSlot() noexcept
+{
+	// xorshift, seeded differently per thread so colliding threads spread over the slots.
+	thread_local uint32 state = static_cast<uint32>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+
+	return slots_[state % SlotCount];
+}
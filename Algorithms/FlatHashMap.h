@@ -0,0 +1,1034 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "ContainerStats.h"
+#include "Types.h"
+
+// SSE2 is there on every x86-64; define ALGORITHMS_FLAT_HASH_PORTABLE to use the 8-byte fallback anyway.
+#if !defined(ALGORITHMS_FLAT_HASH_PORTABLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ALGORITHMS_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * Control bytes of FlatHashMap, one per slot. A full slot stores the low 7 bits of its key's hash
+ * (H2), so the top bit is clear; the special values all have it set.
+ */
+struct FlatHashControl
+{
+	static constexpr int8 Empty = -128;
+	static constexpr int8 Deleted = -2;
+
+	/** Sits after the last slot, ahead of the mirrored bytes; a group load that covers it never matches it. */
+	static constexpr int8 Sentinel = -1;
+};
+
+
+/**
+ * The positions of a group that matched, lowest first. Each position takes 2^Shift bits of `bits`:
+ * one bit per byte from SSE2's movemask, the top bit of each byte in the portable group.
+ */
+template<uint32 Width, uint32 Shift>
+class FlatHashBitMask final
+{
+public:
+	explicit constexpr FlatHashBitMask(uint64 bits) noexcept : bits_{ bits } {}
+
+	explicit constexpr operator bool() const noexcept { return bits_ != 0; }
+
+	[[nodiscard]] constexpr uint32 lowest() const noexcept { return static_cast<uint32>(std::countr_zero(bits_)) >> Shift; }
+	constexpr void clearLowest() noexcept { bits_ &= bits_ - 1; }
+
+	/** Positions before the first match, and after the last one. */
+	[[nodiscard]] constexpr uint32 trailingZeros() const noexcept { return static_cast<uint32>(std::countr_zero(bits_)) >> Shift; }
+	[[nodiscard]] constexpr uint32 leadingZeros() const noexcept
+	{
+		return (static_cast<uint32>(std::countl_zero(bits_)) - (64 - (Width << Shift))) >> Shift;
+	}
+
+private:
+	uint64 bits_;
+};
+
+
+/**
+ * Eight control bytes in a uint64, matched with SWAR bit tricks, for targets without SSE2.
+ * match() may report a full byte just above a true match as a match too; the caller compares keys
+ * anyway, so that costs a comparison and never a wrong answer. The empty masks are exact.
+ */
+class FlatHashGroupPortable final
+{
+public:
+	static constexpr size_t Width = 8;
+
+	using BitMask = FlatHashBitMask<8, 3>;
+
+public:
+	explicit FlatHashGroupPortable(const int8* ctrl) noexcept
+	{
+		// Byte by byte, so the layout is little-endian on every target; compilers make it one load.
+		for (size_t i = 0; i < Width; ++i)
+		{
+			ctrl_ |= static_cast<uint64>(static_cast<uint8>(ctrl[i])) << (8 * i);
+		}
+	}
+
+	[[nodiscard]] BitMask match(uint8 h2) const noexcept
+	{
+		const uint64 x = ctrl_ ^ (Lsbs * h2);
+		return BitMask((x - Lsbs) & ~x & Msbs);
+	}
+
+	/** Empty is the only value with the top bit set and bit 1 clear. */
+	[[nodiscard]] BitMask matchEmpty() const noexcept { return BitMask(ctrl_ & ~(ctrl_ << 6) & Msbs); }
+
+	/** Empty and Deleted are the values with the top bit set and bit 0 clear. */
+	[[nodiscard]] BitMask matchEmptyOrDeleted() const noexcept { return BitMask(ctrl_ & ~(ctrl_ << 7) & Msbs); }
+
+private:
+	static constexpr uint64 Lsbs = 0x0101010101010101ull;
+	static constexpr uint64 Msbs = 0x8080808080808080ull;
+
+	uint64 ctrl_{ 0 };
+};
+
+#if defined(ALGORITHMS_FLAT_HASH_SSE2)
+/** Sixteen control bytes compared at once; every match is exact. */
+class FlatHashGroupSse2 final
+{
+public:
+	static constexpr size_t Width = 16;
+
+	using BitMask = FlatHashBitMask<16, 0>;
+
+public:
+	explicit FlatHashGroupSse2(const int8* ctrl) noexcept : ctrl_{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)) } {}
+
+	[[nodiscard]] BitMask match(uint8 h2) const noexcept
+	{
+		return movemask(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(h2)), ctrl_));
+	}
+
+	[[nodiscard]] BitMask matchEmpty() const noexcept
+	{
+		return movemask(_mm_cmpeq_epi8(_mm_set1_epi8(FlatHashControl::Empty), ctrl_));
+	}
+
+	/** Empty and Deleted are the values below Sentinel. */
+	[[nodiscard]] BitMask matchEmptyOrDeleted() const noexcept
+	{
+		return movemask(_mm_cmpgt_epi8(_mm_set1_epi8(FlatHashControl::Sentinel), ctrl_));
+	}
+
+private:
+	static BitMask movemask(__m128i bytes) noexcept { return BitMask(static_cast<uint32>(_mm_movemask_epi8(bytes))); }
+
+	__m128i ctrl_;
+};
+
+using FlatHashGroup = FlatHashGroupSse2;
+#else
+using FlatHashGroup = FlatHashGroupPortable;
+#endif
+
+
+/**
+ * Hashes std::string, std::string_view and string literals alike, so that a FlatHashMap keyed by
+ * std::string with StringHash and std::equal_to<> can be searched without building a std::string.
+ */
+struct StringHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>()(text); }
+};
+
+
+template<typename Map, bool bConst>
+class FlatHashMapIterator final
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using difference_type = std::ptrdiff_t;
+	using key_type = typename Map::key_type;
+	using mapped_type = std::conditional_t<bConst, const typename Map::mapped_type, typename Map::mapped_type>;
+	using value_type = std::pair<key_type, typename Map::mapped_type>;
+	using reference = std::pair<const key_type&, mapped_type&>;
+
+	using Iterator = FlatHashMapIterator;
+	using MyMap = std::conditional_t<bConst, const Map, Map>;
+
+	/** What operator-> points into: the pair of references lives in the proxy. */
+	struct ArrowProxy
+	{
+		reference pair;
+		const reference* operator->() const noexcept { return &pair; }
+	};
+
+public:
+	FlatHashMapIterator() = default;
+	FlatHashMapIterator(MyMap* owner, size_t index) : owner_{ owner }, index_{ index } {}
+
+	/** Iterators convert to const iterators. */
+	operator FlatHashMapIterator<Map, true>() const requires (!bConst) { return FlatHashMapIterator<Map, true>(owner_, index_); }
+
+	reference operator*() const { return reference(owner_->keys_[index_], owner_->values_[index_]); }
+	ArrowProxy operator->() const { return ArrowProxy{ **this }; }
+
+	Iterator& operator++() { index_ = owner_->nextFull(index_ + 1); return *this; }
+	Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+
+	constexpr bool operator==(const Iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+	[[nodiscard]] constexpr size_t index() const noexcept { return index_; }
+
+private:
+	MyMap* owner_{ nullptr };
+	size_t index_{ 0 };
+};
+
+
+/**
+ * Open-addressing hash map in the SwissTable layout: one control byte per slot and the keys and
+ * values in two separate flat arrays, with no allocation per element.
+ *
+ * A lookup hashes once. The high bits (H1) pick where probing starts; the low 7 bits (H2) go into
+ * the control byte. Probing loads a whole group of control bytes (16 with SSE2, 8 otherwise),
+ * compares all of them against H2 in a few instructions, and only touches the keys array for the
+ * candidates. It stops at the first group with an empty byte, so a miss usually costs one group
+ * load and no key comparison. Groups are probed in a triangular sequence that visits each group once.
+ *
+ * The table holds at most 7/8 of its capacity; capacities are 2^k - 1 with the control array padded
+ * by a copy of its first group, so a group load never wraps. Erasing leaves a tombstone only when a
+ * probe might have passed through the slot; tombstones are reclaimed by the next rehash.
+ *
+ * Like std::flat_map, dereferencing an iterator gives a pair of references,
+ * std::pair<const Key&, Value&>: iterate with `for (auto [key, value] : map)` or `const auto&`,
+ * not `auto&`. Inserting may rehash, which invalidates every iterator; erasing invalidates only
+ * the erased one.
+ *
+ * Lookups (find, contains, erase, tryEmplace, operator[]) take any type the hash and equality
+ * accept when both are transparent (declare is_transparent), as with StringHash and std::equal_to<>.
+ */
+template<
+	typename Key,
+	typename Value,
+	typename Hash = std::hash<Key>,
+	typename KeyEqual = std::equal_to<Key>,
+	typename Allocator = std::allocator<std::pair<const Key, Value>>
+>
+class FlatHashMap final
+{
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using size_type = size_t;
+
+	using Iterator = FlatHashMapIterator<FlatHashMap, false>;
+	using ConstIterator = FlatHashMapIterator<FlatHashMap, true>;
+
+	using allocator_type = Allocator;
+	using alloc_traits = std::allocator_traits<Allocator>;
+
+	using Group = FlatHashGroup;
+
+	static constexpr bool bTransparent = requires { typename Hash::is_transparent; typename KeyEqual::is_transparent; };
+	static constexpr bool bNothrowMoveAssign = alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value;
+
+	/** The smallest table: one group of slots, so a probe always covers whole groups. */
+	static constexpr size_type MinCapacity = Group::Width - 1;
+
+public:
+	FlatHashMap() = default;
+	explicit FlatHashMap(const Allocator& allocator) : allocator_{ allocator } {}
+	explicit FlatHashMap(const Hash& hash, const KeyEqual& equal = KeyEqual(), const Allocator& allocator = Allocator())
+		: hash_{ hash }, equal_{ equal }, allocator_{ allocator } {}
+	FlatHashMap(std::initializer_list<std::pair<Key, Value>> vals, const Allocator& allocator = Allocator());
+	~FlatHashMap();
+
+	/** The copy gets the allocator that select_on_container_copy_construction picks, and a table sized for its elements. */
+	FlatHashMap(const FlatHashMap& other);
+	FlatHashMap(const FlatHashMap& other, const Allocator& allocator);
+	FlatHashMap(FlatHashMap&& other) noexcept;
+
+	/** Assignments and swap follow the allocator's propagate_on_container_* traits, like Vector's. */
+	FlatHashMap& operator=(const FlatHashMap& other);
+	FlatHashMap& operator=(FlatHashMap&& other) noexcept(bNothrowMoveAssign);
+
+	void swap(FlatHashMap& other) noexcept;
+
+	/**
+	 * Inserts `key` with a value built from `args` unless the key is there already; `args` are then
+	 * left alone. Returns the element and whether it was inserted.
+	 */
+	template<typename... Args>
+	std::pair<Iterator, bool> tryEmplace(const Key& key, Args&&... args) { return emplaceKey(key, std::forward<Args>(args)...); }
+
+	template<typename... Args>
+	std::pair<Iterator, bool> tryEmplace(Key&& key, Args&&... args) { return emplaceKey(std::move(key), std::forward<Args>(args)...); }
+
+	/** Heterogeneous: a Key is only built from `key` when it is inserted. */
+	template<typename K, typename... Args>
+		requires bTransparent && (!std::is_convertible_v<K&&, const Key&>)
+	std::pair<Iterator, bool> tryEmplace(K&& key, Args&&... args) { return emplaceKey(std::forward<K>(key), std::forward<Args>(args)...); }
+
+	/** Inserts, or assigns `value` to the element that is already there. */
+	template<typename K, typename V>
+	std::pair<Iterator, bool> insertOrAssign(K&& key, V&& value);
+
+	/** The value of `key`, default-constructed first if the key is new. */
+	template<typename K>
+	Value& operator[](K&& key) { return (*emplaceKey(std::forward<K>(key)).first).second; }
+
+	[[nodiscard]] Iterator find(const Key& key) { return Iterator(this, findIndex(key)); }
+	[[nodiscard]] ConstIterator find(const Key& key) const { return ConstIterator(this, findIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] Iterator find(const K& key) { return Iterator(this, findIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] ConstIterator find(const K& key) const { return ConstIterator(this, findIndex(key)); }
+
+	[[nodiscard]] bool contains(const Key& key) const { return findIndex(key) != capacity_; }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] bool contains(const K& key) const { return findIndex(key) != capacity_; }
+
+	/** false when there was no such key. */
+	bool erase(const Key& key) { return eraseKey(key); }
+
+	template<typename K>
+		requires bTransparent
+	bool erase(const K& key) { return eraseKey(key); }
+
+	void erase(Iterator where);
+
+	/** Destroys every element but keeps the table. */
+	void clear();
+
+	/** Makes room for `n` elements in total, so inserting up to that many doesn't rehash. */
+	void reserve(size_type n);
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return size_; }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return size_ == 0; }
+
+	/** Slots in the table; at most 7/8 of them are ever used. */
+	[[nodiscard]] constexpr size_type capacity() const noexcept { return capacity_; }
+
+	Iterator begin() { return Iterator(this, nextFull(0)); }
+	Iterator end() { return Iterator(this, capacity_); }
+	ConstIterator begin() const { return ConstIterator(this, nextFull(0)); }
+	ConstIterator end() const { return ConstIterator(this, capacity_); }
+	ConstIterator cbegin() const { return begin(); }
+	ConstIterator cend() const { return end(); }
+
+	allocator_type getAllocator() const { return allocator_; }
+
+	/** Rehashes show as reallocations, every element moved by them as a relocation. */
+	ContainerStats stats() const noexcept { return stats_.snapshot(); }
+	void resetStats() noexcept { stats_.reset(); }
+
+private:
+	using ctrl_alloc_type = typename alloc_traits::template rebind_alloc<int8>;
+	using key_alloc_type = typename alloc_traits::template rebind_alloc<Key>;
+	using value_alloc_type = typename alloc_traits::template rebind_alloc<Value>;
+	using ctrl_traits = std::allocator_traits<ctrl_alloc_type>;
+	using key_traits = std::allocator_traits<key_alloc_type>;
+	using value_traits = std::allocator_traits<value_alloc_type>;
+
+	/** Bytes of the control array past the sentinel, mirroring the first slots. */
+	static constexpr size_type ClonedBytes = Group::Width - 1;
+
+	/** Scrambles the user's hash: std::hash of an integer is often the integer, whose low bits make a poor H2. */
+	template<typename K>
+	uint64 hashOf(const K& key) const;
+
+	static constexpr size_type h1(uint64 hash) noexcept { return static_cast<size_type>(hash >> 7); }
+	static constexpr uint8 h2(uint64 hash) noexcept { return static_cast<uint8>(hash & 0x7f); }
+
+	static constexpr size_type capacityToGrowth(size_type capacity) noexcept;
+	static constexpr bool isFull(int8 ctrl) noexcept { return ctrl >= 0; }
+
+	/** The slot holding `key`, or capacity_ if there's none. */
+	template<typename K>
+	size_type findIndex(const K& key) const { return size_ == 0 ? capacity_ : findIndex(key, hashOf(key)); }
+
+	template<typename K>
+	size_type findIndex(const K& key, uint64 hash) const;
+
+	/** First empty or deleted slot on the probe sequence of `hash`. */
+	size_type findFirstNonFull(uint64 hash) const;
+
+	/** First full slot at or after `index`, or capacity_. */
+	size_type nextFull(size_type index) const;
+
+	template<typename K, typename... Args>
+	std::pair<Iterator, bool> emplaceKey(K&& key, Args&&... args);
+
+	/** Builds key and value in the first free slot for `hash`; there must be growth left. */
+	template<typename K, typename... Args>
+	size_type constructAt(uint64 hash, K&& key, Args&&... args);
+
+	template<typename K>
+	bool eraseKey(const K& key);
+
+	void eraseAt(size_type index);
+
+	/** Sets a control byte and its mirror past the sentinel. */
+	void setCtrl(size_type index, int8 value);
+
+	/** Moves every element into a fresh table of `newCapacity` slots, dropping the tombstones. */
+	void rehash(size_type newCapacity);
+
+	/** Called when an insert finds growthLeft_ at zero. */
+	void makeRoomForInsert();
+
+	/** Replaces the table pointers only once all three arrays are allocated; the caller keeps the old ones. */
+	void allocateTable(size_type capacity);
+
+	/** Skips the walk over the control bytes when there's nothing to destroy. */
+	void destroyElements();
+	void destroyEach();
+	void freeTable();
+
+	void copyFromAnother(const FlatHashMap& other);
+	void moveFromAnother(FlatHashMap&& other);
+	void moveElementsFrom(FlatHashMap&& other);
+
+private:
+	int8* ctrl_{ nullptr };
+	Key* keys_{ nullptr };
+	Value* values_{ nullptr };
+
+	size_type size_{ 0 };
+	size_type capacity_{ 0 };
+
+	/** Inserts into empty slots left before the table has to grow. */
+	size_type growthLeft_{ 0 };
+
+	NO_UNIQUE_ADDRESS Hash hash_;
+	NO_UNIQUE_ADDRESS KeyEqual equal_;
+	NO_UNIQUE_ADDRESS Allocator allocator_;
+	NO_UNIQUE_ADDRESS ContainerStatsRecorder stats_;
+
+	friend Iterator;
+	friend ConstIterator;
+};
+
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::FlatHashMap(std::initializer_list<std::pair<Key, Value>> vals, const Allocator& allocator)
+	: allocator_{ allocator }
+{
+	reserve(vals.size());
+	for (const auto& [key, value] : vals)
+	{
+		tryEmplace(key, value);
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::~FlatHashMap()
+{
+	destroyElements();
+	freeTable();
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::FlatHashMap(const FlatHashMap& other)
+	: hash_{ other.hash_ }, equal_{ other.equal_ }, allocator_{ alloc_traits::select_on_container_copy_construction(other.allocator_) }
+{
+	copyFromAnother(other);
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::FlatHashMap(const FlatHashMap& other, const Allocator& allocator)
+	: hash_{ other.hash_ }, equal_{ other.equal_ }, allocator_{ allocator }
+{
+	copyFromAnother(other);
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::FlatHashMap(FlatHashMap&& other) noexcept
+	: hash_{ std::move(other.hash_) }, equal_{ std::move(other.equal_) }, allocator_{ other.allocator_ }
+{
+	moveFromAnother(std::move(other));
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>& FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::operator=(const FlatHashMap& other)
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	// The table has to go back to the allocator that made it before that one is replaced.
+	destroyElements();
+	freeTable();
+
+	if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+	{
+		allocator_ = other.allocator_;
+	}
+
+	hash_ = other.hash_;
+	equal_ = other.equal_;
+	copyFromAnother(other);
+
+	return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>& FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::operator=(FlatHashMap&& other) noexcept(bNothrowMoveAssign)
+{
+	/**
+	 * 1. the allocator propagates - free ours, take the other's allocator and table
+	 * 2. the allocators are equal - take the table
+	 * 3. they differ - move the elements over
+	 */
+
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	destroyElements();
+	freeTable();
+
+	hash_ = std::move(other.hash_);
+	equal_ = std::move(other.equal_);
+
+	if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+	{
+		allocator_ = std::move(other.allocator_);
+		moveFromAnother(std::move(other));
+	}
+	else if (alloc_traits::is_always_equal::value || allocator_ == other.allocator_)
+	{
+		moveFromAnother(std::move(other));
+	}
+	else
+	{
+		moveElementsFrom(std::move(other));
+	}
+
+	return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::swap(FlatHashMap& other) noexcept
+{
+	using std::swap;
+
+	if constexpr (alloc_traits::propagate_on_container_swap::value)
+	{
+		swap(allocator_, other.allocator_);
+	}
+	else
+	{
+		assert(allocator_ == other.allocator_);
+	}
+
+	swap(hash_, other.hash_);
+	swap(equal_, other.equal_);
+	swap(ctrl_, other.ctrl_);
+	swap(keys_, other.keys_);
+	swap(values_, other.values_);
+	swap(size_, other.size_);
+	swap(capacity_, other.capacity_);
+	swap(growthLeft_, other.growthLeft_);
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename V>
+std::pair<typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::Iterator, bool> FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::insertOrAssign(K&& key, V&& value)
+{
+	auto result = emplaceKey(std::forward<K>(key), std::forward<V>(value));
+	if (!result.second)
+	{
+		values_[result.first.index()] = std::forward<V>(value);
+	}
+
+	return result;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::erase(Iterator where)
+{
+	assert(where.index() < capacity_ && isFull(ctrl_[where.index()]));
+	eraseAt(where.index());
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::clear()
+{
+	if (capacity_ == 0)
+	{
+		return;
+	}
+
+	destroyElements();
+
+	for (size_type i = 0; i < capacity_ + Group::Width; ++i)
+	{
+		ctrl_[i] = FlatHashControl::Empty;
+	}
+	ctrl_[capacity_] = FlatHashControl::Sentinel;
+
+	size_ = 0;
+	growthLeft_ = capacityToGrowth(capacity_);
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::reserve(size_type n)
+{
+	if (n <= size_ + growthLeft_)
+	{
+		return;
+	}
+
+	size_type capacity = MinCapacity;
+	while (capacityToGrowth(capacity) < n)
+	{
+		capacity = capacity * 2 + 1;
+	}
+
+	rehash(capacity);
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+uint64 FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::hashOf(const K& key) const
+{
+	// The finalizer of MurmurHash3: every input bit affects every output bit.
+	uint64 hash = static_cast<uint64>(hash_(key));
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+constexpr typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::size_type FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::capacityToGrowth(size_type capacity) noexcept
+{
+	// 7/8, except that the 7 slots of the smallest portable table need one empty slot to end probes.
+	return capacity == 7 ? 6 : capacity - capacity / 8;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::size_type FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::findIndex(const K& key, uint64 hash) const
+{
+	if (capacity_ == 0)
+	{
+		return capacity_;
+	}
+
+	size_type pos = h1(hash) & capacity_;
+	size_type step = 0;
+
+	while (true)
+	{
+		const Group group(ctrl_ + pos);
+		for (auto match = group.match(h2(hash)); match; match.clearLowest())
+		{
+			const size_type index = (pos + match.lowest()) & capacity_;
+			if (equal_(keys_[index], key))
+			{
+				return index;
+			}
+		}
+
+		if (group.matchEmpty())
+		{
+			return capacity_;
+		}
+
+		step += Group::Width;
+		pos = (pos + step) & capacity_;
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::size_type FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::findFirstNonFull(uint64 hash) const
+{
+	size_type pos = h1(hash) & capacity_;
+	size_type step = 0;
+
+	while (true)
+	{
+		const auto free = Group(ctrl_ + pos).matchEmptyOrDeleted();
+		if (free)
+		{
+			return (pos + free.lowest()) & capacity_;
+		}
+
+		step += Group::Width;
+		pos = (pos + step) & capacity_;
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::size_type FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::nextFull(size_type index) const
+{
+	while (index < capacity_ && !isFull(ctrl_[index]))
+	{
+		++index;
+	}
+
+	return index;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename... Args>
+std::pair<typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::Iterator, bool> FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::emplaceKey(K&& key, Args&&... args)
+{
+	/**
+	 * 1. the key is there - return it
+	 * 2. no growth left - build key and value first, since the rehash moves and destroys the
+	 *    elements and `key` or `args` may point at one (m.tryEmplace(k, m.find(old)->second)),
+	 *    then rehash and move them in
+	 * 3. build key and value in the first free slot of the probe sequence
+	 */
+
+	const uint64 hash = hashOf(key);
+	const size_type found = findIndex(key, hash);
+	if (found != capacity_)
+	{
+		return { Iterator(this, found), false };
+	}
+
+	if (growthLeft_ == 0)
+	{
+		Key builtKey(std::forward<K>(key));
+		Value builtValue(std::forward<Args>(args)...);
+		makeRoomForInsert();
+		return { Iterator(this, constructAt(hash, std::move(builtKey), std::move(builtValue))), true };
+	}
+
+	return { Iterator(this, constructAt(hash, std::forward<K>(key), std::forward<Args>(args)...)), true };
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K, typename... Args>
+typename FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::size_type FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::constructAt(uint64 hash, K&& key, Args&&... args)
+{
+	const size_type index = findFirstNonFull(hash);
+
+	key_alloc_type keyAllocator(allocator_);
+	value_alloc_type valueAllocator(allocator_);
+
+	key_traits::construct(keyAllocator, keys_ + index, std::forward<K>(key));
+	try
+	{
+		value_traits::construct(valueAllocator, values_ + index, std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		// The ctrl byte isn't set yet, so nothing else would ever destroy the key.
+		key_traits::destroy(keyAllocator, keys_ + index);
+		throw;
+	}
+
+	// Reusing a tombstone doesn't bring the table closer to having no empty slot.
+	if (ctrl_[index] == FlatHashControl::Empty)
+	{
+		--growthLeft_;
+	}
+	setCtrl(index, static_cast<int8>(h2(hash)));
+	++size_;
+
+	return index;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+template<typename K>
+bool FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::eraseKey(const K& key)
+{
+	const size_type index = findIndex(key);
+	if (index == capacity_)
+	{
+		return false;
+	}
+
+	eraseAt(index);
+	return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::eraseAt(size_type index)
+{
+	/**
+	 * The slot can go back to Empty only if no probe ever went past it. A probe passes a group
+	 * only when the group has no empty byte; if the empty bytes just before and just after the slot
+	 * are less than a group apart, no group load covering the slot was ever full.
+	 */
+
+	key_alloc_type keyAllocator(allocator_);
+	value_alloc_type valueAllocator(allocator_);
+	key_traits::destroy(keyAllocator, keys_ + index);
+	value_traits::destroy(valueAllocator, values_ + index);
+	--size_;
+
+	const size_type indexBefore = (index - Group::Width) & capacity_;
+	const auto emptyAfter = Group(ctrl_ + index).matchEmpty();
+	const auto emptyBefore = Group(ctrl_ + indexBefore).matchEmpty();
+
+	const bool bWasNeverFull = emptyBefore && emptyAfter && emptyAfter.trailingZeros() + emptyBefore.leadingZeros() < Group::Width;
+	if (bWasNeverFull)
+	{
+		setCtrl(index, FlatHashControl::Empty);
+		++growthLeft_;
+	}
+	else
+	{
+		setCtrl(index, FlatHashControl::Deleted);
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::setCtrl(size_type index, int8 value)
+{
+	ctrl_[index] = value;
+	ctrl_[((index - ClonedBytes) & capacity_) + (ClonedBytes & capacity_)] = value;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::makeRoomForInsert()
+{
+	/**
+	 * 1. no table yet - the smallest one
+	 * 2. at most half the growth used by live elements - the rest are tombstones, rehash in place
+	 * 3. otherwise - double
+	 */
+
+	if (capacity_ == 0)
+	{
+		rehash(MinCapacity);
+	}
+	else if (size_ <= capacityToGrowth(capacity_) / 2)
+	{
+		rehash(capacity_);
+	}
+	else
+	{
+		rehash(capacity_ * 2 + 1);
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::rehash(size_type newCapacity)
+{
+	int8* oldCtrl = ctrl_;
+	Key* oldKeys = keys_;
+	Value* oldValues = values_;
+	const size_type oldCapacity = capacity_;
+
+	allocateTable(newCapacity);
+	stats_.countReallocation(size_);
+
+	key_alloc_type keyAllocator(allocator_);
+	value_alloc_type valueAllocator(allocator_);
+
+	for (size_type i = 0; i < oldCapacity; ++i)
+	{
+		if (!isFull(oldCtrl[i]))
+		{
+			continue;
+		}
+
+		const uint64 hash = hashOf(oldKeys[i]);
+		const size_type index = findFirstNonFull(hash);
+		setCtrl(index, static_cast<int8>(h2(hash)));
+
+		key_traits::construct(keyAllocator, keys_ + index, std::move(oldKeys[i]));
+		value_traits::construct(valueAllocator, values_ + index, std::move(oldValues[i]));
+		key_traits::destroy(keyAllocator, oldKeys + i);
+		value_traits::destroy(valueAllocator, oldValues + i);
+	}
+
+	if (oldCtrl)
+	{
+		ctrl_alloc_type ctrlAllocator(allocator_);
+		ctrl_traits::deallocate(ctrlAllocator, oldCtrl, oldCapacity + Group::Width);
+		key_traits::deallocate(keyAllocator, oldKeys, oldCapacity);
+		value_traits::deallocate(valueAllocator, oldValues, oldCapacity);
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::allocateTable(size_type capacity)
+{
+	assert(capacity >= MinCapacity && ((capacity + 1) & capacity) == 0);
+
+	ctrl_alloc_type ctrlAllocator(allocator_);
+	key_alloc_type keyAllocator(allocator_);
+	value_alloc_type valueAllocator(allocator_);
+
+	/**
+	 * All three arrays are allocated before any member changes: if a later allocation throws, the
+	 * earlier ones are handed back and the map still owns its old table, untouched.
+	 */
+	struct PartialTable
+	{
+		ctrl_alloc_type& ctrlAllocator;
+		key_alloc_type& keyAllocator;
+		size_type capacity;
+
+		int8* ctrl{ nullptr };
+		Key* keys{ nullptr };
+
+		~PartialTable()
+		{
+			if (keys)
+			{
+				key_traits::deallocate(keyAllocator, keys, capacity);
+			}
+			if (ctrl)
+			{
+				ctrl_traits::deallocate(ctrlAllocator, ctrl, capacity + Group::Width);
+			}
+		}
+	};
+
+	PartialTable table{ ctrlAllocator, keyAllocator, capacity };
+	table.ctrl = ctrl_traits::allocate(ctrlAllocator, capacity + Group::Width);
+	table.keys = key_traits::allocate(keyAllocator, capacity);
+	Value* values = value_traits::allocate(valueAllocator, capacity);
+
+	for (size_type i = 0; i < capacity + Group::Width; ++i)
+	{
+		table.ctrl[i] = i == capacity ? FlatHashControl::Sentinel : FlatHashControl::Empty;
+	}
+
+	ctrl_ = std::exchange(table.ctrl, nullptr);
+	keys_ = std::exchange(table.keys, nullptr);
+	values_ = values;
+	capacity_ = capacity;
+
+	growthLeft_ = capacityToGrowth(capacity) - size_;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::destroyElements()
+{
+	if constexpr (std::is_trivially_destructible_v<Key> && std::is_trivially_destructible_v<Value>)
+	{
+		return;
+	}
+	else
+	{
+		destroyEach();
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::destroyEach()
+{
+	key_alloc_type keyAllocator(allocator_);
+	value_alloc_type valueAllocator(allocator_);
+	for (size_type i = 0; i < capacity_; ++i)
+	{
+		if (isFull(ctrl_[i]))
+		{
+			key_traits::destroy(keyAllocator, keys_ + i);
+			value_traits::destroy(valueAllocator, values_ + i);
+		}
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::freeTable()
+{
+	if (ctrl_)
+	{
+		ctrl_alloc_type ctrlAllocator(allocator_);
+		key_alloc_type keyAllocator(allocator_);
+		value_alloc_type valueAllocator(allocator_);
+
+		ctrl_traits::deallocate(ctrlAllocator, ctrl_, capacity_ + Group::Width);
+		key_traits::deallocate(keyAllocator, keys_, capacity_);
+		value_traits::deallocate(valueAllocator, values_, capacity_);
+	}
+
+	ctrl_ = nullptr;
+	keys_ = nullptr;
+	values_ = nullptr;
+	size_ = 0;
+	capacity_ = 0;
+	growthLeft_ = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::copyFromAnother(const FlatHashMap& other)
+{
+	reserve(other.size_);
+	for (size_type i = 0; i < other.capacity_; ++i)
+	{
+		if (isFull(other.ctrl_[i]))
+		{
+			tryEmplace(other.keys_[i], other.values_[i]);
+		}
+	}
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::moveFromAnother(FlatHashMap&& other)
+{
+	ctrl_ = other.ctrl_;
+	keys_ = other.keys_;
+	values_ = other.values_;
+	size_ = other.size_;
+	capacity_ = other.capacity_;
+	growthLeft_ = other.growthLeft_;
+
+	other.ctrl_ = nullptr;
+	other.keys_ = nullptr;
+	other.values_ = nullptr;
+	other.size_ = 0;
+	other.capacity_ = 0;
+	other.growthLeft_ = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+void FlatHashMap<Key, Value, Hash, KeyEqual, Allocator>::moveElementsFrom(FlatHashMap&& other)
+{
+	reserve(other.size_);
+	for (size_type i = 0; i < other.capacity_; ++i)
+	{
+		if (isFull(other.ctrl_[i]))
+		{
+			tryEmplace(std::move(other.keys_[i]), std::move(other.values_[i]));
+		}
+	}
+
+	other.destroyElements();
+	other.freeTable();
+}
+
+
+/** FlatHashMap drawing from a std::pmr::memory_resource. */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using PmrFlatHashMap = FlatHashMap<Key, Value, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>;
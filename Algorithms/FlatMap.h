@@ -0,0 +1,514 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "BranchlessSearch.h"
+#include "ContainerStats.h"
+#include "Vector.h"
+
+template<typename Map, bool bConst>
+class FlatMapIterator final
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using difference_type = std::ptrdiff_t;
+	using key_type = typename Map::key_type;
+	using mapped_type = std::conditional_t<bConst, const typename Map::mapped_type, typename Map::mapped_type>;
+	using value_type = std::pair<key_type, typename Map::mapped_type>;
+	using reference = std::pair<const key_type&, mapped_type&>;
+
+	using Iterator = FlatMapIterator;
+	using MyMap = std::conditional_t<bConst, const Map, Map>;
+
+	/** What operator-> points into: the pair of references lives in the proxy. */
+	struct ArrowProxy
+	{
+		reference pair;
+		const reference* operator->() const noexcept { return &pair; }
+	};
+
+public:
+	FlatMapIterator() = default;
+	FlatMapIterator(MyMap* owner, size_t index) : owner_{ owner }, index_{ index } {}
+
+	/** Iterators convert to const iterators. */
+	operator FlatMapIterator<Map, true>() const requires (!bConst) { return FlatMapIterator<Map, true>(owner_, index_); }
+
+	reference operator*() const { return reference(owner_->keys_[index_], owner_->values_[index_]); }
+	ArrowProxy operator->() const { return ArrowProxy{ **this }; }
+
+	Iterator& operator++() { ++index_; return *this; }
+	Iterator operator++(int) { Iterator old = *this; ++index_; return old; }
+	Iterator& operator--() { --index_; return *this; }
+	Iterator operator--(int) { Iterator old = *this; --index_; return old; }
+
+	constexpr bool operator==(const Iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+	/** The element's position in sorted order. */
+	[[nodiscard]] constexpr size_t index() const noexcept { return index_; }
+
+private:
+	MyMap* owner_{ nullptr };
+	size_t index_{ 0 };
+};
+
+
+/**
+ * Sorted map over two Vectors, one of keys and one of values, for lookup tables that are built
+ * once, or in batches, and then mostly read. A lookup is a branchless binary search
+ * (branchlessLowerBound) over the keys alone, so it pulls in only key cache lines and no values
+ * until the hit; iteration walks both arrays in order.
+ *
+ * Building from unsorted input sorts once; insertRange sorts the batch and merges it into the
+ * table in one pass, instead of shifting the tail for every element. A single tryEmplace or erase
+ * shifts the tail and is O(n), as with any sorted array, and invalidates every iterator.
+ *
+ * Of equal keys the first one wins: the element already in the map, then the earliest in a range.
+ *
+ * Exception safety: a throw while building the new element leaves the map as it was, but one
+ * while the arrays are being shifted or merged would split keys from their values, so then, as
+ * std::flat_map does, the map is cleared before the exception propagates.
+ * Like FlatHashMap, dereferencing an iterator gives std::pair<const Key&, Value&>. With a
+ * transparent Compare (is_transparent, e.g. std::less<>) lookups take any comparable type.
+ */
+template<
+	typename Key,
+	typename Value,
+	typename Compare = std::less<Key>,
+	typename Allocator = std::allocator<std::pair<const Key, Value>>
+>
+class FlatMap final
+{
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using key_compare = Compare;
+	using size_type = size_t;
+
+	using Iterator = FlatMapIterator<FlatMap, false>;
+	using ConstIterator = FlatMapIterator<FlatMap, true>;
+
+	using allocator_type = Allocator;
+	using alloc_traits = std::allocator_traits<Allocator>;
+
+	using KeyVector = Vector<Key, typename alloc_traits::template rebind_alloc<Key>>;
+	using ValueVector = Vector<Value, typename alloc_traits::template rebind_alloc<Value>>;
+
+	friend Iterator;
+	friend ConstIterator;
+
+	static constexpr bool bTransparent = requires { typename Compare::is_transparent; };
+
+public:
+	FlatMap() = default;
+	explicit FlatMap(const Compare& less, const Allocator& allocator = Allocator())
+		: keys_{ allocator }, values_{ allocator }, less_{ less } {}
+	explicit FlatMap(const Allocator& allocator) : keys_{ allocator }, values_{ allocator } {}
+	FlatMap(std::initializer_list<std::pair<Key, Value>> vals, const Compare& less = Compare(), const Allocator& allocator = Allocator());
+
+	/** Bulk build: takes (key, value) pairs in any order and sorts them once. */
+	template<std::input_iterator InputIt>
+	FlatMap(InputIt first, InputIt last, const Compare& less = Compare(), const Allocator& allocator = Allocator());
+
+	/**
+	 * Inserts `key` with a value built from `args` unless the key is there already; `args` are then
+	 * left alone. Returns the element and whether it was inserted.
+	 */
+	template<typename... Args>
+	std::pair<Iterator, bool> tryEmplace(const Key& key, Args&&... args) { return emplaceKey(key, std::forward<Args>(args)...); }
+
+	template<typename... Args>
+	std::pair<Iterator, bool> tryEmplace(Key&& key, Args&&... args) { return emplaceKey(std::move(key), std::forward<Args>(args)...); }
+
+	/** Inserts, or assigns `value` to the element that is already there. */
+	template<typename K, typename V>
+	std::pair<Iterator, bool> insertOrAssign(K&& key, V&& value);
+
+	/** The value of `key`, default-constructed first if the key is new. */
+	template<typename K>
+	Value& operator[](K&& key) { return values_[emplaceKey(std::forward<K>(key)).first.index()]; }
+
+	/** Sorts the (key, value) pairs in [first, last) and merges them in: O(n + m log m) for m pairs into n. */
+	template<std::input_iterator InputIt>
+	void insertRange(InputIt first, InputIt last);
+
+	[[nodiscard]] Iterator find(const Key& key) { return Iterator(this, findIndex(key)); }
+	[[nodiscard]] ConstIterator find(const Key& key) const { return ConstIterator(this, findIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] Iterator find(const K& key) { return Iterator(this, findIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] ConstIterator find(const K& key) const { return ConstIterator(this, findIndex(key)); }
+
+	[[nodiscard]] bool contains(const Key& key) const { return findIndex(key) != keys_.size(); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] bool contains(const K& key) const { return findIndex(key) != keys_.size(); }
+
+	/** The first element whose key is not less than `key`. */
+	[[nodiscard]] Iterator lowerBound(const Key& key) { return Iterator(this, lowerBoundIndex(key)); }
+	[[nodiscard]] ConstIterator lowerBound(const Key& key) const { return ConstIterator(this, lowerBoundIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] ConstIterator lowerBound(const K& key) const { return ConstIterator(this, lowerBoundIndex(key)); }
+
+	/** false when there was no such key. */
+	bool erase(const Key& key) { return eraseKey(key); }
+
+	template<typename K>
+		requires bTransparent
+	bool erase(const K& key) { return eraseKey(key); }
+
+	/** Returns the element that followed the erased one. */
+	Iterator erase(Iterator where);
+
+	void clear();
+	void reserve(size_type n);
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return keys_.size(); }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return keys_.isEmpty(); }
+
+	Iterator begin() { return Iterator(this, 0); }
+	Iterator end() { return Iterator(this, keys_.size()); }
+	ConstIterator begin() const { return ConstIterator(this, 0); }
+	ConstIterator end() const { return ConstIterator(this, keys_.size()); }
+	ConstIterator cbegin() const { return begin(); }
+	ConstIterator cend() const { return end(); }
+
+	/** The keys in order; values()[i] belongs to keys()[i]. */
+	[[nodiscard]] const KeyVector& keys() const noexcept { return keys_; }
+	[[nodiscard]] const ValueVector& values() const noexcept { return values_; }
+
+	allocator_type getAllocator() const { return allocator_type(keys_.getAllocator()); }
+
+	/** Both arrays' counters, plus the merges and shifts done on them. */
+	ContainerStats stats() const noexcept;
+	void resetStats() noexcept;
+
+private:
+	using Entry = std::pair<Key, Value>;
+	using EntryVector = Vector<Entry, typename alloc_traits::template rebind_alloc<Entry>>;
+
+	template<typename K>
+	size_type lowerBoundIndex(const K& key) const { return branchlessLowerBound(keys_.data(), keys_.size(), key, less_); }
+
+	/** The index of `key`, or size() if it's not there. */
+	template<typename K>
+	size_type findIndex(const K& key) const;
+
+	template<typename K, typename... Args>
+	std::pair<Iterator, bool> emplaceKey(K&& key, Args&&... args);
+
+	template<typename K>
+	bool eraseKey(const K& key);
+
+	void eraseAt(size_type index);
+
+	/** insertRange's merge of our elements and the sorted `incoming` into `keys`/`values`, which then replace ours. */
+	void mergeInto(KeyVector& keys, ValueVector& values, EntryVector& incoming);
+
+	/** Sorts `entries` by key and drops every entry whose key equals the one before it. */
+	void sortUnique(EntryVector& entries) const;
+
+	void pushBack(Key&& key, Value&& value);
+
+private:
+	KeyVector keys_;
+	ValueVector values_;
+	NO_UNIQUE_ADDRESS Compare less_;
+
+	/** What the arrays can't see: a merge swaps in new arrays, and inserts and erases shift by hand. */
+	NO_UNIQUE_ADDRESS ContainerStatsRecorder stats_;
+};
+
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+FlatMap<Key, Value, Compare, Allocator>::FlatMap(std::initializer_list<std::pair<Key, Value>> vals, const Compare& less, const Allocator& allocator)
+	: FlatMap(vals.begin(), vals.end(), less, allocator)
+{
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::input_iterator InputIt>
+FlatMap<Key, Value, Compare, Allocator>::FlatMap(InputIt first, InputIt last, const Compare& less, const Allocator& allocator)
+	: keys_{ allocator }, values_{ allocator }, less_{ less }
+{
+	insertRange(first, last);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K, typename V>
+std::pair<typename FlatMap<Key, Value, Compare, Allocator>::Iterator, bool> FlatMap<Key, Value, Compare, Allocator>::insertOrAssign(K&& key, V&& value)
+{
+	auto result = emplaceKey(std::forward<K>(key), std::forward<V>(value));
+	if (!result.second)
+	{
+		values_[result.first.index()] = std::forward<V>(value);
+	}
+
+	return result;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<std::input_iterator InputIt>
+void FlatMap<Key, Value, Compare, Allocator>::insertRange(InputIt first, InputIt last)
+{
+	/**
+	 * 1. sort the batch on its own
+	 * 2. all of it past our last key (or we're empty) - append
+	 * 3. otherwise merge both into fresh arrays in one pass, ours first on equal keys
+	 */
+
+	EntryVector incoming(typename EntryVector::allocator_type(keys_.getAllocator()));
+	incoming.pushBackRange(first, last);
+	sortUnique(incoming);
+
+	if (incoming.isEmpty())
+	{
+		return;
+	}
+
+	if (keys_.isEmpty() || less_(keys_.back(), incoming.front().first))
+	{
+		reserve(keys_.size() + incoming.size());
+		for (size_type i = 0; i < incoming.size(); ++i)
+		{
+			pushBack(std::move(incoming[i].first), std::move(incoming[i].second));
+		}
+		return;
+	}
+
+	KeyVector keys(keys_.getAllocator());
+	ValueVector values(values_.getAllocator());
+	keys.reserve(keys_.size() + incoming.size());
+	values.reserve(keys_.size() + incoming.size());
+
+	try
+	{
+		mergeInto(keys, values, incoming);
+	}
+	catch (...)
+	{
+		// Some of our elements may be moved-from already.
+		clear();
+		throw;
+	}
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::mergeInto(KeyVector& keys, ValueVector& values, EntryVector& incoming)
+{
+	size_type i = 0;
+	size_type j = 0;
+	while (i < keys_.size() && j < incoming.size())
+	{
+		if (less_(incoming[j].first, keys_[i]))
+		{
+			keys.pushBack(std::move(incoming[j].first));
+			values.pushBack(std::move(incoming[j].second));
+			++j;
+		}
+		else
+		{
+			if (!less_(keys_[i], incoming[j].first))
+			{
+				++j;
+			}
+			keys.pushBack(std::move(keys_[i]));
+			values.pushBack(std::move(values_[i]));
+			++i;
+		}
+	}
+	for (; i < keys_.size(); ++i)
+	{
+		keys.pushBack(std::move(keys_[i]));
+		values.pushBack(std::move(values_[i]));
+	}
+	for (; j < incoming.size(); ++j)
+	{
+		keys.pushBack(std::move(incoming[j].first));
+		values.pushBack(std::move(incoming[j].second));
+	}
+
+	// The existing elements moved once per array.
+	stats_.countReallocation(keys_.size());
+	stats_.countReallocation(values_.size());
+
+	keys_ = std::move(keys);
+	values_ = std::move(values);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+typename FlatMap<Key, Value, Compare, Allocator>::Iterator FlatMap<Key, Value, Compare, Allocator>::erase(Iterator where)
+{
+	assert(where.index() < keys_.size());
+	eraseAt(where.index());
+
+	return Iterator(this, where.index());
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::clear()
+{
+	keys_.reset();
+	values_.reset();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::reserve(size_type n)
+{
+	keys_.reserve(n);
+	values_.reserve(n);
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+ContainerStats FlatMap<Key, Value, Compare, Allocator>::stats() const noexcept
+{
+	ContainerStats stats = stats_.snapshot();
+	stats += keys_.stats();
+	stats += values_.stats();
+	return stats;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::resetStats() noexcept
+{
+	stats_.reset();
+	keys_.resetStats();
+	values_.resetStats();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+typename FlatMap<Key, Value, Compare, Allocator>::size_type FlatMap<Key, Value, Compare, Allocator>::findIndex(const K& key) const
+{
+	const size_type index = lowerBoundIndex(key);
+	return index < keys_.size() && !less_(key, keys_[index]) ? index : keys_.size();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K, typename... Args>
+std::pair<typename FlatMap<Key, Value, Compare, Allocator>::Iterator, bool> FlatMap<Key, Value, Compare, Allocator>::emplaceKey(K&& key, Args&&... args)
+{
+	const size_type index = lowerBoundIndex(key);
+	if (index < keys_.size() && !less_(key, keys_[index]))
+	{
+		return { Iterator(this, index), false };
+	}
+
+	// Append, then rotate it into place: both tails move up by one.
+	pushBack(Key(std::forward<K>(key)), Value(std::forward<Args>(args)...));
+	try
+	{
+		std::rotate(keys_.data() + index, keys_.data() + keys_.size() - 1, keys_.data() + keys_.size());
+		std::rotate(values_.data() + index, values_.data() + values_.size() - 1, values_.data() + values_.size());
+	}
+	catch (...)
+	{
+		// One array may be rotated and the other not, which pairs keys with the wrong values.
+		clear();
+		throw;
+	}
+	stats_.countRelocations(2 * (keys_.size() - 1 - index));
+
+	return { Iterator(this, index), true };
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+template<typename K>
+bool FlatMap<Key, Value, Compare, Allocator>::eraseKey(const K& key)
+{
+	const size_type index = findIndex(key);
+	if (index == keys_.size())
+	{
+		return false;
+	}
+
+	eraseAt(index);
+	return true;
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::eraseAt(size_type index)
+{
+	try
+	{
+		std::move(keys_.data() + index + 1, keys_.data() + keys_.size(), keys_.data() + index);
+		std::move(values_.data() + index + 1, values_.data() + values_.size(), values_.data() + index);
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+	stats_.countRelocations(2 * (keys_.size() - 1 - index));
+	keys_.popBack();
+	values_.popBack();
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::sortUnique(EntryVector& entries) const
+{
+	Entry* first = entries.data();
+	Entry* last = first + entries.size();
+
+	std::stable_sort(first, last, [this](const Entry& a, const Entry& b) { return less_(a.first, b.first); });
+	Entry* unique = std::unique(first, last, [this](const Entry& a, const Entry& b) { return !less_(a.first, b.first); });
+
+	for (size_type extra = static_cast<size_type>(last - unique); extra > 0; --extra)
+	{
+		entries.popBack();
+	}
+}
+
+template<typename Key, typename Value, typename Compare, typename Allocator>
+void FlatMap<Key, Value, Compare, Allocator>::pushBack(Key&& key, Value&& value)
+{
+	// Room in both arrays first, doubling like Vector does, so that past here only the moves can throw.
+	if (keys_.size() == keys_.capacity() || values_.size() == values_.capacity())
+	{
+		reserve(std::max(keys_.size() + 1, keys_.capacity() * 2));
+	}
+
+	keys_.pushBack(std::move(key));
+
+	// Takes the key back off if the value's move throws, so the arrays stay the same length.
+	struct PendingKey
+	{
+		KeyVector* keys;
+
+		~PendingKey()
+		{
+			if (keys)
+			{
+				keys->popBack();
+			}
+		}
+	};
+
+	PendingKey pending{ &keys_ };
+	values_.pushBack(std::move(value));
+	pending.keys = nullptr;
+}
+
+
+/** FlatMap drawing from a std::pmr::memory_resource. */
+template<typename Key, typename Value, typename Compare = std::less<Key>>
+using PmrFlatMap = FlatMap<Key, Value, Compare, std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>;
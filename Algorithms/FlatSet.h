@@ -0,0 +1,366 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "BranchlessSearch.h"
+#include "ContainerStats.h"
+#include "Vector.h"
+
+template<typename Set>
+class FlatSetIterator final
+{
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using difference_type = std::ptrdiff_t;
+	using value_type = typename Set::key_type;
+	using reference = const value_type&;
+	using pointer = const value_type*;
+
+	using Iterator = FlatSetIterator;
+
+public:
+	FlatSetIterator() = default;
+	FlatSetIterator(const Set* owner, size_t index) : owner_{ owner }, index_{ index } {}
+
+	reference operator*() const { return owner_->keys_[index_]; }
+	pointer operator->() const { return &owner_->keys_[index_]; }
+
+	Iterator& operator++() { ++index_; return *this; }
+	Iterator operator++(int) { Iterator old = *this; ++index_; return old; }
+	Iterator& operator--() { --index_; return *this; }
+	Iterator operator--(int) { Iterator old = *this; --index_; return old; }
+
+	constexpr bool operator==(const Iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+	/** The key's position in sorted order. */
+	[[nodiscard]] constexpr size_t index() const noexcept { return index_; }
+
+private:
+	const Set* owner_{ nullptr };
+	size_t index_{ 0 };
+};
+
+
+/**
+ * Sorted set in one Vector: for lookup tables that are built once, or in batches, and then mostly
+ * read. The keys sit next to each other in order, so a lookup is a branchless binary search
+ * (branchlessLowerBound) over contiguous memory and iteration is a linear scan.
+ *
+ * Building from unsorted input sorts once; insertRange sorts the batch and merges it into the
+ * keys in one pass, instead of shifting the tail for every key. insert() and erase() of a single
+ * key shift the tail and are O(n), as with any sorted array.
+ *
+ * Of equal keys the first one wins: the one already in the set, then the earliest in a range.
+ * With a transparent Compare (is_transparent, e.g. std::less<>) lookups take any comparable type.
+ *
+ * Exception safety: a throw while building the new key leaves the set as it was, but one while
+ * the keys are being shifted or merged would leave them out of order, so then, as std::flat_set
+ * does, the set is cleared before the exception propagates.
+ */
+template<
+	typename Key,
+	typename Compare = std::less<Key>,
+	typename Allocator = std::allocator<Key>
+>
+class FlatSet final
+{
+public:
+	using key_type = Key;
+	using key_compare = Compare;
+	using size_type = size_t;
+
+	using KeyVector = Vector<Key, Allocator>;
+	using ConstIterator = FlatSetIterator<FlatSet>;
+
+	friend ConstIterator;
+
+	static constexpr bool bTransparent = requires { typename Compare::is_transparent; };
+
+public:
+	FlatSet() = default;
+	explicit FlatSet(const Compare& less, const Allocator& allocator = Allocator()) : keys_{ allocator }, less_{ less } {}
+	explicit FlatSet(const Allocator& allocator) : keys_{ allocator } {}
+	FlatSet(std::initializer_list<Key> vals, const Compare& less = Compare(), const Allocator& allocator = Allocator());
+
+	/** Bulk build: takes the range in any order and sorts it once. */
+	template<std::input_iterator InputIt>
+	FlatSet(InputIt first, InputIt last, const Compare& less = Compare(), const Allocator& allocator = Allocator());
+
+	std::pair<ConstIterator, bool> insert(const Key& key) { return insertKey(key); }
+	std::pair<ConstIterator, bool> insert(Key&& key) { return insertKey(std::move(key)); }
+
+	/** Sorts [first, last) and merges it in: O(n + m log m) for m keys into n. */
+	template<std::input_iterator InputIt>
+	void insertRange(InputIt first, InputIt last);
+
+	[[nodiscard]] ConstIterator find(const Key& key) const { return iteratorAt(findIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] ConstIterator find(const K& key) const { return iteratorAt(findIndex(key)); }
+
+	[[nodiscard]] bool contains(const Key& key) const { return findIndex(key) != keys_.size(); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] bool contains(const K& key) const { return findIndex(key) != keys_.size(); }
+
+	/** The first key not less than `key`. */
+	[[nodiscard]] ConstIterator lowerBound(const Key& key) const { return iteratorAt(lowerBoundIndex(key)); }
+
+	template<typename K>
+		requires bTransparent
+	[[nodiscard]] ConstIterator lowerBound(const K& key) const { return iteratorAt(lowerBoundIndex(key)); }
+
+	/** false when there was no such key. */
+	bool erase(const Key& key) { return eraseKey(key); }
+
+	template<typename K>
+		requires bTransparent
+	bool erase(const K& key) { return eraseKey(key); }
+
+	void clear() { keys_.reset(); }
+	void reserve(size_type n) { keys_.reserve(n); }
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return keys_.size(); }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return keys_.isEmpty(); }
+
+	ConstIterator begin() const { return ConstIterator(this, 0); }
+	ConstIterator end() const { return ConstIterator(this, keys_.size()); }
+
+	/** The keys in order, e.g. to hand the whole table to a SIMD scan. */
+	[[nodiscard]] const KeyVector& keys() const noexcept { return keys_; }
+
+	/** The array's counters, plus the merges and shifts done on it. */
+	ContainerStats stats() const noexcept;
+	void resetStats() noexcept;
+
+private:
+	template<typename K>
+	size_type lowerBoundIndex(const K& key) const { return branchlessLowerBound(keys_.data(), keys_.size(), key, less_); }
+
+	/** The index of `key`, or size() if it's not there. */
+	template<typename K>
+	size_type findIndex(const K& key) const;
+
+	ConstIterator iteratorAt(size_type index) const { return ConstIterator(this, index); }
+
+	template<typename K>
+	std::pair<ConstIterator, bool> insertKey(K&& key);
+
+	template<typename K>
+	bool eraseKey(const K& key);
+
+	/** insertRange's merge of our keys and the sorted `incoming` into `merged`, which then replaces ours. */
+	void mergeInto(KeyVector& merged, KeyVector& incoming);
+
+	/** Sorts `keys` and drops every key equal to the one before it. */
+	void sortUnique(KeyVector& keys) const;
+
+private:
+	KeyVector keys_;
+	NO_UNIQUE_ADDRESS Compare less_;
+
+	/** What the array can't see: a merge swaps in a new array, and inserts and erases shift by hand. */
+	NO_UNIQUE_ADDRESS ContainerStatsRecorder stats_;
+};
+
+
+template<typename Key, typename Compare, typename Allocator>
+FlatSet<Key, Compare, Allocator>::FlatSet(std::initializer_list<Key> vals, const Compare& less, const Allocator& allocator)
+	: FlatSet(vals.begin(), vals.end(), less, allocator)
+{
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<std::input_iterator InputIt>
+FlatSet<Key, Compare, Allocator>::FlatSet(InputIt first, InputIt last, const Compare& less, const Allocator& allocator)
+	: keys_{ allocator }, less_{ less }
+{
+	keys_.pushBackRange(first, last);
+	sortUnique(keys_);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<std::input_iterator InputIt>
+void FlatSet<Key, Compare, Allocator>::insertRange(InputIt first, InputIt last)
+{
+	/**
+	 * 1. sort the batch on its own
+	 * 2. all of it past our last key (or we're empty) - append
+	 * 3. otherwise merge both into fresh storage in one pass, ours first on equal keys
+	 */
+
+	KeyVector incoming(keys_.getAllocator());
+	incoming.pushBackRange(first, last);
+	sortUnique(incoming);
+
+	if (incoming.isEmpty())
+	{
+		return;
+	}
+
+	if (keys_.isEmpty() || less_(keys_.back(), incoming.front()))
+	{
+		keys_.reserve(keys_.size() + incoming.size());
+		for (size_type i = 0; i < incoming.size(); ++i)
+		{
+			keys_.pushBack(std::move(incoming[i]));
+		}
+		return;
+	}
+
+	KeyVector merged(keys_.getAllocator());
+	merged.reserve(keys_.size() + incoming.size());
+
+	try
+	{
+		mergeInto(merged, incoming);
+	}
+	catch (...)
+	{
+		// Some of our keys may be moved-from already.
+		clear();
+		throw;
+	}
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void FlatSet<Key, Compare, Allocator>::mergeInto(KeyVector& merged, KeyVector& incoming)
+{
+	size_type i = 0;
+	size_type j = 0;
+	while (i < keys_.size() && j < incoming.size())
+	{
+		if (less_(incoming[j], keys_[i]))
+		{
+			merged.pushBack(std::move(incoming[j++]));
+		}
+		else
+		{
+			if (!less_(keys_[i], incoming[j]))
+			{
+				++j;
+			}
+			merged.pushBack(std::move(keys_[i++]));
+		}
+	}
+	for (; i < keys_.size(); ++i)
+	{
+		merged.pushBack(std::move(keys_[i]));
+	}
+	for (; j < incoming.size(); ++j)
+	{
+		merged.pushBack(std::move(incoming[j]));
+	}
+
+	// The existing keys moved once.
+	stats_.countReallocation(keys_.size());
+	keys_ = std::move(merged);
+}
+
+template<typename Key, typename Compare, typename Allocator>
+ContainerStats FlatSet<Key, Compare, Allocator>::stats() const noexcept
+{
+	ContainerStats stats = stats_.snapshot();
+	stats += keys_.stats();
+	return stats;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void FlatSet<Key, Compare, Allocator>::resetStats() noexcept
+{
+	stats_.reset();
+	keys_.resetStats();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K>
+typename FlatSet<Key, Compare, Allocator>::size_type FlatSet<Key, Compare, Allocator>::findIndex(const K& key) const
+{
+	const size_type index = lowerBoundIndex(key);
+	return index < keys_.size() && !less_(key, keys_[index]) ? index : keys_.size();
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K>
+std::pair<typename FlatSet<Key, Compare, Allocator>::ConstIterator, bool> FlatSet<Key, Compare, Allocator>::insertKey(K&& key)
+{
+	const size_type index = lowerBoundIndex(key);
+	if (index < keys_.size() && !less_(key, keys_[index]))
+	{
+		return { iteratorAt(index), false };
+	}
+
+	// Append, then rotate it into place: the tail moves up by one.
+	keys_.pushBack(std::forward<K>(key));
+	try
+	{
+		std::rotate(keys_.data() + index, keys_.data() + keys_.size() - 1, keys_.data() + keys_.size());
+	}
+	catch (...)
+	{
+		// A half-done rotate leaves the keys out of order.
+		clear();
+		throw;
+	}
+	stats_.countRelocations(keys_.size() - 1 - index);
+
+	return { iteratorAt(index), true };
+}
+
+template<typename Key, typename Compare, typename Allocator>
+template<typename K>
+bool FlatSet<Key, Compare, Allocator>::eraseKey(const K& key)
+{
+	const size_type index = findIndex(key);
+	if (index == keys_.size())
+	{
+		return false;
+	}
+
+	try
+	{
+		std::move(keys_.data() + index + 1, keys_.data() + keys_.size(), keys_.data() + index);
+	}
+	catch (...)
+	{
+		clear();
+		throw;
+	}
+	stats_.countRelocations(keys_.size() - 1 - index);
+	keys_.popBack();
+
+	return true;
+}
+
+template<typename Key, typename Compare, typename Allocator>
+void FlatSet<Key, Compare, Allocator>::sortUnique(KeyVector& keys) const
+{
+	Key* first = keys.data();
+	Key* last = first + keys.size();
+
+	std::stable_sort(first, last, less_);
+	Key* unique = std::unique(first, last, [this](const Key& a, const Key& b) { return !less_(a, b); });
+
+	for (size_type extra = static_cast<size_type>(last - unique); extra > 0; --extra)
+	{
+		keys.popBack();
+	}
+}
+
+
+/** FlatSet drawing from a std::pmr::memory_resource. */
+template<typename Key, typename Compare = std::less<Key>>
+using PmrFlatSet = FlatSet<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
@@ -0,0 +1,353 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "PriorityQueue.h"
+#include "Types.h"
+#include "Vector.h"
+
+/**
+ * d-ary heap whose elements can be found again after they were pushed: push() returns a handle
+ * that stays valid until the element leaves the queue, and decreaseKey/update/erase take it
+ * in O(log n). This is what Dijkstra or a timer wheel with cancellation needs.
+ *
+ * Every heap entry carries its handle and `positions_[handle]` says where the entry is now,
+ * so each move inside the heap also updates one position. Handles of popped or erased elements
+ * are recycled.
+ */
+template<
+	typename T,
+	typename Compare = std::less<T>,
+	size_t Arity = 4
+>
+class IndexedPriorityQueue final
+{
+public:
+	using size_type = size_t;
+	using Handle = uint32;
+
+	static constexpr Handle InvalidHandle = std::numeric_limits<Handle>::max();
+
+public:
+	IndexedPriorityQueue() = default;
+	explicit IndexedPriorityQueue(const Compare& compare) : compare_{ compare } {}
+
+	Handle push(const T& val);
+	Handle push(T&& val);
+
+	void pop();
+
+	[[nodiscard]] const T& top() const;
+	[[nodiscard]] Handle topHandle() const;
+
+	/** True while the element is in the queue. */
+	[[nodiscard]] bool contains(Handle handle) const noexcept;
+
+	[[nodiscard]] const T& value(Handle handle) const;
+
+	/**
+	 * Moves the element towards the top. The new value must not compare below the old one,
+	 * so with std::greater (a min-heap) this is the classic decrease-key.
+	 */
+	void decreaseKey(Handle handle, const T& val);
+
+	/** Replaces the value, which may move either way. */
+	void update(Handle handle, const T& val);
+
+	void erase(Handle handle);
+
+	void clear();
+	void reserve(size_type n);
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return heap_.size(); }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return heap_.isEmpty(); }
+
+private:
+	using Layout = DaryHeapLayout<Arity>;
+
+	struct Entry
+	{
+		T value;
+		Handle handle;
+	};
+
+	static constexpr size_type NotInHeap = std::numeric_limits<size_type>::max();
+
+	template<typename ValType>
+	Handle insert(ValType&& val);
+
+	Handle acquireHandle();
+
+	/** Moves the entry into slot `i` and records where it went. */
+	void place(size_type i, Entry&& entry);
+
+	/** Removes the entry at heap position `i`, keeping the heap valid. */
+	void removeAt(size_type i);
+
+	void siftUp(size_type i);
+	void siftDown(size_type i);
+
+private:
+	Vector<Entry> heap_;
+
+	// Indexed by handle, NotInHeap for handles that are free.
+	Vector<size_type> positions_;
+	Vector<Handle> freeHandles_;
+
+	Compare compare_{};
+};
+
+
+template<typename T, typename Compare, size_t Arity>
+typename IndexedPriorityQueue<T, Compare, Arity>::Handle IndexedPriorityQueue<T, Compare, Arity>::push(const T& val)
+{
+	return insert(val);
+}
+
+template<typename T, typename Compare, size_t Arity>
+typename IndexedPriorityQueue<T, Compare, Arity>::Handle IndexedPriorityQueue<T, Compare, Arity>::push(T&& val)
+{
+	return insert(std::move(val));
+}
+
+template<typename T, typename Compare, size_t Arity>
+template<typename ValType>
+typename IndexedPriorityQueue<T, Compare, Arity>::Handle IndexedPriorityQueue<T, Compare, Arity>::insert(ValType&& val)
+{
+	// Build the entry before taking a handle, so a throwing copy or move of `val` takes nothing.
+	Entry entry{ std::forward<ValType>(val), InvalidHandle };
+
+	const bool bRecycled = !freeHandles_.isEmpty();
+	const Handle handle = acquireHandle();
+	entry.handle = handle;
+
+	try
+	{
+		heap_.pushBack(std::move(entry));
+	}
+	catch (...)
+	{
+		// Give the handle back; neither branch allocates, the free list still has the popped slot.
+		if (bRecycled)
+		{
+			freeHandles_.pushBack(handle);
+		}
+		else
+		{
+			positions_.popBack();
+		}
+		throw;
+	}
+
+	positions_[handle] = heap_.size() - 1;
+	siftUp(heap_.size() - 1);
+
+	return handle;
+}
+
+template<typename T, typename Compare, size_t Arity>
+typename IndexedPriorityQueue<T, Compare, Arity>::Handle IndexedPriorityQueue<T, Compare, Arity>::acquireHandle()
+{
+	if (!freeHandles_.isEmpty())
+	{
+		const Handle handle = freeHandles_.back();
+		freeHandles_.popBack();
+		return handle;
+	}
+
+	assert(positions_.size() < InvalidHandle);
+	positions_.pushBack(NotInHeap);
+
+	return static_cast<Handle>(positions_.size() - 1);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::pop()
+{
+	assert(!isEmpty());
+	removeAt(0);
+}
+
+template<typename T, typename Compare, size_t Arity>
+const T& IndexedPriorityQueue<T, Compare, Arity>::top() const
+{
+	assert(!isEmpty());
+	return heap_.front().value;
+}
+
+template<typename T, typename Compare, size_t Arity>
+typename IndexedPriorityQueue<T, Compare, Arity>::Handle IndexedPriorityQueue<T, Compare, Arity>::topHandle() const
+{
+	assert(!isEmpty());
+	return heap_.front().handle;
+}
+
+template<typename T, typename Compare, size_t Arity>
+bool IndexedPriorityQueue<T, Compare, Arity>::contains(Handle handle) const noexcept
+{
+	return handle < positions_.size() && positions_[handle] != NotInHeap;
+}
+
+template<typename T, typename Compare, size_t Arity>
+const T& IndexedPriorityQueue<T, Compare, Arity>::value(Handle handle) const
+{
+	assert(contains(handle));
+	return heap_[positions_[handle]].value;
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::decreaseKey(Handle handle, const T& val)
+{
+	assert(contains(handle));
+
+	const size_type i = positions_[handle];
+	assert(!compare_(val, heap_[i].value));
+
+	heap_[i].value = val;
+	siftUp(i);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::update(Handle handle, const T& val)
+{
+	assert(contains(handle));
+
+	const size_type i = positions_[handle];
+	const bool bTowardsTop = compare_(heap_[i].value, val);
+
+	heap_[i].value = val;
+
+	if (bTowardsTop)
+	{
+		siftUp(i);
+	}
+	else
+	{
+		siftDown(i);
+	}
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::erase(Handle handle)
+{
+	assert(contains(handle));
+	removeAt(positions_[handle]);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::removeAt(size_type i)
+{
+	/**
+	 * 1. the last entry - just drop it
+	 * 2. otherwise the last entry fills the gap; it came from another subtree,
+	 *    so it may have to go up as well as down
+	 */
+
+	const Handle removed = heap_[i].handle;
+	const size_type last = heap_.size() - 1;
+
+	if (i != last)
+	{
+		place(i, std::move(heap_.back()));
+	}
+	heap_.popBack();
+
+	positions_[removed] = NotInHeap;
+	freeHandles_.pushBack(removed);
+
+	if (i < heap_.size())
+	{
+		if (i > 0 && compare_(heap_[Layout::parent(i)].value, heap_[i].value))
+		{
+			siftUp(i);
+		}
+		else
+		{
+			siftDown(i);
+		}
+	}
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::clear()
+{
+	while (!heap_.isEmpty())
+	{
+		positions_[heap_.back().handle] = NotInHeap;
+		freeHandles_.pushBack(heap_.back().handle);
+		heap_.popBack();
+	}
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::reserve(size_type n)
+{
+	heap_.reserve(n);
+	positions_.reserve(n);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::place(size_type i, Entry&& entry)
+{
+	positions_[entry.handle] = i;
+	heap_[i] = std::move(entry);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::siftUp(size_type i)
+{
+	Entry entry = std::move(heap_[i]);
+
+	while (i > 0)
+	{
+		const size_type parent = Layout::parent(i);
+		if (!compare_(heap_[parent].value, entry.value))
+		{
+			break;
+		}
+
+		place(i, std::move(heap_[parent]));
+		i = parent;
+	}
+
+	place(i, std::move(entry));
+}
+
+template<typename T, typename Compare, size_t Arity>
+void IndexedPriorityQueue<T, Compare, Arity>::siftDown(size_type i)
+{
+	const size_type count = heap_.size();
+	Entry entry = std::move(heap_[i]);
+
+	for (;;)
+	{
+		const size_type first = Layout::firstChild(i);
+		if (first >= count)
+		{
+			break;
+		}
+
+		const size_type last = std::min(first + Arity, count);
+		size_type best = first;
+		for (size_type child = first + 1; child < last; ++child)
+		{
+			if (compare_(heap_[best].value, heap_[child].value))
+			{
+				best = child;
+			}
+		}
+
+		if (!compare_(entry.value, heap_[best].value))
+		{
+			break;
+		}
+
+		place(i, std::move(heap_[best]));
+		i = best;
+	}
+
+	place(i, std::move(entry));
+}
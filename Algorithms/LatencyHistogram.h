@@ -0,0 +1,218 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#include "Types.h"
+#include "Vector.h"
+
+/**
+ * High-dynamic-range histogram for latencies (HdrHistogram's bucket layout): every power of two
+ * is split into 2^SubBucketBits equal sub-buckets, so any recorded value is kept to within
+ * 1 / 2^SubBucketBits of itself (0.8% with the default 7 bits) over the whole uint64 range.
+ * A 40 ns push and a 4 ms reallocation land in the same histogram without either losing detail.
+ *
+ * record() is a bit_width, a shift and one increment; there is no allocation after construction.
+ * The unit is whatever the caller records: nanoseconds, ticks...
+ *
+ * Not thread-safe. Give every thread its own histogram and merge() them when the threads are done;
+ * merging is exact because all histograms with the same SubBucketBits share one bucket layout.
+ */
+template<uint32 SubBucketBits = 7>
+class LatencyHistogram final
+{
+	static_assert(SubBucketBits >= 1 && SubBucketBits <= 16, "SubBucketBits is the precision, 1..16 bits.");
+
+public:
+	using size_type = size_t;
+
+	static constexpr uint64 SubBucketCount = uint64{ 1 } << SubBucketBits;
+
+	/** Values below 2^SubBucketBits get a bucket each; every power of two above adds SubBucketCount. */
+	static constexpr size_type BucketCount = (65 - SubBucketBits) << SubBucketBits;
+
+public:
+	LatencyHistogram();
+
+	void record(uint64 value) { recordN(value, 1); }
+	void recordN(uint64 value, uint64 count);
+
+	/** Adds every value of `other`, as if they had been recorded here. */
+	void merge(const LatencyHistogram& other);
+
+	void reset();
+
+	/**
+	 * The smallest recorded value that `percentile` percent of all values are at or below,
+	 * reported as the top of its bucket (but never above max()). 0 on an empty histogram.
+	 */
+	[[nodiscard]] uint64 valueAtPercentile(double percentile) const;
+
+	[[nodiscard]] constexpr uint64 count() const noexcept { return count_; }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return count_ == 0; }
+
+	[[nodiscard]] constexpr uint64 min() const noexcept { return count_ == 0 ? 0 : min_; }
+	[[nodiscard]] constexpr uint64 max() const noexcept { return max_; }
+
+	/** From the bucket midpoints, so within the same precision as the percentiles. */
+	[[nodiscard]] double mean() const;
+
+	/** Bucket layout, public so tests and callers printing raw buckets can use it. */
+	[[nodiscard]] static constexpr size_type bucketOf(uint64 value) noexcept;
+	[[nodiscard]] static constexpr uint64 bucketLowest(size_type bucket) noexcept;
+	[[nodiscard]] static constexpr uint64 bucketHighest(size_type bucket) noexcept;
+
+private:
+	Vector<uint64> counts_;
+
+	uint64 count_{ 0 };
+	uint64 min_{ std::numeric_limits<uint64>::max() };
+	uint64 max_{ 0 };
+};
+
+
+template<uint32 SubBucketBits>
+LatencyHistogram<SubBucketBits>::LatencyHistogram()
+{
+	counts_.reserve(BucketCount);
+	for (size_type i = 0; i < BucketCount; ++i)
+	{
+		counts_.pushBack(0);
+	}
+}
+
+template<uint32 SubBucketBits>
+void LatencyHistogram<SubBucketBits>::recordN(uint64 value, uint64 count)
+{
+	counts_[bucketOf(value)] += count;
+	count_ += count;
+
+	min_ = std::min(min_, value);
+	max_ = std::max(max_, value);
+}
+
+template<uint32 SubBucketBits>
+void LatencyHistogram<SubBucketBits>::merge(const LatencyHistogram& other)
+{
+	if (other.isEmpty())
+	{
+		return;
+	}
+
+	for (size_type i = 0; i < BucketCount; ++i)
+	{
+		counts_[i] += other.counts_[i];
+	}
+	count_ += other.count_;
+
+	min_ = std::min(min_, other.min_);
+	max_ = std::max(max_, other.max_);
+}
+
+template<uint32 SubBucketBits>
+void LatencyHistogram<SubBucketBits>::reset()
+{
+	for (size_type i = 0; i < BucketCount; ++i)
+	{
+		counts_[i] = 0;
+	}
+
+	count_ = 0;
+	min_ = std::numeric_limits<uint64>::max();
+	max_ = 0;
+}
+
+template<uint32 SubBucketBits>
+uint64 LatencyHistogram<SubBucketBits>::valueAtPercentile(double percentile) const
+{
+	if (isEmpty())
+	{
+		return 0;
+	}
+
+	percentile = std::clamp(percentile, 0.0, 100.0);
+
+	// Rank of the value asked for, rounded rather than ceil'd so 99.9% of 1000 is 999 and not 1000.
+	const uint64 rank = std::max<uint64>(1, static_cast<uint64>(std::llround(percentile / 100.0 * static_cast<double>(count_))));
+
+	uint64 seen = 0;
+	for (size_type i = 0; i < BucketCount; ++i)
+	{
+		seen += counts_[i];
+		if (seen >= rank)
+		{
+			return std::min(bucketHighest(i), max_);
+		}
+	}
+
+	return max_;
+}
+
+template<uint32 SubBucketBits>
+double LatencyHistogram<SubBucketBits>::mean() const
+{
+	if (isEmpty())
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (size_type i = 0; i < BucketCount; ++i)
+	{
+		if (counts_[i] != 0)
+		{
+			const double midpoint = (static_cast<double>(bucketLowest(i)) + static_cast<double>(bucketHighest(i))) / 2.0;
+			total += midpoint * static_cast<double>(counts_[i]);
+		}
+	}
+
+	return total / static_cast<double>(count_);
+}
+
+template<uint32 SubBucketBits>
+constexpr typename LatencyHistogram<SubBucketBits>::size_type LatencyHistogram<SubBucketBits>::bucketOf(uint64 value) noexcept
+{
+	/**
+	 * 1. below 2^SubBucketBits - exact, the value is the bucket
+	 * 2. otherwise keep the top SubBucketBits + 1 bits; `shift` says how many low bits were dropped,
+	 *    and each extra shift is one more run of SubBucketCount buckets
+	 */
+
+	if (value < SubBucketCount)
+	{
+		return static_cast<size_type>(value);
+	}
+
+	const uint32 shift = static_cast<uint32>(std::bit_width(value)) - 1 - SubBucketBits;
+	const uint64 top = value >> shift;
+
+	return static_cast<size_type>((shift + 1) * SubBucketCount + (top - SubBucketCount));
+}
+
+template<uint32 SubBucketBits>
+constexpr uint64 LatencyHistogram<SubBucketBits>::bucketLowest(size_type bucket) noexcept
+{
+	if (bucket < SubBucketCount)
+	{
+		return bucket;
+	}
+
+	const uint64 shift = bucket / SubBucketCount - 1;
+	const uint64 top = SubBucketCount + bucket % SubBucketCount;
+
+	return top << shift;
+}
+
+template<uint32 SubBucketBits>
+constexpr uint64 LatencyHistogram<SubBucketBits>::bucketHighest(size_type bucket) noexcept
+{
+	if (bucket < SubBucketCount)
+	{
+		return bucket;
+	}
+
+	const uint64 shift = bucket / SubBucketCount - 1;
+
+	return bucketLowest(bucket) + ((uint64{ 1 } << shift) - 1);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+
+#include "ArenaAllocator.h"
+
+/**
+ * Monotonic buffer: hands out memory from a buffer the caller provides (typically an array on
+ * the stack) and only goes to the heap once that is used up, each new chunk twice the size of the
+ * last. Nothing is ever freed on its own; release() drops the heap chunks and starts over at the
+ * beginning of the initial buffer, with the next heap chunk back at the first chunk's size.
+ *
+ * The heap chunks are a doubling Arena's blocks; unlike Arena there are no marks to rewind to.
+ * It is meant for a short-lived batch of containers that all die together: a request handler
+ * fills them, and the buffer goes with it.
+ */
+class MonotonicBuffer final
+{
+public:
+	static constexpr size_t DefaultChunkSize = 1024;
+
+public:
+	/** Starts with an empty buffer, the first chunk comes from the heap. */
+	explicit MonotonicBuffer(size_t firstChunkSize = DefaultChunkSize);
+
+	/** `buffer` is used first and has to outlive this object. */
+	MonotonicBuffer(void* buffer, size_t size);
+
+	MonotonicBuffer(const MonotonicBuffer&) = delete;
+	MonotonicBuffer& operator=(const MonotonicBuffer&) = delete;
+
+	[[nodiscard]] void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+	void release() noexcept;
+
+	/** How many chunks came from the heap so far. */
+	[[nodiscard]] size_t heapChunkCount() const noexcept { return heap_.blockCount(); }
+
+private:
+	std::byte* initialBuffer_{ nullptr };
+	size_t initialSize_{ 0 };
+
+	/** Inside the initial buffer; null once it's used up, when everything comes from heap_. */
+	std::byte* cursor_{ nullptr };
+	std::byte* end_{ nullptr };
+
+	Arena heap_;
+};
+
+
+/**
+ * Allocator drawing from a MonotonicBuffer; deallocate() is a no-op. Copies and rebinds share
+ * the buffer. Two allocators are equal when they use the same buffer.
+ *
+ *   std::byte storage[4096];
+ *   MonotonicBuffer buffer(storage, sizeof(storage));
+ *   SingleLinkedList<int, MonotonicAllocator<int>> list{ MonotonicAllocator<int>(buffer) };
+ */
+template<typename T>
+class MonotonicAllocator
+{
+public:
+	using value_type = T;
+
+	explicit MonotonicAllocator(MonotonicBuffer& buffer) noexcept : buffer_{ &buffer } {}
+
+	template<typename U>
+	MonotonicAllocator(const MonotonicAllocator<U>& other) noexcept : buffer_{ other.buffer() } {}
+
+	[[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(buffer_->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) noexcept {}
+
+	[[nodiscard]] MonotonicBuffer* buffer() const noexcept { return buffer_; }
+
+private:
+	MonotonicBuffer* buffer_;
+};
+
+template<typename T, typename U>
+bool operator==(const MonotonicAllocator<T>& lhs, const MonotonicAllocator<U>& rhs) noexcept
+{
+	return lhs.buffer() == rhs.buffer();
+}
+
+
+inline MonotonicBuffer::MonotonicBuffer(size_t firstChunkSize)
+	: heap_{ firstChunkSize > 0 ? firstChunkSize : DefaultChunkSize, ArenaGrowth::Double }
+{
+}
+
+inline MonotonicBuffer::MonotonicBuffer(void* buffer, size_t size)
+	: initialBuffer_{ static_cast<std::byte*>(buffer) }
+	, initialSize_{ size }
+	, cursor_{ initialBuffer_ }
+	, end_{ initialBuffer_ + size }
+	, heap_{ size > 0 ? size * 2 : DefaultChunkSize, ArenaGrowth::Double }
+{
+	assert(buffer || size == 0);
+}
+
+inline void* MonotonicBuffer::allocate(size_t bytes, size_t alignment)
+{
+	if (cursor_)
+	{
+		std::byte* p = Arena::alignUp(cursor_, alignment);
+		if (p <= end_ && bytes <= static_cast<size_t>(end_ - p))
+		{
+			cursor_ = p + bytes;
+			return p;
+		}
+
+		// What is left of the buffer stays unused until release().
+		cursor_ = nullptr;
+	}
+
+	return heap_.allocate(bytes, alignment);
+}
+
+inline void MonotonicBuffer::release() noexcept
+{
+	heap_.release();
+
+	cursor_ = initialBuffer_;
+	end_ = initialBuffer_ ? initialBuffer_ + initialSize_ : nullptr;
+}
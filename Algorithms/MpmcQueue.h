@@ -0,0 +1,343 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Types.h"
+
+/**
+ * Bounded lock-free queue for any number of producer and consumer threads
+ * (the array-based design by Dmitry Vyukov).
+ *
+ * Every slot carries a sequence number that says whose turn it is:
+ *  - sequence == pos       the slot is free for the producer that claims position `pos`;
+ *  - sequence == pos + 1   the slot holds the element of position `pos` for the consumer that claims it;
+ *  - after the pop the slot gets pos + capacity, i.e. it is free for the next lap.
+ * A thread claims a position with one CAS on `enqueuePos_`/`dequeuePos_` and then works on
+ * its slot without further contention. Nothing is allocated after construction.
+ *
+ * The batch variants claim several consecutive ready slots with the same single CAS.
+ *
+ * A claimed slot must be published, or consumers would wait on it forever, so nothing may throw
+ * between the claim and the store of its sequence: T has to be nothrow move constructible.
+ * A push whose construction could throw builds the element first and moves it into the slot;
+ * tryPushN then gives up batching and claims one slot per element. The same goes for pops: an
+ * element is moved out of its slot and the slot freed before it is handed over, so a throwing move
+ * assignment or output iterator can't wedge the queue. If tryPopN's output throws, the element it
+ * was given and the rest of the batch are dropped.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class MpmcQueue final
+{
+	static_assert(std::is_nothrow_move_constructible_v<T>, "A claimed slot must be published, so T's move constructor can't throw.");
+
+public:
+	using allocator_type = Allocator;
+	using size_type = size_t;
+
+public:
+	/** `capacity` is rounded up to a power of two, at least 2. */
+	explicit MpmcQueue(size_type capacity);
+	~MpmcQueue();
+
+	MpmcQueue(const MpmcQueue&) = delete;
+	MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+	bool tryPush(const T& val);
+	bool tryPush(T&& val);
+
+	template<typename... Args>
+	bool tryEmplace(Args&&... args);
+
+	bool tryPop(T& out);
+
+	/** Copies up to `count` elements from `first` and returns how many fit. */
+	template<typename InputIt>
+	size_type tryPushN(InputIt first, size_type count);
+
+	/** Moves up to `maxCount` elements to `out` and returns how many there were. A throw from `out` drops the rest of the batch. */
+	template<typename OutputIt>
+	size_type tryPopN(OutputIt out, size_type maxCount);
+
+	/** Only a snapshot while other threads are running. */
+	size_type sizeApprox() const noexcept;
+
+	constexpr size_type capacity() const noexcept { return mask_ + 1; }
+
+private:
+	struct Cell
+	{
+		std::atomic<size_type> sequence{ 0 };
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+	};
+
+	using cell_alloc_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Cell>;
+	using cell_alloc_traits = std::allocator_traits<cell_alloc_type>;
+
+	static constexpr size_type roundUpToPowerOfTwo(size_type n) noexcept;
+
+	/** How far a slot's sequence is from the one we wait for; wraps correctly on overflow. */
+	static constexpr std::ptrdiff_t distance(size_type sequence, size_type expected) noexcept
+	{
+		return static_cast<std::ptrdiff_t>(sequence - expected);
+	}
+
+	Cell& cellAt(size_type pos) const noexcept { return cells_[pos & mask_]; }
+
+	/** Destroys the element at claimed position `pos` and frees its slot for the next lap. */
+	void release(size_type pos) noexcept;
+
+	/** Claims up to `maxCount` consecutive slots whose sequence is `pos + offset + i`. Returns the first position. */
+	size_type claim(std::atomic<size_type>& position, size_type offset, size_type maxCount, size_type& claimed);
+
+private:
+	alignas(CacheLineSize) std::atomic<size_type> enqueuePos_{ 0 };
+	alignas(CacheLineSize) std::atomic<size_type> dequeuePos_{ 0 };
+
+	// Read-only after construction
+	alignas(CacheLineSize) cell_alloc_type allocator_{};
+	Cell* cells_{ nullptr };
+	size_type mask_{ 0 };
+};
+
+
+template <typename T, typename Allocator>
+constexpr typename MpmcQueue<T, Allocator>::size_type MpmcQueue<T, Allocator>::roundUpToPowerOfTwo(size_type n) noexcept
+{
+	// With a single slot "full for lap n" and "free for lap n + 1" would be the same sequence.
+	size_type result = 2;
+	while (result < n)
+	{
+		result *= 2;
+	}
+	return result;
+}
+
+template <typename T, typename Allocator>
+MpmcQueue<T, Allocator>::MpmcQueue(size_type capacity)
+{
+	const size_type roundedCapacity = roundUpToPowerOfTwo(capacity);
+	mask_ = roundedCapacity - 1;
+
+	cells_ = cell_alloc_traits::allocate(allocator_, roundedCapacity);
+	for (size_type i = 0; i < roundedCapacity; ++i)
+	{
+		cell_alloc_traits::construct(allocator_, &cells_[i]);
+		cells_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <typename T, typename Allocator>
+MpmcQueue<T, Allocator>::~MpmcQueue()
+{
+	const size_type end = enqueuePos_.load(std::memory_order_relaxed);
+	for (size_type pos = dequeuePos_.load(std::memory_order_relaxed); pos != end; ++pos)
+	{
+		std::destroy_at(cellAt(pos).value());
+	}
+
+	for (size_type i = 0; i < capacity(); ++i)
+	{
+		cell_alloc_traits::destroy(allocator_, &cells_[i]);
+	}
+
+	cell_alloc_traits::deallocate(allocator_, cells_, capacity());
+}
+
+template <typename T, typename Allocator>
+typename MpmcQueue<T, Allocator>::size_type MpmcQueue<T, Allocator>::claim(std::atomic<size_type>& position, size_type offset, size_type maxCount, size_type& claimed)
+{
+	/**
+	 * 1. the first slot is ready - count how many after it are ready too and CAS them all at once
+	 * 2. the first slot is behind - the queue is full (push) or empty (pop)
+	 * 3. the first slot is ahead - another thread claimed `pos` meanwhile, reload and retry
+	 */
+
+	size_type pos = position.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		const std::ptrdiff_t diff = distance(cellAt(pos).sequence.load(std::memory_order_acquire), pos + offset);
+
+		if (diff == 0)
+		{
+			size_type ready = 1;
+			while (ready < maxCount && cellAt(pos + ready).sequence.load(std::memory_order_acquire) == pos + ready + offset)
+			{
+				++ready;
+			}
+
+			if (position.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed))
+			{
+				claimed = ready;
+				return pos;
+			}
+		}
+		else if (diff < 0)
+		{
+			claimed = 0;
+			return pos;
+		}
+		else
+		{
+			pos = position.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T, typename Allocator>
+bool MpmcQueue<T, Allocator>::tryPush(const T& val)
+{
+	return tryEmplace(val);
+}
+
+template <typename T, typename Allocator>
+bool MpmcQueue<T, Allocator>::tryPush(T&& val)
+{
+	return tryEmplace(std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+bool MpmcQueue<T, Allocator>::tryEmplace(Args&&... args)
+{
+	if constexpr (!std::is_nothrow_constructible_v<T, Args...>)
+	{
+		// Throw, if at all, before a slot is claimed.
+		return tryEmplace(T(std::forward<Args>(args)...));
+	}
+
+	size_type claimed = 0;
+	const size_type pos = claim(enqueuePos_, 0, 1, claimed);
+	if (claimed == 0)
+	{
+		return false;
+	}
+
+	Cell& cell = cellAt(pos);
+	new (cell.storage) T(std::forward<Args>(args)...);
+	cell.sequence.store(pos + 1, std::memory_order_release);
+
+	return true;
+}
+
+template <typename T, typename Allocator>
+bool MpmcQueue<T, Allocator>::tryPop(T& out)
+{
+	size_type claimed = 0;
+	const size_type pos = claim(dequeuePos_, 1, 1, claimed);
+	if (claimed == 0)
+	{
+		return false;
+	}
+
+	Cell& cell = cellAt(pos);
+	if constexpr (std::is_nothrow_move_assignable_v<T>)
+	{
+		out = std::move(*cell.value());
+		release(pos);
+	}
+	else
+	{
+		// Free the slot before the assignment gets a chance to throw.
+		T val(std::move(*cell.value()));
+		release(pos);
+		out = std::move(val);
+	}
+
+	return true;
+}
+
+template <typename T, typename Allocator>
+template <typename InputIt>
+typename MpmcQueue<T, Allocator>::size_type MpmcQueue<T, Allocator>::tryPushN(InputIt first, size_type count)
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	if constexpr (!std::is_nothrow_constructible_v<T, decltype(*first)>)
+	{
+		size_type pushed = 0;
+		while (pushed < count && tryEmplace(*first))
+		{
+			++pushed;
+			++first;
+		}
+		return pushed;
+	}
+
+	size_type claimed = 0;
+	const size_type pos = claim(enqueuePos_, 0, count, claimed);
+
+	for (size_type i = 0; i < claimed; ++i, ++first)
+	{
+		Cell& cell = cellAt(pos + i);
+		new (cell.storage) T(*first);
+		cell.sequence.store(pos + i + 1, std::memory_order_release);
+	}
+
+	return claimed;
+}
+
+template <typename T, typename Allocator>
+template <typename OutputIt>
+typename MpmcQueue<T, Allocator>::size_type MpmcQueue<T, Allocator>::tryPopN(OutputIt out, size_type maxCount)
+{
+	if (maxCount == 0)
+	{
+		return 0;
+	}
+
+	size_type claimed = 0;
+	const size_type pos = claim(dequeuePos_, 1, maxCount, claimed);
+
+	size_type released = 0;
+	try
+	{
+		for (; released < claimed; ++out)
+		{
+			// Free the slot before `out` gets a chance to throw.
+			T val(std::move(*cellAt(pos + released).value()));
+			release(pos + released);
+			++released;
+
+			*out = std::move(val);
+		}
+	}
+	catch (...)
+	{
+		// The claimed slots must be freed all the same, or producers would wait on them next lap.
+		for (; released < claimed; ++released)
+		{
+			release(pos + released);
+		}
+		throw;
+	}
+
+	return claimed;
+}
+
+template <typename T, typename Allocator>
+void MpmcQueue<T, Allocator>::release(size_type pos) noexcept
+{
+	Cell& cell = cellAt(pos);
+	std::destroy_at(cell.value());
+	cell.sequence.store(pos + capacity(), std::memory_order_release);
+}
+
+template <typename T, typename Allocator>
+typename MpmcQueue<T, Allocator>::size_type MpmcQueue<T, Allocator>::sizeApprox() const noexcept
+{
+	const size_type dequeuePos = dequeuePos_.load(std::memory_order_acquire);
+	const size_type enqueuePos = enqueuePos_.load(std::memory_order_acquire);
+
+	return enqueuePos - dequeuePos;
+}
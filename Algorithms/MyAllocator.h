@@ -1,17 +1,47 @@
 #pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+/**
+ * Plain heap allocator in the shape std::allocator_traits expects: value_type, a converting
+ * constructor for rebinding (the containers allocate nodes, not T) and equality. It holds no
+ * state, so any two instances can free each other's memory.
+ */
 template<typename T>
 struct MyAllocator
 {
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	MyAllocator() noexcept = default;
+
+	template<typename U>
+	MyAllocator(const MyAllocator<U>&) noexcept {}
+
 	T* allocate(size_t n)
 	{
-		return static_cast<T*>(::operator new(n * sizeof(T)));
+		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignof(T) }));
+		}
+		else
+		{
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
 	}
 
 	void deallocate(T* p, size_t)
 	{
-		::operator delete(p);
+		if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		{
+			::operator delete(p, std::align_val_t{ alignof(T) });
+		}
+		else
+		{
+			::operator delete(p);
+		}
 	}
 
 	template <typename... Args>
@@ -25,3 +55,9 @@ struct MyAllocator
 		p->~T();
 	}
 };
+
+template<typename T, typename U>
+constexpr bool operator==(const MyAllocator<T>&, const MyAllocator<U>&) noexcept
+{
+	return true;
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "MyAllocator.h"
+#include "ThreadPool.h"
+#include "Vector.h"
+
+/** Where the pages of a large allocation should live. */
+enum class NumaPolicy
+{
+	/** Wherever the thread that first writes a page runs (the kernel's default, "first touch"). */
+	FirstTouch,
+
+	/** Round-robin over all nodes, so no socket's memory controller becomes the bottleneck. */
+	Interleave,
+
+	/** All pages on one node. */
+	Bind
+};
+
+
+/**
+ * Allocator for big arrays on multi-socket machines. Requests of at least LargeSize bytes get
+ * their own anonymous mapping; on Linux the policy is then applied with mbind(2). Smaller requests,
+ * and everything on other systems or kernels without NUMA support, go to MyAllocator, so the
+ * policy is then simply a no-op.
+ *
+ * The policy only says where pages go once they are touched. With FirstTouch that is decided by
+ * who writes first, see numaFirstTouch().
+ *
+ * Any instance can free what another one allocated, so they all compare equal.
+ */
+template<typename T>
+class NumaAllocator
+{
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	static constexpr size_t LargeSize = 64 * 1024;
+
+public:
+	NumaAllocator() noexcept = default;
+	explicit NumaAllocator(NumaPolicy policy, int node = 0) noexcept : policy_{ policy }, node_{ node } {}
+
+	template<typename U>
+	NumaAllocator(const NumaAllocator<U>& other) noexcept : policy_{ other.policy() }, node_{ other.node() } {}
+
+	[[nodiscard]] T* allocate(size_t n);
+	void deallocate(T* p, size_t n) noexcept;
+
+	[[nodiscard]] NumaPolicy policy() const noexcept { return policy_; }
+	[[nodiscard]] int node() const noexcept { return node_; }
+
+private:
+	static constexpr bool isLarge(size_t n) noexcept { return n >= (LargeSize + sizeof(T) - 1) / sizeof(T); }
+
+	static size_t mappingSize(size_t n) noexcept;
+
+	/** Best effort, the mapping is usable either way. */
+	void applyPolicy(void* p, size_t bytes) const noexcept;
+
+private:
+	NumaPolicy policy_{ NumaPolicy::FirstTouch };
+	int node_{ 0 };
+};
+
+template<typename T, typename U>
+constexpr bool operator==(const NumaAllocator<T>&, const NumaAllocator<U>&) noexcept
+{
+	return true;
+}
+
+
+/** Memory nodes the system reports; 1 where it doesn't tell. */
+inline size_t numaNodeCount()
+{
+#if defined(__linux__)
+	std::error_code error;
+	size_t count = 0;
+	for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error))
+	{
+		const std::string name = entry.path().filename().string();
+		if (name.size() > 4 && name.compare(0, 4, "node") == 0 && std::isdigit(static_cast<unsigned char>(name[4])))
+		{
+			++count;
+		}
+	}
+	return count > 0 ? count : 1;
+#else
+	return 1;
+#endif
+}
+
+/**
+ * Faults in the pages of the vector's unused capacity from the pool's workers, so that under
+ * FirstTouch each page lands on the node of a worker rather than of the thread that fills it
+ * afterwards. Only whole pages past size() are touched; constructed elements are left alone.
+ *
+ * The capacity is split into threadCount() equal parts and worker w touches part w through
+ * forEachWorker. Scan it the same way, so that the pages a worker reads are the ones it placed:
+ *
+ *   Vector<double, NumaAllocator<double>> data;
+ *   data.reserve(n);
+ *   numaFirstTouch(data, pool);
+ *   ... fill
+ *   pool.forEachWorker([&](size_t w) { scan(data, w * n / pool.threadCount(), (w + 1) * n / pool.threadCount()); });
+ */
+template<typename T, typename Allocator>
+void numaFirstTouch(Vector<T, Allocator>& vec, ThreadPool& pool)
+{
+#if defined(__linux__)
+	const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#else
+	const size_t pageSize = 4096;
+#endif
+
+	auto* const storageEnd = reinterpret_cast<std::byte*>(vec.data() + vec.capacity());
+	const auto tail = reinterpret_cast<std::uintptr_t>(vec.data() + vec.size());
+	auto* const firstPage = reinterpret_cast<std::byte*>((tail + pageSize - 1) / pageSize * pageSize);
+
+	if (!vec.data() || firstPage >= storageEnd)
+	{
+		return;
+	}
+
+	const size_t capacity = vec.capacity();
+	const size_t workers = pool.threadCount();
+	T* const data = vec.data();
+
+	pool.forEachWorker([=](size_t worker)
+	{
+		// The pages that start inside this worker's part of the elements.
+		const auto first = reinterpret_cast<std::uintptr_t>(data + worker * capacity / workers);
+		auto* const last = reinterpret_cast<std::byte*>(data + (worker + 1) * capacity / workers);
+		auto* page = std::max(firstPage, reinterpret_cast<std::byte*>((first + pageSize - 1) / pageSize * pageSize));
+
+		for (; page < last && page + pageSize <= storageEnd; page += pageSize)
+		{
+			// A volatile store so the write isn't dropped: nothing reads the byte back.
+			*reinterpret_cast<volatile std::byte*>(page) = std::byte{ 0 };
+		}
+	});
+}
+
+template<typename T>
+size_t NumaAllocator<T>::mappingSize(size_t n) noexcept
+{
+#if defined(__linux__)
+	const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+	return (n * sizeof(T) + pageSize - 1) / pageSize * pageSize;
+#else
+	return n * sizeof(T);
+#endif
+}
+
+template<typename T>
+T* NumaAllocator<T>::allocate(size_t n)
+{
+#if defined(__linux__)
+	if (isLarge(n))
+	{
+		const size_t bytes = mappingSize(n);
+		void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+		{
+			throw std::bad_alloc();
+		}
+
+		applyPolicy(p, bytes);
+		return static_cast<T*>(p);
+	}
+#endif
+
+	return MyAllocator<T>().allocate(n);
+}
+
+template<typename T>
+void NumaAllocator<T>::deallocate(T* p, size_t n) noexcept
+{
+#if defined(__linux__)
+	if (isLarge(n))
+	{
+		::munmap(p, mappingSize(n));
+		return;
+	}
+#endif
+
+	MyAllocator<T>().deallocate(p, n);
+}
+
+template<typename T>
+void NumaAllocator<T>::applyPolicy([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes) const noexcept
+{
+#if defined(__linux__) && defined(SYS_mbind)
+	// From <numaif.h>, which is only there with libnuma's headers installed.
+	constexpr int MpolBind = 2;
+	constexpr int MpolInterleave = 3;
+	constexpr size_t MaxNodes = 64;
+
+	if (policy_ == NumaPolicy::FirstTouch)
+	{
+		return;
+	}
+
+	unsigned long mask = 0;
+	int mode = 0;
+
+	if (policy_ == NumaPolicy::Interleave)
+	{
+		// Nodes that don't exist or aren't allowed are dropped by the kernel.
+		mask = ~0ul;
+		mode = MpolInterleave;
+	}
+	else
+	{
+		if (node_ < 0 || static_cast<size_t>(node_) >= MaxNodes)
+		{
+			return;
+		}
+		mask = 1ul << node_;
+		mode = MpolBind;
+	}
+
+	// The kernel reads maxnode - 1 bits of the mask.
+	::syscall(SYS_mbind, p, bytes, mode, &mask, MaxNodes + 1, 0);
+#endif
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "Vector.h"
+
+/**
+ * Index arithmetic of a d-ary heap stored in an array: the children of `i`
+ * are Arity * i + 1 ... Arity * i + Arity.
+ *
+ * With Arity = 4 the children of a node sit next to each other (a cache line holds all four
+ * for small T) and the tree is half as deep as a binary one, so a sift-down touches fewer lines.
+ * It compares more per level, but those compares hit memory that is already loaded.
+ */
+template<size_t Arity>
+struct DaryHeapLayout
+{
+	static_assert(Arity >= 2, "A heap needs at least two children per node.");
+
+	static constexpr size_t parent(size_t i) noexcept { return (i - 1) / Arity; }
+	static constexpr size_t firstChild(size_t i) noexcept { return Arity * i + 1; }
+};
+
+
+/**
+ * Heap-ordered priority queue on top of Vector. As with std::priority_queue, top() is the element
+ * that compares greatest, so std::less gives a max-heap and std::greater a min-heap.
+ *
+ * Sifting moves a "hole" instead of swapping: the moving element is held aside and
+ * every level costs one move instead of three.
+ */
+template<
+	typename T,
+	typename Compare = std::less<T>,
+	size_t Arity = 4
+>
+class PriorityQueue final
+{
+public:
+	using size_type = size_t;
+	using value_compare = Compare;
+
+public:
+	PriorityQueue() = default;
+	explicit PriorityQueue(const Compare& compare) : compare_{ compare } {}
+	PriorityQueue(std::initializer_list<T> vals, const Compare& compare = Compare());
+
+	template<std::input_iterator InputIt>
+	PriorityQueue(InputIt first, InputIt last, const Compare& compare = Compare());
+
+	void push(const T& val);
+	void push(T&& val);
+
+	template<typename... Args>
+	void emplace(Args&&... args);
+
+	/**
+	 * Adds [first, last). When the new elements outnumber the old ones, the whole array is
+	 * re-heapified bottom-up (Floyd), which is O(n) instead of O(k log n) for k single pushes.
+	 */
+	template<std::input_iterator InputIt>
+	void pushRange(InputIt first, InputIt last);
+
+	void pop();
+
+	/** Removes the top and hands it out, saving a copy compared to top() + pop(). */
+	[[nodiscard]] T extractTop();
+
+	[[nodiscard]] const T& top() const;
+
+	void clear();
+	void reserve(size_type n) { heap_.reserve(n); }
+
+	[[nodiscard]] constexpr size_type size() const noexcept { return heap_.size(); }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return heap_.isEmpty(); }
+
+private:
+	using Layout = DaryHeapLayout<Arity>;
+
+	void siftUp(size_type i);
+	void siftDown(size_type i);
+	void heapify();
+
+private:
+	Vector<T> heap_;
+	Compare compare_{};
+};
+
+
+template<typename T, typename Compare, size_t Arity>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(std::initializer_list<T> vals, const Compare& compare)
+	: PriorityQueue(vals.begin(), vals.end(), compare)
+{
+}
+
+template<typename T, typename Compare, size_t Arity>
+template<std::input_iterator InputIt>
+PriorityQueue<T, Compare, Arity>::PriorityQueue(InputIt first, InputIt last, const Compare& compare)
+	: compare_{ compare }
+{
+	pushRange(first, last);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::push(const T& val)
+{
+	heap_.pushBack(val);
+	siftUp(heap_.size() - 1);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::push(T&& val)
+{
+	heap_.pushBack(std::move(val));
+	siftUp(heap_.size() - 1);
+}
+
+template<typename T, typename Compare, size_t Arity>
+template<typename... Args>
+void PriorityQueue<T, Compare, Arity>::emplace(Args&&... args)
+{
+	push(T(std::forward<Args>(args)...));
+}
+
+template<typename T, typename Compare, size_t Arity>
+template<std::input_iterator InputIt>
+void PriorityQueue<T, Compare, Arity>::pushRange(InputIt first, InputIt last)
+{
+	const size_type oldSize = heap_.size();
+	heap_.pushBackRange(first, last);
+	const size_type added = heap_.size() - oldSize;
+
+	if (added > oldSize)
+	{
+		heapify();
+		return;
+	}
+
+	for (size_type i = oldSize; i < heap_.size(); ++i)
+	{
+		siftUp(i);
+	}
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::pop()
+{
+	assert(!isEmpty());
+
+	if (heap_.size() > 1)
+	{
+		heap_.front() = std::move(heap_.back());
+	}
+	heap_.popBack();
+
+	if (!heap_.isEmpty())
+	{
+		siftDown(0);
+	}
+}
+
+template<typename T, typename Compare, size_t Arity>
+T PriorityQueue<T, Compare, Arity>::extractTop()
+{
+	assert(!isEmpty());
+
+	T result = std::move(heap_.front());
+	pop();
+
+	return result;
+}
+
+template<typename T, typename Compare, size_t Arity>
+const T& PriorityQueue<T, Compare, Arity>::top() const
+{
+	assert(!isEmpty());
+	return heap_.front();
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::clear()
+{
+	// Keeps the storage, a scheduler refills it right away.
+	while (!heap_.isEmpty())
+	{
+		heap_.popBack();
+	}
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::siftUp(size_type i)
+{
+	T val = std::move(heap_[i]);
+
+	while (i > 0)
+	{
+		const size_type parent = Layout::parent(i);
+		if (!compare_(heap_[parent], val))
+		{
+			break;
+		}
+
+		heap_[i] = std::move(heap_[parent]);
+		i = parent;
+	}
+
+	heap_[i] = std::move(val);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::siftDown(size_type i)
+{
+	const size_type count = heap_.size();
+	T val = std::move(heap_[i]);
+
+	for (;;)
+	{
+		const size_type first = Layout::firstChild(i);
+		if (first >= count)
+		{
+			break;
+		}
+
+		const size_type last = std::min(first + Arity, count);
+		size_type best = first;
+		for (size_type child = first + 1; child < last; ++child)
+		{
+			if (compare_(heap_[best], heap_[child]))
+			{
+				best = child;
+			}
+		}
+
+		if (!compare_(val, heap_[best]))
+		{
+			break;
+		}
+
+		heap_[i] = std::move(heap_[best]);
+		i = best;
+	}
+
+	heap_[i] = std::move(val);
+}
+
+template<typename T, typename Compare, size_t Arity>
+void PriorityQueue<T, Compare, Arity>::heapify()
+{
+	if (heap_.size() < 2)
+	{
+		return;
+	}
+
+	// Leaves are heaps already; fix every inner node, the deepest first.
+	for (size_type i = Layout::parent(heap_.size() - 1) + 1; i-- > 0;)
+	{
+		siftDown(i);
+	}
+}
@@ -1,11 +1,19 @@
 #pragma once
+#include <initializer_list>
+#include <iterator>
 #include <memory>
 
-#include "SingleLinkedList.h"
+#include "RingBuffer.h"
 
+/**
+ * FIFO adaptor. `Container` must provide pushBack, popFront, front, clear, isEmpty and size;
+ * pushBackRange is used for bulk pushes when it is there.
+ * RingBuffer keeps the elements contiguous and allocates only on growth;
+ * SingleLinkedList (or DoubleLinkedList) can still be plugged in when stable element addresses matter.
+ */
 template<
 	typename T, 
-	template<typename> typename Container = SingleLinkedList
+	template<typename> typename Container = RingBuffer
 >
 class Queue final
 {
@@ -15,6 +23,11 @@ public:
 	using const_reference = const T&;
 public:
 	Queue() = default;
+	Queue(std::initializer_list<T> vals);
+
+	/** The first element of the range ends up at the front. */
+	template<std::input_iterator InputIt>
+	Queue(InputIt first, InputIt last);
 
 	Queue(const Queue&) = default;
 	Queue(Queue&&) noexcept = default;
@@ -26,6 +39,10 @@ public:
 	void push(const T& val);
 	void push(T&& val);
 
+	/** Pushes [first, last) in order, growing the storage once when the container allows it. */
+	template<std::input_iterator InputIt>
+	void pushRange(InputIt first, InputIt last);
+
 	void pop();
 
 	void clear();
@@ -36,11 +53,28 @@ public:
 	[[nodiscard]] bool isEmpty() const noexcept(noexcept(container_.isEmpty()));
 	[[nodiscard]] size_type size() const noexcept(noexcept(container_.size()));
 
+	/** The underlying container's counters. */
+	[[nodiscard]] ContainerStats stats() const noexcept { return container_.stats(); }
+	void resetStats() noexcept { container_.resetStats(); }
+
 private:
 	Container<T> container_;
 };
 
 
+template<typename T, template<typename> typename Container>
+Queue<T, Container>::Queue(std::initializer_list<T> vals)
+	: Queue(vals.begin(), vals.end())
+{
+}
+
+template<typename T, template<typename> typename Container>
+template<std::input_iterator InputIt>
+Queue<T, Container>::Queue(InputIt first, InputIt last)
+{
+	pushRange(first, last);
+}
+
 template<typename T, template<typename> typename Container>
 void Queue<T, Container>::push(const T& val)
 {
@@ -54,6 +88,23 @@ void Queue<T, Container>::push(T&& val)
 	container_.pushBack(std::move(val));
 }
 
+template<typename T, template<typename> typename Container>
+template<std::input_iterator InputIt>
+void Queue<T, Container>::pushRange(InputIt first, InputIt last)
+{
+	if constexpr (requires { container_.pushBackRange(first, last); })
+	{
+		container_.pushBackRange(first, last);
+	}
+	else
+	{
+		for (; first != last; ++first)
+		{
+			push(*first);
+		}
+	}
+}
+
 template<typename T, template<typename> typename Container>
 void Queue<T, Container>::pop()
 {
@@ -0,0 +1,560 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "ContainerStats.h"
+#include "Types.h"
+
+/**
+ * A growable circular buffer. Elements live in one contiguous block whose capacity
+ * is always a power of two, so wrapping an index around is a single `& mask_`
+ * instead of a division. Pushing and popping at both ends is O(1) and allocates
+ * only when the buffer is full, in which case the elements are relocated
+ * (unwrapped, front first) into a block twice as big.
+ *
+ * It is the default container of Queue.
+ */
+
+template<typename T, typename Allocator>
+class RingBuffer;
+
+template<typename T, typename Allocator, bool bConst>
+class RingBufferIterator final
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = std::conditional_t<bConst, const T*, T*>;
+	using reference = std::conditional_t<bConst, const T&, T&>;
+
+	using Iterator = RingBufferIterator;
+	using MyBuffer = std::conditional_t<bConst, const RingBuffer<T, Allocator>, RingBuffer<T, Allocator>>;
+
+public:
+	RingBufferIterator() = default;
+	RingBufferIterator(MyBuffer* owner, size_t index) : owner_{ owner }, index_{ index } {}
+
+	reference operator*() const { return (*owner_)[index_]; }
+	pointer operator->() const { return &(*owner_)[index_]; }
+
+	Iterator& operator++() { ++index_; return *this; }
+	Iterator operator++(int) { Iterator old = *this; ++index_; return old; }
+
+	constexpr bool operator==(const Iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return index_ == other.index_;
+	}
+	constexpr bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+private:
+	MyBuffer* owner_{ nullptr };
+
+	// Logical index, i.e. 0 is always the front.
+	size_t index_{ 0 };
+};
+
+
+template<typename T, typename Allocator = std::allocator<T>>
+class RingBuffer final
+{
+public:
+	using Iterator = RingBufferIterator<T, Allocator, false>;
+	using ConstIterator = RingBufferIterator<T, Allocator, true>;
+
+	using allocator_type = Allocator;
+	using alloc_traits = std::allocator_traits<Allocator>;
+
+	static constexpr bool bNothrowMoveAssign = alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value;
+	using pointer = typename alloc_traits::pointer;
+	using size_type = typename alloc_traits::size_type;
+
+public:
+	RingBuffer() = default;
+	explicit RingBuffer(const Allocator& allocator) : allocator_{ allocator } {}
+	RingBuffer(std::initializer_list<T> vals, const Allocator& allocator = Allocator());
+	~RingBuffer();
+
+	/** The copy gets the allocator that select_on_container_copy_construction picks. */
+	RingBuffer(const RingBuffer& other);
+	RingBuffer(const RingBuffer& other, const Allocator& allocator);
+	RingBuffer(RingBuffer&& other) noexcept;
+
+	/**
+	 * Assignments follow the allocator's propagate_on_container_* traits, like Vector's. When a move
+	 * can't take the allocator along and the two allocators differ, the elements are moved one by one.
+	 */
+	RingBuffer& operator=(const RingBuffer& other);
+	RingBuffer& operator=(RingBuffer&& other) noexcept(bNothrowMoveAssign);
+
+	/** Allocators are swapped only if they propagate on swap; otherwise they must be equal. */
+	void swap(RingBuffer& other) noexcept;
+
+	void pushBack(const T& val);
+	void pushBack(T&& val);
+
+	/** Appends [first, last) in order. For forward iterators the storage grows once up front. */
+	template<std::input_iterator InputIt>
+	void pushBackRange(InputIt first, InputIt last);
+
+	void pushFront(const T& val);
+	void pushFront(T&& val);
+
+	void popFront();
+	void popBack();
+
+	/** Destroys the elements but keeps the storage. */
+	void clear();
+
+	/** Destroys the elements and frees the storage. */
+	void reset();
+
+	/** Rounds `n` up to a power of two. */
+	void reserve(size_type n);
+
+	constexpr size_type size() const noexcept { return size_; }
+	constexpr size_type capacity() const noexcept { return capacity_; }
+	constexpr bool isEmpty() const noexcept { return size_ == 0; }
+
+	T& front();
+	const T& front() const;
+
+	T& back();
+	const T& back() const;
+
+	T& operator[](size_type i);
+	const T& operator[](size_type i) const;
+
+	Iterator begin() { return Iterator(this, 0); }
+	Iterator end() { return Iterator(this, size_); }
+
+	ConstIterator begin() const { return ConstIterator(this, 0); }
+	ConstIterator end() const { return ConstIterator(this, size_); }
+
+	ConstIterator cbegin() const { return begin(); }
+	ConstIterator cend() const { return end(); }
+
+	allocator_type getAllocator() const { return allocator_; }
+
+	/** Growths and element moves so far; zeros unless built with ALGORITHMS_ENABLE_STATS. */
+	ContainerStats stats() const noexcept { return stats_.snapshot(); }
+	void resetStats() noexcept { stats_.reset(); }
+
+private:
+	constexpr size_type physicalIndex(size_type i) const noexcept { return (head_ + i) & (capacity_ - 1); }
+
+	void relocate(size_type newCapacity);
+
+	template<typename ValType>
+	void insertAtEnd(ValType&& val);
+
+	template<typename ValType>
+	void insertAtBeginning(ValType&& val);
+
+	void copyFromAnother(const RingBuffer& other);
+	void moveFromAnother(RingBuffer&& other);
+
+	/** For a move between unequal allocators that don't propagate. */
+	void moveElementsFrom(RingBuffer&& other);
+
+	static constexpr size_type roundUpToPowerOfTwo(size_type n) noexcept;
+
+private:
+	static constexpr size_type MinCapacity = 8;
+
+	NO_UNIQUE_ADDRESS allocator_type allocator_{};
+
+	pointer data_{ nullptr };
+
+	size_type head_{ 0 };
+	size_type size_{ 0 };
+	size_type capacity_{ 0 };
+
+	NO_UNIQUE_ADDRESS ContainerStatsRecorder stats_;
+};
+
+
+template <typename T, typename Allocator>
+constexpr typename RingBuffer<T, Allocator>::size_type RingBuffer<T, Allocator>::roundUpToPowerOfTwo(size_type n) noexcept
+{
+	size_type result = MinCapacity;
+	while (result < n)
+	{
+		result *= 2;
+	}
+	return result;
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>::RingBuffer(std::initializer_list<T> vals, const Allocator& allocator)
+	: allocator_{ allocator }
+{
+	reserve(vals.size());
+	for (auto& val : vals)
+	{
+		insertAtEnd(val);
+	}
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>::RingBuffer(const RingBuffer& other)
+	: allocator_{ alloc_traits::select_on_container_copy_construction(other.allocator_) }
+{
+	copyFromAnother(other);
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>::RingBuffer(const RingBuffer& other, const Allocator& allocator)
+	: allocator_{ allocator }
+{
+	copyFromAnother(other);
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>::RingBuffer(RingBuffer&& other) noexcept
+	: allocator_{ other.allocator_ }
+{
+	moveFromAnother(std::move(other));
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>::~RingBuffer()
+{
+	reset();
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>& RingBuffer<T, Allocator>::operator=(const RingBuffer& other)
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+	{
+		// Our storage has to go back to the allocator that made it before that one is replaced.
+		if (allocator_ != other.allocator_)
+		{
+			reset();
+		}
+		allocator_ = other.allocator_;
+	}
+
+	copyFromAnother(other);
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+RingBuffer<T, Allocator>& RingBuffer<T, Allocator>::operator=(RingBuffer&& other) noexcept(bNothrowMoveAssign)
+{
+	/**
+	 * 1. the allocator propagates - free ours, take the other's allocator and storage
+	 * 2. the allocators are equal - take the storage
+	 * 3. they differ - move the elements over
+	 */
+
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+	{
+		reset();
+		allocator_ = std::move(other.allocator_);
+		moveFromAnother(std::move(other));
+	}
+	else if (alloc_traits::is_always_equal::value || allocator_ == other.allocator_)
+	{
+		moveFromAnother(std::move(other));
+	}
+	else
+	{
+		moveElementsFrom(std::move(other));
+	}
+
+	return *this;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::swap(RingBuffer& other) noexcept
+{
+	if constexpr (alloc_traits::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(allocator_, other.allocator_);
+	}
+	else
+	{
+		assert(allocator_ == other.allocator_);
+	}
+
+	std::swap(data_, other.data_);
+	std::swap(head_, other.head_);
+	std::swap(size_, other.size_);
+	std::swap(capacity_, other.capacity_);
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::pushBack(const T& val)
+{
+	insertAtEnd(val);
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::pushBack(T&& val)
+{
+	insertAtEnd(std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+void RingBuffer<T, Allocator>::pushBackRange(InputIt first, InputIt last)
+{
+	if constexpr (std::forward_iterator<InputIt>)
+	{
+		reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+	}
+
+	for (; first != last; ++first)
+	{
+		insertAtEnd(*first);
+	}
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::pushFront(const T& val)
+{
+	insertAtBeginning(val);
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::pushFront(T&& val)
+{
+	insertAtBeginning(std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <typename ValType>
+void RingBuffer<T, Allocator>::insertAtEnd(ValType&& val)
+{
+	if (size_ == capacity_)
+	{
+		// `val` may be one of our own elements (rb.pushBack(rb.front())), and relocating
+		// frees it, so build the value before growing.
+		T value(std::forward<ValType>(val));
+		relocate(capacity_ == 0 ? MinCapacity : capacity_ * 2);
+		alloc_traits::construct(allocator_, &data_[physicalIndex(size_)], std::move(value));
+		++size_;
+		return;
+	}
+
+	alloc_traits::construct(allocator_, &data_[physicalIndex(size_)], std::forward<ValType>(val));
+	++size_;
+}
+
+template <typename T, typename Allocator>
+template <typename ValType>
+void RingBuffer<T, Allocator>::insertAtBeginning(ValType&& val)
+{
+	if (size_ == capacity_)
+	{
+		// Same aliasing concern as insertAtEnd.
+		T value(std::forward<ValType>(val));
+		relocate(capacity_ == 0 ? MinCapacity : capacity_ * 2);
+		insertAtBeginning(std::move(value));
+		return;
+	}
+
+	// Unsigned wrap-around is fine here, the mask brings it back into range.
+	size_type newHead = (head_ - 1) & (capacity_ - 1);
+	alloc_traits::construct(allocator_, &data_[newHead], std::forward<ValType>(val));
+
+	head_ = newHead;
+	++size_;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::popFront()
+{
+	assert(!isEmpty());
+
+	alloc_traits::destroy(allocator_, &data_[head_]);
+	head_ = (head_ + 1) & (capacity_ - 1);
+	--size_;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::popBack()
+{
+	assert(!isEmpty());
+
+	alloc_traits::destroy(allocator_, &data_[physicalIndex(size_ - 1)]);
+	--size_;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::clear()
+{
+	for (size_type i = 0; i < size_; ++i)
+	{
+		alloc_traits::destroy(allocator_, &data_[physicalIndex(i)]);
+	}
+
+	head_ = 0;
+	size_ = 0;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::reset()
+{
+	clear();
+
+	if (data_)
+	{
+		alloc_traits::deallocate(allocator_, data_, capacity_);
+	}
+
+	data_ = nullptr;
+	capacity_ = 0;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::reserve(size_type n)
+{
+	if (n <= capacity_)
+	{
+		return;
+	}
+
+	relocate(roundUpToPowerOfTwo(n));
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::relocate(size_type newCapacity)
+{
+	/**
+	 * The old block may be wrapped (the front is somewhere in the middle).
+	 * Moving the elements in logical order unwraps them, so in the new block
+	 * the front sits at 0 again.
+	 */
+
+	pointer newData = alloc_traits::allocate(allocator_, newCapacity);
+
+	stats_.countReallocation(size_);
+
+	for (size_type i = 0; i < size_; ++i)
+	{
+		T& old = data_[physicalIndex(i)];
+		alloc_traits::construct(allocator_, &newData[i], std::move(old));
+		alloc_traits::destroy(allocator_, &old);
+	}
+
+	if (data_)
+	{
+		alloc_traits::deallocate(allocator_, data_, capacity_);
+	}
+
+	data_ = newData;
+	capacity_ = newCapacity;
+	head_ = 0;
+}
+
+template <typename T, typename Allocator>
+T& RingBuffer<T, Allocator>::front()
+{
+	return const_cast<T&>(static_cast<const RingBuffer&>(*this).front());
+}
+
+template <typename T, typename Allocator>
+const T& RingBuffer<T, Allocator>::front() const
+{
+	assert(!isEmpty());
+	return data_[head_];
+}
+
+template <typename T, typename Allocator>
+T& RingBuffer<T, Allocator>::back()
+{
+	return const_cast<T&>(static_cast<const RingBuffer&>(*this).back());
+}
+
+template <typename T, typename Allocator>
+const T& RingBuffer<T, Allocator>::back() const
+{
+	assert(!isEmpty());
+	return data_[physicalIndex(size_ - 1)];
+}
+
+template <typename T, typename Allocator>
+T& RingBuffer<T, Allocator>::operator[](size_type i)
+{
+	return const_cast<T&>(static_cast<const RingBuffer&>(*this)[i]);
+}
+
+template <typename T, typename Allocator>
+const T& RingBuffer<T, Allocator>::operator[](size_type i) const
+{
+	assert(i < size_);
+	return data_[physicalIndex(i)];
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::copyFromAnother(const RingBuffer& other)
+{
+	reset();
+
+	if (other.isEmpty())
+	{
+		return;
+	}
+
+	data_ = alloc_traits::allocate(allocator_, other.capacity_);
+	capacity_ = other.capacity_;
+
+	for (size_type i = 0; i < other.size_; ++i)
+	{
+		alloc_traits::construct(allocator_, &data_[i], other[i]);
+	}
+
+	size_ = other.size_;
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::moveFromAnother(RingBuffer&& other)
+{
+	reset();
+
+	data_ = std::exchange(other.data_, nullptr);
+	head_ = std::exchange(other.head_, 0);
+	size_ = std::exchange(other.size_, 0);
+	capacity_ = std::exchange(other.capacity_, 0);
+}
+
+template <typename T, typename Allocator>
+void RingBuffer<T, Allocator>::moveElementsFrom(RingBuffer&& other)
+{
+	reset();
+	reserve(other.size_);
+
+	for (size_type i = 0; i < other.size_; ++i)
+	{
+		alloc_traits::construct(allocator_, &data_[i], std::move(other[i]));
+	}
+	size_ = other.size_;
+
+	other.reset();
+}
+
+
+/** RingBuffer drawing from a std::pmr::memory_resource. */
+template<typename T>
+using PmrRingBuffer = RingBuffer<T, std::pmr::polymorphic_allocator<T>>;
@@ -1,7 +1,15 @@
 #pragma once
 #include <algorithm>
 #include <assert.h>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "ContainerStats.h"
+#include "Types.h"
 
 
 template<typename ValType>
@@ -59,10 +67,16 @@ public:
 	using node_pointer = typename node_alloc_traits::pointer;
 	using size_type = typename alloc_traits::size_type;
 
+	static constexpr bool bNothrowMoveAssign = node_alloc_traits::propagate_on_container_move_assignment::value || node_alloc_traits::is_always_equal::value;
+
 public:
 	SingleLinkedList() = default;
-	SingleLinkedList(std::initializer_list<T> vals);
+	explicit SingleLinkedList(const Allocator& allocator) : nodeAllocator_{ allocator } {}
+	SingleLinkedList(std::initializer_list<T> vals, const Allocator& allocator = Allocator());
+
+	/** The copy gets the allocator that select_on_container_copy_construction picks. */
 	SingleLinkedList(const SingleLinkedList& other);
+	SingleLinkedList(const SingleLinkedList& other, const Allocator& allocator);
 	SingleLinkedList(SingleLinkedList&& other) noexcept;
 	~SingleLinkedList();
 
@@ -72,6 +86,10 @@ public:
 	void pushBack(const T& val);
 	void pushBack(T&& val);
 
+	/** Appends [first, last) in order. */
+	template<std::input_iterator InputIt>
+	void pushBackRange(InputIt first, InputIt last);
+
 	void popFront();
 	void popBack();
 
@@ -80,8 +98,15 @@ public:
 	constexpr size_t size() const noexcept;
 	constexpr bool isEmpty() const noexcept;
 
+	/**
+	 * Assignments follow the allocator's propagate_on_container_* traits. When a move can't take
+	 * the allocator along and the two allocators differ, the values are moved into new nodes.
+	 */
 	SingleLinkedList& operator=(const SingleLinkedList& other);
-	SingleLinkedList& operator=(SingleLinkedList&& other) noexcept;
+	SingleLinkedList& operator=(SingleLinkedList&& other) noexcept(bNothrowMoveAssign);
+
+	/** Allocators are swapped only if they propagate on swap; otherwise they must be equal. */
+	void swap(SingleLinkedList& other) noexcept;
 
 	void remove(Iterator where);
 
@@ -100,9 +125,23 @@ public:
 	ConstIterator cbegin() const;
 	ConstIterator cend() const;
 
+	allocator_type getAllocator() const { return allocator_type(nodeAllocator_); }
+
+	/** Node allocations and O(n) walks so far; zeros unless built with ALGORITHMS_ENABLE_STATS. */
+	ContainerStats stats() const noexcept { return stats_.snapshot(); }
+	void resetStats() noexcept { stats_.reset(); }
+
 private:
-	void copyFromAnother(const SingleLinkedList<T>& other);
-	void moveFromAnother(SingleLinkedList<T>&& other);
+	void copyFromAnother(const SingleLinkedList& other);
+
+	/** Takes the nodes of `other`. Our allocator must be able to free them. */
+	void moveFromAnother(SingleLinkedList&& other);
+
+	/** Moves the values of `other` into nodes of our own allocator. */
+	void moveElementsFrom(SingleLinkedList&& other);
+
+	template<typename ValType>
+	NodePtr allocateAndConstruct(ValType&& val, NodePtr next);
 
 	template<typename ValType>
 	void insertAtBeginning(ValType&& val);
@@ -116,12 +155,15 @@ private:
 	constexpr bool isInBound(size_t index) const noexcept;
 
 private:
-	allocator_type allocator_{};
-	node_alloc_type nodeAllocator_{};
+	// Only the node allocator is kept, allocator_type is rebuilt from it on request.
+	NO_UNIQUE_ADDRESS node_alloc_type nodeAllocator_{};
 
 	Node* head_{ nullptr };
 	Node* tail_{ nullptr };
 	size_t size_{0};
+
+	// Mutable so the const lookups can count their walks too.
+	NO_UNIQUE_ADDRESS mutable ContainerStatsRecorder stats_;
 };
 
 
@@ -129,10 +171,13 @@ template<typename T, typename Allocator>
 class ConstSingleLinkedListIterator final
 {
 public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
 	using val_type = T;
-	using reference = T&;
+	using reference = const T&;
 	using const_reference = const T&;
-	using pointer = T*;
+	using pointer = const T*;
 
 	using Iterator = ConstSingleLinkedListIterator<T, Allocator>;
 	using Node = SingleLinkedListNode<T>;
@@ -141,9 +186,11 @@ public:
 	using my_list = SingleLinkedList<T, Allocator>;
 
 public:
+	ConstSingleLinkedListIterator() = default;
 	ConstSingleLinkedListIterator(const my_list* owner, NodePtr node) : owner_{ owner }, node_{ node } {}
 
 	const_reference operator*() const { return node_->value; }
+	pointer operator->() const { return &node_->value; }
 
 	Iterator& operator++() { node_ = node_->next; return *this; }
 	Iterator operator++(int) { Iterator old(owner_, node_); node_ = node_->next; return old; }
@@ -159,7 +206,7 @@ private:
 	const my_list* owner_{ nullptr };
 	NodePtr node_{ nullptr };
 
-	friend class my_list;
+	friend my_list;
 };
 
 
@@ -167,6 +214,9 @@ template<typename T, typename Allocator>
 class SingleLinkedListIterator final
 {
 public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
 	using val_type = T;
 	using reference = T&;
 	using const_reference = const T&;
@@ -179,10 +229,11 @@ public:
 	using my_list = SingleLinkedList<T, Allocator>;
 
 public:
+	SingleLinkedListIterator() = default;
 	SingleLinkedListIterator(const my_list* owner, NodePtr node) : owner_{ owner }, node_{ node } {}
 
-	reference operator*() { return node_->value; }
-	const_reference operator*() const { return node_->value; }
+	reference operator*() const { return node_->value; }
+	pointer operator->() const { return &node_->value; }
 
 	Iterator& operator++() { node_ = node_->next; return *this; }
 	Iterator operator++(int) { Iterator old(owner_, node_); node_ = node_->next; return old; }
@@ -198,7 +249,7 @@ private:
 	const my_list* owner_{ nullptr };
 	NodePtr node_{ nullptr };
 
-	friend class my_list;
+	friend my_list;
 };
 
 
@@ -224,15 +275,15 @@ constexpr bool SingleLinkedList<T, Allocator>::isInBound(size_t index) const noe
 
 
 template <typename T, typename Allocator>
-SingleLinkedList<T, Allocator>::SingleLinkedList(std::initializer_list<T> vals)
+SingleLinkedList<T, Allocator>::SingleLinkedList(std::initializer_list<T> vals, const Allocator& allocator)
+	: nodeAllocator_{ allocator }
 {
 	size_ = vals.size();
 	NodePtr previousNode = nullptr;
 
 	for (auto& val : vals)
 	{
-		NodePtr newNode = node_alloc_traits::allocate(nodeAllocator_, 1);
-		node_alloc_traits::construct(nodeAllocator_, newNode, val);
+		NodePtr newNode = allocateAndConstruct(val, nullptr);
 
 		if (head_ == nullptr)
 		{
@@ -253,6 +304,15 @@ SingleLinkedList<T, Allocator>::SingleLinkedList(std::initializer_list<T> vals)
 
 template <typename T, typename Allocator>
 SingleLinkedList<T, Allocator>::SingleLinkedList(const SingleLinkedList& other)
+	: nodeAllocator_{ node_alloc_traits::select_on_container_copy_construction(other.nodeAllocator_) }
+{
+	copyFromAnother(other);
+}
+
+
+template <typename T, typename Allocator>
+SingleLinkedList<T, Allocator>::SingleLinkedList(const SingleLinkedList& other, const Allocator& allocator)
+	: nodeAllocator_{ allocator }
 {
 	copyFromAnother(other);
 }
@@ -260,6 +320,7 @@ SingleLinkedList<T, Allocator>::SingleLinkedList(const SingleLinkedList& other)
 
 template <typename T, typename Allocator>
 SingleLinkedList<T, Allocator>::SingleLinkedList(SingleLinkedList&& other) noexcept
+	: nodeAllocator_{ other.nodeAllocator_ }
 {
 	moveFromAnother(std::move(other));
 }
@@ -290,8 +351,7 @@ template <typename T, typename Allocator>
 template <typename ValType>
 void SingleLinkedList<T, Allocator>::insertAtBeginning(ValType&& val)
 {
-	Node* newNode = new Node(std::forward<ValType>(val), head_);
-	head_ = newNode;
+	head_ = allocateAndConstruct(std::forward<ValType>(val), head_);
 
 	if (size_ == 0)
 	{
@@ -312,7 +372,18 @@ void SingleLinkedList<T, Allocator>::pushBack(const T& val)
 template <typename T, typename Allocator>
 void SingleLinkedList<T, Allocator>::pushBack(T&& val)
 {
-	insertAtEnd(val);
+	insertAtEnd(std::move(val));
+}
+
+
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+void SingleLinkedList<T, Allocator>::pushBackRange(InputIt first, InputIt last)
+{
+	for (; first != last; ++first)
+	{
+		insertAtEnd(*first);
+	}
 }
 
 
@@ -354,9 +425,7 @@ void SingleLinkedList<T, Allocator>::insertAtEnd(ValType&& val)
  * 2. Head != nullptr && Tail != nullptr
  */
 
-	Node* newNode = new Node;
-	newNode->value = std::forward<ValType>(val);
-	newNode->next = nullptr;
+	Node* newNode = allocateAndConstruct(std::forward<ValType>(val), nullptr);
 
 	/** case 1 */
 	if (head_ == nullptr && tail_ == nullptr)
@@ -435,6 +504,16 @@ SingleLinkedList<T, Allocator>& SingleLinkedList<T, Allocator>::operator=(const
 		return *this;
 	}
 
+	if constexpr (node_alloc_traits::propagate_on_container_copy_assignment::value)
+	{
+		// Our nodes have to go back to the allocator that made them before that one is replaced.
+		if (nodeAllocator_ != other.nodeAllocator_)
+		{
+			clear();
+		}
+		nodeAllocator_ = other.nodeAllocator_;
+	}
+
 	copyFromAnother(other);
 
 	return *this;
@@ -442,14 +521,33 @@ SingleLinkedList<T, Allocator>& SingleLinkedList<T, Allocator>::operator=(const
 
 
 template <typename T, typename Allocator>
-SingleLinkedList<T, Allocator>& SingleLinkedList<T, Allocator>::operator=(SingleLinkedList&& other) noexcept
+SingleLinkedList<T, Allocator>& SingleLinkedList<T, Allocator>::operator=(SingleLinkedList&& other) noexcept(bNothrowMoveAssign)
 {
+	/**
+	 * 1. the allocator propagates - free our nodes, take the other's allocator and nodes
+	 * 2. the allocators are equal - take the nodes
+	 * 3. they differ - move the values over
+	 */
+
 	if (this == &other)
 	{
 		return *this;
 	}
 
-	moveFromAnother(std::move(other));
+	if constexpr (node_alloc_traits::propagate_on_container_move_assignment::value)
+	{
+		clear();
+		nodeAllocator_ = std::move(other.nodeAllocator_);
+		moveFromAnother(std::move(other));
+	}
+	else if (node_alloc_traits::is_always_equal::value || nodeAllocator_ == other.nodeAllocator_)
+	{
+		moveFromAnother(std::move(other));
+	}
+	else
+	{
+		moveElementsFrom(std::move(other));
+	}
 
 	return *this;
 }
@@ -470,6 +568,8 @@ const typename SingleLinkedList<T, Allocator>::Node* SingleLinkedList<T, Allocat
 		return nullptr;
 	}
 
+	stats_.countWalk(index);
+
 	Node* node = head_;
 	for (size_t i = 0; i < index; ++i)
 	{
@@ -497,10 +597,13 @@ void SingleLinkedList<T, Allocator>::remove(Iterator where)
 	else
 	{
 		Node* previous = head_;
+		uint64 steps = 0;
 		while (previous && previous->next != nodeToDelete)
 		{
 			previous = previous->next;
+			++steps;
 		}
+		stats_.countWalk(steps);
 
 		if (previous && previous->next == nodeToDelete)
 		{
@@ -592,7 +695,7 @@ typename SingleLinkedList<T, Allocator>::ConstIterator SingleLinkedList<T, Alloc
 
 
 template <typename T, typename Allocator>
-void SingleLinkedList<T, Allocator>::copyFromAnother(const SingleLinkedList<T>& other)
+void SingleLinkedList<T, Allocator>::copyFromAnother(const SingleLinkedList& other)
 {
 	if (!isEmpty())
 	{
@@ -603,8 +706,7 @@ void SingleLinkedList<T, Allocator>::copyFromAnother(const SingleLinkedList<T>&
 	NodePtr previousNode = nullptr;
 	while (otherNode)
 	{
-		NodePtr newNode = node_alloc_traits::allocate(nodeAllocator_, 1);
-		node_alloc_traits::construct(nodeAllocator_, newNode, otherNode->value);
+		NodePtr newNode = allocateAndConstruct(otherNode->value, nullptr);
 
 		if (head_ == nullptr)
 		{
@@ -626,7 +728,7 @@ void SingleLinkedList<T, Allocator>::copyFromAnother(const SingleLinkedList<T>&
 
 
 template <typename T, typename Allocator>
-void SingleLinkedList<T, Allocator>::moveFromAnother(SingleLinkedList<T>&& other)
+void SingleLinkedList<T, Allocator>::moveFromAnother(SingleLinkedList&& other)
 {
 	if (!isEmpty())
 	{
@@ -639,3 +741,50 @@ void SingleLinkedList<T, Allocator>::moveFromAnother(SingleLinkedList<T>&& other
 }
 
 
+template <typename T, typename Allocator>
+template <typename ValType>
+typename SingleLinkedList<T, Allocator>::NodePtr SingleLinkedList<T, Allocator>::allocateAndConstruct(ValType&& val, NodePtr next)
+{
+	NodePtr node = node_alloc_traits::allocate(nodeAllocator_, 1);
+	node_alloc_traits::construct(nodeAllocator_, node, std::forward<ValType>(val), next);
+	stats_.countNodeAllocation();
+	return node;
+}
+
+
+template <typename T, typename Allocator>
+void SingleLinkedList<T, Allocator>::moveElementsFrom(SingleLinkedList&& other)
+{
+	clear();
+
+	for (NodePtr node = other.head_; node; node = node->next)
+	{
+		insertAtEnd(std::move(node->value));
+	}
+
+	other.clear();
+}
+
+
+template <typename T, typename Allocator>
+void SingleLinkedList<T, Allocator>::swap(SingleLinkedList& other) noexcept
+{
+	if constexpr (node_alloc_traits::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(nodeAllocator_, other.nodeAllocator_);
+	}
+	else
+	{
+		assert(nodeAllocator_ == other.nodeAllocator_);
+	}
+
+	std::swap(head_, other.head_);
+	std::swap(tail_, other.tail_);
+	std::swap(size_, other.size_);
+}
+
+
+/** SingleLinkedList drawing from a std::pmr::memory_resource. */
+template<typename T>
+using PmrSingleLinkedList = SingleLinkedList<T, std::pmr::polymorphic_allocator<T>>;
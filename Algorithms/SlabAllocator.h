@@ -0,0 +1,388 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "MyAllocator.h"
+#include "Types.h"
+
+/**
+ * Process-wide heap for small blocks, split into size classes (16 to 512 bytes).
+ *
+ * Every class carves fixed-size blocks out of 64 KiB spans. A free block is linked through its
+ * first word, so the lists cost no memory of their own. Each thread keeps a short free list per
+ * class and allocates and frees without any locking; only when that list runs dry or grows
+ * too long does it move a batch of blocks from or to the class's shared list, which is behind
+ * a mutex.
+ *
+ * A block may be freed by any thread, not only the one that allocated it: blocks of one class
+ * are interchangeable, and the freeing thread's list simply hands the surplus back to the shared
+ * list. A thread's cached blocks go back when the thread exits.
+ *
+ * Spans are never returned to the OS, and the heap itself is never destroyed. That way,
+ * containers in static storage can still free into it when the program ends.
+ */
+class SlabHeap final
+{
+public:
+	static constexpr size_t MaxSmallSize = 512;
+	static constexpr size_t BlockAlignment = 16;
+	static constexpr size_t SpanSize = 64 * 1024;
+
+	/** Blocks moved between a thread's list and the shared one at a time. */
+	static constexpr size_t BatchSize = 32;
+	static constexpr size_t MaxCachedBlocks = 2 * BatchSize;
+
+	static constexpr size_t ClassCount = 16;
+
+public:
+	static SlabHeap& instance();
+
+	SlabHeap(const SlabHeap&) = delete;
+	SlabHeap& operator=(const SlabHeap&) = delete;
+
+	/** `bytes` must not exceed MaxSmallSize. */
+	[[nodiscard]] void* allocate(size_t bytes);
+
+	/** `bytes` must be what was passed to allocate(). */
+	void deallocate(void* p, size_t bytes) noexcept;
+
+	/** Hands this thread's cached blocks back to the shared lists, as thread exit does. */
+	void flushThreadCache() noexcept;
+
+	static constexpr size_t classOf(size_t bytes) noexcept;
+	static constexpr size_t classSize(size_t sizeClass) noexcept { return ClassSizes[sizeClass]; }
+
+	/** Spans taken from the OS so far, over all classes. */
+	[[nodiscard]] size_t spanCount() const;
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	struct alignas(BlockAlignment) Span
+	{
+		Span* next;
+	};
+
+	struct alignas(CacheLineSize) SizeClass
+	{
+		std::mutex mutex;
+		FreeBlock* freeList{ nullptr };
+
+		// The part of the newest span nobody has taken yet.
+		std::byte* spanCursor{ nullptr };
+		std::byte* spanEnd{ nullptr };
+	};
+
+	struct ThreadCache
+	{
+		struct Bin
+		{
+			FreeBlock* head{ nullptr };
+			size_t count{ 0 };
+		};
+
+		Bin bins[ClassCount];
+
+		ThreadCache() noexcept;
+		~ThreadCache();
+	};
+
+	enum class CacheState : unsigned char { Unused, Alive, Dead };
+
+	static constexpr size_t ClassSizes[ClassCount] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512 };
+
+	SlabHeap() = default;
+
+	/** Null once the thread's cache is destroyed; blocks then go straight to the shared lists. */
+	static ThreadCache* threadCache() noexcept;
+
+	/** Takes up to `maxCount` blocks of the class, at least one. Returns how many. */
+	size_t fetch(size_t sizeClass, size_t maxCount, FreeBlock*& head);
+
+	/** Gives back the chain [head, tail]. */
+	void giveBack(size_t sizeClass, FreeBlock* head, FreeBlock* tail) noexcept;
+
+	/** Gives back the first `count` blocks of the bin. */
+	void drain(size_t sizeClass, ThreadCache::Bin& bin, size_t count) noexcept;
+
+private:
+	SizeClass classes_[ClassCount];
+
+	mutable std::mutex spansMutex_;
+	Span* spans_{ nullptr };
+	size_t spanCount_{ 0 };
+
+	// Trivially destructible, so it can still be read while the thread's destructors run.
+	static inline thread_local CacheState cacheState_{ CacheState::Unused };
+};
+
+
+/**
+ * Allocator for small objects drawing from SlabHeap; bigger or over-aligned requests go to
+ * MyAllocator. It holds no state, so any two instances are equal and memory may be freed by
+ * another thread than the one that allocated it.
+ *
+ * Meant for node-based containers, where every allocation has the same small size:
+ *   DoubleLinkedList<int, SlabAllocator<int>> list;
+ */
+template<typename T>
+struct SlabAllocator
+{
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	SlabAllocator() noexcept = default;
+
+	template<typename U>
+	SlabAllocator(const SlabAllocator<U>&) noexcept {}
+
+	[[nodiscard]] T* allocate(size_t n)
+	{
+		if (usesSlab(n))
+		{
+			return static_cast<T*>(SlabHeap::instance().allocate(n * sizeof(T)));
+		}
+		return MyAllocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		if (usesSlab(n))
+		{
+			SlabHeap::instance().deallocate(p, n * sizeof(T));
+			return;
+		}
+		MyAllocator<T>().deallocate(p, n);
+	}
+
+private:
+	static constexpr bool usesSlab(size_t n) noexcept
+	{
+		return alignof(T) <= SlabHeap::BlockAlignment && n <= SlabHeap::MaxSmallSize / sizeof(T);
+	}
+};
+
+template<typename T, typename U>
+constexpr bool operator==(const SlabAllocator<T>&, const SlabAllocator<U>&) noexcept
+{
+	return true;
+}
+
+
+inline SlabHeap& SlabHeap::instance()
+{
+	// Deliberately leaked, see the class comment.
+	static SlabHeap* heap = new SlabHeap;
+	return *heap;
+}
+
+constexpr size_t SlabHeap::classOf(size_t bytes) noexcept
+{
+	/**
+	 * 1. up to 128 bytes - steps of 16
+	 * 2. up to 256 bytes - steps of 32
+	 * 3. up to 512 bytes - steps of 64
+	 */
+
+	if (bytes <= 128)
+	{
+		return bytes == 0 ? 0 : (bytes - 1) / 16;
+	}
+	if (bytes <= 256)
+	{
+		return 7 + (bytes - 128 + 31) / 32;
+	}
+	return 11 + (bytes - 256 + 63) / 64;
+}
+
+inline SlabHeap::ThreadCache::ThreadCache() noexcept
+{
+	cacheState_ = CacheState::Alive;
+}
+
+inline SlabHeap::ThreadCache::~ThreadCache()
+{
+	SlabHeap& heap = instance();
+	for (size_t sizeClass = 0; sizeClass < ClassCount; ++sizeClass)
+	{
+		heap.drain(sizeClass, bins[sizeClass], bins[sizeClass].count);
+	}
+
+	cacheState_ = CacheState::Dead;
+}
+
+inline SlabHeap::ThreadCache* SlabHeap::threadCache() noexcept
+{
+	if (cacheState_ == CacheState::Dead)
+	{
+		return nullptr;
+	}
+
+	thread_local ThreadCache cache;
+	return &cache;
+}
+
+inline void* SlabHeap::allocate(size_t bytes)
+{
+	assert(bytes <= MaxSmallSize);
+
+	const size_t sizeClass = classOf(bytes);
+
+	ThreadCache* cache = threadCache();
+	if (!cache)
+	{
+		FreeBlock* block = nullptr;
+		fetch(sizeClass, 1, block);
+		return block;
+	}
+
+	ThreadCache::Bin& bin = cache->bins[sizeClass];
+	if (!bin.head)
+	{
+		bin.count = fetch(sizeClass, BatchSize, bin.head);
+	}
+
+	FreeBlock* block = bin.head;
+	bin.head = block->next;
+	--bin.count;
+
+	return block;
+}
+
+inline void SlabHeap::deallocate(void* p, size_t bytes) noexcept
+{
+	assert(bytes <= MaxSmallSize);
+
+	if (!p)
+	{
+		return;
+	}
+
+	const size_t sizeClass = classOf(bytes);
+	FreeBlock* block = static_cast<FreeBlock*>(p);
+
+	ThreadCache* cache = threadCache();
+	if (!cache)
+	{
+		giveBack(sizeClass, block, block);
+		return;
+	}
+
+	ThreadCache::Bin& bin = cache->bins[sizeClass];
+	block->next = bin.head;
+	bin.head = block;
+
+	if (++bin.count > MaxCachedBlocks)
+	{
+		drain(sizeClass, bin, BatchSize);
+	}
+}
+
+inline void SlabHeap::flushThreadCache() noexcept
+{
+	ThreadCache* cache = threadCache();
+	if (!cache)
+	{
+		return;
+	}
+
+	for (size_t sizeClass = 0; sizeClass < ClassCount; ++sizeClass)
+	{
+		drain(sizeClass, cache->bins[sizeClass], cache->bins[sizeClass].count);
+	}
+}
+
+inline size_t SlabHeap::spanCount() const
+{
+	std::lock_guard lock(spansMutex_);
+	return spanCount_;
+}
+
+inline size_t SlabHeap::fetch(size_t sizeClass, size_t maxCount, FreeBlock*& head)
+{
+	/**
+	 * 1. blocks somebody gave back
+	 * 2. fresh blocks from the current span
+	 * 3. nothing at all - a new span first
+	 */
+
+	SizeClass& shared = classes_[sizeClass];
+	const size_t blockSize = classSize(sizeClass);
+
+	std::lock_guard lock(shared.mutex);
+
+	size_t count = 0;
+	head = nullptr;
+
+	while (count < maxCount && shared.freeList)
+	{
+		FreeBlock* block = shared.freeList;
+		shared.freeList = block->next;
+
+		block->next = head;
+		head = block;
+		++count;
+	}
+
+	if (count == 0 && static_cast<size_t>(shared.spanEnd - shared.spanCursor) < blockSize)
+	{
+		void* memory = ::operator new(SpanSize);
+
+		{
+			std::lock_guard spansLock(spansMutex_);
+			spans_ = new (memory) Span{ spans_ };
+			++spanCount_;
+		}
+
+		shared.spanCursor = static_cast<std::byte*>(memory) + sizeof(Span);
+		shared.spanEnd = static_cast<std::byte*>(memory) + SpanSize;
+	}
+
+	while (count < maxCount && static_cast<size_t>(shared.spanEnd - shared.spanCursor) >= blockSize)
+	{
+		FreeBlock* block = new (shared.spanCursor) FreeBlock{ head };
+		shared.spanCursor += blockSize;
+
+		head = block;
+		++count;
+	}
+
+	return count;
+}
+
+inline void SlabHeap::giveBack(size_t sizeClass, FreeBlock* head, FreeBlock* tail) noexcept
+{
+	SizeClass& shared = classes_[sizeClass];
+
+	std::lock_guard lock(shared.mutex);
+	tail->next = shared.freeList;
+	shared.freeList = head;
+}
+
+inline void SlabHeap::drain(size_t sizeClass, ThreadCache::Bin& bin, size_t count) noexcept
+{
+	assert(count <= bin.count);
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	FreeBlock* head = bin.head;
+	FreeBlock* tail = head;
+	for (size_t i = 1; i < count; ++i)
+	{
+		tail = tail->next;
+	}
+
+	bin.head = tail->next;
+	bin.count -= count;
+
+	giveBack(sizeClass, head, tail);
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+#include "Types.h"
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * `head_` is written only by the consumer and `tail_` only by the producer; each sits on its own
+ * cache line so the two threads don't keep stealing the line from each other. Both indices grow
+ * forever and are mapped onto the power-of-two buffer with a mask.
+ *
+ * Each side also keeps a private copy of the other side's index (`cachedTail_`, `cachedHead_`)
+ * and rereads the shared one only when the copy says the queue is empty/full. While the queue is
+ * neither, push and pop touch no shared cache line except the slot itself.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class SpscQueue final
+{
+public:
+	using allocator_type = Allocator;
+	using alloc_traits = std::allocator_traits<Allocator>;
+	using pointer = typename alloc_traits::pointer;
+	using size_type = typename alloc_traits::size_type;
+
+public:
+	/** `capacity` is rounded up to a power of two. */
+	explicit SpscQueue(size_type capacity);
+	~SpscQueue();
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer side
+
+	bool tryPush(const T& val);
+	bool tryPush(T&& val);
+
+	template<typename... Args>
+	bool tryEmplace(Args&&... args);
+
+	/** Copies up to `count` elements from `first`, publishes them at once and returns how many fit. A throwing copy publishes the ones before it. */
+	template<typename InputIt>
+	size_type tryPushN(InputIt first, size_type count);
+
+	// Consumer side
+
+	bool tryPop(T& out);
+
+	/**
+	 * Moves up to `maxCount` elements to `out`, releases their slots at once and returns how many there were.
+	 * If `out` throws, the elements it already took are released and the rest stay queued.
+	 */
+	template<typename OutputIt>
+	size_type tryPopN(OutputIt out, size_type maxCount);
+
+	// Either side. Only a snapshot while the other side is running.
+
+	size_type sizeApprox() const noexcept;
+	bool isEmptyApprox() const noexcept { return sizeApprox() == 0; }
+
+	constexpr size_type capacity() const noexcept { return capacity_; }
+
+private:
+	static constexpr size_type roundUpToPowerOfTwo(size_type n) noexcept;
+
+	T* slot(size_type index) const noexcept { return std::to_address(data_ + (index & mask_)); }
+
+private:
+	// Consumer's line
+	alignas(CacheLineSize) std::atomic<size_type> head_{ 0 };
+	size_type cachedTail_{ 0 };
+
+	// Producer's line
+	alignas(CacheLineSize) std::atomic<size_type> tail_{ 0 };
+	size_type cachedHead_{ 0 };
+
+	// Read-only after construction
+	alignas(CacheLineSize) allocator_type allocator_{};
+	pointer data_{ nullptr };
+	size_type capacity_{ 0 };
+	size_type mask_{ 0 };
+};
+
+
+template <typename T, typename Allocator>
+constexpr typename SpscQueue<T, Allocator>::size_type SpscQueue<T, Allocator>::roundUpToPowerOfTwo(size_type n) noexcept
+{
+	size_type result = 1;
+	while (result < n)
+	{
+		result *= 2;
+	}
+	return result;
+}
+
+template <typename T, typename Allocator>
+SpscQueue<T, Allocator>::SpscQueue(size_type capacity)
+	: capacity_{ roundUpToPowerOfTwo(capacity) }
+{
+	assert(capacity > 0);
+
+	mask_ = capacity_ - 1;
+	data_ = alloc_traits::allocate(allocator_, capacity_);
+}
+
+template <typename T, typename Allocator>
+SpscQueue<T, Allocator>::~SpscQueue()
+{
+	size_type tail = tail_.load(std::memory_order_relaxed);
+	for (size_type i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+	{
+		alloc_traits::destroy(allocator_, slot(i));
+	}
+
+	alloc_traits::deallocate(allocator_, data_, capacity_);
+}
+
+template <typename T, typename Allocator>
+bool SpscQueue<T, Allocator>::tryPush(const T& val)
+{
+	return tryEmplace(val);
+}
+
+template <typename T, typename Allocator>
+bool SpscQueue<T, Allocator>::tryPush(T&& val)
+{
+	return tryEmplace(std::move(val));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+bool SpscQueue<T, Allocator>::tryEmplace(Args&&... args)
+{
+	const size_type tail = tail_.load(std::memory_order_relaxed);
+
+	if (tail - cachedHead_ == capacity_)
+	{
+		cachedHead_ = head_.load(std::memory_order_acquire);
+		if (tail - cachedHead_ == capacity_)
+		{
+			return false;
+		}
+	}
+
+	alloc_traits::construct(allocator_, slot(tail), std::forward<Args>(args)...);
+	tail_.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+template <typename T, typename Allocator>
+template <typename InputIt>
+typename SpscQueue<T, Allocator>::size_type SpscQueue<T, Allocator>::tryPushN(InputIt first, size_type count)
+{
+	const size_type tail = tail_.load(std::memory_order_relaxed);
+
+	size_type freeSlots = capacity_ - (tail - cachedHead_);
+	if (freeSlots < count)
+	{
+		cachedHead_ = head_.load(std::memory_order_acquire);
+		freeSlots = capacity_ - (tail - cachedHead_);
+	}
+
+	const size_type n = std::min(count, freeSlots);
+	size_type i = 0;
+	try
+	{
+		for (; i < n; ++i, ++first)
+		{
+			alloc_traits::construct(allocator_, slot(tail + i), *first);
+		}
+	}
+	catch (...)
+	{
+		// Publish the elements already built, or they would never be popped nor destroyed.
+		tail_.store(tail + i, std::memory_order_release);
+		throw;
+	}
+
+	if (n > 0)
+	{
+		tail_.store(tail + n, std::memory_order_release);
+	}
+
+	return n;
+}
+
+template <typename T, typename Allocator>
+bool SpscQueue<T, Allocator>::tryPop(T& out)
+{
+	const size_type head = head_.load(std::memory_order_relaxed);
+
+	if (head == cachedTail_)
+	{
+		cachedTail_ = tail_.load(std::memory_order_acquire);
+		if (head == cachedTail_)
+		{
+			return false;
+		}
+	}
+
+	T* element = slot(head);
+	out = std::move(*element);
+	alloc_traits::destroy(allocator_, element);
+
+	head_.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+template <typename T, typename Allocator>
+template <typename OutputIt>
+typename SpscQueue<T, Allocator>::size_type SpscQueue<T, Allocator>::tryPopN(OutputIt out, size_type maxCount)
+{
+	const size_type head = head_.load(std::memory_order_relaxed);
+
+	size_type available = cachedTail_ - head;
+	if (available < maxCount)
+	{
+		cachedTail_ = tail_.load(std::memory_order_acquire);
+		available = cachedTail_ - head;
+	}
+
+	const size_type n = std::min(maxCount, available);
+	size_type i = 0;
+	try
+	{
+		for (; i < n; ++i, ++out)
+		{
+			T* element = slot(head + i);
+			*out = std::move(*element);
+			alloc_traits::destroy(allocator_, element);
+		}
+	}
+	catch (...)
+	{
+		// Release the elements already destroyed; the one that failed stays in the queue.
+		head_.store(head + i, std::memory_order_release);
+		throw;
+	}
+
+	if (n > 0)
+	{
+		head_.store(head + n, std::memory_order_release);
+	}
+
+	return n;
+}
+
+template <typename T, typename Allocator>
+typename SpscQueue<T, Allocator>::size_type SpscQueue<T, Allocator>::sizeApprox() const noexcept
+{
+	const size_type head = head_.load(std::memory_order_acquire);
+	const size_type tail = tail_.load(std::memory_order_acquire);
+
+	// head is read first, so the tail we read can only be newer and never behind it.
+	return tail - head;
+}
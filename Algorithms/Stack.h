@@ -1,91 +1,153 @@
 #pragma once
-#include "SingleLinkedList.h"
-
-template <typename T>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "Vector.h"
+
+/**
+ * LIFO adaptor. `Container` must provide pushBack, popBack, back, isEmpty and size;
+ * the top of the stack is the back of the container. reserve and pushBackRange are used when they are there.
+ * Vector keeps the elements contiguous and allocates only when it doubles;
+ * DoubleLinkedList (or CompactList) can still be plugged in when stable element addresses matter.
+ */
+template<
+	typename T,
+	template<typename> typename Container = Vector
+>
 class Stack final
 {
+public:
+	using size_type = size_t;
+
 public:
 	Stack() = default;
 	Stack(std::initializer_list<T> vals);
-	Stack(const Stack<T>& other) = default;
-	Stack(Stack<T>&& other) noexcept = default;
+
+	/** The last element of the range ends up on top. */
+	template<std::input_iterator InputIt>
+	Stack(InputIt first, InputIt last);
+
+	Stack(const Stack& other) = default;
+	Stack(Stack&& other) noexcept = default;
 	~Stack() = default;
 
 	void push(const T& val);
 	void push(T&& val);
+
+	/** Pushes [first, last) in order, growing the storage once when the container allows it. */
+	template<std::input_iterator InputIt>
+	void pushRange(InputIt first, InputIt last);
+
 	void pop();
 
 	T& peek();
 	const T& peek() const;
 
-	constexpr size_t size() const noexcept;
+	/** Pre-allocates room for `n` elements if the container supports it, otherwise does nothing. */
+	void reserve(size_type n);
+
+	constexpr size_type size() const noexcept;
 	constexpr bool isEmpty() const noexcept;
 
-	Stack<T>& operator=(const Stack<T>& other);
-	Stack<T>& operator=(Stack<T>&& other) noexcept;
+	/** The underlying container's counters. */
+	ContainerStats stats() const noexcept { return data_.stats(); }
+	void resetStats() noexcept { data_.resetStats(); }
+
+	Stack& operator=(const Stack& other);
+	Stack& operator=(Stack&& other) noexcept(std::is_nothrow_move_assignable_v<Container<T>>);
 
 private:
-	SingleLinkedList<T> data_;
+	Container<T> data_;
 };
 
-template <typename T>
-constexpr size_t Stack<T>::size() const noexcept
+template<typename T, template<typename> typename Container>
+constexpr typename Stack<T, Container>::size_type Stack<T, Container>::size() const noexcept
 {
 	return data_.size();
 }
 
-template <typename T>
-constexpr bool Stack<T>::isEmpty() const noexcept
+template<typename T, template<typename> typename Container>
+constexpr bool Stack<T, Container>::isEmpty() const noexcept
 {
 	return data_.isEmpty();
 }
 
-template <typename T>
-Stack<T>::Stack(std::initializer_list<T> vals)
-// Cannot use since the order will be reversed
-	// : data_{vals}
+template<typename T, template<typename> typename Container>
+Stack<T, Container>::Stack(std::initializer_list<T> vals)
+	: Stack(vals.begin(), vals.end())
 {
-	// TODO: Make something like SingleLinkedList::assign
-	for (auto& val : vals)
-	{
-		push(val);
-	}
 }
 
-template <typename T>
-void Stack<T>::push(const T& val)
+template<typename T, template<typename> typename Container>
+template<std::input_iterator InputIt>
+Stack<T, Container>::Stack(InputIt first, InputIt last)
+{
+	pushRange(first, last);
+}
+
+template<typename T, template<typename> typename Container>
+void Stack<T, Container>::push(const T& val)
 {
-	data_.pushFront(val);
+	data_.pushBack(val);
 }
 
-template <typename T>
-void Stack<T>::push(T&& val)
+template<typename T, template<typename> typename Container>
+void Stack<T, Container>::push(T&& val)
 {
-	data_.pushFront(std::move(val));
+	data_.pushBack(std::move(val));
 }
 
-template <typename T>
-void Stack<T>::pop()
+template<typename T, template<typename> typename Container>
+template<std::input_iterator InputIt>
+void Stack<T, Container>::pushRange(InputIt first, InputIt last)
 {
-	data_.popFront();
+	// The top is the back, so appending in order is already the right order.
+	if constexpr (requires { data_.pushBackRange(first, last); })
+	{
+		data_.pushBackRange(first, last);
+	}
+	else
+	{
+		for (; first != last; ++first)
+		{
+			push(*first);
+		}
+	}
 }
 
-template <typename T>
-T& Stack<T>::peek()
+template<typename T, template<typename> typename Container>
+void Stack<T, Container>::pop()
 {
-	return data_.front();
+	data_.popBack();
 }
 
-template <typename T>
-const T& Stack<T>::peek() const
+template<typename T, template<typename> typename Container>
+T& Stack<T, Container>::peek()
 {
-	return data_.front();
+	return data_.back();
+}
+
+template<typename T, template<typename> typename Container>
+const T& Stack<T, Container>::peek() const
+{
+	return data_.back();
+}
+
+template<typename T, template<typename> typename Container>
+void Stack<T, Container>::reserve(size_type n)
+{
+	if constexpr (requires { data_.reserve(n); })
+	{
+		data_.reserve(n);
+	}
 }
 
-template <typename T>
-Stack<T>& Stack<T>::operator=(const Stack<T>& other)
+template<typename T, template<typename> typename Container>
+Stack<T, Container>& Stack<T, Container>::operator=(const Stack& other)
 {
-	// A little bit redundant, I guess, since SingleLinkedList check for this.
+	// A little bit redundant, I guess, since the containers check for this.
 	// But, just in case...
 	if (this == &other)
 	{
@@ -96,10 +158,10 @@ Stack<T>& Stack<T>::operator=(const Stack<T>& other)
 	return *this;
 }
 
-template <typename T>
-Stack<T>& Stack<T>::operator=(Stack<T>&& other) noexcept
+template<typename T, template<typename> typename Container>
+Stack<T, Container>& Stack<T, Container>::operator=(Stack&& other) noexcept(std::is_nothrow_move_assignable_v<Container<T>>)
 {
-	// A little bit redundant, I guess, since SingleLinkedList check for this.
+	// A little bit redundant, I guess, since the containers check for this.
 	// But, just in case...
 	if (this == &other)
 	{
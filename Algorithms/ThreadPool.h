@@ -0,0 +1,533 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "Queue.h"
+#include "Types.h"
+#include "Vector.h"
+#include "WorkStealingDeque.h"
+
+class TaskGroup;
+
+/**
+ * Fixed-size pool of worker threads, each with its own WorkStealingDeque.
+ *
+ * Work spawned on a worker goes to the bottom of that worker's deque and is run by it in LIFO
+ * order; idle workers steal from the top of the others. Work submitted from outside goes to a
+ * shared injection queue. Workers that find nothing anywhere sleep on a condition variable.
+ *
+ *   ThreadPool pool;
+ *   auto answer = pool.submit([] { return 42; });
+ *   pool.parallelFor(size_t{ 0 }, n, [&](size_t i) { out[i] = f(in[i]); });
+ *   pool.forEachWorker([&](size_t worker) { scan(part[worker]); });
+ *
+ *   TaskGroup group(pool);
+ *   group.run([&] { left = solve(a); });
+ *   right = solve(b);
+ *   group.wait();
+ */
+class ThreadPool final
+{
+public:
+	using size_type = size_t;
+
+public:
+	/** 0 means one thread per hardware thread. */
+	explicit ThreadPool(size_type threadCount = 0);
+
+	/** Runs everything that is still queued, then joins the workers. */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template<typename Fn>
+	[[nodiscard]] std::future<std::invoke_result_t<std::decay_t<Fn>>> submit(Fn&& fn);
+
+	/**
+	 * Calls fn(i) for every i in [first, last). The range is halved recursively down to `grain`
+	 * indices so idle workers steal big halves first. 0 picks a grain that gives each worker a few chunks.
+	 */
+	template<typename Index, typename Fn>
+	void parallelFor(Index first, Index last, Fn&& fn, Index grain = 0);
+
+	/**
+	 * Calls fn(worker) once on every worker, on that worker's own thread, and waits for all of them.
+	 * Nothing is stolen, so worker i always runs part i: use it when the same thread has to come back
+	 * to the same data, e.g. to read the pages it first touched on its NUMA node.
+	 */
+	template<typename Fn>
+	void forEachWorker(Fn&& fn);
+
+	size_type threadCount() const noexcept { return workers_.size(); }
+
+	/** Index of the calling worker of this pool, or NotAWorker. */
+	size_type currentWorker() const noexcept;
+
+	static constexpr size_type NotAWorker = static_cast<size_type>(-1);
+
+private:
+	friend class TaskGroup;
+
+	struct Task
+	{
+		virtual ~Task() = default;
+		virtual void run() = 0;
+	};
+
+	template<typename Fn>
+	struct FunctionTask final : Task
+	{
+		explicit FunctionTask(Fn&& fn) : fn_{ std::move(fn) } {}
+		void run() override { fn_(); }
+
+		Fn fn_;
+	};
+
+	struct Worker
+	{
+		WorkStealingDeque<Task*> deque;
+		std::thread thread;
+
+		/** Tasks only this worker may run, from forEachWorker. */
+		std::mutex pinnedMutex;
+		Queue<Task*> pinned;
+
+		/** Size of `pinned`, readable without the lock. Kept out of queued_ so other workers don't wait on it. */
+		std::atomic<size_type> pinnedQueued{ 0 };
+	};
+
+	template<typename Fn>
+	void spawn(Fn&& fn);
+
+	template<typename Fn>
+	void spawnOn(size_type worker, Fn&& fn);
+
+	void enqueue(Task* task);
+	void enqueueOn(size_type worker, Task* task);
+
+	Task* findTask(size_type self);
+
+	/** Runs one queued task if there is any. Used by waiters so they help instead of blocking. */
+	bool tryRunOne();
+
+	void workerLoop(size_type self);
+
+	template<typename Index, typename Fn>
+	void splitRange(TaskGroup& group, Index first, Index last, Fn& fn, Index grain);
+
+private:
+	struct CurrentWorker
+	{
+		const ThreadPool* pool;
+		size_type index;
+	};
+
+	static inline thread_local CurrentWorker current_{ nullptr, NotAWorker };
+
+	Vector<std::unique_ptr<Worker>> workers_;
+
+	std::mutex injectionMutex_;
+	Queue<Task*> injection_;
+
+	/** Stealable tasks queued somewhere but not taken yet. Sleepers wake up when it's non-zero. */
+	std::atomic<size_type> queued_{ 0 };
+
+	std::mutex sleepMutex_;
+	std::condition_variable wakeUp_;
+	std::atomic<size_type> sleepers_{ 0 };
+	std::atomic<bool> bStopping_{ false };
+};
+
+
+/**
+ * Fork/join on top of a ThreadPool. run() spawns, wait() returns when every spawned task has
+ * finished. A waiting thread runs queued tasks meanwhile, so nested groups on workers can't starve
+ * the pool. The first exception thrown by a task is rethrown from wait().
+ */
+class TaskGroup final
+{
+public:
+	explicit TaskGroup(ThreadPool& pool) : pool_{ pool } {}
+
+	/** Waiting here is a safety net: a group must not die while its tasks reference it. */
+	~TaskGroup() { waitForTasks(); }
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	template<typename Fn>
+	void run(Fn&& fn);
+
+	void wait();
+
+private:
+	friend class ThreadPool;
+
+	/** run() on the given worker only, for ThreadPool::forEachWorker. */
+	template<typename Fn>
+	void runOn(ThreadPool::size_type worker, Fn&& fn);
+
+	/** Wraps fn so that it counts itself done and hands any exception to wait(). */
+	template<typename Fn>
+	auto track(Fn&& fn);
+
+	void waitForTasks();
+
+private:
+	ThreadPool& pool_;
+
+	std::atomic<size_t> pending_{ 0 };
+
+	std::mutex exceptionMutex_;
+	std::exception_ptr exception_;
+};
+
+
+inline ThreadPool::ThreadPool(size_type threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max<size_type>(1, std::thread::hardware_concurrency());
+	}
+
+	workers_.reserve(threadCount);
+	for (size_type i = 0; i < threadCount; ++i)
+	{
+		workers_.pushBack(std::make_unique<Worker>());
+	}
+
+	// Only start once every deque exists, since workers steal from each other right away.
+	for (size_type i = 0; i < threadCount; ++i)
+	{
+		workers_[i]->thread = std::thread([this, i] { workerLoop(i); });
+	}
+}
+
+inline ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(sleepMutex_);
+		bStopping_.store(true);
+	}
+	wakeUp_.notify_all();
+
+	for (auto& worker : workers_)
+	{
+		worker->thread.join();
+	}
+}
+
+inline ThreadPool::size_type ThreadPool::currentWorker() const noexcept
+{
+	return current_.pool == this ? current_.index : NotAWorker;
+}
+
+template<typename Fn>
+std::future<std::invoke_result_t<std::decay_t<Fn>>> ThreadPool::submit(Fn&& fn)
+{
+	using Result = std::invoke_result_t<std::decay_t<Fn>>;
+
+	std::packaged_task<Result()> task(std::forward<Fn>(fn));
+	std::future<Result> future = task.get_future();
+
+	spawn(std::move(task));
+
+	return future;
+}
+
+template<typename Fn>
+void ThreadPool::spawn(Fn&& fn)
+{
+	enqueue(new FunctionTask<std::decay_t<Fn>>(std::forward<Fn>(fn)));
+}
+
+template<typename Fn>
+void ThreadPool::spawnOn(size_type worker, Fn&& fn)
+{
+	enqueueOn(worker, new FunctionTask<std::decay_t<Fn>>(std::forward<Fn>(fn)));
+}
+
+inline void ThreadPool::enqueue(Task* task)
+{
+	// Counted before it becomes visible, so a thief can't take it and decrement first.
+	queued_.fetch_add(1, std::memory_order_seq_cst);
+
+	const size_type self = currentWorker();
+	if (self != NotAWorker)
+	{
+		workers_[self]->deque.push(task);
+	}
+	else
+	{
+		std::lock_guard lock(injectionMutex_);
+		injection_.push(task);
+	}
+
+	/**
+	 * Pairs with workerLoop: it announces itself in sleepers_ and then rechecks queued_,
+	 * we bumped queued_ and then check sleepers_. Both seq_cst, so at least one of us sees the other
+	 * and the task can't be left behind with everybody asleep.
+	 */
+	if (sleepers_.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard lock(sleepMutex_);
+		wakeUp_.notify_one();
+	}
+}
+
+inline void ThreadPool::enqueueOn(size_type worker, Task* task)
+{
+	{
+		std::lock_guard lock(workers_[worker]->pinnedMutex);
+		workers_[worker]->pinned.push(task);
+		workers_[worker]->pinnedQueued.fetch_add(1, std::memory_order_seq_cst);
+	}
+
+	// Only one thread can run it, and notify_one might wake another.
+	if (sleepers_.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard lock(sleepMutex_);
+		wakeUp_.notify_all();
+	}
+}
+
+inline ThreadPool::Task* ThreadPool::findTask(size_type self)
+{
+	/**
+	 * 1. tasks pinned to us - nobody else will run them
+	 * 2. own deque, newest first - it's what we were just working on
+	 * 3. the injection queue - outside work shouldn't wait for all spawned work to finish
+	 * 4. steal the oldest task of another worker, starting with the next one so thieves spread out
+	 */
+
+	Task* task = nullptr;
+
+	if (self != NotAWorker)
+	{
+		Worker& worker = *workers_[self];
+		std::lock_guard lock(worker.pinnedMutex);
+		if (!worker.pinned.isEmpty())
+		{
+			task = worker.pinned.front();
+			worker.pinned.pop();
+			worker.pinnedQueued.fetch_sub(1, std::memory_order_relaxed);
+
+			// Pinned tasks never counted towards queued_.
+			return task;
+		}
+	}
+
+	if (!task && self != NotAWorker)
+	{
+		if (auto own = workers_[self]->deque.pop())
+		{
+			task = *own;
+		}
+	}
+
+	if (!task)
+	{
+		std::lock_guard lock(injectionMutex_);
+		if (!injection_.isEmpty())
+		{
+			task = injection_.front();
+			injection_.pop();
+		}
+	}
+
+	const size_type count = workers_.size();
+	const size_type start = self == NotAWorker ? 0 : self + 1;
+	for (size_type i = 0; !task && i < count; ++i)
+	{
+		const size_type victim = (start + i) % count;
+		if (victim == self)
+		{
+			continue;
+		}
+
+		if (auto stolen = workers_[victim]->deque.steal())
+		{
+			task = *stolen;
+		}
+	}
+
+	if (task)
+	{
+		queued_.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	return task;
+}
+
+inline bool ThreadPool::tryRunOne()
+{
+	Task* task = findTask(currentWorker());
+	if (!task)
+	{
+		return false;
+	}
+
+	task->run();
+	delete task;
+
+	return true;
+}
+
+inline void ThreadPool::workerLoop(size_type self)
+{
+	current_ = { this, self };
+
+	for (;;)
+	{
+		if (Task* task = findTask(self))
+		{
+			task->run();
+			delete task;
+			continue;
+		}
+
+		/**
+		 * A failed steal doesn't mean there's nothing left, only that somebody else was faster.
+		 * Tasks pinned to other workers aren't in queued_, we couldn't take them anyway.
+		 */
+		if (queued_.load(std::memory_order_relaxed) > 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::atomic<size_type>& pinnedQueued = workers_[self]->pinnedQueued;
+
+		std::unique_lock lock(sleepMutex_);
+		sleepers_.fetch_add(1, std::memory_order_seq_cst);
+		wakeUp_.wait(lock, [this, &pinnedQueued]
+		{
+			return bStopping_.load()
+				|| queued_.load(std::memory_order_seq_cst) > 0
+				|| pinnedQueued.load(std::memory_order_seq_cst) > 0;
+		});
+		sleepers_.fetch_sub(1, std::memory_order_relaxed);
+
+		if (bStopping_.load() && queued_.load() == 0 && pinnedQueued.load() == 0)
+		{
+			return;
+		}
+	}
+}
+
+template<typename Index, typename Fn>
+void ThreadPool::parallelFor(Index first, Index last, Fn&& fn, Index grain)
+{
+	if (first >= last)
+	{
+		return;
+	}
+
+	if (grain <= 0)
+	{
+		const Index chunks = static_cast<Index>(threadCount() * 4);
+		grain = std::max<Index>(1, (last - first) / chunks);
+	}
+
+	TaskGroup group(*this);
+	splitRange(group, first, last, fn, grain);
+	group.wait();
+}
+
+template<typename Fn>
+void ThreadPool::forEachWorker(Fn&& fn)
+{
+	TaskGroup group(*this);
+	for (size_type worker = 0; worker < workers_.size(); ++worker)
+	{
+		group.runOn(worker, [&fn, worker] { fn(worker); });
+	}
+	group.wait();
+}
+
+template<typename Index, typename Fn>
+void ThreadPool::splitRange(TaskGroup& group, Index first, Index last, Fn& fn, Index grain)
+{
+	// Hand the upper half to whoever steals it and keep halving the lower one ourselves.
+	while (last - first > grain)
+	{
+		const Index middle = first + (last - first) / 2;
+		group.run([this, &group, middle, last, &fn, grain] { splitRange(group, middle, last, fn, grain); });
+		last = middle;
+	}
+
+	for (Index i = first; i < last; ++i)
+	{
+		fn(i);
+	}
+}
+
+
+template<typename Fn>
+void TaskGroup::run(Fn&& fn)
+{
+	pending_.fetch_add(1, std::memory_order_relaxed);
+	pool_.spawn(track(std::forward<Fn>(fn)));
+}
+
+template<typename Fn>
+void TaskGroup::runOn(ThreadPool::size_type worker, Fn&& fn)
+{
+	pending_.fetch_add(1, std::memory_order_relaxed);
+	pool_.spawnOn(worker, track(std::forward<Fn>(fn)));
+}
+
+template<typename Fn>
+auto TaskGroup::track(Fn&& fn)
+{
+	return [this, task = std::forward<Fn>(fn)]() mutable
+	{
+		try
+		{
+			task();
+		}
+		catch (...)
+		{
+			std::lock_guard lock(exceptionMutex_);
+			if (!exception_)
+			{
+				exception_ = std::current_exception();
+			}
+		}
+
+		// The last touch of the group: once it reaches zero, wait() may return and the group may be gone.
+		pending_.fetch_sub(1, std::memory_order_release);
+	};
+}
+
+inline void TaskGroup::waitForTasks()
+{
+	while (pending_.load(std::memory_order_acquire) > 0)
+	{
+		if (!pool_.tryRunOne())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+inline void TaskGroup::wait()
+{
+	waitForTasks();
+
+	std::lock_guard lock(exceptionMutex_);
+	if (exception_)
+	{
+		std::rethrow_exception(std::exchange(exception_, nullptr));
+	}
+}
@@ -1,5 +1,19 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 using int64 = int64_t;
-using uint64 = uint64_t;
\ No newline at end of file
+using int8 = int8_t;
+using uint64 = uint64_t;
+using uint32 = uint32_t;
+using uint8 = uint8_t;
+
+// Keeping data written by different threads this far apart stops them from sharing a cache line.
+inline constexpr size_t CacheLineSize = 64;
+
+// Lets an empty member, such as a stateless allocator, take no space. MSVC only honours its own spelling.
+#if defined(_MSC_VER)
+#define NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
@@ -1,8 +1,15 @@
 #pragma once
 #include <algorithm>
 #include <cassert>
+#include <compare>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "ContainerStats.h"
+#include "Types.h"
 
 
 template<typename T, typename Allocator = std::allocator<T>>
@@ -12,18 +19,39 @@ template<typename T, typename Allocator>
 class ConstVectorIterator final
 {
 public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
 	using val_type = T;
-	using reference = T&;
+	using reference = const T&;
 	using const_reference = const T&;
-	using pointer = T*;
+	using pointer = const T*;
 	using const_iterator = ConstVectorIterator<T, Allocator>;
-	using my_vector = Vector<T>;
-	ConstVectorIterator(const my_vector* owner, const pointer ptr) :owner_{owner}, ptr_ { ptr } {}
+	using my_vector = Vector<T, Allocator>;
+
+	ConstVectorIterator() = default;
+	ConstVectorIterator(const my_vector* owner, pointer ptr) : owner_{ owner }, ptr_{ ptr } {}
 
-	const_reference operator*() const { return *ptr_; }
+	reference operator*() const { return *ptr_; }
+	pointer operator->() const { return ptr_; }
+	reference operator[](difference_type n) const { return ptr_[n]; }
 
 	const_iterator& operator++() { ++ptr_; return *this; }
 	const_iterator operator++(int) { const_iterator tmp = *this; ++ptr_; return tmp; }
+	const_iterator& operator--() { --ptr_; return *this; }
+	const_iterator operator--(int) { const_iterator tmp = *this; --ptr_; return tmp; }
+
+	const_iterator& operator+=(difference_type n) { ptr_ += n; return *this; }
+	const_iterator& operator-=(difference_type n) { ptr_ -= n; return *this; }
+	friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+	friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+	friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+
+	difference_type operator-(const const_iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return ptr_ - other.ptr_;
+	}
 
 	constexpr bool operator==(const const_iterator& other) const
 	{
@@ -32,29 +60,57 @@ public:
 	}
 	constexpr bool operator!=(const const_iterator& other) const { return !(*this == other); }
 
+	constexpr auto operator<=>(const const_iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return ptr_ <=> other.ptr_;
+	}
+
 private:
 	const my_vector* owner_{ nullptr };
-	const T* ptr_{ nullptr };
+	pointer ptr_{ nullptr };
 };
 
 template<typename T, typename Allocator>
 class VectorIterator final
 {
 public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
 	using val_type = T;
 	using reference = T&;
 	using const_reference = const T&;
 	using pointer = T*;
 	using iterator = VectorIterator<T, Allocator>;
-	using my_vector = Vector<T>;
+	using my_vector = Vector<T, Allocator>;
 
+	VectorIterator() = default;
 	VectorIterator(const my_vector* owner, pointer ptr) : owner_(owner), ptr_{ ptr } {}
 
-	reference operator*() { return *ptr_; }
-	const_reference operator*() const { return *ptr_; }
+	/** Iterators convert to const iterators. */
+	operator ConstVectorIterator<T, Allocator>() const { return ConstVectorIterator<T, Allocator>(owner_, ptr_); }
+
+	reference operator*() const { return *ptr_; }
+	pointer operator->() const { return ptr_; }
+	reference operator[](difference_type n) const { return ptr_[n]; }
 
 	iterator& operator++() { ++ptr_; return *this; } // Pre-increment
 	iterator operator++(int) { iterator tmp = *this; ++ptr_; return tmp; } // Post-increment
+	iterator& operator--() { --ptr_; return *this; }
+	iterator operator--(int) { iterator tmp = *this; --ptr_; return tmp; }
+
+	iterator& operator+=(difference_type n) { ptr_ += n; return *this; }
+	iterator& operator-=(difference_type n) { ptr_ -= n; return *this; }
+	friend iterator operator+(iterator it, difference_type n) { return it += n; }
+	friend iterator operator+(difference_type n, iterator it) { return it += n; }
+	friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+
+	difference_type operator-(const iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return ptr_ - other.ptr_;
+	}
 
 	constexpr bool operator==(const iterator& other) const
 	{
@@ -62,6 +118,13 @@ public:
 		return ptr_ == other.ptr_;
 	}
 	constexpr bool operator!=(const iterator& other) const { return !(*this == other); }
+
+	constexpr auto operator<=>(const iterator& other) const
+	{
+		assert(owner_ == other.owner_);
+		return ptr_ <=> other.ptr_;
+	}
+
 private:
 	const my_vector* owner_{ nullptr };
 	pointer ptr_{ nullptr };
@@ -76,19 +139,32 @@ public:
 
 	using allocator_type = Allocator;
 	using alloc_traits = std::allocator_traits<Allocator>;
+
+	static constexpr bool bNothrowMoveAssign = alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value;
 	using pointer = typename alloc_traits::pointer;
 	using size_type = typename alloc_traits::size_type;
 
 public:
 	Vector() = default;
-	Vector(std::initializer_list<T> vals);
+	explicit Vector(const Allocator& allocator) : allocator_{ allocator } {}
+	Vector(std::initializer_list<T> vals, const Allocator& allocator = Allocator());
 	~Vector();
 
-	Vector(const Vector<T>& other);
-	Vector(Vector<T>&& other) noexcept;
+	/** The copy gets the allocator that select_on_container_copy_construction picks. */
+	Vector(const Vector& other);
+	Vector(const Vector& other, const Allocator& allocator);
+	Vector(Vector&& other) noexcept;
 
-	Vector& operator=(const Vector<T>& other);
-	Vector& operator=(Vector<T>&& other) noexcept;
+	/**
+	 * Assignments follow the allocator's propagate_on_container_* traits. When a move can't take
+	 * the allocator along and the two allocators differ, the elements are moved one by one into
+	 * storage of our own allocator.
+	 */
+	Vector& operator=(const Vector& other);
+	Vector& operator=(Vector&& other) noexcept(bNothrowMoveAssign);
+
+	/** Allocators are swapped only if they propagate on swap; otherwise they must be equal. */
+	void swap(Vector& other) noexcept;
 
 	void pushFront(const T& val);
 	void pushFront(T&& val);
@@ -96,6 +172,10 @@ public:
 	void pushBack(const T& val);
 	void pushBack(T&& val);
 
+	/** Appends [first, last) in order. For forward iterators the storage grows once up front. */
+	template<std::input_iterator InputIt>
+	void pushBackRange(InputIt first, InputIt last);
+
 	void popFront();
 	void popBack();
 
@@ -110,12 +190,28 @@ public:
 	T& operator[](size_type i);
 	const T& operator[](size_type i) const;
 
+	T& front();
+	const T& front() const;
+
+	T& back();
+	const T& back() const;
+
+	/** Start of the storage; the capacity() - size() slots past the end are allocated but hold no elements. */
+	T* data() noexcept { return data_; }
+	const T* data() const noexcept { return data_; }
+
 	Iterator begin();
 	Iterator end();
 
 	ConstIterator begin() const;
 	ConstIterator end() const;
 
+	allocator_type getAllocator() const { return allocator_; }
+
+	/** Growths and element moves so far; zeros unless built with ALGORITHMS_ENABLE_STATS. */
+	ContainerStats stats() const noexcept { return stats_.snapshot(); }
+	void resetStats() noexcept { stats_.reset(); }
+
 private:
 	void inflate();
 
@@ -127,16 +223,23 @@ private:
 
 	constexpr bool isInBounds(size_type i) const noexcept;
 
-	void copyFromAnother(const Vector<T>& other);
-	void moveFromAnother(Vector<T>&& other);
+	void copyFromAnother(const Vector& other);
+
+	/** Takes the storage of `other`. Our allocator must be able to free it. */
+	void moveFromAnother(Vector&& other);
+
+	/** Moves the elements of `other` into our own storage, for allocators that can't share it. */
+	void moveElementsFrom(Vector&& other);
 
 private:
-	allocator_type allocator_{};
+	NO_UNIQUE_ADDRESS allocator_type allocator_{};
 
 	pointer data_{nullptr};
 
 	size_type size_{0};
 	size_type capacity_{ 0 };
+
+	NO_UNIQUE_ADDRESS ContainerStatsRecorder stats_;
 };
 
 template <typename T, typename Allocator>
@@ -147,7 +250,8 @@ constexpr bool Vector<T, Allocator>::isInBounds(size_type i) const noexcept
 
 
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(std::initializer_list<T> vals)
+Vector<T, Allocator>::Vector(std::initializer_list<T> vals, const Allocator& allocator)
+	: allocator_{ allocator }
 {
 	size_ = vals.size();
 	capacity_ = size_;
@@ -170,20 +274,39 @@ Vector<T, Allocator>::~Vector()
 
 
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const Vector<T>& other)
+Vector<T, Allocator>::Vector(const Vector& other)
+	: allocator_{ alloc_traits::select_on_container_copy_construction(other.allocator_) }
+{
+	copyFromAnother(other);
+}
+
+
+template <typename T, typename Allocator>
+Vector<T, Allocator>::Vector(const Vector& other, const Allocator& allocator)
+	: allocator_{ allocator }
 {
 	copyFromAnother(other);
 }
 
 
 template <typename T, typename Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector<T>& other)
+Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector& other)
 {
 	if (this == &other)
 	{
 		return *this;
 	}
 
+	if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+	{
+		// Our storage has to go back to the allocator that made it before that one is replaced.
+		if (allocator_ != other.allocator_)
+		{
+			reset();
+		}
+		allocator_ = other.allocator_;
+	}
+
 	copyFromAnother(other);
 
 	return *this;
@@ -191,21 +314,41 @@ Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector<T>& other)
 
 
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(Vector<T>&& other) noexcept
+Vector<T, Allocator>::Vector(Vector&& other) noexcept
+	: allocator_{ other.allocator_ }
 {
 	moveFromAnother(std::move(other));
 }
 
 
 template <typename T, typename Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector<T>&& other) noexcept
+Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector&& other) noexcept(bNothrowMoveAssign)
 {
+	/**
+	 * 1. the allocator propagates - free ours, take the other's allocator and storage
+	 * 2. the allocators are equal - take the storage
+	 * 3. they differ - move the elements over
+	 */
+
 	if (this == &other)
 	{
 		return *this;
 	}
 
-	moveFromAnother(std::move(other));
+	if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+	{
+		reset();
+		allocator_ = std::move(other.allocator_);
+		moveFromAnother(std::move(other));
+	}
+	else if (alloc_traits::is_always_equal::value || allocator_ == other.allocator_)
+	{
+		moveFromAnother(std::move(other));
+	}
+	else
+	{
+		moveElementsFrom(std::move(other));
+	}
 
 	return *this;
 }
@@ -227,6 +370,10 @@ template <typename T, typename Allocator>
 template <typename ValType>
 void Vector<T, Allocator>::insertAtBeginning(ValType&& val)
 {
+	// `val` may be one of our own elements (v.pushFront(v.back())): both growing and the shift
+	// below move it away, so build the value first.
+	T value(std::forward<ValType>(val));
+
 	const bool bHasEnoughCapacity = size_ + 1 <= capacity_;
 	if (!bHasEnoughCapacity)
 	{
@@ -237,6 +384,8 @@ void Vector<T, Allocator>::insertAtBeginning(ValType&& val)
 	/*
 	* std::move_backward(data_, data_ + size_, data_ + size_ + 1);
 	*/
+	stats_.countRelocations(size_);
+
 	for (size_type i = size_; i > 0; --i)
 	{
 		/*
@@ -254,7 +403,7 @@ void Vector<T, Allocator>::insertAtBeginning(ValType&& val)
 		alloc_traits::destroy(allocator_, &data_[i - 1]); 
 	}
 
-	alloc_traits::construct(allocator_, &data_[0], std::forward<ValType>(val));
+	alloc_traits::construct(allocator_, &data_[0], std::move(value));
 
 	++size_;
 }
@@ -273,13 +422,40 @@ void Vector<T, Allocator>::pushBack(T&& val)
 	insertAtEnd(std::move(val));
 }
 
+
+template <typename T, typename Allocator>
+template <std::input_iterator InputIt>
+void Vector<T, Allocator>::pushBackRange(InputIt first, InputIt last)
+{
+	if constexpr (std::forward_iterator<InputIt>)
+	{
+		const size_type needed = size_ + static_cast<size_type>(std::distance(first, last));
+		if (needed > capacity_)
+		{
+			// Keep doubling, or a loop of small ranges would reallocate on every call.
+			reserve(std::max(needed, capacity_ * 2));
+		}
+	}
+
+	for (; first != last; ++first)
+	{
+		insertAtEnd(*first);
+	}
+}
+
 template <typename T, typename Allocator>
 template <typename ValType>
 void Vector<T, Allocator>::insertAtEnd(ValType&& val)
 {
 	if (size_ >= capacity_)
 	{
+		// `val` may be one of our own elements (v.pushBack(v.front())), and inflating frees it,
+		// so build the value before growing.
+		T value(std::forward<ValType>(val));
 		inflate();
+		alloc_traits::construct(allocator_, &data_[size_], std::move(value));
+		size_++;
+		return;
 	}
 
 	alloc_traits::construct(allocator_, &data_[size_], std::forward<ValType>(val));
@@ -298,13 +474,16 @@ void Vector<T, Allocator>::popFront()
 
 	assert(!isEmpty());
 
-	alloc_traits::destroy(allocator_, &data_[0]);
+	stats_.countRelocations(size_ - 1);
 
+	// Shift over the front, then destroy the moved-from last slot: the front itself is still
+	// alive when the next element is moved into it.
 	for (size_type i = 0; i < size_ - 1; ++i)
 	{
 		data_[i] = std::move(data_[i + 1]);
 	}
 
+	alloc_traits::destroy(allocator_, &data_[size_ - 1]);
 	--size_;
 }
 
@@ -312,7 +491,7 @@ void Vector<T, Allocator>::popFront()
 template <typename T, typename Allocator>
 void Vector<T, Allocator>::popBack()
 {
-	assert(isInBounds(size_ - 1));
+	assert(!isEmpty());
 	alloc_traits::destroy(allocator_, &data_[size_ - 1]);
 	--size_;
 }
@@ -326,7 +505,10 @@ void Vector<T, Allocator>::reset()
 		alloc_traits::destroy(allocator_, &data_[i]);
 	}
 
-	alloc_traits::deallocate(allocator_, data_, capacity_);
+	if (data_)
+	{
+		alloc_traits::deallocate(allocator_, data_, capacity_);
+	}
 
 	data_ = nullptr;
 
@@ -356,6 +538,36 @@ const T& Vector<T, Allocator>::operator[](size_type i) const
 	return data_[i];
 }
 
+
+template <typename T, typename Allocator>
+T& Vector<T, Allocator>::front()
+{
+	return const_cast<T&>(static_cast<const Vector&>(*this).front());
+}
+
+
+template <typename T, typename Allocator>
+const T& Vector<T, Allocator>::front() const
+{
+	assert(!isEmpty());
+	return data_[0];
+}
+
+
+template <typename T, typename Allocator>
+T& Vector<T, Allocator>::back()
+{
+	return const_cast<T&>(static_cast<const Vector&>(*this).back());
+}
+
+
+template <typename T, typename Allocator>
+const T& Vector<T, Allocator>::back() const
+{
+	assert(!isEmpty());
+	return data_[size_ - 1];
+}
+
 template <typename T, typename Allocator>
 typename Vector<T, Allocator>::Iterator Vector<T, Allocator>::begin()
 {
@@ -404,7 +616,7 @@ void Vector<T, Allocator>::inflate()
 template<typename T, typename Allocator>
 void Vector<T, Allocator>::reserve(size_type n)
 {
-	if (n < capacity_)
+	if (n <= capacity_)
 	{
 		return;
 	}
@@ -415,6 +627,8 @@ void Vector<T, Allocator>::reserve(size_type n)
 
 	data_ = alloc_traits::allocate(allocator_, n);
 
+	stats_.countReallocation(size_);
+
 	for (size_type i = 0; i < size_; ++i)
 	{
 		alloc_traits::construct(allocator_, &data_[i], std::move(oldData[i]));
@@ -428,12 +642,15 @@ void Vector<T, Allocator>::reserve(size_type n)
 	}
 
 	capacity_ = n;
-	alloc_traits::deallocate(allocator_, oldData, oldCapacity);
+	if (oldData)
+	{
+		alloc_traits::deallocate(allocator_, oldData, oldCapacity);
+	}
 }
 
 
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::copyFromAnother(const Vector<T>& other)
+void Vector<T, Allocator>::copyFromAnother(const Vector& other)
 {
 	reset();
 
@@ -450,7 +667,7 @@ void Vector<T, Allocator>::copyFromAnother(const Vector<T>& other)
 
 
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::moveFromAnother(Vector<T>&& other)
+void Vector<T, Allocator>::moveFromAnother(Vector&& other)
 {
 	reset();
 
@@ -464,3 +681,42 @@ void Vector<T, Allocator>::moveFromAnother(Vector<T>&& other)
 	other.data_ = nullptr;
 }
 
+
+template <typename T, typename Allocator>
+void Vector<T, Allocator>::moveElementsFrom(Vector&& other)
+{
+	reset();
+	reserve(other.size_);
+
+	for (size_type i = 0; i < other.size_; ++i)
+	{
+		alloc_traits::construct(allocator_, &data_[i], std::move(other.data_[i]));
+	}
+	size_ = other.size_;
+
+	other.reset();
+}
+
+
+template <typename T, typename Allocator>
+void Vector<T, Allocator>::swap(Vector& other) noexcept
+{
+	if constexpr (alloc_traits::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(allocator_, other.allocator_);
+	}
+	else
+	{
+		assert(allocator_ == other.allocator_);
+	}
+
+	std::swap(data_, other.data_);
+	std::swap(size_, other.size_);
+	std::swap(capacity_, other.capacity_);
+}
+
+
+/** Vector drawing from a std::pmr::memory_resource. */
+template<typename T>
+using PmrVector = Vector<T, std::pmr::polymorphic_allocator<T>>;
@@ -0,0 +1,210 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <optional>
+#include <type_traits>
+
+#include "Types.h"
+#include "Vector.h"
+
+/**
+ * Chase-Lev work-stealing deque (with the memory orders of Le et al., "Correct and Efficient
+ * Work-Stealing for Weak Memory Models").
+ *
+ * The owner thread pushes and pops at the bottom like a stack, so it keeps working on the most
+ * recent (cache-hot) item. Any other thread may steal from the top, i.e. the oldest item, which
+ * for recursive work is the biggest chunk. The owner only needs an atomic read-modify-write when
+ * it races a thief for the very last item.
+ *
+ * The circular array grows when full. A thief may still be reading the old one, so old arrays
+ * are retired rather than freed and only go away with the deque. Elements are copied in and out
+ * of atomics, hence T has to be trivially copyable (typically a pointer to a task).
+ */
+template<typename T>
+class WorkStealingDeque final
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Elements are read by thieves racing the owner, they must be trivially copyable.");
+
+public:
+	using size_type = size_t;
+
+public:
+	/** `capacity` is rounded up to a power of two. */
+	explicit WorkStealingDeque(size_type capacity = 64);
+	~WorkStealingDeque();
+
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	// Owner thread only
+
+	void push(T val);
+	std::optional<T> pop();
+
+	// Any thread
+
+	/** Empty when the deque is empty or when another thread took the item first. */
+	std::optional<T> steal();
+
+	/** Only a snapshot while other threads are running. */
+	size_type sizeApprox() const noexcept;
+	bool isEmptyApprox() const noexcept { return sizeApprox() == 0; }
+
+	size_type capacity() const noexcept { return array_.load(std::memory_order_relaxed)->capacity(); }
+
+private:
+	class Array final
+	{
+	public:
+		explicit Array(size_type capacity) : slots_{ new std::atomic<T>[capacity] }, mask_{ capacity - 1 } {}
+		~Array() { delete[] slots_; }
+
+		Array(const Array&) = delete;
+		Array& operator=(const Array&) = delete;
+
+		size_type capacity() const noexcept { return mask_ + 1; }
+
+		T get(int64 i) const noexcept { return slots_[i & mask_].load(std::memory_order_relaxed); }
+		void put(int64 i, T val) noexcept { slots_[i & mask_].store(val, std::memory_order_relaxed); }
+
+		/** Copies the live range [top, bottom) into an array twice as big. */
+		Array* grow(int64 top, int64 bottom) const;
+
+	private:
+		std::atomic<T>* slots_;
+		size_type mask_;
+	};
+
+private:
+	// Written by the owner, read by thieves
+	alignas(CacheLineSize) std::atomic<int64> bottom_{ 0 };
+	std::atomic<Array*> array_{ nullptr };
+
+	// Written by whoever takes the top item
+	alignas(CacheLineSize) std::atomic<int64> top_{ 0 };
+
+	// Owner only
+	alignas(CacheLineSize) Vector<Array*> retired_;
+};
+
+
+template<typename T>
+typename WorkStealingDeque<T>::Array* WorkStealingDeque<T>::Array::grow(int64 top, int64 bottom) const
+{
+	Array* bigger = new Array(capacity() * 2);
+	for (int64 i = top; i < bottom; ++i)
+	{
+		bigger->put(i, get(i));
+	}
+	return bigger;
+}
+
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_type capacity)
+{
+	size_type roundedCapacity = 1;
+	while (roundedCapacity < capacity)
+	{
+		roundedCapacity *= 2;
+	}
+
+	array_.store(new Array(roundedCapacity), std::memory_order_relaxed);
+}
+
+template<typename T>
+WorkStealingDeque<T>::~WorkStealingDeque()
+{
+	delete array_.load(std::memory_order_relaxed);
+
+	for (Array* array : retired_)
+	{
+		delete array;
+	}
+}
+
+template<typename T>
+void WorkStealingDeque<T>::push(T val)
+{
+	const int64 bottom = bottom_.load(std::memory_order_relaxed);
+	const int64 top = top_.load(std::memory_order_acquire);
+	Array* array = array_.load(std::memory_order_relaxed);
+
+	if (bottom - top > static_cast<int64>(array->capacity()) - 1)
+	{
+		retired_.pushBack(array);
+		array = array->grow(top, bottom);
+		array_.store(array, std::memory_order_release);
+	}
+
+	array->put(bottom, val);
+	bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::pop()
+{
+	/**
+	 * Claim the bottom item first, then look at top. Both must be sequentially consistent:
+	 * a thief does the same in the opposite order, so at least one of us sees the other.
+	 *
+	 * 1. more than one item left - no thief can reach ours, take it
+	 * 2. exactly one item left - race the thieves for it with a CAS on top
+	 * 3. empty - undo the claim
+	 */
+
+	const int64 bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	Array* array = array_.load(std::memory_order_relaxed);
+	bottom_.store(bottom, std::memory_order_seq_cst);
+	int64 top = top_.load(std::memory_order_seq_cst);
+
+	if (top > bottom)
+	{
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+
+	std::optional<T> result = array->get(bottom);
+
+	if (top == bottom)
+	{
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			result.reset();
+		}
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return result;
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::steal()
+{
+	int64 top = top_.load(std::memory_order_seq_cst);
+	const int64 bottom = bottom_.load(std::memory_order_seq_cst);
+
+	if (top >= bottom)
+	{
+		return std::nullopt;
+	}
+
+	// Acquire pairs with the release in push, so the array we read is the one the item is in.
+	Array* array = array_.load(std::memory_order_acquire);
+	T val = array->get(top);
+
+	if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return std::nullopt;
+	}
+
+	return val;
+}
+
+template<typename T>
+typename WorkStealingDeque<T>::size_type WorkStealingDeque<T>::sizeApprox() const noexcept
+{
+	const int64 top = top_.load(std::memory_order_acquire);
+	const int64 bottom = bottom_.load(std::memory_order_acquire);
+
+	return bottom > top ? static_cast<size_type>(bottom - top) : 0;
+}
@@ -0,0 +1,628 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <iterator>
+#include <utility>
+
+#include "Types.h"
+#include "Vector.h"
+
+/**
+ * Recording what a program does to a container, and doing it again offline to any other container.
+ *
+ * A TracedContainer sits where the real container was and writes every operation into a
+ * WorkloadTrace; save() puts the trace in a file. replayTrace() later applies the same
+ * operations to whichever container is being evaluated, ours or std's, so backends can be
+ * benchmarked on recorded production behaviour instead of a synthetic loop.
+ */
+
+enum class TraceOp : uint8
+{
+	/** The argument of a push is the element's size: size() where it has one, sizeof otherwise. */
+	PushBack,
+	PushFront,
+	PopBack,
+	PopFront,
+
+	/** Reads the element at the index in the argument. */
+	Get,
+
+	/** Reads the first `argument` elements in order. */
+	Iterate,
+
+	Clear,
+
+	Count
+};
+
+struct TraceEvent
+{
+	TraceOp op{ TraceOp::Clear };
+	uint64 argument{ 0 };
+
+	friend constexpr bool operator==(const TraceEvent&, const TraceEvent&) = default;
+};
+
+constexpr bool traceOpHasArgument(TraceOp op) noexcept
+{
+	return op == TraceOp::PushBack || op == TraceOp::PushFront || op == TraceOp::Get || op == TraceOp::Iterate;
+}
+
+
+/**
+ * The recorded operations, encoded as one byte for the operation followed, for those that have
+ * one, by the argument as a LEB128 varint. Pops take one byte, small pushes and lookups two or
+ * three, so a trace of millions of operations stays a few megabytes.
+ *
+ * File layout, all integers little-endian: the magic "ATRC", a format version byte, the event
+ * count and the byte count (8 bytes each), then the encoded events.
+ */
+class WorkloadTrace final
+{
+public:
+	using size_type = size_t;
+
+	static constexpr uint8 FormatVersion = 1;
+
+public:
+	void record(TraceOp op, uint64 argument = 0);
+
+	/** Calls `fn(TraceEvent)` for every event, oldest first. */
+	template<typename Fn>
+	void forEach(Fn&& fn) const;
+
+	/** Decodes the whole trace, so a replay doesn't pay for the decoding. */
+	[[nodiscard]] Vector<TraceEvent> events() const;
+
+	void clear() noexcept;
+
+	[[nodiscard]] constexpr uint64 size() const noexcept { return eventCount_; }
+	[[nodiscard]] constexpr bool isEmpty() const noexcept { return eventCount_ == 0; }
+
+	/** Size of the encoded events. */
+	[[nodiscard]] constexpr size_type byteSize() const noexcept { return bytes_.size(); }
+
+	/** false when the file can't be written. */
+	bool save(const char* path) const;
+
+	/** false when the file can't be read or isn't a well-formed trace; the trace is then left empty. */
+	bool load(const char* path);
+
+private:
+	/** Decodes the event at `offset` and moves `offset` past it; false on malformed input. */
+	bool decode(size_type& offset, TraceEvent& event) const;
+
+	void writeVarint(uint64 value);
+
+private:
+	Vector<uint8> bytes_;
+	uint64 eventCount_{ 0 };
+};
+
+
+/**
+ * How replayTrace and TracedContainer spell each operation on a given container. Ours and the
+ * std ones name them differently, and the adaptors have only push and pop: Stack and std::stack
+ * (those with peek or top) pop at the back, Queue and std::queue at the front. std::vector gets
+ * its front operations as insert/erase at begin(), which costs what Vector's pushFront does.
+ */
+template<typename Container>
+struct TraceDispatch
+{
+	static constexpr bool bStackLike = requires(Container& c) { c.pop(); c.peek(); } || requires(Container& c) { c.pop(); c.top(); };
+	static constexpr bool bQueueLike = !bStackLike && requires(Container& c) { c.pop(); c.front(); };
+
+	template<typename Val>
+	static constexpr bool bPushBack = requires(Container& c, Val&& val) { c.pushBack(std::forward<Val>(val)); }
+		|| requires(Container& c, Val&& val) { c.push_back(std::forward<Val>(val)); }
+		|| requires(Container& c, Val&& val) { c.push(std::forward<Val>(val)); };
+
+	template<typename Val>
+	static constexpr bool bPushFront = requires(Container& c, Val&& val) { c.pushFront(std::forward<Val>(val)); }
+		|| requires(Container& c, Val&& val) { c.push_front(std::forward<Val>(val)); }
+		|| requires(Container& c, Val&& val) { c.insert(c.begin(), std::forward<Val>(val)); };
+
+	static constexpr bool bPopBack = requires(Container& c) { c.popBack(); } || requires(Container& c) { c.pop_back(); } || bStackLike;
+	static constexpr bool bPopFront = requires(Container& c) { c.popFront(); } || requires(Container& c) { c.pop_front(); }
+		|| requires(Container& c) { c.erase(c.begin()); } || bQueueLike;
+	static constexpr bool bIterable = requires(Container& c) { std::begin(c); std::end(c); };
+
+	template<typename Val>
+	static void pushBack(Container& c, Val&& val)
+	{
+		if constexpr (requires { c.pushBack(std::forward<Val>(val)); }) { c.pushBack(std::forward<Val>(val)); }
+		else if constexpr (requires { c.push_back(std::forward<Val>(val)); }) { c.push_back(std::forward<Val>(val)); }
+		else { c.push(std::forward<Val>(val)); }
+	}
+
+	template<typename Val>
+	static void pushFront(Container& c, Val&& val)
+	{
+		if constexpr (requires { c.pushFront(std::forward<Val>(val)); }) { c.pushFront(std::forward<Val>(val)); }
+		else if constexpr (requires { c.push_front(std::forward<Val>(val)); }) { c.push_front(std::forward<Val>(val)); }
+		else { c.insert(c.begin(), std::forward<Val>(val)); }
+	}
+
+	static void popBack(Container& c)
+	{
+		if constexpr (requires { c.popBack(); }) { c.popBack(); }
+		else if constexpr (requires { c.pop_back(); }) { c.pop_back(); }
+		else { c.pop(); }
+	}
+
+	static void popFront(Container& c)
+	{
+		if constexpr (requires { c.popFront(); }) { c.popFront(); }
+		else if constexpr (requires { c.pop_front(); }) { c.pop_front(); }
+		else if constexpr (requires { c.erase(c.begin()); }) { c.erase(c.begin()); }
+		else { c.pop(); }
+	}
+
+	static bool isEmpty(const Container& c)
+	{
+		if constexpr (requires { c.isEmpty(); }) { return c.isEmpty(); }
+		else { return c.empty(); }
+	}
+
+	/** Indexes where the container can, walks from the front where it can't (which is what a list costs). */
+	static decltype(auto) get(Container& c, size_t index)
+	{
+		if constexpr (requires { c[index]; }) { return c[index]; }
+		else { return *std::next(std::begin(c), static_cast<std::ptrdiff_t>(index)); }
+	}
+
+	/** Visits the element at `index` if there is one. Without size() (std::forward_list) that's one walk, stopping at the end. */
+	template<typename Visit>
+	static bool visitAt(Container& c, uint64 index, Visit& visit)
+	{
+		if constexpr (requires { c.size(); })
+		{
+			if (index >= static_cast<uint64>(c.size()))
+			{
+				return false;
+			}
+			visit(get(c, static_cast<size_t>(index)));
+		}
+		else
+		{
+			auto it = std::begin(c);
+			for (; index > 0 && it != std::end(c); --index)
+			{
+				++it;
+			}
+			if (it == std::end(c))
+			{
+				return false;
+			}
+			visit(*it);
+		}
+		return true;
+	}
+
+	static size_t size(const Container& c)
+	{
+		if constexpr (requires { c.size(); }) { return c.size(); }
+		else { return static_cast<size_t>(std::distance(std::begin(c), std::end(c))); }
+	}
+
+	static void clear(Container& c)
+	{
+		if constexpr (requires { c.clear(); }) { c.clear(); }
+		else if constexpr (requires { c.reset(); }) { c.reset(); }
+		else { c = Container(); }
+	}
+};
+
+/** The size a push records. */
+template<typename T>
+uint64 traceSizeOf(const T& val)
+{
+	if constexpr (requires { val.size(); })
+	{
+		return static_cast<uint64>(val.size());
+	}
+	else
+	{
+		return sizeof(T);
+	}
+}
+
+
+/**
+ * A container that writes every operation done through it into a trace. It has the operations
+ * of the container it wraps (push/pop for the adaptors) plus get(), forEach() and clear(), which
+ * are the reads and resets worth recording; anything else goes through container(), untraced.
+ */
+template<typename Container>
+class TracedContainer final
+{
+public:
+	using Dispatch = TraceDispatch<Container>;
+
+public:
+	explicit TracedContainer(WorkloadTrace& trace) : trace_{ trace } {}
+
+	template<typename Val>
+	void pushBack(Val&& val);
+
+	template<typename Val>
+	void pushFront(Val&& val);
+
+	void popBack();
+	void popFront();
+
+	/** For Stack and Queue: recorded as PushBack, and PopBack or PopFront to match the adaptor. */
+	template<typename Val>
+	void push(Val&& val) { pushBack(std::forward<Val>(val)); }
+	void pop();
+
+	decltype(auto) get(size_t index);
+
+	/** Calls `fn` on every element, recorded as one Iterate over that many elements. */
+	template<typename Fn>
+	void forEach(Fn&& fn);
+
+	void clear();
+
+	[[nodiscard]] size_t size() const { return Dispatch::size(container_); }
+	[[nodiscard]] bool isEmpty() const { return Dispatch::isEmpty(container_); }
+
+	[[nodiscard]] Container& container() noexcept { return container_; }
+	[[nodiscard]] const Container& container() const noexcept { return container_; }
+
+private:
+	Container container_;
+	WorkloadTrace& trace_;
+};
+
+
+/** What a replay did: operations applied, and those the container couldn't perform. */
+struct TraceReplayResult
+{
+	uint64 applied{ 0 };
+
+	/**
+	 * Operations the container has no spelling for (pushFront on a Vector-backed Stack...), and
+	 * those that had become impossible because of them: pops of an empty container, lookups
+	 * past the end. Always 0 when replaying to a container as capable as the recorded one.
+	 */
+	uint64 skipped{ 0 };
+};
+
+/**
+ * Applies `events` (WorkloadTrace::events(), or any range of TraceEvent) to `container` in order.
+ * Pushes insert `makeElement(size)`, so the recorded sizes can be reproduced; every element
+ * a Get or Iterate reads is passed to `visit`, which should consume it so the reads aren't
+ * optimized away.
+ */
+template<typename Container, typename Events, typename MakeElement, typename Visit>
+TraceReplayResult replayTrace(const Events& events, Container& container, MakeElement&& makeElement, Visit&& visit);
+
+
+inline void WorkloadTrace::record(TraceOp op, uint64 argument)
+{
+	bytes_.pushBack(static_cast<uint8>(op));
+	if (traceOpHasArgument(op))
+	{
+		writeVarint(argument);
+	}
+
+	++eventCount_;
+}
+
+inline void WorkloadTrace::writeVarint(uint64 value)
+{
+	while (value >= 0x80)
+	{
+		bytes_.pushBack(static_cast<uint8>(value | 0x80));
+		value >>= 7;
+	}
+	bytes_.pushBack(static_cast<uint8>(value));
+}
+
+inline bool WorkloadTrace::decode(size_type& offset, TraceEvent& event) const
+{
+	if (offset >= bytes_.size() || bytes_[offset] >= static_cast<uint8>(TraceOp::Count))
+	{
+		return false;
+	}
+
+	event.op = static_cast<TraceOp>(bytes_[offset++]);
+	event.argument = 0;
+	if (!traceOpHasArgument(event.op))
+	{
+		return true;
+	}
+
+	for (uint32 shift = 0; shift < 64; shift += 7)
+	{
+		if (offset >= bytes_.size())
+		{
+			return false;
+		}
+
+		const uint8 byte = bytes_[offset++];
+		event.argument |= static_cast<uint64>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<typename Fn>
+void WorkloadTrace::forEach(Fn&& fn) const
+{
+	size_type offset = 0;
+	TraceEvent event;
+	for (uint64 i = 0; i < eventCount_; ++i)
+	{
+		[[maybe_unused]] const bool bDecoded = decode(offset, event);
+		assert(bDecoded);
+		fn(event);
+	}
+}
+
+inline Vector<TraceEvent> WorkloadTrace::events() const
+{
+	Vector<TraceEvent> result;
+	result.reserve(static_cast<size_t>(eventCount_));
+	forEach([&result](const TraceEvent& event) { result.pushBack(event); });
+
+	return result;
+}
+
+inline void WorkloadTrace::clear() noexcept
+{
+	bytes_.reset();
+	eventCount_ = 0;
+}
+
+inline bool WorkloadTrace::save(const char* path) const
+{
+	std::FILE* file = std::fopen(path, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	uint8 header[21] = { 'A', 'T', 'R', 'C', FormatVersion };
+	for (uint32 i = 0; i < 8; ++i)
+	{
+		header[5 + i] = static_cast<uint8>(eventCount_ >> (8 * i));
+		header[13 + i] = static_cast<uint8>(static_cast<uint64>(bytes_.size()) >> (8 * i));
+	}
+
+	bool bWritten = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+	if (bWritten && !bytes_.isEmpty())
+	{
+		bWritten = std::fwrite(bytes_.data(), 1, bytes_.size(), file) == bytes_.size();
+	}
+
+	return std::fclose(file) == 0 && bWritten;
+}
+
+inline bool WorkloadTrace::load(const char* path)
+{
+	/**
+	 * 1. header - magic and version must match
+	 * 2. body - exactly the announced byte count, and it has to decode into exactly
+	 *    the announced number of events
+	 */
+
+	clear();
+
+	std::FILE* file = std::fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+
+	uint8 header[21];
+	bool bValid = std::fread(header, 1, sizeof(header), file) == sizeof(header)
+		&& header[0] == 'A' && header[1] == 'T' && header[2] == 'R' && header[3] == 'C'
+		&& header[4] == FormatVersion;
+
+	uint64 eventCount = 0;
+	uint64 byteCount = 0;
+	if (bValid)
+	{
+		for (uint32 i = 0; i < 8; ++i)
+		{
+			eventCount |= static_cast<uint64>(header[5 + i]) << (8 * i);
+			byteCount |= static_cast<uint64>(header[13 + i]) << (8 * i);
+		}
+	}
+
+	// Read in chunks rather than trusting byteCount for one big allocation.
+	uint8 chunk[4096];
+	while (bValid && bytes_.size() < byteCount)
+	{
+		const size_t wanted = static_cast<size_t>(std::min<uint64>(sizeof(chunk), byteCount - bytes_.size()));
+		const size_t got = std::fread(chunk, 1, wanted, file);
+		bytes_.pushBackRange(chunk, chunk + got);
+		bValid = got == wanted;
+	}
+	bValid = bValid && std::fgetc(file) == EOF;
+
+	std::fclose(file);
+
+	size_type offset = 0;
+	TraceEvent event;
+	for (uint64 i = 0; bValid && i < eventCount; ++i)
+	{
+		bValid = decode(offset, event);
+	}
+	bValid = bValid && offset == bytes_.size();
+
+	if (!bValid)
+	{
+		clear();
+		return false;
+	}
+
+	eventCount_ = eventCount;
+	return true;
+}
+
+
+template<typename Container>
+template<typename Val>
+void TracedContainer<Container>::pushBack(Val&& val)
+{
+	trace_.record(TraceOp::PushBack, traceSizeOf(val));
+	Dispatch::pushBack(container_, std::forward<Val>(val));
+}
+
+template<typename Container>
+template<typename Val>
+void TracedContainer<Container>::pushFront(Val&& val)
+{
+	trace_.record(TraceOp::PushFront, traceSizeOf(val));
+	Dispatch::pushFront(container_, std::forward<Val>(val));
+}
+
+template<typename Container>
+void TracedContainer<Container>::popBack()
+{
+	trace_.record(TraceOp::PopBack);
+	Dispatch::popBack(container_);
+}
+
+template<typename Container>
+void TracedContainer<Container>::popFront()
+{
+	trace_.record(TraceOp::PopFront);
+	Dispatch::popFront(container_);
+}
+
+template<typename Container>
+void TracedContainer<Container>::pop()
+{
+	static_assert(Dispatch::bStackLike || Dispatch::bQueueLike, "pop() is for Stack and Queue; use popBack or popFront.");
+
+	if constexpr (Dispatch::bStackLike)
+	{
+		popBack();
+	}
+	else
+	{
+		popFront();
+	}
+}
+
+template<typename Container>
+decltype(auto) TracedContainer<Container>::get(size_t index)
+{
+	trace_.record(TraceOp::Get, index);
+	return Dispatch::get(container_, index);
+}
+
+template<typename Container>
+template<typename Fn>
+void TracedContainer<Container>::forEach(Fn&& fn)
+{
+	// Counted on the way rather than asked for up front: not every container has size().
+	size_t count = 0;
+	for (auto& val : container_)
+	{
+		fn(val);
+		++count;
+	}
+	trace_.record(TraceOp::Iterate, count);
+}
+
+template<typename Container>
+void TracedContainer<Container>::clear()
+{
+	trace_.record(TraceOp::Clear);
+	Dispatch::clear(container_);
+}
+
+
+template<typename Container, typename Events, typename MakeElement, typename Visit>
+TraceReplayResult replayTrace(const Events& events, Container& container, MakeElement&& makeElement, Visit&& visit)
+{
+	using Dispatch = TraceDispatch<Container>;
+	using Element = decltype(makeElement(uint64{ 0 }));
+
+	TraceReplayResult result;
+	for (const TraceEvent& event : events)
+	{
+		bool bApplied = false;
+		switch (event.op)
+		{
+		case TraceOp::PushBack:
+			if constexpr (Dispatch::template bPushBack<Element>)
+			{
+				Dispatch::pushBack(container, makeElement(event.argument));
+				bApplied = true;
+			}
+			break;
+
+		case TraceOp::PushFront:
+			if constexpr (Dispatch::template bPushFront<Element>)
+			{
+				Dispatch::pushFront(container, makeElement(event.argument));
+				bApplied = true;
+			}
+			break;
+
+		case TraceOp::PopBack:
+			if constexpr (Dispatch::bPopBack)
+			{
+				if (!Dispatch::isEmpty(container))
+				{
+					Dispatch::popBack(container);
+					bApplied = true;
+				}
+			}
+			break;
+
+		case TraceOp::PopFront:
+			if constexpr (Dispatch::bPopFront)
+			{
+				if (!Dispatch::isEmpty(container))
+				{
+					Dispatch::popFront(container);
+					bApplied = true;
+				}
+			}
+			break;
+
+		case TraceOp::Get:
+			if constexpr (Dispatch::bIterable)
+			{
+				bApplied = Dispatch::visitAt(container, event.argument, visit);
+			}
+			break;
+
+		case TraceOp::Iterate:
+			if constexpr (Dispatch::bIterable)
+			{
+				uint64 remaining = event.argument;
+				for (auto it = std::begin(container); remaining > 0 && it != std::end(container); ++it, --remaining)
+				{
+					visit(*it);
+				}
+				bApplied = true;
+			}
+			break;
+
+		case TraceOp::Clear:
+			Dispatch::clear(container);
+			bApplied = true;
+			break;
+
+		default:
+			break;
+		}
+
+		++(bApplied ? result.applied : result.skipped);
+	}
+
+	return result;
+}
@@ -0,0 +1,151 @@
+#include <cstdio>
+#include <stack>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ContainerBackends.h"
+#include "HeapCounter.h"
+
+#include "../Algorithms/CompactList.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/Queue.h"
+#include "../Algorithms/RingBuffer.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Stack.h"
+#include "../Algorithms/Vector.h"
+
+namespace
+{
+	constexpr size_t ElementCount = 1 << 20;
+	constexpr size_t SteadyDepth = 1024;
+
+	/**
+	 * One body for Stack and Queue on every container they take: a fill and drain, push+pop
+	 * against a steady backlog, and what a full one holds on the heap. Backends have the
+	 * ContainerBackends.h spelling; those with reserve() can start at full size.
+	 */
+	template<typename Backend>
+	void benchmarkAdapter(const char* label, bool bReserve = false)
+	{
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%s: push N, pop N", label);
+		printResult(runBenchmark(name, 2 * ElementCount, [bReserve]
+		{
+			Backend backend;
+			if constexpr (requires { backend.reserve(ElementCount); })
+			{
+				if (bReserve)
+				{
+					backend.reserve(ElementCount);
+				}
+			}
+			for (size_t i = 0; i < ElementCount; ++i)
+			{
+				backend.push(static_cast<int>(i));
+			}
+			while (!backend.empty())
+			{
+				doNotOptimize(backend.next());
+				backend.pop();
+			}
+		}));
+
+		std::snprintf(name, sizeof(name), "%s: push+pop at depth %zu", label, SteadyDepth);
+		printResult(runBenchmark(name, 2 * ElementCount, []
+		{
+			Backend backend;
+			for (size_t i = 0; i < SteadyDepth; ++i)
+			{
+				backend.push(static_cast<int>(i));
+			}
+			for (size_t i = 0; i < ElementCount; ++i)
+			{
+				backend.push(static_cast<int>(i));
+				doNotOptimize(backend.next());
+				backend.pop();
+			}
+		}));
+
+		HeapStats before = heapStats();
+		{
+			Backend backend;
+			for (size_t i = 0; i < ElementCount; ++i)
+			{
+				backend.push(static_cast<int>(i));
+			}
+
+			HeapStats filled = heapStats();
+			std::printf("%-56s %12.2f bytes/elem, %zu allocations\n", label,
+				static_cast<double>(filled.liveBytes - before.liveBytes) / ElementCount,
+				filled.allocations - before.allocations);
+		}
+	}
+
+	template<template<typename> typename Container>
+	struct StackOn
+	{
+		Stack<int, Container> container;
+
+		void push(int val) { container.push(val); }
+		void pop() { container.pop(); }
+		int& next() { return container.peek(); }
+		bool empty() const { return container.isEmpty(); }
+		void reserve(size_t n) { container.reserve(n); }
+	};
+
+	/** What Stack used to be: a SingleLinkedList pushed and popped at the front. */
+	struct FrontListStack
+	{
+		SingleLinkedList<int> container;
+
+		void push(int val) { container.pushFront(val); }
+		void pop() { container.popFront(); }
+		int& next() { return container.front(); }
+		bool empty() const { return container.isEmpty(); }
+	};
+
+	/** std::stack on the container Stack defaults to, rather than on std::deque. */
+	struct StdVectorStack
+	{
+		std::stack<int, std::vector<int>> container;
+
+		void push(int val) { container.push(val); }
+		void pop() { container.pop(); }
+		int& next() { return container.top(); }
+		bool empty() const { return container.empty(); }
+	};
+
+	template<template<typename> typename Container>
+	struct QueueOn
+	{
+		Queue<int, Container> container;
+
+		void push(int val) { container.push(val); }
+		void pop() { container.pop(); }
+		int& next() { return container.front(); }
+		bool empty() const { return container.isEmpty(); }
+	};
+}
+
+void runStackBenchmarks()
+{
+	printHeader("Stack<int> backends");
+
+	benchmarkAdapter<StackOn<Vector>>("Stack<Vector>");
+	benchmarkAdapter<StackOn<Vector>>("Stack<Vector>, reserved", true);
+	benchmarkAdapter<StackOn<DoubleLinkedList>>("Stack<DoubleLinkedList>");
+	benchmarkAdapter<StackOn<CompactList>>("Stack<CompactList>");
+	benchmarkAdapter<FrontListStack>("SingleLinkedList, at front");
+	benchmarkAdapter<StdVectorStack>("std::stack<int, std::vector<int>>");
+}
+
+void runQueueBenchmarks()
+{
+	printHeader("Queue<int> backends");
+
+	benchmarkAdapter<QueueOn<RingBuffer>>("Queue<RingBuffer>");
+	benchmarkAdapter<QueueOn<SingleLinkedList>>("Queue<SingleLinkedList>");
+	benchmarkAdapter<QueueOn<DoubleLinkedList>>("Queue<DoubleLinkedList>");
+	benchmarkAdapter<StdQueueBackend<int>>("std::queue<int> (std::deque)");
+}
@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/CompactList.h"
+#include "../Algorithms/CountingAllocator.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/SlabAllocator.h"
+#include "../Algorithms/Vector.h"
+
+namespace
+{
+	constexpr size_t ElementCount = 1 << 20;
+	constexpr size_t ChurnSteps = 1 << 20;
+	constexpr size_t ChurnLive = 4096;
+	constexpr size_t ProfileCount = 100000;
+
+	template<typename ListType>
+	void benchmarkList(const char* backend)
+	{
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%s: pushBack N, popFront N", backend);
+		printResult(runBenchmark(name, 2 * ElementCount, []
+		{
+			ListType list;
+			for (size_t i = 0; i < ElementCount; ++i)
+			{
+				list.pushBack(static_cast<int>(i));
+			}
+			while (!list.isEmpty())
+			{
+				doNotOptimize(list.front());
+				list.popFront();
+			}
+		}));
+	}
+
+	/**
+	 * Every thread keeps ChurnLive lists of one node alive and keeps replacing the oldest one,
+	 * so allocations and frees interleave the way they do in a long-running service.
+	 * The nodes left at the end are freed by the calling thread, which exercises cross-thread frees.
+	 */
+	template<typename Allocator>
+	void churn(size_t threadCount)
+	{
+		using List = SingleLinkedList<int, Allocator>;
+
+		std::vector<std::vector<List>> lists(threadCount, std::vector<List>(ChurnLive));
+		std::vector<std::thread> threads;
+
+		for (size_t t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&, t]
+			{
+				const size_t share = ChurnSteps / threadCount;
+				auto& mine = lists[t];
+				for (size_t i = 0; i < share; ++i)
+				{
+					List& list = mine[i % ChurnLive];
+					if (!list.isEmpty())
+					{
+						list.popFront();
+					}
+					list.pushFront(static_cast<int>(i));
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		// The nodes die on this thread, not on the ones that allocated them.
+		lists.clear();
+	}
+
+	/** Fills a container through CountingAllocator and prints what it asked the heap for. */
+	template<template<typename, typename> typename Container>
+	void profile(const char* backend)
+	{
+		using Alloc = CountingAllocator<int>;
+
+		AllocationStats stats;
+		{
+			Container<int, Alloc> container{ Alloc(stats) };
+			for (size_t i = 0; i < ProfileCount; ++i)
+			{
+				container.pushBack(static_cast<int>(i));
+			}
+		}
+
+		std::printf("%-32s %12zu %12zu %12.2f\n", backend, stats.allocations(), stats.peakBytes(),
+			static_cast<double>(stats.totalBytes()) / ProfileCount);
+	}
+}
+
+void runAllocatorBenchmarks()
+{
+	std::printf("\n== Allocators: heap traffic of pushing %zu ints, via CountingAllocator ==\n", ProfileCount);
+	std::printf("%-32s %12s %12s %12s\n", "container", "allocations", "peak bytes", "total/elem");
+
+	profile<Vector>("Vector");
+	profile<SingleLinkedList>("SingleLinkedList");
+	profile<DoubleLinkedList>("DoubleLinkedList");
+	profile<CompactList>("CompactList");
+
+	printHeader("Allocators: list push/pop");
+
+	benchmarkList<DoubleLinkedList<int>>("DoubleLinkedList std::allocator");
+	benchmarkList<DoubleLinkedList<int, SlabAllocator<int>>>("DoubleLinkedList SlabAllocator");
+	benchmarkList<SingleLinkedList<int>>("SingleLinkedList std::allocator");
+	benchmarkList<SingleLinkedList<int, SlabAllocator<int>>>("SingleLinkedList SlabAllocator");
+
+	printHeader("Allocators: multi-threaded churn, one alloc + one free per op");
+
+	for (size_t threads = 1; threads <= 8; threads *= 2)
+	{
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%zu threads: std::allocator", threads);
+		printResult(runBenchmark(name, ChurnSteps, [threads] { churn<std::allocator<int>>(threads); }, 3));
+
+		std::snprintf(name, sizeof(name), "%zu threads: SlabAllocator", threads);
+		printResult(runBenchmark(name, ChurnSteps, [threads] { churn<SlabAllocator<int>>(threads); }, 3));
+	}
+}
@@ -0,0 +1,217 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "PerfCounters.h"
+
+/**
+ * A minimal timing harness: run a piece of work a few times, keep the fastest run
+ * and print it as ns/op and ops/s. Good enough to compare two backends of the same container.
+ *
+ * Besides the table on stdout, results can go to a CSV file (main's --csv), one row per
+ * printResult: suite,case,operations,seconds,ns_per_op,mops_per_s and the counters below.
+ * The suite is the title of the last printHeader.
+ *
+ * With --counters every repetition is also measured with PerfCounters, and the table and the CSV
+ * get cycles, instructions, L1D and LLC misses and branch misses per operation of the fastest
+ * repetition. Counters that can't be read show as "-" in the table and stay empty in the CSV.
+ */
+
+struct BenchmarkResult
+{
+	const char* name{ "" };
+	size_t operations{ 0 };
+	double seconds{ 0.0 };
+	PerfSample counters{};
+
+	double nsPerOp() const { return seconds * 1e9 / static_cast<double>(operations); }
+	double opsPerSecond() const { return static_cast<double>(operations) / seconds; }
+	double perOp(PerfEvent event) const { return static_cast<double>(counters.get(event)) / static_cast<double>(operations); }
+};
+
+struct BenchmarkReport
+{
+	std::FILE* csv{ nullptr };
+	char suite[128]{};
+
+	// Set while hardware counters are collected.
+	PerfCounters* counters{ nullptr };
+
+	// The trace the replay suite runs (--trace); it makes up one when this is null.
+	const char* tracePath{ nullptr };
+};
+
+inline BenchmarkReport& benchmarkReport()
+{
+	static BenchmarkReport report;
+	return report;
+}
+
+/** Quotes every field; case names contain commas. */
+inline void writeCsvField(std::FILE* file, const char* text)
+{
+	std::fputc('"', file);
+	for (; *text != '\0'; ++text)
+	{
+		if (*text == '"')
+		{
+			std::fputc('"', file);
+		}
+		std::fputc(*text, file);
+	}
+	std::fputc('"', file);
+}
+
+inline void writeCsvHeader(std::FILE* file)
+{
+	std::fprintf(file, "suite,case,operations,seconds,ns_per_op,mops_per_s,"
+		"cycles_per_op,instructions_per_op,l1d_misses_per_op,llc_misses_per_op,branch_misses_per_op\n");
+}
+
+/** Keeps the optimizer from dropping a value that nothing else reads. */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	const volatile void* volatile sink = &value;
+	(void)sink;
+	_ReadWriteBarrier();
+#endif
+}
+
+/** Times one call of `fn` and keeps it, counters included, if it's the fastest so far. */
+template<typename Fn>
+void measureRepetition(BenchmarkResult& result, bool bFirst, Fn&& fn)
+{
+	using Clock = std::chrono::steady_clock;
+
+	PerfCounters* counters = benchmarkReport().counters;
+	if (counters)
+	{
+		counters->start();
+	}
+
+	auto start = Clock::now();
+	fn();
+	std::chrono::duration<double> elapsed = Clock::now() - start;
+
+	const PerfSample sample = counters ? counters->stop() : PerfSample{};
+
+	if (bFirst || elapsed.count() < result.seconds)
+	{
+		result.seconds = elapsed.count();
+		result.counters = sample;
+	}
+}
+
+/** `fn` has to perform exactly `operations` operations per call. */
+template<typename Fn>
+BenchmarkResult runBenchmark(const char* name, size_t operations, Fn&& fn, int repetitions = 5)
+{
+	BenchmarkResult result{ name, operations };
+	for (int i = 0; i < repetitions; ++i)
+	{
+		measureRepetition(result, i == 0, fn);
+	}
+
+	return result;
+}
+
+/**
+ * Like runBenchmark, but `setup()` builds a fresh state before every repetition and only
+ * `fn(state)` is timed. The state is also destroyed outside the clock.
+ */
+template<typename Setup, typename Fn>
+BenchmarkResult runBenchmarkWithSetup(const char* name, size_t operations, Setup&& setup, Fn&& fn, int repetitions = 5)
+{
+	BenchmarkResult result{ name, operations };
+	for (int i = 0; i < repetitions; ++i)
+	{
+		auto state = setup();
+		measureRepetition(result, i == 0, [&fn, &state] { fn(state); });
+	}
+
+	return result;
+}
+
+inline void printHeader(const char* title)
+{
+	std::snprintf(benchmarkReport().suite, sizeof(benchmarkReport().suite), "%s", title);
+
+	std::printf("\n== %s ==\n", title);
+	std::printf("%-56s %12s %14s", "case", "ns/op", "Mops/s");
+	if (benchmarkReport().counters)
+	{
+		std::printf(" %10s %10s %6s %10s %10s %10s", "cycles/op", "instr/op", "IPC", "L1D-miss", "LLC-miss", "br-miss");
+	}
+	std::printf("\n");
+}
+
+inline void printPerOp(const BenchmarkResult& result, PerfEvent event)
+{
+	if (result.counters.has(event))
+	{
+		std::printf(" %10.2f", result.perOp(event));
+	}
+	else
+	{
+		std::printf(" %10s", "-");
+	}
+}
+
+inline void printResult(const BenchmarkResult& result)
+{
+	BenchmarkReport& report = benchmarkReport();
+	const PerfSample& counters = result.counters;
+
+	std::printf("%-56s %12.2f %14.2f", result.name, result.nsPerOp(), result.opsPerSecond() / 1e6);
+	if (report.counters)
+	{
+		printPerOp(result, PerfEvent::Cycles);
+		printPerOp(result, PerfEvent::Instructions);
+
+		if (counters.has(PerfEvent::Cycles) && counters.has(PerfEvent::Instructions) && counters.get(PerfEvent::Cycles) > 0)
+		{
+			std::printf(" %6.2f", static_cast<double>(counters.get(PerfEvent::Instructions)) / static_cast<double>(counters.get(PerfEvent::Cycles)));
+		}
+		else
+		{
+			std::printf(" %6s", "-");
+		}
+
+		printPerOp(result, PerfEvent::L1dMisses);
+		printPerOp(result, PerfEvent::LlcMisses);
+		printPerOp(result, PerfEvent::BranchMisses);
+	}
+	std::printf("\n");
+
+	if (report.csv)
+	{
+		writeCsvField(report.csv, report.suite);
+		std::fputc(',', report.csv);
+		writeCsvField(report.csv, result.name);
+		std::fprintf(report.csv, ",%zu,%.9f,%.3f,%.3f", result.operations, result.seconds, result.nsPerOp(), result.opsPerSecond() / 1e6);
+
+		for (size_t i = 0; i < PerfEventCount; ++i)
+		{
+			const PerfEvent event = static_cast<PerfEvent>(i);
+			if (counters.has(event))
+			{
+				std::fprintf(report.csv, ",%.4f", result.perOp(event));
+			}
+			else
+			{
+				std::fputc(',', report.csv);
+			}
+		}
+		std::fputc('\n', report.csv);
+	}
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include <forward_list>
+#include <list>
+#include <queue>
+#include <stack>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/Queue.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Stack.h"
+#include "../Algorithms/Vector.h"
+
+/**
+ * Element types and container adapters shared by the container and latency suites.
+ */
+
+/** Can't be copied, so every container has to take the move paths. */
+struct MoveOnly
+{
+	int value;
+
+	explicit MoveOnly(int v) : value{ v } {}
+	MoveOnly(MoveOnly&&) noexcept = default;
+	MoveOnly& operator=(MoveOnly&&) noexcept = default;
+
+	MoveOnly(const MoveOnly&) = delete;
+	MoveOnly& operator=(const MoveOnly&) = delete;
+};
+
+/** How to make the i-th element and what reading one costs. */
+template<typename T>
+struct Element;
+
+template<>
+struct Element<int>
+{
+	static constexpr const char* Name = "int";
+
+	static int make(size_t i) { return static_cast<int>(i); }
+	static size_t read(const int& val) { return static_cast<size_t>(val); }
+};
+
+template<>
+struct Element<std::string>
+{
+	static constexpr const char* Name = "string";
+
+	// Too long for the small-string buffer, so each copy allocates like a real payload would.
+	static std::string make(size_t i) { return "element #" + std::to_string(i) + " of the benchmark"; }
+	static size_t read(const std::string& val) { return val.size(); }
+};
+
+template<>
+struct Element<MoveOnly>
+{
+	static constexpr const char* Name = "move-only";
+
+	static MoveOnly make(size_t i) { return MoveOnly(static_cast<int>(i)); }
+	static size_t read(const MoveOnly& val) { return static_cast<size_t>(val.value); }
+};
+
+/**
+ * Every backend below gives its container the same spelling: push(), pop(), next() (the element
+ * pop() removes) and empty(). Sequences also say bIterable and expose the container for range-for.
+ * Each of ours is paired with the std container it stands in for, used the same way.
+ */
+
+template<typename T>
+struct VectorBackend
+{
+	static constexpr const char* Name = "Vector";
+	static constexpr bool bIterable = true;
+
+	Vector<T> container;
+
+	void push(T&& val) { container.pushBack(std::move(val)); }
+	void pop() { container.popBack(); }
+	T& next() { return container.back(); }
+	bool empty() const { return container.isEmpty(); }
+};
+
+template<typename T>
+struct StdVectorBackend
+{
+	static constexpr const char* Name = "std::vector";
+	static constexpr bool bIterable = true;
+
+	std::vector<T> container;
+
+	void push(T&& val) { container.push_back(std::move(val)); }
+	void pop() { container.pop_back(); }
+	T& next() { return container.back(); }
+	bool empty() const { return container.empty(); }
+};
+
+/** std::forward_list only has a front, so both singly linked lists are used as a LIFO there. */
+template<typename T>
+struct SingleLinkedListBackend
+{
+	static constexpr const char* Name = "SingleLinkedList";
+	static constexpr bool bIterable = true;
+
+	SingleLinkedList<T> container;
+
+	void push(T&& val) { container.pushFront(std::move(val)); }
+	void pop() { container.popFront(); }
+	T& next() { return container.front(); }
+	bool empty() const { return container.isEmpty(); }
+};
+
+template<typename T>
+struct StdForwardListBackend
+{
+	static constexpr const char* Name = "std::forward_list";
+	static constexpr bool bIterable = true;
+
+	std::forward_list<T> container;
+
+	void push(T&& val) { container.push_front(std::move(val)); }
+	void pop() { container.pop_front(); }
+	T& next() { return container.front(); }
+	bool empty() const { return container.empty(); }
+};
+
+/** Pushed at the back and popped at the front, the way a list gets used as a FIFO. */
+template<typename T>
+struct DoubleLinkedListBackend
+{
+	static constexpr const char* Name = "DoubleLinkedList";
+	static constexpr bool bIterable = true;
+
+	DoubleLinkedList<T> container;
+
+	void push(T&& val) { container.pushBack(std::move(val)); }
+	void pop() { container.popFront(); }
+	T& next() { return container.front(); }
+	bool empty() const { return container.isEmpty(); }
+};
+
+template<typename T>
+struct StdListBackend
+{
+	static constexpr const char* Name = "std::list";
+	static constexpr bool bIterable = true;
+
+	std::list<T> container;
+
+	void push(T&& val) { container.push_back(std::move(val)); }
+	void pop() { container.pop_front(); }
+	T& next() { return container.front(); }
+	bool empty() const { return container.empty(); }
+};
+
+/** Adapters on their default containers: Vector against std::deque. */
+template<typename T>
+struct StackBackend
+{
+	static constexpr const char* Name = "Stack";
+	static constexpr bool bIterable = false;
+
+	Stack<T> container;
+
+	void push(T&& val) { container.push(std::move(val)); }
+	void pop() { container.pop(); }
+	T& next() { return container.peek(); }
+	bool empty() const { return container.isEmpty(); }
+};
+
+template<typename T>
+struct StdStackBackend
+{
+	static constexpr const char* Name = "std::stack";
+	static constexpr bool bIterable = false;
+
+	std::stack<T> container;
+
+	void push(T&& val) { container.push(std::move(val)); }
+	void pop() { container.pop(); }
+	T& next() { return container.top(); }
+	bool empty() const { return container.empty(); }
+};
+
+/** RingBuffer against std::deque. */
+template<typename T>
+struct QueueBackend
+{
+	static constexpr const char* Name = "Queue";
+	static constexpr bool bIterable = false;
+
+	Queue<T> container;
+
+	void push(T&& val) { container.push(std::move(val)); }
+	void pop() { container.pop(); }
+	T& next() { return container.front(); }
+	bool empty() const { return container.isEmpty(); }
+};
+
+template<typename T>
+struct StdQueueBackend
+{
+	static constexpr const char* Name = "std::queue";
+	static constexpr bool bIterable = false;
+
+	std::queue<T> container;
+
+	void push(T&& val) { container.push(std::move(val)); }
+	void pop() { container.pop(); }
+	T& next() { return container.front(); }
+	bool empty() const { return container.empty(); }
+};
@@ -0,0 +1,134 @@
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ContainerBackends.h"
+
+namespace
+{
+	constexpr size_t ElementCount = 1 << 18;
+
+	/** The elements are made before the clock starts; push only pays for moving them in. */
+	template<typename T>
+	std::vector<T> makeElements()
+	{
+		std::vector<T> elements;
+		elements.reserve(ElementCount);
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			elements.push_back(Element<T>::make(i));
+		}
+		return elements;
+	}
+
+	template<typename BackendType>
+	BackendType makeFilled()
+	{
+		using T = std::remove_reference_t<decltype(std::declval<BackendType&>().next())>;
+
+		BackendType backend;
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			backend.push(Element<T>::make(i));
+		}
+		return backend;
+	}
+
+	template<template<typename> typename Backend, typename T>
+	void benchmarkBackend()
+	{
+		using BackendType = Backend<T>;
+
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%s<%s>: push", BackendType::Name, Element<T>::Name);
+		printResult(runBenchmarkWithSetup(name, ElementCount,
+			[]
+			{
+				return std::pair<BackendType, std::vector<T>>{ BackendType{}, makeElements<T>() };
+			},
+			[](std::pair<BackendType, std::vector<T>>& state)
+			{
+				for (T& val : state.second)
+				{
+					state.first.push(std::move(val));
+				}
+			}));
+
+		std::snprintf(name, sizeof(name), "%s<%s>: pop", BackendType::Name, Element<T>::Name);
+		printResult(runBenchmarkWithSetup(name, ElementCount, makeFilled<BackendType>, [](BackendType& backend)
+		{
+			size_t sum = 0;
+			while (!backend.empty())
+			{
+				sum += Element<T>::read(backend.next());
+				backend.pop();
+			}
+			doNotOptimize(sum);
+		}));
+
+		if constexpr (BackendType::bIterable)
+		{
+			std::snprintf(name, sizeof(name), "%s<%s>: iterate", BackendType::Name, Element<T>::Name);
+			printResult(runBenchmarkWithSetup(name, ElementCount, makeFilled<BackendType>, [](BackendType& backend)
+			{
+				size_t sum = 0;
+				for (const T& val : backend.container)
+				{
+					sum += Element<T>::read(val);
+				}
+				doNotOptimize(sum);
+			}));
+		}
+
+		if constexpr (std::is_copy_constructible_v<T>)
+		{
+			// The copy lives in the state, so freeing it isn't timed either.
+			std::snprintf(name, sizeof(name), "%s<%s>: copy", BackendType::Name, Element<T>::Name);
+			printResult(runBenchmarkWithSetup(name, ElementCount,
+				[]
+				{
+					return std::pair<BackendType, std::optional<BackendType>>{ makeFilled<BackendType>(), std::nullopt };
+				},
+				[](std::pair<BackendType, std::optional<BackendType>>& state)
+				{
+					state.second.emplace(state.first);
+					doNotOptimize(state.second->empty());
+				}));
+		}
+	}
+
+	template<typename T>
+	void benchmarkElement()
+	{
+		char title[96];
+		std::snprintf(title, sizeof(title), "Containers vs std, %zu x %s", ElementCount, Element<T>::Name);
+		printHeader(title);
+
+		// Whichever case runs first would otherwise also pay for faulting in the heap's pages.
+		doNotOptimize(makeFilled<StdListBackend<T>>().empty());
+		doNotOptimize(makeFilled<StdVectorBackend<T>>().empty());
+
+		benchmarkBackend<VectorBackend, T>();
+		benchmarkBackend<StdVectorBackend, T>();
+		benchmarkBackend<SingleLinkedListBackend, T>();
+		benchmarkBackend<StdForwardListBackend, T>();
+		benchmarkBackend<DoubleLinkedListBackend, T>();
+		benchmarkBackend<StdListBackend, T>();
+		benchmarkBackend<StackBackend, T>();
+		benchmarkBackend<StdStackBackend, T>();
+		benchmarkBackend<QueueBackend, T>();
+		benchmarkBackend<StdQueueBackend, T>();
+	}
+}
+
+void runContainerBenchmarks()
+{
+	benchmarkElement<int>();
+	benchmarkElement<std::string>();
+	benchmarkElement<MoveOnly>();
+}
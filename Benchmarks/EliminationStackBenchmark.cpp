@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/EliminationStack.h"
+#include "../Algorithms/Stack.h"
+
+namespace
+{
+	constexpr size_t PairCount = 1 << 19;
+	constexpr size_t Capacity = 1024;
+
+	struct LockedStack
+	{
+		std::mutex mutex;
+		Stack<int> stack;
+
+		bool tryPush(int val)
+		{
+			std::lock_guard lock(mutex);
+			stack.push(val);
+			return true;
+		}
+
+		bool tryPop(int& out)
+		{
+			std::lock_guard lock(mutex);
+			if (stack.isEmpty())
+			{
+				return false;
+			}
+			out = stack.peek();
+			stack.pop();
+			return true;
+		}
+	};
+
+	/**
+	 * Every thread alternates push and pop, PairCount pairs in total. This is the pattern
+	 * elimination is made for: at any moment about half of the threads want to push and half to pop.
+	 */
+	template<typename StackType>
+	void contend(StackType& stack, size_t threadCount)
+	{
+		std::vector<std::thread> threads;
+
+		for (size_t t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&, t]
+			{
+				const size_t share = PairCount / threadCount + (t < PairCount % threadCount ? 1 : 0);
+				int out = 0;
+				for (size_t i = 0; i < share; ++i)
+				{
+					while (!stack.tryPush(static_cast<int>(i)))
+					{
+						std::this_thread::yield();
+					}
+					if (stack.tryPop(out))
+					{
+						doNotOptimize(out);
+					}
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+}
+
+void runEliminationStackBenchmarks()
+{
+	printHeader("Stack contention, every thread pushes and pops");
+
+	for (size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%2zu threads: Stack<int> + std::mutex", threads);
+		printResult(runBenchmark(name, PairCount, [threads]
+		{
+			LockedStack stack;
+			contend(stack, threads);
+		}, 3));
+
+		std::snprintf(name, sizeof(name), "%2zu threads: EliminationStack<int>", threads);
+		printResult(runBenchmark(name, PairCount, [threads]
+		{
+			EliminationStack<int> stack(Capacity);
+			contend(stack, threads);
+		}, 3));
+	}
+}
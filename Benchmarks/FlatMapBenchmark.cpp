@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/BranchlessSearch.h"
+#include "../Algorithms/FlatHashMap.h"
+#include "../Algorithms/FlatMap.h"
+
+namespace
+{
+	/** A lookup table that still fits in L2 for uint64 keys, where search cost is mostly mispredictions. */
+	constexpr size_t ElementCount = 1 << 16;
+
+	/** Inserted in batches of this many by the insertRange cases. */
+	constexpr size_t BatchSize = 1024;
+
+	struct Input
+	{
+		/** Distinct keys in random order, with their values. */
+		std::vector<std::pair<uint64, uint64>> pairs;
+
+		/** The same keys shuffled again, so lookups don't follow the build order. */
+		std::vector<uint64> lookups;
+
+		/** The keys sorted, for the bare searches. */
+		std::vector<uint64> sorted;
+	};
+
+	Input makeInput()
+	{
+		Input input;
+		std::mt19937_64 random(13);
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			// Odd multiples of a large odd constant: distinct, and spread over the whole range.
+			const uint64 key = (static_cast<uint64>(i) * 2 + 1) * 0x9E3779B97F4A7C15ull;
+			input.pairs.emplace_back(key, i);
+			input.lookups.push_back(key);
+		}
+
+		std::shuffle(input.pairs.begin(), input.pairs.end(), random);
+		std::shuffle(input.lookups.begin(), input.lookups.end(), random);
+
+		input.sorted = input.lookups;
+		std::sort(input.sorted.begin(), input.sorted.end());
+
+		return input;
+	}
+
+	void benchmarkBuild(const Input& input)
+	{
+		const auto& pairs = input.pairs;
+
+		printResult(runBenchmark("FlatMap: bulk build", ElementCount, [&pairs]
+		{
+			FlatMap<uint64, uint64> map(pairs.begin(), pairs.end());
+			doNotOptimize(map);
+		}));
+
+		printResult(runBenchmark("FlatMap: insertRange, batches", ElementCount, [&pairs]
+		{
+			FlatMap<uint64, uint64> map;
+			for (size_t i = 0; i < ElementCount; i += BatchSize)
+			{
+				map.insertRange(pairs.begin() + i, pairs.begin() + i + BatchSize);
+			}
+			doNotOptimize(map);
+		}));
+
+		printResult(runBenchmark("FlatMap: tryEmplace, one by one", ElementCount, [&pairs]
+		{
+			FlatMap<uint64, uint64> map;
+			for (const auto& [key, value] : pairs)
+			{
+				map.tryEmplace(key, value);
+			}
+			doNotOptimize(map);
+		}));
+
+		printResult(runBenchmark("std::map: insert", ElementCount, [&pairs]
+		{
+			std::map<uint64, uint64> map(pairs.begin(), pairs.end());
+			doNotOptimize(map);
+		}));
+
+		printResult(runBenchmark("FlatHashMap: insert", ElementCount, [&pairs]
+		{
+			FlatHashMap<uint64, uint64> map;
+			for (const auto& [key, value] : pairs)
+			{
+				map.tryEmplace(key, value);
+			}
+			doNotOptimize(map);
+		}));
+	}
+
+	void benchmarkSearch(const Input& input)
+	{
+		const auto& lookups = input.lookups;
+		const auto& sorted = input.sorted;
+
+		printResult(runBenchmark("branchlessLowerBound", ElementCount, [&lookups, &sorted]
+		{
+			size_t sum = 0;
+			for (uint64 key : lookups)
+			{
+				sum += branchlessLowerBound(sorted.data(), sorted.size(), key, std::less<uint64>());
+			}
+			doNotOptimize(sum);
+		}));
+
+		printResult(runBenchmark("std::lower_bound", ElementCount, [&lookups, &sorted]
+		{
+			size_t sum = 0;
+			for (uint64 key : lookups)
+			{
+				sum += static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+			}
+			doNotOptimize(sum);
+		}));
+	}
+
+	template<typename Map>
+	void benchmarkFind(const char* name, const Map& map, const std::vector<uint64>& lookups)
+	{
+		printResult(runBenchmark(name, ElementCount, [&map, &lookups]
+		{
+			uint64 sum = 0;
+			for (uint64 key : lookups)
+			{
+				auto it = map.find(key);
+				sum += it == map.end() ? 0 : it->second;
+			}
+			doNotOptimize(sum);
+		}));
+	}
+
+	template<typename Map>
+	void benchmarkIterate(const char* name, const Map& map)
+	{
+		printResult(runBenchmark(name, ElementCount, [&map]
+		{
+			uint64 sum = 0;
+			for (const auto& [key, value] : map)
+			{
+				sum += value;
+			}
+			doNotOptimize(sum);
+		}));
+	}
+
+	void benchmarkLookup(const Input& input)
+	{
+		const FlatMap<uint64, uint64> flat(input.pairs.begin(), input.pairs.end());
+		const std::map<uint64, uint64> tree(input.pairs.begin(), input.pairs.end());
+
+		FlatHashMap<uint64, uint64> hash;
+		for (const auto& [key, value] : input.pairs)
+		{
+			hash.tryEmplace(key, value);
+		}
+
+		benchmarkFind("FlatMap: find, hit", flat, input.lookups);
+		benchmarkFind("std::map: find, hit", tree, input.lookups);
+		benchmarkFind("FlatHashMap: find, hit", hash, input.lookups);
+
+		benchmarkIterate("FlatMap: iterate", flat);
+		benchmarkIterate("std::map: iterate", tree);
+		benchmarkIterate("FlatHashMap: iterate", hash);
+	}
+}
+
+void runFlatMapBenchmarks()
+{
+	char title[96];
+	std::snprintf(title, sizeof(title), "Sorted flat map, %zu x uint64 -> uint64", ElementCount);
+	printHeader(title);
+
+	const Input input = makeInput();
+
+	benchmarkBuild(input);
+	benchmarkSearch(input);
+	benchmarkLookup(input);
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/FlatHashMap.h"
+
+namespace
+{
+	constexpr size_t ElementCount = 1 << 19;
+
+	template<typename K>
+	struct HashKey;
+
+	template<>
+	struct HashKey<uint64>
+	{
+		static constexpr const char* Name = "uint64";
+
+		using Hash = std::hash<uint64>;
+		using Equal = std::equal_to<uint64>;
+
+		// Spread out, the way ids and pointers are; sequential keys would flatter std's identity hash.
+		static uint64 make(size_t i) { return static_cast<uint64>(i) * 0x9E3779B97F4A7C15ull; }
+	};
+
+	template<>
+	struct HashKey<std::string>
+	{
+		static constexpr const char* Name = "string";
+
+		using Hash = StringHash;
+		using Equal = std::equal_to<>;
+
+		static std::string make(size_t i) { return "session/" + std::to_string(i) + "/user"; }
+	};
+
+	/** The two maps behind the same spelling, like the container backends. */
+	template<typename K>
+	struct FlatHashMapBackend
+	{
+		static constexpr const char* Name = "FlatHashMap";
+
+		FlatHashMap<K, uint64, typename HashKey<K>::Hash, typename HashKey<K>::Equal> map;
+
+		void reserve(size_t n) { map.reserve(n); }
+		void insert(const K& key, uint64 value) { map.tryEmplace(key, value); }
+		uint64 find(const K& key) const { auto it = map.find(key); return it == map.end() ? 0 : it->second; }
+		void erase(const K& key) { map.erase(key); }
+	};
+
+	template<typename K>
+	struct StdUnorderedMapBackend
+	{
+		static constexpr const char* Name = "std::unordered_map";
+
+		std::unordered_map<K, uint64, typename HashKey<K>::Hash, typename HashKey<K>::Equal> map;
+
+		void reserve(size_t n) { map.reserve(n); }
+		void insert(const K& key, uint64 value) { map.try_emplace(key, value); }
+		uint64 find(const K& key) const { auto it = map.find(key); return it == map.end() ? 0 : it->second; }
+		void erase(const K& key) { map.erase(key); }
+	};
+
+	template<typename K>
+	struct Keys
+	{
+		std::vector<K> present;
+
+		/** The same keys in another order, so lookups don't walk the table in insertion order. */
+		std::vector<K> shuffled;
+
+		std::vector<K> absent;
+	};
+
+	template<typename K>
+	Keys<K> makeKeys()
+	{
+		Keys<K> keys;
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			keys.present.push_back(HashKey<K>::make(i));
+			keys.absent.push_back(HashKey<K>::make(ElementCount + i));
+		}
+
+		keys.shuffled = keys.present;
+		std::shuffle(keys.shuffled.begin(), keys.shuffled.end(), std::mt19937(7));
+
+		return keys;
+	}
+
+	template<typename BackendType, typename K>
+	BackendType makeFilled(const Keys<K>& keys)
+	{
+		BackendType backend;
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			backend.insert(keys.present[i], i);
+		}
+		return backend;
+	}
+
+	template<template<typename> typename Backend, typename K>
+	void benchmarkBackend(const Keys<K>& keys)
+	{
+		using BackendType = Backend<K>;
+
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%s<%s>: insert", BackendType::Name, HashKey<K>::Name);
+		printResult(runBenchmarkWithSetup(name, ElementCount, [] { return BackendType(); }, [&keys](BackendType& backend)
+		{
+			for (size_t i = 0; i < ElementCount; ++i)
+			{
+				backend.insert(keys.present[i], i);
+			}
+		}));
+
+		std::snprintf(name, sizeof(name), "%s<%s>: insert, reserved", BackendType::Name, HashKey<K>::Name);
+		printResult(runBenchmarkWithSetup(name, ElementCount,
+			[]
+			{
+				BackendType backend;
+				backend.reserve(ElementCount);
+				return backend;
+			},
+			[&keys](BackendType& backend)
+			{
+				for (size_t i = 0; i < ElementCount; ++i)
+				{
+					backend.insert(keys.present[i], i);
+				}
+			}));
+
+		const BackendType filled = makeFilled<BackendType>(keys);
+
+		std::snprintf(name, sizeof(name), "%s<%s>: find, hit", BackendType::Name, HashKey<K>::Name);
+		printResult(runBenchmark(name, ElementCount, [&keys, &filled]
+		{
+			uint64 sum = 0;
+			for (const K& key : keys.shuffled)
+			{
+				sum += filled.find(key);
+			}
+			doNotOptimize(sum);
+		}));
+
+		std::snprintf(name, sizeof(name), "%s<%s>: find, miss", BackendType::Name, HashKey<K>::Name);
+		printResult(runBenchmark(name, ElementCount, [&keys, &filled]
+		{
+			uint64 sum = 0;
+			for (const K& key : keys.absent)
+			{
+				sum += filled.find(key);
+			}
+			doNotOptimize(sum);
+		}));
+
+		std::snprintf(name, sizeof(name), "%s<%s>: iterate", BackendType::Name, HashKey<K>::Name);
+		printResult(runBenchmark(name, ElementCount, [&filled]
+		{
+			uint64 sum = 0;
+			for (const auto& [key, value] : filled.map)
+			{
+				sum += value;
+			}
+			doNotOptimize(sum);
+		}));
+
+		std::snprintf(name, sizeof(name), "%s<%s>: erase", BackendType::Name, HashKey<K>::Name);
+		printResult(runBenchmarkWithSetup(name, ElementCount, [&keys] { return makeFilled<BackendType>(keys); }, [&keys](BackendType& backend)
+		{
+			for (const K& key : keys.shuffled)
+			{
+				backend.erase(key);
+			}
+		}));
+	}
+
+	template<typename K>
+	void benchmarkKey()
+	{
+		char title[96];
+		std::snprintf(title, sizeof(title), "Hash maps, %zu x %s -> uint64", ElementCount, HashKey<K>::Name);
+		printHeader(title);
+
+		const Keys<K> keys = makeKeys<K>();
+
+		benchmarkBackend<FlatHashMapBackend, K>(keys);
+		benchmarkBackend<StdUnorderedMapBackend, K>(keys);
+	}
+}
+
+void runHashMapBenchmarks()
+{
+	benchmarkKey<uint64>();
+	benchmarkKey<std::string>();
+}
@@ -0,0 +1,56 @@
+#include "HeapCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define HEAP_BLOCK_SIZE(p) _msize(p)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define HEAP_BLOCK_SIZE(p) malloc_size(p)
+#else
+#include <malloc.h>
+#define HEAP_BLOCK_SIZE(p) malloc_usable_size(p)
+#endif
+
+namespace
+{
+	std::atomic<size_t> gLiveBytes{ 0 };
+	std::atomic<size_t> gAllocations{ 0 };
+}
+
+HeapStats heapStats()
+{
+	return HeapStats{ gLiveBytes.load(std::memory_order_relaxed), gAllocations.load(std::memory_order_relaxed) };
+}
+
+void* operator new(size_t size)
+{
+	void* p = std::malloc(size == 0 ? 1 : size);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+
+	gLiveBytes.fetch_add(HEAP_BLOCK_SIZE(p), std::memory_order_relaxed);
+	gAllocations.fetch_add(1, std::memory_order_relaxed);
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	if (!p)
+	{
+		return;
+	}
+
+	gLiveBytes.fetch_sub(HEAP_BLOCK_SIZE(p), std::memory_order_relaxed);
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	operator delete(p);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * Counts what goes through the global operator new/delete of the benchmark executable
+ * (see HeapCounter.cpp). Bytes are the real block sizes reported by the C runtime,
+ * so allocator rounding and per-node waste are included.
+ */
+struct HeapStats
+{
+	size_t liveBytes{ 0 };
+	size_t allocations{ 0 };
+};
+
+HeapStats heapStats();
@@ -0,0 +1,164 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ContainerBackends.h"
+
+#include "../Algorithms/LatencyHistogram.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using Histogram = LatencyHistogram<>;
+
+	constexpr size_t ElementCount = 1 << 18;
+	constexpr size_t ThreadCount = 4;
+
+	uint64 nanosecondsBetween(Clock::time_point start, Clock::time_point end)
+	{
+		return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	void printLatencyHeader(const char* title)
+	{
+		std::printf("\n== %s ==\n", title);
+		std::printf("%-48s %8s %8s %8s %10s %12s\n", "case (ns)", "p50", "p99", "p99.9", "max", "mean");
+	}
+
+	void printLatency(const char* name, const Histogram& histogram)
+	{
+		std::printf("%-48s %8llu %8llu %8llu %10llu %12.1f\n", name,
+			static_cast<unsigned long long>(histogram.valueAtPercentile(50.0)),
+			static_cast<unsigned long long>(histogram.valueAtPercentile(99.0)),
+			static_cast<unsigned long long>(histogram.valueAtPercentile(99.9)),
+			static_cast<unsigned long long>(histogram.max()),
+			histogram.mean());
+	}
+
+	/** Two clock reads with nothing in between: the floor under every number of this suite. */
+	void benchmarkClock()
+	{
+		Histogram histogram;
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			const Clock::time_point start = Clock::now();
+			histogram.record(nanosecondsBetween(start, Clock::now()));
+		}
+		printLatency("clock overhead", histogram);
+	}
+
+	/** Pushes N elements into an empty container, then pops them all, timing every single call. */
+	template<typename BackendType, typename T>
+	void recordPushPop(BackendType& backend, Histogram& pushes, Histogram& pops)
+	{
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			T val = Element<T>::make(i);
+
+			const Clock::time_point start = Clock::now();
+			backend.push(std::move(val));
+			pushes.record(nanosecondsBetween(start, Clock::now()));
+		}
+
+		while (!backend.empty())
+		{
+			doNotOptimize(backend.next());
+
+			const Clock::time_point start = Clock::now();
+			backend.pop();
+			pops.record(nanosecondsBetween(start, Clock::now()));
+		}
+	}
+
+	template<template<typename> typename Backend, typename T>
+	void benchmarkBackend()
+	{
+		Histogram pushes;
+		Histogram pops;
+		{
+			Backend<T> backend;
+			recordPushPop<Backend<T>, T>(backend, pushes, pops);
+		}
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s<%s>: push", Backend<T>::Name, Element<T>::Name);
+		printLatency(name, pushes);
+		std::snprintf(name, sizeof(name), "%s<%s>: pop", Backend<T>::Name, Element<T>::Name);
+		printLatency(name, pops);
+	}
+
+	/**
+	 * Every thread fills its own container and records into its own histogram; they are merged
+	 * afterwards. The containers share nothing but the allocator, so the tail is allocator stalls.
+	 */
+	template<template<typename> typename Backend>
+	void benchmarkThreaded()
+	{
+		std::vector<Histogram> pushes(ThreadCount);
+		std::vector<Histogram> pops(ThreadCount);
+
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < ThreadCount; ++t)
+		{
+			threads.emplace_back([&pushes, &pops, t]
+			{
+				Backend<int> backend;
+				recordPushPop<Backend<int>, int>(backend, pushes[t], pops[t]);
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (size_t t = 1; t < ThreadCount; ++t)
+		{
+			pushes[0].merge(pushes[t]);
+			pops[0].merge(pops[t]);
+		}
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s<int>: push, %zu threads", Backend<int>::Name, ThreadCount);
+		printLatency(name, pushes[0]);
+		std::snprintf(name, sizeof(name), "%s<int>: pop, %zu threads", Backend<int>::Name, ThreadCount);
+		printLatency(name, pops[0]);
+	}
+
+	template<typename T>
+	void benchmarkElement()
+	{
+		char title[96];
+		std::snprintf(title, sizeof(title), "Per-operation latency, %zu x %s", ElementCount, Element<T>::Name);
+		printLatencyHeader(title);
+
+		benchmarkClock();
+		benchmarkBackend<VectorBackend, T>();
+		benchmarkBackend<StdVectorBackend, T>();
+		benchmarkBackend<SingleLinkedListBackend, T>();
+		benchmarkBackend<StdForwardListBackend, T>();
+		benchmarkBackend<DoubleLinkedListBackend, T>();
+		benchmarkBackend<StdListBackend, T>();
+		benchmarkBackend<StackBackend, T>();
+		benchmarkBackend<StdStackBackend, T>();
+		benchmarkBackend<QueueBackend, T>();
+		benchmarkBackend<StdQueueBackend, T>();
+	}
+}
+
+void runLatencyBenchmarks()
+{
+	benchmarkElement<int>();
+	benchmarkElement<std::string>();
+
+	char title[96];
+	std::snprintf(title, sizeof(title), "Per-operation latency, %zu x int per thread, merged", ElementCount);
+	printLatencyHeader(title);
+
+	benchmarkThreaded<VectorBackend>();
+	benchmarkThreaded<DoubleLinkedListBackend>();
+	benchmarkThreaded<StdListBackend>();
+}
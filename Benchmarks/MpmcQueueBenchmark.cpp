@@ -0,0 +1,172 @@
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/MpmcQueue.h"
+#include "../Algorithms/Queue.h"
+
+namespace
+{
+	constexpr size_t ItemCount = 1 << 20;
+	constexpr size_t Capacity = 1024;
+	constexpr size_t BatchSize = 32;
+
+	struct LockedQueue
+	{
+		std::mutex mutex;
+		Queue<int> queue;
+
+		bool tryPush(int val)
+		{
+			std::lock_guard lock(mutex);
+			queue.push(val);
+			return true;
+		}
+
+		bool tryPop(int& out)
+		{
+			std::lock_guard lock(mutex);
+			if (queue.isEmpty())
+			{
+				return false;
+			}
+			out = queue.front();
+			queue.pop();
+			return true;
+		}
+	};
+
+	template<typename QueueType>
+	size_t pushSome(QueueType& queue, int* items, size_t count, bool bBatched)
+	{
+		if constexpr (requires { queue.tryPushN(items, count); })
+		{
+			if (bBatched)
+			{
+				return queue.tryPushN(items, count);
+			}
+		}
+		return queue.tryPush(items[0]) ? 1 : 0;
+	}
+
+	template<typename QueueType>
+	size_t popSome(QueueType& queue, int* items, size_t count, bool bBatched)
+	{
+		if constexpr (requires { queue.tryPopN(items, count); })
+		{
+			if (bBatched)
+			{
+				return queue.tryPopN(items, count);
+			}
+		}
+		return queue.tryPop(items[0]) ? 1 : 0;
+	}
+
+	/**
+	 * Half of the threads produce, half consume, ItemCount items in total.
+	 * With one thread it alternates between pushing and popping.
+	 */
+	template<typename QueueType>
+	void contend(QueueType& queue, size_t threadCount, bool bBatched)
+	{
+		const size_t producers = threadCount == 1 ? 1 : threadCount / 2;
+		const size_t consumers = threadCount == 1 ? 0 : threadCount - producers;
+		const size_t batch = bBatched ? BatchSize : 1;
+
+		if (consumers == 0)
+		{
+			int items[BatchSize] = {};
+			for (size_t done = 0; done < ItemCount;)
+			{
+				size_t pushed = pushSome(queue, items, batch, bBatched);
+				size_t popped = 0;
+				while (popped < pushed)
+				{
+					popped += popSome(queue, items, pushed - popped, bBatched);
+				}
+				done += pushed;
+			}
+			return;
+		}
+
+		std::atomic<size_t> consumed{ 0 };
+		std::vector<std::thread> threads;
+
+		for (size_t p = 0; p < producers; ++p)
+		{
+			threads.emplace_back([&, p]
+			{
+				const size_t share = ItemCount / producers + (p < ItemCount % producers ? 1 : 0);
+				int items[BatchSize] = {};
+				for (size_t sent = 0; sent < share;)
+				{
+					size_t n = pushSome(queue, items, std::min(batch, share - sent), bBatched);
+					if (n == 0)
+					{
+						std::this_thread::yield();
+					}
+					sent += n;
+				}
+			});
+		}
+
+		for (size_t c = 0; c < consumers; ++c)
+		{
+			threads.emplace_back([&]
+			{
+				int items[BatchSize];
+				while (consumed.load(std::memory_order_relaxed) < ItemCount)
+				{
+					size_t n = popSome(queue, items, batch, bBatched);
+					if (n == 0)
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					doNotOptimize(items[n - 1]);
+					consumed.fetch_add(n, std::memory_order_relaxed);
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+}
+
+void runMpmcQueueBenchmarks()
+{
+	printHeader("MPMC contention, threads split between producers and consumers");
+
+	for (size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "%2zu threads: Queue<int> + std::mutex", threads);
+		printResult(runBenchmark(name, ItemCount, [threads]
+		{
+			LockedQueue queue;
+			contend(queue, threads, false);
+		}, 3));
+
+		std::snprintf(name, sizeof(name), "%2zu threads: MpmcQueue<int>", threads);
+		printResult(runBenchmark(name, ItemCount, [threads]
+		{
+			MpmcQueue<int> queue(Capacity);
+			contend(queue, threads, false);
+		}, 3));
+
+		std::snprintf(name, sizeof(name), "%2zu threads: MpmcQueue<int> batches of %zu", threads, BatchSize);
+		printResult(runBenchmark(name, ItemCount, [threads]
+		{
+			MpmcQueue<int> queue(Capacity);
+			contend(queue, threads, true);
+		}, 3));
+	}
+}
@@ -0,0 +1,84 @@
+#include <atomic>
+#include <cstdio>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/NumaAllocator.h"
+#include "../Algorithms/ThreadPool.h"
+#include "../Algorithms/Vector.h"
+
+namespace
+{
+	constexpr size_t ElementCount = size_t{ 1 } << 23;
+
+	/** Fills the vector from this thread, the way a loader would. */
+	template<typename VectorType>
+	void fill(VectorType& vec)
+	{
+		for (size_t i = 0; i < ElementCount; ++i)
+		{
+			vec.pushBack(static_cast<int64>(i));
+		}
+	}
+
+	/**
+	 * Every worker sums its share of the vector; memory bandwidth is what limits this. Worker w
+	 * always reads part w, the same split numaFirstTouch() uses, so it reads the pages it placed.
+	 */
+	template<typename VectorType>
+	void benchmarkScan(const char* name, ThreadPool& pool, const VectorType& vec)
+	{
+		const BenchmarkResult result = runBenchmark(name, ElementCount, [&pool, &vec]
+		{
+			std::atomic<int64> total{ 0 };
+			const size_t workers = pool.threadCount();
+
+			pool.forEachWorker([&](size_t worker)
+			{
+				int64 sum = 0;
+				const size_t last = (worker + 1) * ElementCount / workers;
+				for (size_t i = worker * ElementCount / workers; i < last; ++i)
+				{
+					sum += vec[i];
+				}
+				total.fetch_add(sum, std::memory_order_relaxed);
+			});
+
+			doNotOptimize(total.load());
+		});
+
+		printResult(result);
+		std::printf("%-56s %12.2f GB/s\n", "", static_cast<double>(ElementCount * sizeof(int64)) / result.seconds / 1e9);
+	}
+}
+
+void runNumaBenchmarks()
+{
+	char title[96];
+	std::snprintf(title, sizeof(title), "NUMA placement: parallel scan of a 64 MiB Vector<int64>, %zu node(s)", numaNodeCount());
+	printHeader(title);
+
+	ThreadPool pool;
+
+	{
+		Vector<int64> vec;
+		vec.reserve(ElementCount);
+		fill(vec);
+		benchmarkScan("std::allocator, filled by one thread", pool, vec);
+	}
+
+	{
+		Vector<int64, NumaAllocator<int64>> vec;
+		vec.reserve(ElementCount);
+		numaFirstTouch(vec, pool);
+		fill(vec);
+		benchmarkScan("NumaAllocator first touch by the workers", pool, vec);
+	}
+
+	{
+		Vector<int64, NumaAllocator<int64>> vec{ NumaAllocator<int64>(NumaPolicy::Interleave) };
+		vec.reserve(ElementCount);
+		fill(vec);
+		benchmarkScan("NumaAllocator interleaved", pool, vec);
+	}
+}
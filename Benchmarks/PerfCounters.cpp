@@ -0,0 +1,175 @@
+#include "PerfCounters.h"
+
+#include <cstdio>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+namespace
+{
+	struct EventConfig
+	{
+		uint32 type;
+		uint64 config;
+	};
+
+	constexpr uint64 cacheEvent(uint64 cache, uint64 op, uint64 result)
+	{
+		return cache | (op << 8) | (result << 16);
+	}
+
+	// Indexed by PerfEvent. "Cache misses" is the generic event the kernel maps to the last level.
+	constexpr EventConfig EventConfigs[PerfEventCount] = {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	};
+
+	int openEvent(const EventConfig& event)
+	{
+		perf_event_attr attr{};
+		attr.size = sizeof(attr);
+		attr.type = event.type;
+		attr.config = event.config;
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+}
+
+PerfCounters::PerfCounters()
+{
+	int lastError = 0;
+	for (size_t i = 0; i < PerfEventCount; ++i)
+	{
+		fds_[i] = openEvent(EventConfigs[i]);
+		if (fds_[i] < 0)
+		{
+			lastError = errno;
+		}
+	}
+
+	if (!isAvailable())
+	{
+		std::snprintf(reason_, sizeof(reason_), "perf_event_open failed: %s", std::strerror(lastError));
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (int fd : fds_)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+}
+
+void PerfCounters::start()
+{
+	for (int fd : fds_)
+	{
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+PerfSample PerfCounters::stop()
+{
+	for (int fd : fds_)
+	{
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+
+	PerfSample sample;
+	for (size_t i = 0; i < PerfEventCount; ++i)
+	{
+		// value, time enabled, time running
+		uint64 data[3]{};
+		if (fds_[i] < 0 || read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+		{
+			continue;
+		}
+
+		/**
+		 * 1. never got onto the PMU - no number at all
+		 * 2. shared the PMU with other events - extrapolate to the whole time it was enabled
+		 */
+		if (data[2] == 0)
+		{
+			continue;
+		}
+
+		sample.values[i] = data[2] < data[1]
+			? static_cast<uint64>(static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]))
+			: data[0];
+		sample.bValid[i] = true;
+	}
+
+	return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters()
+{
+	for (int& fd : fds_)
+	{
+		fd = -1;
+	}
+
+	std::snprintf(reason_, sizeof(reason_), "hardware counters are only read on Linux");
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start()
+{
+}
+
+PerfSample PerfCounters::stop()
+{
+	return PerfSample{};
+}
+
+#endif
+
+PerfCounters& PerfCounters::instance()
+{
+	static PerfCounters counters;
+	return counters;
+}
+
+bool PerfCounters::isAvailable() const noexcept
+{
+	for (int fd : fds_)
+	{
+		if (fd >= 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+
+#include "../Algorithms/Types.h"
+
+/**
+ * Hardware counters around a benchmark case, read through perf_event_open on Linux.
+ *
+ * Every event is opened on its own rather than as a group: a PMU with too few registers, or a
+ * kernel that refuses one event, then only costs that column. When nothing can be opened at all
+ * (perf_event_paranoid, a VM without a virtual PMU, another OS) isAvailable() is false and the
+ * harness prints wall-clock time only.
+ *
+ * The counters follow the thread that opened them. Threads a case starts are added in as well,
+ * but only once they have exited, so for the threaded suites the numbers are the main thread's.
+ */
+enum class PerfEvent
+{
+	Cycles,
+	Instructions,
+	L1dMisses,
+	LlcMisses,
+	BranchMisses,
+
+	Count
+};
+
+inline constexpr size_t PerfEventCount = static_cast<size_t>(PerfEvent::Count);
+
+struct PerfSample
+{
+	uint64 values[PerfEventCount]{};
+	bool bValid[PerfEventCount]{};
+
+	bool has(PerfEvent event) const noexcept { return bValid[static_cast<size_t>(event)]; }
+	uint64 get(PerfEvent event) const noexcept { return values[static_cast<size_t>(event)]; }
+};
+
+class PerfCounters final
+{
+public:
+	/** Opens the counters for the calling thread on first use. */
+	static PerfCounters& instance();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	/** True if at least one event could be opened. */
+	bool isAvailable() const noexcept;
+
+	/** Why no event could be opened; empty while isAvailable(). */
+	const char* unavailableReason() const noexcept { return reason_; }
+
+	bool isOpen(PerfEvent event) const noexcept { return fds_[static_cast<size_t>(event)] >= 0; }
+
+	/** Zeroes and enables every open counter. */
+	void start();
+
+	/** Stops the counters and reads them, scaled up if the kernel had to multiplex them. */
+	PerfSample stop();
+
+private:
+	PerfCounters();
+	~PerfCounters();
+
+private:
+	int fds_[PerfEventCount];
+	char reason_[128]{};
+};
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/PriorityQueue.h"
+
+namespace
+{
+	constexpr size_t ElementCount = 1 << 20;
+
+	std::vector<int> randomValues()
+	{
+		std::mt19937 random(42);
+		std::vector<int> values(ElementCount);
+		for (auto& value : values)
+		{
+			value = static_cast<int>(random());
+		}
+		return values;
+	}
+
+	template<size_t Arity>
+	void benchmarkArity(const std::vector<int>& values)
+	{
+		char name[64];
+
+		std::snprintf(name, sizeof(name), "PriorityQueue, %zu-ary: push N, pop N", Arity);
+		printResult(runBenchmark(name, 2 * ElementCount, [&values]
+		{
+			PriorityQueue<int, std::less<int>, Arity> queue;
+			for (int value : values)
+			{
+				queue.push(value);
+			}
+			while (!queue.isEmpty())
+			{
+				doNotOptimize(queue.top());
+				queue.pop();
+			}
+		}, 3));
+
+		std::snprintf(name, sizeof(name), "PriorityQueue, %zu-ary: pushRange (heapify)", Arity);
+		printResult(runBenchmark(name, ElementCount, [&values]
+		{
+			PriorityQueue<int, std::less<int>, Arity> queue(values.begin(), values.end());
+			doNotOptimize(queue.top());
+		}, 3));
+	}
+}
+
+void runPriorityQueueBenchmarks()
+{
+	printHeader("PriorityQueue<int>, random keys");
+
+	const std::vector<int> values = randomValues();
+
+	benchmarkArity<2>(values);
+	benchmarkArity<4>(values);
+	benchmarkArity<8>(values);
+
+	printResult(runBenchmark("std::priority_queue: push N, pop N", 2 * ElementCount, [&values]
+	{
+		std::priority_queue<int> queue;
+		for (int value : values)
+		{
+			queue.push(value);
+		}
+		while (!queue.empty())
+		{
+			doNotOptimize(queue.top());
+			queue.pop();
+		}
+	}, 3));
+
+	printResult(runBenchmark("std::priority_queue: range constructor", ElementCount, [&values]
+	{
+		std::priority_queue<int> queue(values.begin(), values.end());
+		doNotOptimize(queue.top());
+	}, 3));
+}
@@ -0,0 +1,192 @@
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/Queue.h"
+#include "../Algorithms/SpscQueue.h"
+
+namespace
+{
+	constexpr size_t ItemCount = 1 << 22;
+	constexpr size_t RoundTrips = 100000;
+	constexpr size_t Capacity = 1024;
+	constexpr size_t BatchSize = 64;
+
+	/** Spinning without yielding starves the other side when both threads share one core. */
+	void backOff()
+	{
+		std::this_thread::yield();
+	}
+
+	/** The baseline: the regular Queue behind a mutex, as the pipeline uses it today. */
+	struct LockedQueue
+	{
+		std::mutex mutex;
+		Queue<int> queue;
+
+		bool tryPush(int val)
+		{
+			std::lock_guard lock(mutex);
+			queue.push(val);
+			return true;
+		}
+
+		bool tryPop(int& out)
+		{
+			std::lock_guard lock(mutex);
+			if (queue.isEmpty())
+			{
+				return false;
+			}
+			out = queue.front();
+			queue.pop();
+			return true;
+		}
+	};
+
+	template<typename QueueType>
+	void transfer(QueueType& queue)
+	{
+		std::thread producer([&]
+		{
+			for (size_t i = 0; i < ItemCount; ++i)
+			{
+				while (!queue.tryPush(static_cast<int>(i)))
+				{
+					backOff();
+				}
+			}
+		});
+
+		int val = 0;
+		for (size_t i = 0; i < ItemCount; ++i)
+		{
+			while (!queue.tryPop(val))
+			{
+				backOff();
+			}
+			doNotOptimize(val);
+		}
+
+		producer.join();
+	}
+
+	void transferBatched(SpscQueue<int>& queue)
+	{
+		std::thread producer([&]
+		{
+			int batch[BatchSize];
+			for (size_t i = 0; i < ItemCount; i += BatchSize)
+			{
+				for (size_t j = 0; j < BatchSize; ++j)
+				{
+					batch[j] = static_cast<int>(i + j);
+				}
+
+				size_t pushed = 0;
+				while (pushed < BatchSize)
+				{
+					size_t n = queue.tryPushN(batch + pushed, BatchSize - pushed);
+					if (n == 0)
+					{
+						backOff();
+					}
+					pushed += n;
+				}
+			}
+		});
+
+		int batch[BatchSize];
+		size_t received = 0;
+		while (received < ItemCount)
+		{
+			size_t n = queue.tryPopN(batch, BatchSize);
+			if (n == 0)
+			{
+				backOff();
+				continue;
+			}
+			doNotOptimize(batch[n - 1]);
+			received += n;
+		}
+
+		producer.join();
+	}
+
+	/** One message in flight: a ping goes through `there`, the pong comes back through `back`. */
+	template<typename QueueType>
+	double oneWayLatencyNs(QueueType& there, QueueType& back)
+	{
+		std::thread echo([&]
+		{
+			int val = 0;
+			for (size_t i = 0; i < RoundTrips; ++i)
+			{
+				while (!there.tryPop(val))
+				{
+					backOff();
+				}
+				while (!back.tryPush(val))
+				{
+					backOff();
+				}
+			}
+		});
+
+		auto start = std::chrono::steady_clock::now();
+		int val = 0;
+		for (size_t i = 0; i < RoundTrips; ++i)
+		{
+			while (!there.tryPush(static_cast<int>(i)))
+			{
+				backOff();
+			}
+			while (!back.tryPop(val))
+			{
+				backOff();
+			}
+		}
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+		echo.join();
+		return elapsed.count() / RoundTrips / 2;
+	}
+}
+
+void runSpscQueueBenchmarks()
+{
+	printHeader("SPSC transfer, 1 producer -> 1 consumer");
+
+	printResult(runBenchmark("Queue<int> + std::mutex", ItemCount, []
+	{
+		LockedQueue queue;
+		transfer(queue);
+	}, 3));
+
+	printResult(runBenchmark("SpscQueue<int> tryPush/tryPop", ItemCount, []
+	{
+		SpscQueue<int> queue(Capacity);
+		transfer(queue);
+	}, 3));
+
+	printResult(runBenchmark("SpscQueue<int> tryPushN/tryPopN (64)", ItemCount, []
+	{
+		SpscQueue<int> queue(Capacity);
+		transferBatched(queue);
+	}, 3));
+
+	std::printf("\n%-56s %12s\n", "ping-pong latency", "ns one-way");
+	{
+		LockedQueue there;
+		LockedQueue back;
+		std::printf("%-56s %12.1f\n", "Queue<int> + std::mutex", oneWayLatencyNs(there, back));
+	}
+	{
+		SpscQueue<int> there(Capacity);
+		SpscQueue<int> back(Capacity);
+		std::printf("%-56s %12.1f\n", "SpscQueue<int>", oneWayLatencyNs(there, back));
+	}
+}
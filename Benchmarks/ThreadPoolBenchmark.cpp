@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <thread>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/ThreadPool.h"
+
+namespace
+{
+	constexpr int FibN = 27;
+
+	int64 serialFib(int n)
+	{
+		return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2);
+	}
+
+	/** Number of calls serialFib(n) makes, i.e. how many tasks the parallel version spawns without a cutoff. */
+	size_t callCount(int n)
+	{
+		return n < 2 ? 1 : 1 + callCount(n - 1) + callCount(n - 2);
+	}
+
+	/** Below `cutoff` the recursion runs serially; with a cutoff of 2 every call but the leaves spawns a task. */
+	int64 parallelFib(ThreadPool& pool, int n, int cutoff)
+	{
+		if (n < cutoff)
+		{
+			return serialFib(n);
+		}
+
+		int64 left = 0;
+		TaskGroup group(pool);
+		group.run([&] { left = parallelFib(pool, n - 1, cutoff); });
+		int64 right = parallelFib(pool, n - 2, cutoff);
+		group.wait();
+
+		return left + right;
+	}
+}
+
+void runThreadPoolBenchmarks()
+{
+	const size_t calls = callCount(FibN);
+
+	char title[96];
+	std::snprintf(title, sizeof(title), "Recursive fork/join, fib(%d), ns per fib call", FibN);
+	printHeader(title);
+
+	printResult(runBenchmark("serial", calls, []
+	{
+		doNotOptimize(serialFib(FibN));
+	}));
+
+	const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (size_t threads = 1; threads <= std::max<size_t>(4, hardwareThreads); threads *= 2)
+	{
+		ThreadPool pool(threads);
+
+		for (int cutoff : { 2, 12 })
+		{
+			char name[64];
+			std::snprintf(name, sizeof(name), "%2zu workers, spawning down to n = %d", threads, cutoff);
+			printResult(runBenchmark(name, calls, [&pool, cutoff]
+			{
+				doNotOptimize(pool.submit([&pool, cutoff] { return parallelFib(pool, FibN, cutoff); }).get());
+			}));
+		}
+	}
+}
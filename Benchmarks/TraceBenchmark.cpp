@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "../Algorithms/CompactList.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/RingBuffer.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Vector.h"
+#include "../Algorithms/WorkloadTrace.h"
+
+namespace
+{
+	constexpr size_t SyntheticOperations = 1 << 18;
+	constexpr size_t SyntheticMaxSize = 4096;
+
+	/**
+	 * Stands in for a recorded trace when none is given: a queue that mostly pushes at the back and
+	 * pops at the front, with some work at the other ends, index lookups and full scans, hovering
+	 * around SyntheticMaxSize elements of varying length.
+	 */
+	WorkloadTrace makeSyntheticTrace()
+	{
+		WorkloadTrace trace;
+		TracedContainer<Vector<std::string>> traced(trace);
+
+		std::mt19937 random(42);
+		for (size_t i = 0; i < SyntheticOperations; ++i)
+		{
+			const uint32 roll = random() % 100;
+			const size_t size = traced.size();
+
+			if (size == 0 || (size < SyntheticMaxSize && roll < 45))
+			{
+				traced.pushBack(std::string(8 + random() % 56, 'x'));
+			}
+			else if (size < SyntheticMaxSize && roll < 50)
+			{
+				traced.pushFront(std::string(8 + random() % 56, 'x'));
+			}
+			else if (roll < 85)
+			{
+				traced.popFront();
+			}
+			else if (roll < 90)
+			{
+				traced.popBack();
+			}
+			else if (roll < 99)
+			{
+				doNotOptimize(traced.get(random() % size));
+			}
+			else
+			{
+				traced.forEach([](const std::string& val) { doNotOptimize(val); });
+			}
+		}
+
+		return trace;
+	}
+
+	template<typename T>
+	struct TraceElement;
+
+	template<>
+	struct TraceElement<int>
+	{
+		static constexpr const char* Name = "int";
+
+		static int make(uint64 size) { return static_cast<int>(size); }
+		static size_t read(const int& val) { return static_cast<size_t>(val); }
+	};
+
+	/** Strings of the recorded length, so the replay allocates what the recorded program did. */
+	template<>
+	struct TraceElement<std::string>
+	{
+		static constexpr const char* Name = "string";
+
+		static std::string make(uint64 size) { return std::string(static_cast<size_t>(size), 'x'); }
+		static size_t read(const std::string& val) { return val.size(); }
+	};
+
+	template<typename Container, typename T>
+	void benchmarkReplay(const char* containerName, const Vector<TraceEvent>& events)
+	{
+		TraceReplayResult replay;
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%s<%s>", containerName, TraceElement<T>::Name);
+		printResult(runBenchmarkWithSetup(name, events.size(), [] { return Container(); }, [&events, &replay](Container& container)
+		{
+			size_t sum = 0;
+			replay = replayTrace(events, container, TraceElement<T>::make, [&sum](const T& val) { sum += TraceElement<T>::read(val); });
+			doNotOptimize(sum);
+		}));
+
+		if (replay.skipped > 0)
+		{
+			std::printf("  (%s skipped %llu of the operations)\n", name, static_cast<unsigned long long>(replay.skipped));
+		}
+	}
+
+	template<typename T>
+	void benchmarkElement(const char* traceName, const Vector<TraceEvent>& events)
+	{
+		char title[128];
+		std::snprintf(title, sizeof(title), "Replay of %s, %zu operations, %s", traceName, events.size(), TraceElement<T>::Name);
+		printHeader(title);
+
+		benchmarkReplay<Vector<T>, T>("Vector", events);
+		benchmarkReplay<std::vector<T>, T>("std::vector", events);
+		benchmarkReplay<RingBuffer<T>, T>("RingBuffer", events);
+		benchmarkReplay<std::deque<T>, T>("std::deque", events);
+		benchmarkReplay<DoubleLinkedList<T>, T>("DoubleLinkedList", events);
+		benchmarkReplay<CompactList<T>, T>("CompactList", events);
+		benchmarkReplay<std::list<T>, T>("std::list", events);
+		benchmarkReplay<SingleLinkedList<T>, T>("SingleLinkedList", events);
+	}
+}
+
+void runTraceBenchmarks()
+{
+	const char* path = benchmarkReport().tracePath;
+
+	WorkloadTrace trace;
+	if (path)
+	{
+		if (!trace.load(path))
+		{
+			std::printf("\n%s is not a readable trace, skipping the replay suite.\n", path);
+			return;
+		}
+	}
+	else
+	{
+		trace = makeSyntheticTrace();
+	}
+
+	const Vector<TraceEvent> events = trace.events();
+	const char* traceName = path ? path : "synthetic trace";
+
+	benchmarkElement<int>(traceName, events);
+	benchmarkElement<std::string>(traceName, events);
+}
@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <cstring>
+
+#include "Benchmark.h"
+
+void runContainerBenchmarks();
+void runLatencyBenchmarks();
+void runTraceBenchmarks();
+void runHashMapBenchmarks();
+void runFlatMapBenchmarks();
+void runQueueBenchmarks();
+void runStackBenchmarks();
+void runPriorityQueueBenchmarks();
+void runSpscQueueBenchmarks();
+void runMpmcQueueBenchmarks();
+void runThreadPoolBenchmarks();
+void runEliminationStackBenchmarks();
+void runAllocatorBenchmarks();
+void runNumaBenchmarks();
+
+namespace
+{
+	struct Suite
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	constexpr Suite Suites[] = {
+		{ "containers", runContainerBenchmarks },
+		{ "latency", runLatencyBenchmarks },
+		{ "trace", runTraceBenchmarks },
+		{ "hash-map", runHashMapBenchmarks },
+		{ "flat-map", runFlatMapBenchmarks },
+		{ "queue", runQueueBenchmarks },
+		{ "stack", runStackBenchmarks },
+		{ "priority-queue", runPriorityQueueBenchmarks },
+		{ "spsc", runSpscQueueBenchmarks },
+		{ "mpmc", runMpmcQueueBenchmarks },
+		{ "thread-pool", runThreadPoolBenchmarks },
+		{ "elimination-stack", runEliminationStackBenchmarks },
+		{ "allocator", runAllocatorBenchmarks },
+		{ "numa", runNumaBenchmarks },
+	};
+
+	constexpr size_t SuiteCount = sizeof(Suites) / sizeof(Suites[0]);
+
+	void printUsage(const char* program)
+	{
+		std::printf("usage: %s [--csv <file>] [--counters] [--trace <file>] [suite...]\n", program);
+		std::printf("Runs the given suites, or all of them. --csv also writes every result to <file>,\n");
+		std::printf("--counters adds hardware counters per operation where perf_event_open allows it,\n");
+		std::printf("--trace has the trace suite replay a recorded WorkloadTrace instead of a synthetic one.\nsuites:");
+		for (const Suite& suite : Suites)
+		{
+			std::printf(" %s", suite.name);
+		}
+		std::printf("\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool bSelected[SuiteCount] = {};
+	bool bAnySelected = false;
+	const char* csvPath = nullptr;
+	bool bCounters = false;
+	const char* tracePath = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+		{
+			csvPath = argv[++i];
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+		{
+			tracePath = argv[++i];
+			continue;
+		}
+
+		if (std::strcmp(argv[i], "--counters") == 0)
+		{
+			bCounters = true;
+			continue;
+		}
+
+		size_t s = 0;
+		while (s < SuiteCount && std::strcmp(argv[i], Suites[s].name) != 0)
+		{
+			++s;
+		}
+
+		if (s == SuiteCount)
+		{
+			printUsage(argv[0]);
+			return 1;
+		}
+
+		bSelected[s] = true;
+		bAnySelected = true;
+	}
+
+	BenchmarkReport& report = benchmarkReport();
+	report.tracePath = tracePath;
+
+	if (csvPath)
+	{
+		report.csv = std::fopen(csvPath, "w");
+		if (!report.csv)
+		{
+			std::fprintf(stderr, "can't open %s for writing\n", csvPath);
+			return 1;
+		}
+		writeCsvHeader(report.csv);
+	}
+
+	if (bCounters)
+	{
+		PerfCounters& counters = PerfCounters::instance();
+		if (counters.isAvailable())
+		{
+			report.counters = &counters;
+		}
+		else
+		{
+			std::printf("Hardware counters unavailable (%s), timing only.\n", counters.unavailableReason());
+		}
+	}
+
+	for (size_t s = 0; s < SuiteCount; ++s)
+	{
+		if (!bAnySelected || bSelected[s])
+		{
+			Suites[s].run();
+		}
+	}
+
+	if (report.csv)
+	{
+		std::fclose(report.csv);
+	}
+
+	return 0;
+}
@@ -0,0 +1,231 @@
+#include "pch.h"
+#include "../Algorithms/CompactList.h"
+#include "../Algorithms/ContainerStats.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/FlatHashMap.h"
+#include "../Algorithms/FlatMap.h"
+#include "../Algorithms/FlatSet.h"
+#include "../Algorithms/MyAllocator.h"
+#include "../Algorithms/Queue.h"
+#include "../Algorithms/RingBuffer.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Stack.h"
+#include "../Algorithms/Vector.h"
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// This project is built with ALGORITHMS_ENABLE_STATS, which changes the containers' layout, so it
+// can't share a binary with Sample-Test1. The disabled recorder is checked directly.
+
+TEST(ContainerStatsTest, DisabledRecorderIsEmptyAndReadsZero) {
+    static_assert(std::is_empty_v<ContainerStatsRecorderImpl<false>>);
+
+    ContainerStatsRecorderImpl<false> recorder;
+    recorder.countReallocation(10);
+    recorder.countNodeAllocation();
+    recorder.countWalk(5);
+
+    ContainerStats stats = recorder.snapshot();
+    EXPECT_EQ(stats.reallocations, 0);
+    EXPECT_EQ(stats.relocations, 0);
+    EXPECT_EQ(stats.nodeAllocations, 0);
+    EXPECT_EQ(stats.linearWalks, 0);
+}
+
+TEST(ContainerStatsTest, EnabledInThisBuild) {
+    EXPECT_TRUE(bContainerStatsEnabled);
+}
+
+TEST(ContainerStatsTest, CountersAddOneRecorderToEachContainer) {
+    EXPECT_EQ(sizeof(Vector<int>), 3 * sizeof(void*) + sizeof(ContainerStats));
+    EXPECT_EQ(sizeof(Vector<int, MyAllocator<int>>), 3 * sizeof(void*) + sizeof(ContainerStats));
+    EXPECT_EQ(sizeof(SingleLinkedList<int>), 3 * sizeof(void*) + sizeof(ContainerStats));
+    EXPECT_EQ(sizeof(DoubleLinkedList<int>), 3 * sizeof(void*) + sizeof(ContainerStats));
+    EXPECT_EQ(sizeof(RingBuffer<int>), 4 * sizeof(void*) + sizeof(ContainerStats));
+}
+
+TEST(ContainerStatsTest, VectorCountsGrowth) {
+    Vector<int> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.pushBack(i);
+    }
+
+    // Capacities 1, 2, 4 ... 128; every growth moves what the previous block held.
+    ContainerStats stats = vec.stats();
+    EXPECT_EQ(stats.reallocations, 8);
+    EXPECT_EQ(stats.relocations, 1 + 2 + 4 + 8 + 16 + 32 + 64);
+    EXPECT_EQ(stats.nodeAllocations, 0);
+    EXPECT_EQ(stats.linearWalks, 0);
+}
+
+TEST(ContainerStatsTest, VectorReserveAvoidsRelocations) {
+    Vector<int> vec;
+    vec.reserve(100);
+    for (int i = 0; i < 100; ++i) {
+        vec.pushBack(i);
+    }
+
+    EXPECT_EQ(vec.stats().reallocations, 1);
+    EXPECT_EQ(vec.stats().relocations, 0);
+}
+
+TEST(ContainerStatsTest, VectorFrontOperationsShift) {
+    Vector<int> vec;
+    vec.reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        vec.pushFront(i);
+    }
+    EXPECT_EQ(vec.stats().relocations, 0 + 1 + 2 + 3);
+
+    vec.resetStats();
+    vec.popFront();
+    EXPECT_EQ(vec.stats().relocations, 3);
+    EXPECT_EQ(vec.stats().reallocations, 0);
+}
+
+TEST(ContainerStatsTest, CopyStartsWithFreshCounters) {
+    Vector<int> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.pushBack(i);
+    }
+
+    Vector<int> copy(vec);
+    EXPECT_EQ(copy.stats().reallocations, 0);
+    EXPECT_GT(vec.stats().reallocations, 0);
+}
+
+TEST(ContainerStatsTest, SingleLinkedListCountsNodesAndWalks) {
+    SingleLinkedList<int> list;
+    for (int i = 0; i < 10; ++i) {
+        list.pushBack(i);
+    }
+    EXPECT_EQ(list.stats().nodeAllocations, 10);
+    EXPECT_EQ(list.stats().linearWalks, 0);
+
+    // No back link: popBack walks to the node before the tail.
+    list.popBack();
+    EXPECT_EQ(list.stats().linearWalks, 1);
+    EXPECT_EQ(list.stats().walkSteps, 8);
+
+    // remove() searches for the predecessor of the node it is given.
+    list.resetStats();
+    auto it = list.begin();
+    for (int i = 0; i < 5; ++i) {
+        ++it;
+    }
+    list.remove(it);
+    EXPECT_EQ(list.stats().linearWalks, 1);
+    EXPECT_EQ(list.stats().walkSteps, 4);
+
+    // Removing the head needs no search.
+    list.remove(list.begin());
+    EXPECT_EQ(list.stats().linearWalks, 1);
+}
+
+TEST(ContainerStatsTest, DoubleLinkedListCountsNodes) {
+    DoubleLinkedList<int> list;
+    for (int i = 0; i < 10; ++i) {
+        list.pushBack(i);
+        list.pushFront(i);
+    }
+    list.popBack();
+    list.popFront();
+
+    ContainerStats stats = list.stats();
+    EXPECT_EQ(stats.nodeAllocations, 20);
+    EXPECT_EQ(stats.linearWalks, 0);
+    EXPECT_EQ(stats.reallocations, 0);
+}
+
+TEST(ContainerStatsTest, RingBufferCountsGrowth) {
+    RingBuffer<int> buffer;
+    for (int i = 0; i < 20; ++i) {
+        buffer.pushBack(i);
+    }
+
+    // Capacities 8, 16, 32.
+    EXPECT_EQ(buffer.stats().reallocations, 3);
+    EXPECT_EQ(buffer.stats().relocations, 8 + 16);
+}
+
+TEST(ContainerStatsTest, CompactListReportsItsSlab) {
+    CompactList<int> list;
+    for (int i = 0; i < 100; ++i) {
+        list.pushBack(i);
+    }
+
+    ContainerStats stats = list.stats();
+    EXPECT_EQ(stats.nodeAllocations, 0);
+    EXPECT_EQ(stats.reallocations, 8);
+
+    list.resetStats();
+    EXPECT_EQ(list.stats().reallocations, 0);
+}
+
+TEST(ContainerStatsTest, AdaptersForwardTheirContainers) {
+    Stack<int> stack;
+    Queue<int> queue;
+    for (int i = 0; i < 20; ++i) {
+        stack.push(i);
+        queue.push(i);
+    }
+
+    EXPECT_EQ(stack.stats().reallocations, 6);
+    EXPECT_EQ(queue.stats().reallocations, 3);
+
+    Stack<int, SingleLinkedList> listStack;
+    listStack.push(1);
+    listStack.push(2);
+    EXPECT_EQ(listStack.stats().nodeAllocations, 2);
+
+    stack.resetStats();
+    queue.resetStats();
+    EXPECT_EQ(stack.stats().reallocations, 0);
+    EXPECT_EQ(queue.stats().reallocations, 0);
+}
+
+TEST(ContainerStatsTest, FlatMapBulkBuildSortsOnce) {
+    std::vector<std::pair<int, int>> input = { { 3, 3 }, { 1, 1 }, { 2, 2 }, { 1, 0 } };
+    FlatMap<int, int> map(input.begin(), input.end());
+
+    // One allocation per array, sized for the result.
+    EXPECT_EQ(map.stats().reallocations, 2);
+}
+
+TEST(ContainerStatsTest, FlatMapInsertRangeMergesInOnePass) {
+    FlatMap<int, int> map = { { 10, 1 }, { 20, 1 }, { 30, 1 } };
+    std::vector<std::pair<int, int>> batch = { { 25, 2 }, { 5, 2 }, { 20, 2 }, { 35, 2 }, { 15, 2 } };
+    map.resetStats();
+    map.insertRange(batch.begin(), batch.end());
+
+    // One new buffer per array for the whole batch, not a shift per element.
+    EXPECT_EQ(map.stats().reallocations, 2);
+}
+
+TEST(ContainerStatsTest, FlatSetCountsMergesAndShifts) {
+    std::vector<int> input = { 5, 3, 9, 3, 1 };
+    FlatSet<int> set(input.begin(), input.end());
+    EXPECT_EQ(set.stats().reallocations, 1);
+
+    set.reserve(5);
+    set.resetStats();
+    set.insert(4);
+    EXPECT_EQ(set.stats().relocations, 2); // 5 and 9 moved up.
+
+    std::vector<int> batch = { 7, 2, 4 };
+    set.resetStats();
+    set.insertRange(batch.begin(), batch.end());
+    EXPECT_EQ(set.stats().reallocations, 1);
+}
+
+TEST(ContainerStatsTest, FlatHashMapReserveAvoidsRehashing) {
+    FlatHashMap<int, int> map;
+    map.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        map.tryEmplace(i, i);
+    }
+
+    EXPECT_EQ(map.stats().reallocations, 1);
+    EXPECT_EQ(map.stats().relocations, 0);
+}
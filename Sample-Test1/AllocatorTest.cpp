@@ -0,0 +1,382 @@
+#include "pch.h"
+#include "../Algorithms/ArenaAllocator.h"
+#include "../Algorithms/CompactList.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/MonotonicAllocator.h"
+#include "../Algorithms/MyAllocator.h"
+#include "../Algorithms/RingBuffer.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    struct alignas(64) OverAligned {
+        int value;
+    };
+
+    bool isAligned(const void* p, size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+
+    // Heap allocator with an identity that travels on every assignment and swap.
+    template<typename T>
+    struct PropagatingAllocator {
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        int id{ 0 };
+
+        PropagatingAllocator() = default;
+        explicit PropagatingAllocator(int id) : id{ id } {}
+
+        template<typename U>
+        PropagatingAllocator(const PropagatingAllocator<U>& other) : id{ other.id } {}
+
+        T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+        void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+        template<typename U>
+        bool operator==(const PropagatingAllocator<U>& other) const { return id == other.id; }
+    };
+}
+
+TEST(MyAllocatorTest, WorksWithEveryContainer) {
+    Vector<std::string, MyAllocator<std::string>> vec{ "a", "b" };
+    vec.pushBack("c");
+    EXPECT_EQ(vec.back(), "c");
+
+    SingleLinkedList<int, MyAllocator<int>> single{ 1, 2 };
+    single.pushFront(0);
+    single.pushBack(3);
+    EXPECT_EQ(single.front(), 0);
+    EXPECT_EQ(single.back(), 3);
+
+    DoubleLinkedList<int, MyAllocator<int>> doubled{ 1, 2 };
+    doubled.pushFront(0);
+    EXPECT_EQ(doubled.size(), 3);
+
+    CompactList<int, MyAllocator<int>> compact{ 1, 2 };
+    compact.pushBack(3);
+    EXPECT_EQ(compact.back(), 3);
+}
+
+TEST(MyAllocatorTest, RebindsAndCompares) {
+    MyAllocator<int> ints;
+    MyAllocator<double> doubles(ints);
+    EXPECT_TRUE(ints == doubles);
+
+    MyAllocator<OverAligned> aligned;
+    OverAligned* p = aligned.allocate(3);
+    EXPECT_TRUE(isAligned(p, alignof(OverAligned)));
+    aligned.deallocate(p, 3);
+}
+
+TEST(ArenaTest, AllocatesAlignedFromBlocks) {
+    Arena arena(256);
+    EXPECT_EQ(arena.bytesUsed(), 0);
+
+    void* a = arena.allocate(1, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(sizeof(OverAligned), alignof(OverAligned));
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(isAligned(b, 8));
+    EXPECT_TRUE(isAligned(c, alignof(OverAligned)));
+
+    // Bigger than a block: gets one of its own.
+    void* big = arena.allocate(1000, 16);
+    EXPECT_TRUE(isAligned(big, 16));
+    EXPECT_GE(arena.bytesUsed(), 1000);
+}
+
+TEST(ArenaTest, ResetAndRewindReuseMemory) {
+    Arena arena(128);
+    void* first = arena.allocate(16);
+
+    Arena::Marker marker = arena.mark();
+    void* second = arena.allocate(16);
+    for (int i = 0; i < 20; ++i) {
+        (void)arena.allocate(64);
+    }
+    arena.rewind(marker);
+    EXPECT_EQ(arena.allocate(16), second);
+
+    arena.reset();
+    EXPECT_EQ(arena.bytesUsed(), 0);
+    EXPECT_EQ(arena.allocate(16), first);
+}
+
+TEST(ArenaTest, DoublingBlocks) {
+    Arena arena(64, ArenaGrowth::Double);
+    (void)arena.allocate(48);
+    EXPECT_EQ(arena.blockSize(), 128);
+
+    (void)arena.allocate(48);
+    (void)arena.allocate(500);
+    EXPECT_EQ(arena.blockCount(), 3);
+    EXPECT_GE(arena.blockSize(), 1024);
+
+    arena.release();
+    EXPECT_EQ(arena.blockSize(), 64);
+}
+
+TEST(ArenaTest, ScopeGivesBackWhatContainersTook) {
+    Arena arena(1024);
+    (void)arena.allocate(8);
+    const size_t before = arena.bytesUsed();
+
+    {
+        ArenaScope scope(arena);
+
+        Vector<std::string, ArenaAllocator<std::string>> vec{ ArenaAllocator<std::string>(arena) };
+        SingleLinkedList<int, ArenaAllocator<int>> single{ ArenaAllocator<int>(arena) };
+        DoubleLinkedList<int, ArenaAllocator<int>> doubled({ 1, 2, 3 }, ArenaAllocator<int>(arena));
+        for (int i = 0; i < 100; ++i) {
+            vec.pushBack(std::to_string(i));
+            single.pushBack(i);
+            doubled.pushFront(i);
+        }
+        EXPECT_EQ(vec[99], "99");
+        EXPECT_EQ(single.back(), 99);
+        EXPECT_EQ(doubled.front(), 99);
+        EXPECT_GT(arena.bytesUsed(), before);
+    }
+
+    EXPECT_EQ(arena.bytesUsed(), before);
+}
+
+TEST(ArenaAllocatorTest, CopiesAndMovesKeepTheArena) {
+    Arena arena;
+    Arena other;
+    using Alloc = ArenaAllocator<int>;
+
+    EXPECT_TRUE(Alloc(arena) == ArenaAllocator<double>(arena));
+    EXPECT_FALSE(Alloc(arena) == Alloc(other));
+
+    Vector<int, Alloc> vec({ 1, 2, 3 }, Alloc(arena));
+    Vector<int, Alloc> copy(vec);
+    EXPECT_EQ(copy.getAllocator().arena(), &arena);
+
+    Vector<int, Alloc> elsewhere(vec, Alloc(other));
+    EXPECT_EQ(elsewhere.getAllocator().arena(), &other);
+    EXPECT_EQ(elsewhere[2], 3);
+
+    Vector<int, Alloc> moved(std::move(vec));
+    EXPECT_EQ(moved.getAllocator().arena(), &arena);
+    EXPECT_EQ(moved.size(), 3);
+
+    SingleLinkedList<int, Alloc> single({ 1, 2 }, Alloc(arena));
+    SingleLinkedList<int, Alloc> singleMoved(std::move(single));
+    EXPECT_EQ(singleMoved.getAllocator().arena(), &arena);
+    EXPECT_EQ(singleMoved.back(), 2);
+
+    CompactList<int, Alloc> compact({ 1, 2 }, Alloc(arena));
+    CompactList<int, Alloc> compactMoved(std::move(compact));
+    EXPECT_EQ(compactMoved.getAllocator().arena(), &arena);
+    EXPECT_EQ(compactMoved.front(), 1);
+
+    RingBuffer<int, Alloc> ring({ 1, 2 }, Alloc(arena));
+    RingBuffer<int, Alloc> ringCopy(ring);
+    EXPECT_EQ(ringCopy.getAllocator().arena(), &arena);
+    RingBuffer<int, Alloc> ringMoved(std::move(ring));
+    EXPECT_EQ(ringMoved.getAllocator().arena(), &arena);
+    EXPECT_EQ(ringMoved.back(), 2);
+}
+
+TEST(MonotonicBufferTest, UsesTheGivenBufferFirst) {
+    alignas(std::max_align_t) std::byte storage[256];
+    MonotonicBuffer buffer(storage, sizeof(storage));
+
+    void* p = buffer.allocate(64);
+    EXPECT_EQ(p, storage);
+    EXPECT_EQ(buffer.heapChunkCount(), 0);
+
+    (void)buffer.allocate(300);
+    EXPECT_EQ(buffer.heapChunkCount(), 1);
+
+    buffer.release();
+    EXPECT_EQ(buffer.heapChunkCount(), 0);
+    EXPECT_EQ(buffer.allocate(64), storage);
+}
+
+TEST(MonotonicBufferTest, GrowsGeometrically) {
+    MonotonicBuffer buffer(64);
+    for (int i = 0; i < 100; ++i) {
+        void* p = buffer.allocate(32, 32);
+        EXPECT_TRUE(isAligned(p, 32));
+    }
+    // 3200 bytes plus padding from 64, 128, 256, ... byte chunks.
+    EXPECT_LE(buffer.heapChunkCount(), 8);
+
+    // Starting over starts at 64 bytes again: the first chunk has room for 63 bytes and one more, not two.
+    buffer.release();
+    (void)buffer.allocate(63, 1);
+    EXPECT_EQ(buffer.heapChunkCount(), 1);
+    (void)buffer.allocate(2, 1);
+    EXPECT_EQ(buffer.heapChunkCount(), 2);
+}
+
+TEST(MonotonicAllocatorTest, BacksContainers) {
+    alignas(std::max_align_t) std::byte storage[4096];
+    MonotonicBuffer buffer(storage, sizeof(storage));
+    using Alloc = MonotonicAllocator<std::unique_ptr<int>>;
+
+    SingleLinkedList<std::unique_ptr<int>, Alloc> list{ Alloc(buffer) };
+    for (int i = 0; i < 10; ++i) {
+        list.pushBack(std::make_unique<int>(i));
+    }
+    EXPECT_EQ(*list.front(), 0);
+    EXPECT_EQ(*list.back(), 9);
+    EXPECT_EQ(buffer.heapChunkCount(), 0);
+
+    Vector<int, MonotonicAllocator<int>> vec{ MonotonicAllocator<int>(buffer) };
+    for (int i = 0; i < 2000; ++i) {
+        vec.pushBack(i);
+    }
+    EXPECT_EQ(vec[1999], 1999);
+    EXPECT_GT(buffer.heapChunkCount(), 0);
+}
+
+TEST(AllocatorPropagationTest, MoveWithoutPropagationKeepsTheTargetAllocator) {
+    Arena arena;
+    Arena other;
+    using Alloc = ArenaAllocator<int>;
+
+    Vector<int, Alloc> vec({ 1, 2, 3 }, Alloc(arena));
+    Vector<int, Alloc> sameArena({ 9 }, Alloc(arena));
+    const int* storage = &vec[0];
+
+    // Same arena: the storage is simply taken over.
+    sameArena = std::move(vec);
+    EXPECT_EQ(&sameArena[0], storage);
+    EXPECT_TRUE(vec.isEmpty());
+
+    // Another arena: the elements are moved into memory of the target's arena.
+    Vector<int, Alloc> elsewhere{ Alloc(other) };
+    elsewhere = std::move(sameArena);
+    EXPECT_EQ(elsewhere.getAllocator().arena(), &other);
+    EXPECT_NE(&elsewhere[0], storage);
+    EXPECT_EQ(elsewhere[2], 3);
+    EXPECT_TRUE(sameArena.isEmpty());
+
+    DoubleLinkedList<int, Alloc> list({ 1, 2 }, Alloc(arena));
+    DoubleLinkedList<int, Alloc> otherList{ Alloc(other) };
+    otherList = std::move(list);
+    EXPECT_EQ(otherList.getAllocator().arena(), &other);
+    EXPECT_EQ(otherList.back(), 2);
+    EXPECT_TRUE(list.isEmpty());
+
+    SingleLinkedList<int, Alloc> single({ 1, 2 }, Alloc(arena));
+    SingleLinkedList<int, Alloc> otherSingle{ Alloc(other) };
+    otherSingle = std::move(single);
+    EXPECT_EQ(otherSingle.getAllocator().arena(), &other);
+    EXPECT_EQ(otherSingle.front(), 1);
+    EXPECT_TRUE(single.isEmpty());
+
+    CompactList<int, Alloc> compact({ 1, 2 }, Alloc(arena));
+    CompactList<int, Alloc> otherCompact{ Alloc(other) };
+    otherCompact = std::move(compact);
+    EXPECT_EQ(otherCompact.getAllocator().arena(), &other);
+    EXPECT_EQ(otherCompact.back(), 2);
+
+    RingBuffer<int, Alloc> ring({ 1, 2 }, Alloc(arena));
+    ring.pushFront(0); // Wrapped, so the element-wise move has to unwrap it.
+    RingBuffer<int, Alloc> otherRing{ Alloc(other) };
+    otherRing = std::move(ring);
+    EXPECT_EQ(otherRing.getAllocator().arena(), &other);
+    EXPECT_EQ(otherRing.front(), 0);
+    EXPECT_EQ(otherRing.back(), 2);
+    EXPECT_TRUE(ring.isEmpty());
+}
+
+TEST(AllocatorPropagationTest, PropagatingAllocatorsTravel) {
+    using Alloc = PropagatingAllocator<int>;
+
+    Vector<int, Alloc> a({ 1, 2 }, Alloc(1));
+    Vector<int, Alloc> b({ 3 }, Alloc(2));
+    b = a;
+    EXPECT_EQ(b.getAllocator().id, 1);
+
+    Vector<int, Alloc> c({ 4 }, Alloc(3));
+    c = std::move(a);
+    EXPECT_EQ(c.getAllocator().id, 1);
+    EXPECT_EQ(c[1], 2);
+
+    DoubleLinkedList<int, Alloc> x({ 1 }, Alloc(1));
+    DoubleLinkedList<int, Alloc> y({ 2, 3 }, Alloc(2));
+    x.swap(y);
+    EXPECT_EQ(x.getAllocator().id, 2);
+    EXPECT_EQ(x.size(), 2);
+    EXPECT_EQ(y.getAllocator().id, 1);
+
+    SingleLinkedList<int, Alloc> p({ 1 }, Alloc(1));
+    SingleLinkedList<int, Alloc> q({ 2 }, Alloc(2));
+    q = p;
+    EXPECT_EQ(q.getAllocator().id, 1);
+    EXPECT_EQ(q.front(), 1);
+
+    RingBuffer<int, Alloc> r({ 1 }, Alloc(1));
+    RingBuffer<int, Alloc> s({ 2, 3 }, Alloc(2));
+    r.swap(s);
+    EXPECT_EQ(r.getAllocator().id, 2);
+    EXPECT_EQ(r.back(), 3);
+    s = std::move(r);
+    EXPECT_EQ(s.getAllocator().id, 2);
+    EXPECT_EQ(s.size(), 2);
+}
+
+TEST(AllocatorPropagationTest, StatelessAllocatorsTakeNoSpace) {
+    EXPECT_EQ(sizeof(Vector<int>), 3 * sizeof(void*));
+    EXPECT_EQ(sizeof(Vector<int, MyAllocator<int>>), 3 * sizeof(void*));
+    EXPECT_EQ(sizeof(SingleLinkedList<int>), 3 * sizeof(void*));
+    EXPECT_EQ(sizeof(DoubleLinkedList<int>), 3 * sizeof(void*));
+    EXPECT_EQ(sizeof(RingBuffer<int>), 4 * sizeof(void*));
+}
+
+TEST(PmrContainersTest, DrawFromTheMemoryResource) {
+    std::byte storage[4096];
+    std::pmr::monotonic_buffer_resource resource(storage, sizeof(storage), std::pmr::null_memory_resource());
+
+    PmrVector<std::pmr::string> strings{ std::pmr::polymorphic_allocator<std::pmr::string>(&resource) };
+    strings.pushBack("a string long enough to need its own heap block");
+    // Uses-allocator construction: the element draws from the same resource.
+    EXPECT_EQ(strings[0].get_allocator().resource(), &resource);
+
+    PmrDoubleLinkedList<int> doubled{ std::pmr::polymorphic_allocator<int>(&resource) };
+    PmrSingleLinkedList<int> single{ std::pmr::polymorphic_allocator<int>(&resource) };
+    PmrCompactList<int> compact{ std::pmr::polymorphic_allocator<int>(&resource) };
+    PmrRingBuffer<int> ring{ std::pmr::polymorphic_allocator<int>(&resource) };
+    for (int i = 0; i < 10; ++i) {
+        doubled.pushBack(i);
+        single.pushBack(i);
+        compact.pushBack(i);
+        ring.pushBack(i);
+    }
+    EXPECT_EQ(doubled.getAllocator().resource(), &resource);
+    EXPECT_EQ(ring.getAllocator().resource(), &resource);
+
+    // polymorphic_allocator never propagates: assignments keep the target's resource.
+    PmrDoubleLinkedList<int> onHeap;
+    onHeap = doubled;
+    EXPECT_EQ(onHeap.getAllocator().resource(), std::pmr::get_default_resource());
+    onHeap = std::move(doubled);
+    EXPECT_EQ(onHeap.size(), 10);
+    EXPECT_EQ(onHeap.getAllocator().resource(), std::pmr::get_default_resource());
+
+    PmrSingleLinkedList<int> singleCopy(single);
+    EXPECT_EQ(singleCopy.getAllocator().resource(), std::pmr::get_default_resource());
+    PmrCompactList<int> compactMoved;
+    compactMoved = std::move(compact);
+    EXPECT_EQ(compactMoved.back(), 9);
+
+    PmrRingBuffer<int> ringCopy(ring);
+    EXPECT_EQ(ringCopy.getAllocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(ringCopy.back(), 9);
+}
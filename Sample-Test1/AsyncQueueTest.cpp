@@ -0,0 +1,172 @@
+#include "pch.h"
+#include "../Algorithms/AsyncQueue.h"
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    AsyncTask Consume(AsyncQueue<int>& queue, std::vector<int>& received) {
+        while (std::optional<int> item = co_await queue.pop()) {
+            received.push_back(*item);
+        }
+    }
+
+    AsyncTask Produce(SingleThreadExecutor& executor, AsyncQueue<int>& queue, int first, int count) {
+        for (int i = first; i < first + count; ++i) {
+            co_await executor.schedule();
+            queue.push(i);
+        }
+    }
+}
+
+TEST(AsyncQueueTest, ReadyItemsDoNotSuspend) {
+    AsyncQueue<int> queue;
+    queue.push(1);
+    queue.push(2);
+    queue.close();
+
+    std::vector<int> received;
+    AsyncTask consumer = Consume(queue, received);
+    EXPECT_TRUE(consumer.isDone());
+    EXPECT_EQ(received, (std::vector<int>{ 1, 2 }));
+}
+
+TEST(AsyncQueueTest, PushResumesWaiterDirectly) {
+    AsyncQueue<int> queue;
+    std::vector<int> received;
+    AsyncTask consumer = Consume(queue, received);
+
+    EXPECT_FALSE(consumer.isDone());
+    EXPECT_TRUE(queue.hasWaiters());
+
+    // The consumer runs inside push(), the value never touches the queue.
+    queue.push(7);
+    EXPECT_EQ(received, (std::vector<int>{ 7 }));
+    EXPECT_TRUE(queue.isEmpty());
+
+    queue.close();
+    EXPECT_TRUE(consumer.isDone());
+    EXPECT_FALSE(queue.push(8));
+}
+
+TEST(AsyncQueueTest, WaitersAreServedInOrder) {
+    SingleThreadExecutor executor;
+    AsyncQueue<int> queue(&executor);
+
+    std::vector<int> first;
+    std::vector<int> second;
+    AsyncTask a = Consume(queue, first);
+    AsyncTask b = Consume(queue, second);
+
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    // With an executor the woken consumers only run when the executor does.
+    EXPECT_TRUE(first.empty());
+    executor.run();
+
+    EXPECT_EQ(first, (std::vector<int>{ 1, 3 }));
+    EXPECT_EQ(second, (std::vector<int>{ 2 }));
+
+    queue.close();
+    executor.run();
+    EXPECT_TRUE(a.isDone());
+    EXPECT_TRUE(b.isDone());
+}
+
+TEST(AsyncQueueTest, ProducersAndConsumersOnExecutor) {
+    SingleThreadExecutor executor;
+    AsyncQueue<int> queue(&executor);
+
+    std::vector<int> received;
+    AsyncTask consumer = Consume(queue, received);
+    AsyncTask producerA = Produce(executor, queue, 0, 50);
+    AsyncTask producerB = Produce(executor, queue, 100, 50);
+
+    EXPECT_GT(executor.run(), 100);
+    EXPECT_TRUE(producerA.isDone());
+    EXPECT_TRUE(producerB.isDone());
+    EXPECT_EQ(received.size(), 100);
+
+    queue.close();
+    executor.run();
+    EXPECT_TRUE(consumer.isDone());
+}
+
+TEST(AsyncQueueTest, TryPopAndMoveOnly) {
+    AsyncQueue<std::unique_ptr<std::string>> queue;
+    EXPECT_FALSE(queue.tryPop().has_value());
+
+    queue.push(std::make_unique<std::string>("hi"));
+    EXPECT_EQ(queue.size(), 1);
+    auto item = queue.tryPop();
+    ASSERT_TRUE(item.has_value());
+    EXPECT_EQ(**item, "hi");
+}
+
+TEST(AsyncQueueTest, DestroyedWaiterLeavesTheLine) {
+    AsyncQueue<int> queue;
+    std::vector<int> gone;
+    std::vector<int> kept;
+
+    {
+        AsyncTask abandoned = Consume(queue, gone);
+    }
+    AsyncTask consumer = Consume(queue, kept);
+
+    queue.push(5);
+    EXPECT_TRUE(gone.empty());
+    EXPECT_EQ(kept, (std::vector<int>{ 5 }));
+    queue.close();
+}
+
+TEST(AsyncQueueTest, ExceptionsAreKeptInTheTask) {
+    AsyncQueue<int> queue;
+    AsyncTask task = [](AsyncQueue<int>& queue) -> AsyncTask {
+        co_await queue.pop();
+        throw std::runtime_error("handler failed");
+    }(queue);
+
+    EXPECT_NO_THROW(task.rethrowIfFailed());
+    queue.push(1);
+    EXPECT_TRUE(task.isDone());
+    EXPECT_THROW(task.rethrowIfFailed(), std::runtime_error);
+}
+
+TEST(AsyncQueueTest, ThrowingCopyKeepsWaiterInLine) {
+    struct Thrower {
+        int value;
+        bool bThrowOnCopy;
+
+        Thrower(int value, bool bThrowOnCopy) : value(value), bThrowOnCopy(bThrowOnCopy) {}
+        Thrower(const Thrower& other) : value(other.value), bThrowOnCopy(false) {
+            if (other.bThrowOnCopy) {
+                throw std::runtime_error("copy");
+            }
+        }
+        Thrower(Thrower&&) = default;
+    };
+
+    AsyncQueue<Thrower> queue;
+    std::vector<int> received;
+    AsyncTask consumer = [](AsyncQueue<Thrower>& queue, std::vector<int>& received) -> AsyncTask {
+        while (std::optional<Thrower> item = co_await queue.pop()) {
+            received.push_back(item->value);
+        }
+    }(queue, received);
+
+    const Thrower bad(1, true);
+    EXPECT_THROW(queue.push(bad), std::runtime_error);
+    EXPECT_TRUE(queue.hasWaiters());
+    EXPECT_TRUE(received.empty());
+
+    const Thrower good(2, false);
+    queue.push(good);
+    EXPECT_EQ(received, (std::vector<int>{ 2 }));
+
+    queue.close();
+    EXPECT_TRUE(consumer.isDone());
+}
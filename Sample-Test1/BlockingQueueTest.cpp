@@ -0,0 +1,237 @@
+#include "pch.h"
+#include "../Algorithms/BlockingQueue.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(BlockingQueueTest, FifoOrder) {
+    BlockingQueue<int> queue(4);
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_EQ(queue.capacity(), 4);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_EQ(queue.size(), 3);
+
+    int out = -1;
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(queue.pop(out));
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(BlockingQueueTest, TryPushFailsWhenFull) {
+    BlockingQueue<int> queue(2);
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_FALSE(queue.tryPush(3));
+
+    int out = 0;
+    EXPECT_TRUE(queue.tryPop(out));
+    EXPECT_TRUE(queue.tryPush(3));
+}
+
+TEST(BlockingQueueTest, TryPopFailsWhenEmpty) {
+    BlockingQueue<int> queue(2);
+    int out = 7;
+    EXPECT_FALSE(queue.tryPop(out));
+    EXPECT_EQ(out, 7);
+}
+
+TEST(BlockingQueueTest, PopForTimesOut) {
+    BlockingQueue<int> queue(2);
+    int out = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(queue.popFor(out, 20ms));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+
+    queue.push(5);
+    EXPECT_TRUE(queue.popFor(out, 20ms));
+    EXPECT_EQ(out, 5);
+}
+
+TEST(BlockingQueueTest, PopWaitsForProducer) {
+    BlockingQueue<std::string> queue(1);
+    std::thread producer([&] {
+        std::this_thread::sleep_for(10ms);
+        queue.push("late");
+    });
+
+    std::string out;
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, "late");
+    producer.join();
+}
+
+TEST(BlockingQueueTest, PushWaitsForRoom) {
+    BlockingQueue<int> queue(1);
+    queue.push(1);
+
+    std::atomic<bool> bPushed{ false };
+    std::thread producer([&] {
+        queue.push(2);
+        bPushed = true;
+    });
+
+    std::this_thread::sleep_for(10ms);
+    EXPECT_FALSE(bPushed);
+
+    int out = 0;
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 1);
+    producer.join();
+    EXPECT_TRUE(bPushed);
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 2);
+}
+
+TEST(BlockingQueueTest, DrainToTakesBatch) {
+    BlockingQueue<int> queue(8);
+    for (int i = 0; i < 5; ++i) {
+        queue.push(i);
+    }
+
+    Vector<int> batch;
+    batch.pushBack(-1);
+    EXPECT_EQ(queue.drainTo(batch, 3), 3);
+    EXPECT_EQ(batch.size(), 4);
+    EXPECT_EQ(batch[0], -1);
+    EXPECT_EQ(batch[1], 0);
+    EXPECT_EQ(batch[3], 2);
+
+    EXPECT_EQ(queue.drainTo(batch, 10), 2);
+    EXPECT_EQ(batch[5], 4);
+    EXPECT_EQ(queue.drainTo(batch, 10), 0);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(BlockingQueueTest, RepeatedDrainsGrowGeometrically) {
+    BlockingQueue<int> queue(4);
+    Vector<int> batch;
+    int growths = 0;
+
+    for (int i = 0; i < 1000; ++i) {
+        queue.push(i);
+        const size_t capacity = batch.capacity();
+        EXPECT_EQ(queue.drainTo(batch, 4), 1);
+        growths += batch.capacity() != capacity;
+    }
+
+    EXPECT_EQ(batch.size(), 1000);
+    EXPECT_LE(growths, 11);
+}
+
+TEST(BlockingQueueTest, DrainToWakesBlockedProducers) {
+    BlockingQueue<int> queue(2);
+    queue.push(0);
+    queue.push(1);
+
+    std::vector<std::thread> producers;
+    for (int i = 2; i < 4; ++i) {
+        producers.emplace_back([&queue, i] { queue.push(i); });
+    }
+
+    Vector<int> batch;
+    size_t total = 0;
+    while (total < 4) {
+        total += queue.drainTo(batch, 4);
+        std::this_thread::yield();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(batch.size(), 4);
+}
+
+TEST(BlockingQueueTest, CloseRejectsPushesButDrainsRemaining) {
+    BlockingQueue<int> queue(4);
+    queue.push(1);
+    queue.push(2);
+    queue.close();
+
+    EXPECT_TRUE(queue.isClosed());
+    EXPECT_FALSE(queue.push(3));
+    EXPECT_FALSE(queue.tryPush(3));
+
+    int out = 0;
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 1);
+    EXPECT_TRUE(queue.popFor(out, 1ms));
+    EXPECT_EQ(out, 2);
+    EXPECT_FALSE(queue.pop(out));
+}
+
+TEST(BlockingQueueTest, CloseWakesWaiters) {
+    BlockingQueue<int> full(1);
+    full.push(0);
+    BlockingQueue<int> empty(1);
+
+    std::thread producer([&] { EXPECT_FALSE(full.push(1)); });
+    std::thread consumer([&] {
+        int out = 0;
+        EXPECT_FALSE(empty.pop(out));
+    });
+
+    std::this_thread::sleep_for(10ms);
+    full.close();
+    empty.close();
+    producer.join();
+    consumer.join();
+}
+
+TEST(BlockingQueueTest, MoveOnlyType) {
+    BlockingQueue<std::unique_ptr<int>> queue(2);
+    queue.push(std::make_unique<int>(3));
+
+    std::unique_ptr<int> out;
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(*out, 3);
+}
+
+TEST(BlockingQueueTest, ManyProducersAndConsumers) {
+    constexpr int Producers = 4;
+    constexpr int PerProducer = 2000;
+    BlockingQueue<int> queue(16);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PerProducer; ++i) {
+                queue.push(p * PerProducer + i);
+            }
+        });
+    }
+
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> count{ 0 };
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 3; ++c) {
+        consumers.emplace_back([&] {
+            int out = 0;
+            while (queue.pop(out)) {
+                sum += out;
+                ++count;
+            }
+        });
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    const long long n = Producers * PerProducer;
+    EXPECT_EQ(count, n);
+    EXPECT_EQ(sum, n * (n - 1) / 2);
+}
@@ -0,0 +1,258 @@
+#include "pch.h"
+#include "../Algorithms/CompactList.h"
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(CompactListTest, DefaultConstructor) {
+    CompactList<int> list;
+    ASSERT_TRUE(list.isEmpty());
+    ASSERT_EQ(list.size(), 0);
+    ASSERT_EQ(list.begin(), list.end());
+}
+
+TEST(CompactListTest, NodeLinksAreHalfOfPointerLinks) {
+    ASSERT_EQ(sizeof(CompactListNode<int>), sizeof(int) + 2 * sizeof(uint32));
+}
+
+TEST(CompactListTest, InitializerListConstructor) {
+    CompactList<int> list{ 1, 2, 3, 4, 5 };
+    ASSERT_EQ(list.size(), 5);
+    ASSERT_EQ(list.front(), 1);
+    ASSERT_EQ(list.back(), 5);
+    ASSERT_GE(list.capacity(), 5);
+
+    std::vector<int> expected = { 1, 2, 3, 4, 5 };
+    size_t i = 0;
+    for (const auto& val : list) {
+        ASSERT_EQ(val, expected[i++]);
+    }
+}
+
+TEST(CompactListTest, PushFrontAndBack) {
+    CompactList<std::string> list;
+    list.pushBack("b");
+    list.pushFront("a");
+    list.pushBack("c");
+    ASSERT_EQ(list.size(), 3);
+    ASSERT_EQ(list.front(), "a");
+    ASSERT_EQ(list.back(), "c");
+
+    std::string result;
+    for (const auto& val : list) {
+        result += val;
+    }
+    ASSERT_EQ(result, "abc");
+}
+
+TEST(CompactListTest, PopFrontAndBack) {
+    CompactList<int> list{ 1, 2, 3 };
+    list.popFront();
+    ASSERT_EQ(list.front(), 2);
+    list.popBack();
+    ASSERT_EQ(list.front(), 2);
+    ASSERT_EQ(list.back(), 2);
+    list.popBack();
+    ASSERT_TRUE(list.isEmpty());
+    ASSERT_EQ(list.begin(), list.end());
+}
+
+TEST(CompactListTest, PopOnEmptyList) {
+    CompactList<int> list;
+    ASSERT_DEATH(list.popFront(), ".*");
+    ASSERT_DEATH(list.popBack(), ".*");
+}
+
+TEST(CompactListTest, FreedNodesAreReused) {
+    CompactList<int> list{ 1, 2, 3, 4 };
+    size_t capacity = list.capacity();
+
+    for (int i = 0; i < 100; ++i) {
+        list.popFront();
+        list.pushBack(i);
+    }
+
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(list.capacity(), capacity);
+    ASSERT_EQ(list.front(), 96);
+    ASSERT_EQ(list.back(), 99);
+}
+
+TEST(CompactListTest, RemoveFromMiddle) {
+    CompactList<int> list{ 10, 20, 30, 40 };
+    auto it = list.begin();
+    ++it;
+    list.remove(it);
+    ASSERT_EQ(list.size(), 3);
+
+    std::vector<int> expected = { 10, 30, 40 };
+    size_t i = 0;
+    for (const auto& val : list) {
+        ASSERT_EQ(val, expected[i++]);
+    }
+
+    list.pushFront(5);
+    ASSERT_EQ(list.front(), 5);
+    ASSERT_EQ(list.size(), 4);
+}
+
+TEST(CompactListTest, RemoveHeadAndTail) {
+    CompactList<int> list{ 1, 2, 3 };
+    list.remove(list.begin());
+    auto it = list.begin();
+    ++it;
+    list.remove(it);
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(list.front(), 2);
+    ASSERT_EQ(list.back(), 2);
+}
+
+TEST(CompactListTest, CopyIsIndependent) {
+    CompactList<std::string> original{ "x", "y", "z" };
+    original.popFront();
+    CompactList<std::string> copy = original;
+
+    original.pushBack("w");
+    original.front() = "changed";
+
+    ASSERT_EQ(copy.size(), 2);
+    ASSERT_EQ(copy.front(), "y");
+    ASSERT_EQ(copy.back(), "z");
+
+    copy.pushFront("x");
+    ASSERT_EQ(copy.front(), "x");
+    ASSERT_EQ(copy.size(), 3);
+}
+
+TEST(CompactListTest, CopyAssignment) {
+    CompactList<int> original{ 5, 6, 7 };
+    CompactList<int> assigned{ 1 };
+    assigned = original;
+    ASSERT_EQ(assigned.size(), 3);
+    ASSERT_EQ(assigned.front(), 5);
+    ASSERT_EQ(assigned.back(), 7);
+
+    assigned = assigned;
+    ASSERT_EQ(assigned.size(), 3);
+}
+
+TEST(CompactListTest, MoveConstructorAndAssignment) {
+    CompactList<int> original{ 100, 200 };
+    CompactList<int> moved = std::move(original);
+    ASSERT_TRUE(original.isEmpty());
+    ASSERT_EQ(moved.size(), 2);
+    ASSERT_EQ(moved.back(), 200);
+
+    original.pushBack(1);
+    ASSERT_EQ(original.front(), 1);
+
+    CompactList<int> assigned;
+    assigned = std::move(moved);
+    ASSERT_TRUE(moved.isEmpty());
+    ASSERT_EQ(assigned.front(), 100);
+}
+
+TEST(CompactListTest, MoveOnlyType) {
+    CompactList<std::unique_ptr<int>> list;
+    for (int i = 0; i < 50; ++i) {
+        list.pushBack(std::make_unique<int>(i));
+    }
+    list.popFront();
+    ASSERT_EQ(*list.front(), 1);
+    ASSERT_EQ(*list.back(), 49);
+}
+
+TEST(CompactListTest, PushOwnElementWhenFull) {
+    // The slab has to grow for each push, and the argument lives in the slab being moved.
+    CompactList<std::string> list{ "first, and too long for the small-string buffer", "last" };
+    ASSERT_EQ(list.size(), list.capacity());
+    list.pushBack(list.front());
+    ASSERT_EQ(list.back(), "first, and too long for the small-string buffer");
+
+    while (list.size() < list.capacity()) {
+        list.pushBack("filler");
+    }
+    list.pushFront(list.back());
+    ASSERT_EQ(list.front(), "filler");
+}
+
+TEST(CompactListTest, ThrowingCopyDoesNotLoseNodes) {
+    struct Thrower {
+        int value;
+        bool bThrowOnCopy;
+
+        Thrower(int value, bool bThrowOnCopy) : value(value), bThrowOnCopy(bThrowOnCopy) {}
+        Thrower(const Thrower& other) : value(other.value), bThrowOnCopy(false) {
+            if (other.bThrowOnCopy) {
+                throw std::runtime_error("copy");
+            }
+        }
+        Thrower(Thrower&&) = default;
+    };
+
+    CompactList<Thrower> list;
+    list.reserve(4);
+    const Thrower bad(0, true);
+
+    // A node appended to the slab...
+    ASSERT_THROW(list.pushBack(bad), std::runtime_error);
+    for (int i = 0; i < 4; ++i) {
+        list.pushBack(Thrower(i, false));
+    }
+    ASSERT_EQ(list.capacity(), 4);
+
+    // ...and one taken off the free list both go back to it.
+    list.popFront();
+    ASSERT_THROW(list.pushFront(bad), std::runtime_error);
+    list.pushBack(Thrower(4, false));
+    ASSERT_EQ(list.capacity(), 4);
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(list.front().value, 1);
+    ASSERT_EQ(list.back().value, 4);
+}
+
+TEST(CompactListTest, ClearReleasesSlab) {
+    CompactList<std::string> list{ "hello", "world" };
+    list.clear();
+    ASSERT_TRUE(list.isEmpty());
+    ASSERT_EQ(list.capacity(), 0);
+    ASSERT_EQ(list.begin(), list.end());
+
+    list.pushBack("again");
+    ASSERT_EQ(list.front(), "again");
+}
+
+TEST(CompactListTest, ConstIterator) {
+    const CompactList<int> list{ 2, 4, 6 };
+    std::vector<int> result;
+    for (auto it = list.cbegin(); it != list.cend(); ++it) {
+        result.push_back(*it);
+    }
+    ASSERT_EQ(result, (std::vector<int>{ 2, 4, 6 }));
+}
+
+static_assert(std::bidirectional_iterator<CompactList<int>::Iterator>);
+static_assert(std::ranges::bidirectional_range<const CompactList<int>>);
+
+TEST(CompactListTest, ReverseIteration) {
+    CompactList<int> list{ 1, 2, 3 };
+    list.popFront();
+    list.pushBack(4);
+    std::vector<int> result(list.rbegin(), list.rend());
+    ASSERT_EQ(result, (std::vector<int>{ 4, 3, 2 }));
+
+    auto it = list.end();
+    --it;
+    ASSERT_EQ(*it, 4);
+}
+
+TEST(CompactListTest, PushBackRange) {
+    std::vector<int> values{ 1, 2, 3 };
+    CompactList<int> list{ 0 };
+    list.pushBackRange(values.begin(), values.end());
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_GE(list.capacity(), 4);
+    ASSERT_EQ(std::vector<int>(list.begin(), list.end()), (std::vector<int>{ 0, 1, 2, 3 }));
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "../Algorithms/CountingAllocator.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/MyAllocator.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Vector.h"
+#include <thread>
+#include <vector>
+
+TEST(AllocationStatsTest, BucketsArePowersOfTwo) {
+    EXPECT_EQ(AllocationStats::bucketOf(0), 0);
+    EXPECT_EQ(AllocationStats::bucketOf(1), 0);
+    EXPECT_EQ(AllocationStats::bucketOf(2), 1);
+    EXPECT_EQ(AllocationStats::bucketOf(3), 2);
+    EXPECT_EQ(AllocationStats::bucketOf(4), 2);
+    EXPECT_EQ(AllocationStats::bucketOf(24), 5);
+    EXPECT_EQ(AllocationStats::bucketLimit(5), 32);
+    EXPECT_EQ(AllocationStats::bucketOf(size_t{ 1 } << 40), AllocationStats::BucketCount - 1);
+}
+
+TEST(CountingAllocatorTest, CountsPerContainerInstance) {
+    using Alloc = CountingAllocator<int, MyAllocator<int>>;
+    using List = DoubleLinkedList<int, Alloc>;
+
+    AllocationStats stats;
+    AllocationStats otherStats;
+    {
+        List list{ Alloc(stats) };
+        List other{ Alloc(otherStats) };
+        for (int i = 0; i < 10; ++i) {
+            list.pushBack(i);
+        }
+        other.pushBack(1);
+
+        EXPECT_EQ(stats.allocations(), 10);
+        EXPECT_EQ(stats.liveAllocations(), 10);
+        EXPECT_EQ(stats.liveBytes(), 10 * sizeof(List::Node));
+        EXPECT_EQ(stats.histogram(AllocationStats::bucketOf(sizeof(List::Node))), 10);
+        EXPECT_EQ(otherStats.allocations(), 1);
+
+        list.popFront();
+        list.popFront();
+        EXPECT_EQ(stats.liveAllocations(), 8);
+        EXPECT_EQ(stats.peakBytes(), 10 * sizeof(List::Node));
+
+        // The copy keeps counting into the same stats.
+        List copy(list);
+        EXPECT_EQ(stats.liveAllocations(), 16);
+    }
+
+    EXPECT_EQ(stats.liveAllocations(), 0);
+    EXPECT_EQ(stats.liveBytes(), 0);
+    EXPECT_EQ(stats.totalBytes(), 18 * sizeof(DoubleLinkedListNode<int>));
+}
+
+TEST(CountingAllocatorTest, ShowsHowVectorGrows) {
+    AllocationStats stats;
+    {
+        Vector<int, CountingAllocator<int>> vec{ CountingAllocator<int>(stats) };
+        for (int i = 0; i < 1000; ++i) {
+            vec.pushBack(i);
+        }
+
+        // 1, 2, 4, ..., 1024 ints.
+        EXPECT_EQ(stats.allocations(), 11);
+        EXPECT_EQ(stats.liveAllocations(), 1);
+        EXPECT_EQ(stats.liveBytes(), 1024 * sizeof(int));
+        EXPECT_EQ(stats.peakBytes(), (1024 + 512) * sizeof(int));
+    }
+    EXPECT_EQ(stats.deallocations(), 11);
+
+    stats.reset();
+    {
+        Vector<int, CountingAllocator<int>> vec{ CountingAllocator<int>(stats) };
+        vec.reserve(1000);
+        for (int i = 0; i < 1000; ++i) {
+            vec.pushBack(i);
+        }
+        EXPECT_EQ(stats.allocations(), 1);
+    }
+}
+
+TEST(CountingAllocatorTest, ResetKeepsLiveMemory) {
+    AllocationStats stats;
+    CountingAllocator<int> allocator(stats);
+
+    int* first = allocator.allocate(100);
+    int* second = allocator.allocate(50);
+    allocator.deallocate(second, 50);
+
+    stats.reset();
+    EXPECT_EQ(stats.allocations(), 0);
+    EXPECT_EQ(stats.liveAllocations(), 1);
+    EXPECT_EQ(stats.liveBytes(), 100 * sizeof(int));
+    EXPECT_EQ(stats.peakBytes(), 100 * sizeof(int));
+
+    // Freeing what was live before the reset doesn't wrap anything.
+    allocator.deallocate(first, 100);
+    EXPECT_EQ(stats.liveAllocations(), 0);
+    EXPECT_EQ(stats.liveBytes(), 0);
+
+    int* third = allocator.allocate(10);
+    EXPECT_EQ(stats.peakBytes(), 100 * sizeof(int));
+    EXPECT_EQ(stats.liveBytes(), 10 * sizeof(int));
+    allocator.deallocate(third, 10);
+
+    stats.reset();
+    EXPECT_EQ(stats.peakBytes(), 0);
+}
+
+TEST(CountingAllocatorTest, TagsSumUpContainers) {
+    struct ListsTag {};
+    using Alloc = CountingAllocator<int, std::allocator<int>, ListsTag>;
+
+    AllocationStats& stats = AllocationStats::forTag<ListsTag>();
+    stats.reset();
+
+    SingleLinkedList<int, Alloc> first;
+    DoubleLinkedList<int, Alloc> second;
+    first.pushBack(1);
+    second.pushBack(2);
+    second.pushBack(3);
+
+    EXPECT_EQ(stats.liveAllocations(), 3);
+    EXPECT_TRUE(first.getAllocator() == Alloc());
+}
+
+TEST(CountingAllocatorTest, CountsFromSeveralThreads) {
+    constexpr int Threads = 4;
+    constexpr int PerThread = 10000;
+
+    AllocationStats stats;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([&stats] {
+            SingleLinkedList<int, CountingAllocator<int>> list{ CountingAllocator<int>(stats) };
+            for (int i = 0; i < PerThread; ++i) {
+                list.pushFront(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(stats.allocations(), Threads * PerThread);
+    EXPECT_EQ(stats.liveBytes(), 0);
+    EXPECT_GE(stats.peakBytes(), PerThread * sizeof(SingleLinkedListNode<int>));
+}
@@ -3,6 +3,8 @@
 #include <vector>
 #include <algorithm> // For std::equal
 #include <numeric>
+#include <iterator>
+#include <ranges>
 
 TEST(DoubleLinkedListTest, DefaultConstructor)
 {
@@ -398,6 +400,208 @@ TEST(DoubleLinkedListTest, RangeBasedForLoop) {
     ASSERT_EQ(constResult, "xy");
 }
 
+template <typename T>
+std::vector<T> ToVector(const DoubleLinkedList<T>& list) {
+    std::vector<T> result;
+    for (const auto& val : list) {
+        result.push_back(val);
+    }
+    return result;
+}
+
+TEST(DoubleLinkedListTest, RemoveFromMiddleKeepsBackwardLinks) {
+    DoubleLinkedList<int> list{ 1, 2, 3 };
+    auto it = list.begin();
+    ++it;
+    list.remove(it);
+    list.popBack();
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(list.back(), 1);
+}
+
+TEST(DoubleLinkedListTest, InsertAtPosition) {
+    DoubleLinkedList<int> list{ 1, 3 };
+    auto it = list.begin();
+    ++it;
+    auto inserted = list.insert(it, 2);
+    ASSERT_EQ(*inserted, 2);
+    list.insert(list.begin(), 0);
+    list.insert(list.end(), 4);
+    ASSERT_EQ(list.size(), 5);
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 0, 1, 2, 3, 4 }));
+    ASSERT_EQ(list.front(), 0);
+    ASSERT_EQ(list.back(), 4);
+}
+
+TEST(DoubleLinkedListTest, InsertIntoEmptyList) {
+    DoubleLinkedList<std::string> list;
+    list.insert(list.end(), "only");
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(list.front(), "only");
+    ASSERT_EQ(list.back(), "only");
+}
+
+TEST(DoubleLinkedListTest, EmplaceConstructsInPlace) {
+    DoubleLinkedList<std::string> list{ "a", "c" };
+    auto it = list.begin();
+    ++it;
+    auto emplaced = list.emplace(it, 3, 'b');
+    ASSERT_EQ(*emplaced, "bbb");
+    ASSERT_EQ(ToVector(list), (std::vector<std::string>{ "a", "bbb", "c" }));
+}
+
+TEST(DoubleLinkedListTest, EraseRange) {
+    DoubleLinkedList<int> list{ 1, 2, 3, 4, 5 };
+    auto first = list.begin();
+    ++first;
+    auto last = first;
+    ++last;
+    ++last;
+    auto next = list.erase(first, last);
+    ASSERT_EQ(*next, 4);
+    ASSERT_EQ(list.size(), 3);
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 1, 4, 5 }));
+
+    list.erase(list.begin(), list.end());
+    ASSERT_TRUE(list.isEmpty());
+    ASSERT_EQ(list.begin(), list.end());
+}
+
+TEST(DoubleLinkedListTest, EraseRangeAtTail) {
+    DoubleLinkedList<int> list{ 1, 2, 3 };
+    auto first = list.begin();
+    ++first;
+    ASSERT_EQ(list.erase(first, list.end()), list.end());
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(list.back(), 1);
+    list.pushBack(9);
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 1, 9 }));
+}
+
+TEST(DoubleLinkedListTest, SpliceRangeFromAnotherList) {
+    DoubleLinkedList<int> list{ 1, 5 };
+    DoubleLinkedList<int> other{ 10, 2, 3, 4, 20 };
+
+    auto first = other.begin();
+    ++first;
+    auto last = first;
+    ++last;
+    ++last;
+    ++last;
+    int* movedAddress = &*first;
+
+    auto where = list.begin();
+    ++where;
+    list.splice(where, other, first, last);
+
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 1, 2, 3, 4, 5 }));
+    ASSERT_EQ(ToVector(other), (std::vector<int>{ 10, 20 }));
+    ASSERT_EQ(list.size(), 5);
+    ASSERT_EQ(other.size(), 2);
+
+    // Nodes are relinked, not copied.
+    auto it = list.begin();
+    ++it;
+    ASSERT_EQ(&*it, movedAddress);
+}
+
+TEST(DoubleLinkedListTest, SplicedIteratorsKeepTheirElements) {
+    DoubleLinkedList<int> list{ 1 };
+    DoubleLinkedList<int> other{ 2, 3 };
+
+    auto it = other.begin();
+    list.splice(list.end(), other);
+
+    // Still the same element, now in `list`.
+    ASSERT_EQ(*it, 2);
+    *it = 20;
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 1, 20, 3 }));
+
+    // But it still belongs to `other`: comparing with `list` needs an iterator re-obtained from it.
+    ASSERT_DEATH((void)(it == list.end()), "owner_");
+
+    auto fresh = list.begin();
+    ++fresh;
+    ASSERT_EQ(&*fresh, &*it);
+}
+
+TEST(DoubleLinkedListTest, SpliceWholeList) {
+    DoubleLinkedList<int> list{ 1, 2 };
+    DoubleLinkedList<int> other{ 3, 4 };
+    list.splice(list.end(), other);
+    ASSERT_TRUE(other.isEmpty());
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(list.back(), 4);
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 1, 2, 3, 4 }));
+
+    other.pushBack(7);
+    ASSERT_EQ(other.front(), 7);
+}
+
+TEST(DoubleLinkedListTest, SpliceSingleElementWithinList) {
+    DoubleLinkedList<int> list{ 1, 2, 3 };
+    auto last = list.begin();
+    ++last;
+    ++last;
+    list.splice(list.begin(), list, last);
+    ASSERT_EQ(list.size(), 3);
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 3, 1, 2 }));
+    ASSERT_EQ(list.front(), 3);
+    ASSERT_EQ(list.back(), 2);
+}
+
+static_assert(std::bidirectional_iterator<DoubleLinkedList<int>::Iterator>);
+static_assert(std::bidirectional_iterator<DoubleLinkedList<int>::ConstIterator>);
+static_assert(std::ranges::bidirectional_range<DoubleLinkedList<int>>);
+static_assert(std::ranges::bidirectional_range<const DoubleLinkedList<int>>);
+
+TEST(DoubleLinkedListTest, IteratorDecrement) {
+    DoubleLinkedList<int> list{ 1, 2, 3 };
+    auto it = list.end();
+    --it;
+    ASSERT_EQ(*it, 3);
+    auto old = it--;
+    ASSERT_EQ(*old, 3);
+    ASSERT_EQ(*it, 2);
+    --it;
+    ASSERT_EQ(it, list.begin());
+}
+
+TEST(DoubleLinkedListTest, ReverseIteration) {
+    DoubleLinkedList<int> list{ 1, 2, 3, 4 };
+    std::vector<int> result(list.rbegin(), list.rend());
+    ASSERT_EQ(result, (std::vector<int>{ 4, 3, 2, 1 }));
+
+    const DoubleLinkedList<int>& constList = list;
+    std::vector<int> constResult(constList.crbegin(), constList.crend());
+    ASSERT_EQ(constResult, (std::vector<int>{ 4, 3, 2, 1 }));
+
+    DoubleLinkedList<int> empty;
+    ASSERT_EQ(empty.rbegin(), empty.rend());
+}
+
+TEST(DoubleLinkedListTest, IteratorConvertsToConstIterator) {
+    DoubleLinkedList<int> list{ 7 };
+    DoubleLinkedList<int>::ConstIterator it = list.begin();
+    ASSERT_EQ(*it, 7);
+}
+
+TEST(DoubleLinkedListTest, StandardAlgorithms) {
+    DoubleLinkedList<int> list{ 5, 1, 4, 2, 3 };
+
+    ASSERT_EQ(*std::find(list.begin(), list.end(), 4), 4);
+    ASSERT_EQ(*std::ranges::max_element(list), 5);
+
+    std::reverse(list.begin(), list.end());
+    ASSERT_EQ(ToVector(list), (std::vector<int>{ 3, 2, 4, 1, 5 }));
+
+    std::vector<int> evenReversed;
+    for (int val : list | std::views::reverse | std::views::filter([](int v) { return v % 2 == 0; })) {
+        evenReversed.push_back(val);
+    }
+    ASSERT_EQ(evenReversed, (std::vector<int>{ 4, 2 }));
+}
+
 //TEST(DoubleLinkedListTest, LargeNumberOfElements) {
 //    DoubleLinkedList<int> list;
 //    const size_t count = 1000;
@@ -437,4 +641,12 @@ TEST(DoubleLinkedListTest, RangeBasedForLoop) {
 //    ASSERT_EQ(*constList.get(1), 'f');
 //    ASSERT_EQ(*constList.get(2), 'g');
 //    ASSERT_EQ(constList.get(3), nullptr); // Out of bounds
-//}
\ No newline at end of file
+//}
+
+TEST(DoubleLinkedListTest, PushBackRange) {
+    std::vector<int> values{ 2, 3 };
+    DoubleLinkedList<int> list{ 1 };
+    list.pushBackRange(values.begin(), values.end());
+    EXPECT_EQ(ToVector(list), (std::vector<int>{ 1, 2, 3 }));
+    EXPECT_EQ(list.back(), 3);
+}
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "../Algorithms/EliminationStack.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(EliminationStackTest, PopsNewestFirst) {
+    EliminationStack<int> stack(8);
+    int out = 0;
+    EXPECT_FALSE(stack.tryPop(out));
+    EXPECT_TRUE(stack.isEmptyApprox());
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(stack.tryPush(i));
+    }
+    EXPECT_FALSE(stack.isEmptyApprox());
+
+    for (int i = 2; i >= 0; --i) {
+        ASSERT_TRUE(stack.tryPop(out));
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_FALSE(stack.tryPop(out));
+}
+
+TEST(EliminationStackTest, RejectsPushWhenFull) {
+    EliminationStack<int> stack(2);
+    EXPECT_EQ(stack.capacity(), 2);
+
+    EXPECT_TRUE(stack.tryPush(1));
+    EXPECT_TRUE(stack.tryPush(2));
+    EXPECT_FALSE(stack.tryPush(3));
+
+    int out = 0;
+    ASSERT_TRUE(stack.tryPop(out));
+    EXPECT_EQ(out, 2);
+    EXPECT_TRUE(stack.tryPush(4));
+    ASSERT_TRUE(stack.tryPop(out));
+    EXPECT_EQ(out, 4);
+}
+
+TEST(EliminationStackTest, ThrowingCopyKeepsCapacity) {
+    struct Thrower {
+        int value{ 0 };
+        bool bThrowOnCopy{ false };
+
+        Thrower() = default;
+        Thrower(int value, bool bThrowOnCopy) : value(value), bThrowOnCopy(bThrowOnCopy) {}
+        Thrower(const Thrower& other) : value(other.value), bThrowOnCopy(false) {
+            if (other.bThrowOnCopy) {
+                throw std::runtime_error("copy");
+            }
+        }
+        Thrower(Thrower&&) = default;
+        Thrower& operator=(Thrower&&) = default;
+    };
+
+    EliminationStack<Thrower> stack(2);
+    const Thrower bad(0, true);
+    EXPECT_THROW(stack.tryPush(bad), std::runtime_error);
+    EXPECT_THROW(stack.tryPush(bad), std::runtime_error);
+
+    EXPECT_TRUE(stack.tryPush(Thrower(1, false)));
+    EXPECT_TRUE(stack.tryPush(Thrower(2, false)));
+    EXPECT_FALSE(stack.tryPush(Thrower(3, false)));
+
+    Thrower out;
+    EXPECT_TRUE(stack.tryPop(out));
+    EXPECT_EQ(out.value, 2);
+}
+
+TEST(EliminationStackTest, HoldsMoveOnlyTypes) {
+    EliminationStack<std::unique_ptr<int>> stack(4);
+    EXPECT_TRUE(stack.tryPush(std::make_unique<int>(7)));
+    EXPECT_TRUE(stack.tryEmplace(new int(8)));
+
+    std::unique_ptr<int> out;
+    ASSERT_TRUE(stack.tryPop(out));
+    EXPECT_EQ(*out, 8);
+
+    // The one left behind is freed by the stack's destructor.
+}
+
+TEST(EliminationStackTest, EveryItemIsPoppedExactlyOnce) {
+    constexpr int PerThread = 20000;
+    constexpr int Threads = 4;
+
+    // Small enough that pushes fail now and then and threads collide at the head all the time.
+    EliminationStack<int> stack(64);
+    std::vector<std::atomic<int>> popped(PerThread * Threads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([&, t] {
+            int out = 0;
+            for (int i = 0; i < PerThread; ++i) {
+                const int item = t * PerThread + i;
+                while (!stack.tryPush(item)) {
+                    if (stack.tryPop(out)) {
+                        ++popped[out];
+                    }
+                    std::this_thread::yield();
+                }
+                if (i % 2 == 0 && stack.tryPop(out)) {
+                    ++popped[out];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    int out = 0;
+    while (stack.tryPop(out)) {
+        ++popped[out];
+    }
+    for (int i = 0; i < PerThread * Threads; ++i) {
+        ASSERT_EQ(popped[i], 1) << i;
+    }
+}
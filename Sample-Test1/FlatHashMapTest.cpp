@@ -0,0 +1,507 @@
+#include "pch.h"
+#include "../Algorithms/CountingAllocator.h"
+#include "../Algorithms/FlatHashMap.h"
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+    // Every key lands on the same probe sequence, with the same H2.
+    struct CollidingHash {
+        size_t operator()(int) const { return 42; }
+    };
+
+    // Counts how often it had to hash a std::string_view, i.e. a lookup that built no std::string.
+    struct CountingStringHash {
+        using is_transparent = void;
+
+        int* viewHashes;
+
+        size_t operator()(std::string_view text) const { ++*viewHashes; return std::hash<std::string_view>()(text); }
+        size_t operator()(const std::string& text) const { return std::hash<std::string>()(text); }
+    };
+
+    // Throws std::bad_alloc on the allocation numbered `failAt`, counting from the last arm().
+    class FailingResource : public std::pmr::memory_resource {
+    public:
+        void arm(int failAt) { failAt_ = failAt; }
+
+        int liveAllocations() const { return live_; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (failAt_ > 0 && --failAt_ == 0) {
+                throw std::bad_alloc();
+            }
+            ++live_;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            --live_;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        int failAt_ = 0;
+        int live_ = 0;
+    };
+
+    // Counts live instances, so a key that's never destroyed shows up.
+    struct TrackedKey {
+        static inline int live = 0;
+
+        int id;
+
+        TrackedKey(int id) : id(id) { ++live; }
+        TrackedKey(const TrackedKey& other) : id(other.id) { ++live; }
+        ~TrackedKey() { --live; }
+        bool operator==(const TrackedKey& other) const { return id == other.id; }
+    };
+
+    struct TrackedHash {
+        size_t operator()(const TrackedKey& key) const { return std::hash<int>()(key.id); }
+    };
+
+    struct ThrowingValue {
+        ThrowingValue(bool bThrow) { if (bThrow) throw std::runtime_error("value"); }
+    };
+
+    template<typename Group>
+    void ExpectGroupMatches(const int8* ctrl) {
+        Group group(ctrl);
+
+        for (uint32 i = 0; i < Group::Width; ++i) {
+            bool bEmpty = ctrl[i] == FlatHashControl::Empty;
+            bool bFree = bEmpty || ctrl[i] == FlatHashControl::Deleted;
+
+            bool bReportedEmpty = false;
+            for (auto mask = group.matchEmpty(); mask; mask.clearLowest()) {
+                bReportedEmpty |= mask.lowest() == i;
+            }
+            EXPECT_EQ(bReportedEmpty, bEmpty) << i;
+
+            bool bReportedFree = false;
+            for (auto mask = group.matchEmptyOrDeleted(); mask; mask.clearLowest()) {
+                bReportedFree |= mask.lowest() == i;
+            }
+            EXPECT_EQ(bReportedFree, bFree) << i;
+
+            // Every true match is reported; anything else reported has to be a full slot.
+            if (ctrl[i] >= 0) {
+                bool bReported = false;
+                for (auto mask = group.match(static_cast<uint8>(ctrl[i])); mask; mask.clearLowest()) {
+                    bReported |= mask.lowest() == i;
+                }
+                EXPECT_TRUE(bReported) << i;
+            }
+            for (auto mask = group.match(0x35); mask; mask.clearLowest()) {
+                EXPECT_GE(ctrl[mask.lowest()], 0);
+            }
+        }
+    }
+}
+
+TEST(FlatHashMapTest, GroupsMatchControlBytes) {
+    std::mt19937 random(5);
+    const int8 specials[] = { FlatHashControl::Empty, FlatHashControl::Deleted, FlatHashControl::Sentinel };
+
+    for (int round = 0; round < 200; ++round) {
+        int8 ctrl[16];
+        for (int8& byte : ctrl) {
+            byte = random() % 2 == 0 ? specials[random() % 3] : static_cast<int8>(random() % 128);
+        }
+        ctrl[random() % 16] = 0x35;
+
+        ExpectGroupMatches<FlatHashGroupPortable>(ctrl);
+        ExpectGroupMatches<FlatHashGroupPortable>(ctrl + 8);
+        ExpectGroupMatches<FlatHashGroup>(ctrl);
+    }
+}
+
+TEST(FlatHashMapTest, BitMaskZeros) {
+    // Portable layout: the top bit of each byte.
+    FlatHashBitMask<8, 3> portable(0x0000800000008000ull);
+    EXPECT_EQ(portable.trailingZeros(), 1);
+    EXPECT_EQ(portable.leadingZeros(), 2);
+
+    FlatHashBitMask<16, 0> sse(0b0000000100100000);
+    EXPECT_EQ(sse.trailingZeros(), 5);
+    EXPECT_EQ(sse.leadingZeros(), 7);
+}
+
+TEST(FlatHashMapTest, EmptyMap) {
+    FlatHashMap<int, int> map;
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.capacity(), 0);
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_FALSE(map.erase(1));
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(FlatHashMapTest, InsertAndFind) {
+    FlatHashMap<int, std::string> map;
+    auto [it, bInserted] = map.tryEmplace(1, "one");
+    EXPECT_TRUE(bInserted);
+    EXPECT_EQ((*it).first, 1);
+    EXPECT_EQ(it->second, "one");
+
+    map.tryEmplace(2, "two");
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.find(2)->second, "two");
+    EXPECT_TRUE(map.contains(1));
+    EXPECT_FALSE(map.contains(3));
+}
+
+TEST(FlatHashMapTest, TryEmplaceKeepsExisting) {
+    FlatHashMap<std::string, std::string> map;
+    map.tryEmplace("key", "first");
+
+    std::string value = "second";
+    auto [it, bInserted] = map.tryEmplace("key", std::move(value));
+    EXPECT_FALSE(bInserted);
+    EXPECT_EQ(it->second, "first");
+    EXPECT_EQ(value, "second"); // Not moved from.
+}
+
+TEST(FlatHashMapTest, InsertOrAssign) {
+    FlatHashMap<int, int> map;
+    EXPECT_TRUE(map.insertOrAssign(1, 10).second);
+    EXPECT_FALSE(map.insertOrAssign(1, 20).second);
+    EXPECT_EQ(map.find(1)->second, 20);
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatHashMapTest, SubscriptOperator) {
+    FlatHashMap<std::string, int> map;
+    map["a"] = 1;
+    ++map["a"];
+    ++map["b"];
+    EXPECT_EQ(map["a"], 2);
+    EXPECT_EQ(map["b"], 1);
+    EXPECT_EQ(map.size(), 2);
+}
+
+TEST(FlatHashMapTest, ManyElementsGrow) {
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 10000; ++i) {
+        map.tryEmplace(i, i * 2);
+    }
+
+    EXPECT_EQ(map.size(), 10000);
+    EXPECT_LE(map.size(), map.capacity() - map.capacity() / 8);
+    for (int i = 0; i < 10000; ++i) {
+        auto it = map.find(i);
+        ASSERT_NE(it, map.end()) << i;
+        EXPECT_EQ(it->second, i * 2);
+    }
+    EXPECT_FALSE(map.contains(10000));
+    EXPECT_FALSE(map.contains(-1));
+}
+
+TEST(FlatHashMapTest, ReserveAvoidsRehashing) {
+    FlatHashMap<int, int> map;
+    map.reserve(1000);
+    size_t capacity = map.capacity();
+    EXPECT_GE(capacity - capacity / 8, 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        map.tryEmplace(i, i);
+    }
+    EXPECT_EQ(map.capacity(), capacity);
+
+    // Reserving less than what's there changes nothing.
+    map.reserve(10);
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, EraseByKeyAndIterator) {
+    FlatHashMap<int, int> map = { { 1, 1 }, { 2, 2 }, { 3, 3 } };
+    EXPECT_TRUE(map.erase(2));
+    EXPECT_FALSE(map.erase(2));
+    EXPECT_FALSE(map.contains(2));
+
+    map.erase(map.find(1));
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_TRUE(map.contains(3));
+}
+
+TEST(FlatHashMapTest, ChurnDoesNotGrowTheTable) {
+    // Tombstones have to be reclaimed, or a map of constant size would keep growing.
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 100000; ++i) {
+        map.tryEmplace(i, i);
+        if (i >= 10) {
+            ASSERT_TRUE(map.erase(i - 10));
+        }
+    }
+
+    EXPECT_EQ(map.size(), 10);
+    EXPECT_LE(map.capacity(), 31);
+    for (int i = 100000 - 10; i < 100000; ++i) {
+        EXPECT_TRUE(map.contains(i));
+    }
+}
+
+TEST(FlatHashMapTest, CollidingHashesStillWork) {
+    FlatHashMap<int, int, CollidingHash> map;
+    for (int i = 0; i < 200; ++i) {
+        map.tryEmplace(i, i);
+    }
+    for (int i = 0; i < 200; i += 2) {
+        EXPECT_TRUE(map.erase(i));
+    }
+
+    EXPECT_EQ(map.size(), 100);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(map.contains(i), i % 2 == 1) << i;
+    }
+}
+
+TEST(FlatHashMapTest, IterationVisitsEveryElementOnce) {
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 500; ++i) {
+        map.tryEmplace(i, i + 1);
+    }
+    for (int i = 0; i < 500; i += 3) {
+        map.erase(i);
+    }
+
+    std::map<int, int> seen;
+    for (auto [key, value] : map) {
+        EXPECT_EQ(value, key + 1);
+        ++seen[key];
+    }
+
+    EXPECT_EQ(seen.size(), map.size());
+    for (const auto& [key, count] : seen) {
+        EXPECT_EQ(count, 1);
+        EXPECT_NE(key % 3, 0);
+    }
+}
+
+TEST(FlatHashMapTest, IterationCanModifyValues) {
+    FlatHashMap<int, int> map = { { 1, 1 }, { 2, 2 } };
+    for (auto [key, value] : map) {
+        value *= 10;
+    }
+    EXPECT_EQ(map.find(1)->second, 10);
+    EXPECT_EQ(map.find(2)->second, 20);
+
+    const auto& constMap = map;
+    int sum = 0;
+    for (const auto& [key, value] : constMap) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 30);
+
+    FlatHashMap<int, int>::ConstIterator it = map.begin();
+    EXPECT_EQ(it, constMap.begin());
+}
+
+TEST(FlatHashMapTest, HeterogeneousLookup) {
+    int viewHashes = 0;
+    FlatHashMap<std::string, int, CountingStringHash, std::equal_to<>> map(CountingStringHash{ &viewHashes });
+    map.tryEmplace(std::string("apple"), 1);
+    map.tryEmplace(std::string("pear"), 2);
+    viewHashes = 0;
+
+    std::string_view pear = "pear";
+    EXPECT_EQ(map.find(pear)->second, 2);
+    EXPECT_TRUE(map.contains(std::string_view("apple")));
+    EXPECT_FALSE(map.contains(std::string_view("plum")));
+    EXPECT_EQ(viewHashes, 3);
+
+    // Only inserting builds a std::string.
+    EXPECT_TRUE(map.tryEmplace(std::string_view("plum"), 3).second);
+    EXPECT_FALSE(map.tryEmplace(std::string_view("plum"), 4).second);
+    EXPECT_EQ(map.find(std::string_view("plum"))->second, 3);
+
+    EXPECT_TRUE(map.erase(std::string_view("apple")));
+    EXPECT_EQ(map.size(), 2);
+}
+
+TEST(FlatHashMapTest, StringHashWithLiterals) {
+    FlatHashMap<std::string, int, StringHash, std::equal_to<>> map;
+    map["one"] = 1;
+    EXPECT_TRUE(map.contains("one"));
+    EXPECT_EQ(map.find(std::string_view("one"))->second, 1);
+}
+
+TEST(FlatHashMapTest, MoveOnlyValues) {
+    FlatHashMap<int, std::unique_ptr<int>> map;
+    for (int i = 0; i < 100; ++i) {
+        map.tryEmplace(i, std::make_unique<int>(i));
+    }
+
+    FlatHashMap<int, std::unique_ptr<int>> moved(std::move(map));
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_EQ(*moved.find(50)->second, 50);
+}
+
+TEST(FlatHashMapTest, CopyAndAssign) {
+    FlatHashMap<std::string, int> map = { { "a", 1 }, { "b", 2 } };
+    FlatHashMap<std::string, int> copy(map);
+    copy["c"] = 3;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(copy.size(), 3);
+
+    map = copy;
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map["c"], 3);
+
+    FlatHashMap<std::string, int> other;
+    other = std::move(map);
+    EXPECT_EQ(other.size(), 3);
+    EXPECT_TRUE(map.isEmpty());
+
+    other.swap(copy);
+    EXPECT_EQ(other.size(), 3);
+}
+
+TEST(FlatHashMapTest, ClearKeepsTheTable) {
+    FlatHashMap<std::string, std::string> map;
+    for (int i = 0; i < 100; ++i) {
+        map.tryEmplace(std::to_string(i), std::string(50, 'x'));
+    }
+    size_t capacity = map.capacity();
+
+    map.clear();
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_EQ(map.begin(), map.end());
+
+    map["x"] = "y";
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatHashMapTest, FreesEverythingItAllocates) {
+    AllocationStats stats;
+    {
+        using Alloc = CountingAllocator<std::pair<const std::string, std::string>>;
+        FlatHashMap<std::string, std::string, std::hash<std::string>, std::equal_to<std::string>, Alloc> map{ Alloc(stats) };
+        for (int i = 0; i < 1000; ++i) {
+            map.tryEmplace(std::to_string(i), "value");
+        }
+
+        // Control bytes, keys and values: three blocks per table.
+        EXPECT_EQ(stats.liveAllocations(), 3);
+    }
+    EXPECT_EQ(stats.liveAllocations(), 0);
+}
+
+TEST(FlatHashMapTest, FailedGrowthLeavesTheMapIntact) {
+    FailingResource resource;
+    {
+        PmrFlatHashMap<std::string, std::string> map{ std::pmr::polymorphic_allocator<std::pair<const std::string, std::string>>(&resource) };
+
+        // Fill the table to its 7/8 limit, so the next insert has to grow it.
+        map.reserve(100);
+        size_t capacity = map.capacity();
+        int count = 0;
+        for (; map.size() < capacity - capacity / 8; ++count) {
+            map.tryEmplace(std::to_string(count), "value");
+        }
+        ASSERT_EQ(map.capacity(), capacity);
+
+        // Fail the keys array, then the values array: the control bytes were already allocated.
+        for (int failAt : { 2, 3 }) {
+            resource.arm(failAt);
+            EXPECT_THROW(map.tryEmplace("new", "value"), std::bad_alloc);
+            resource.arm(0);
+
+            EXPECT_EQ(map.capacity(), capacity);
+            EXPECT_EQ(map.size(), static_cast<size_t>(count));
+            EXPECT_EQ(resource.liveAllocations(), 3);
+            for (int i = 0; i < count; ++i) {
+                ASSERT_TRUE(map.contains(std::to_string(i))) << i;
+            }
+        }
+
+        EXPECT_TRUE(map.tryEmplace("new", "value").second);
+        EXPECT_GT(map.capacity(), capacity);
+    }
+    EXPECT_EQ(resource.liveAllocations(), 0);
+}
+
+TEST(FlatHashMapTest, InsertOwnValueWhileGrowing) {
+    // The argument lives in the values array that the rehash frees.
+    FlatHashMap<int, std::string> map;
+    map.tryEmplace(0, "value, and too long for the small-string buffer");
+    for (int i = 1; i < 1000; ++i) {
+        size_t capacity = map.capacity();
+        ASSERT_TRUE(map.tryEmplace(i, map.find(i - 1)->second).second);
+        if (map.capacity() != capacity) {
+            ASSERT_EQ(map.find(i)->second, "value, and too long for the small-string buffer") << i;
+        }
+    }
+    EXPECT_EQ(map[999], "value, and too long for the small-string buffer");
+}
+
+TEST(FlatHashMapTest, ThrowingValueDestroysTheKey) {
+    {
+        FlatHashMap<TrackedKey, ThrowingValue, TrackedHash> map;
+        map.tryEmplace(TrackedKey(1), false);
+        EXPECT_THROW(map.tryEmplace(TrackedKey(2), true), std::runtime_error);
+        EXPECT_EQ(map.size(), 1);
+        EXPECT_EQ(TrackedKey::live, 1);
+
+        // At the growth boundary the key is built before the value as well.
+        for (int i = 3; map.size() < map.capacity() - map.capacity() / 8; ++i) {
+            map.tryEmplace(TrackedKey(i), false);
+        }
+        const size_t size = map.size();
+        EXPECT_THROW(map.tryEmplace(TrackedKey(-1), true), std::runtime_error);
+        EXPECT_EQ(map.size(), size);
+        EXPECT_EQ(TrackedKey::live, static_cast<int>(size));
+    }
+    EXPECT_EQ(TrackedKey::live, 0);
+}
+
+TEST(FlatHashMapTest, PmrMap) {
+    std::pmr::monotonic_buffer_resource resource;
+    PmrFlatHashMap<int, int> map{ std::pmr::polymorphic_allocator<std::pair<const int, int>>(&resource) };
+    for (int i = 0; i < 100; ++i) {
+        map.tryEmplace(i, i);
+    }
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_EQ(map.getAllocator().resource(), &resource);
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMap) {
+    std::mt19937 random(17);
+    FlatHashMap<int, int> map;
+    std::unordered_map<int, int> expected;
+
+    for (int i = 0; i < 50000; ++i) {
+        int key = static_cast<int>(random() % 2000);
+        switch (random() % 4) {
+        case 0:
+        case 1:
+            EXPECT_EQ(map.insertOrAssign(key, i).second, expected.insert_or_assign(key, i).second);
+            break;
+        case 2:
+            EXPECT_EQ(map.erase(key), expected.erase(key) == 1);
+            break;
+        default:
+            EXPECT_EQ(map.contains(key), expected.count(key) == 1);
+            break;
+        }
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+    for (const auto& [key, value] : expected) {
+        auto it = map.find(key);
+        ASSERT_NE(it, map.end());
+        EXPECT_EQ(it->second, value);
+    }
+}
@@ -0,0 +1,308 @@
+#include "pch.h"
+#include "../Algorithms/FlatMap.h"
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    // A value whose move can be made to throw, to catch up with a half-done insert.
+    struct ThrowingValue {
+        static inline bool bThrowOnMove = false;
+
+        // Counts down with every move and throws at zero; negative never throws.
+        static inline int movesBeforeThrow = -1;
+
+        int value = 0;
+
+        ThrowingValue(int value) : value(value) {}
+        ThrowingValue(ThrowingValue&& other) : value(other.value) {
+            if (bThrowOnMove || movesBeforeThrow == 0) {
+                throw std::runtime_error("move");
+            }
+            if (movesBeforeThrow > 0) {
+                --movesBeforeThrow;
+            }
+        }
+        ThrowingValue& operator=(ThrowingValue&&) = default;
+    };
+
+    // Keys in sorted order, read straight from the map.
+    std::vector<int> KeysOf(const FlatMap<int, int>& map) {
+        std::vector<int> keys;
+        for (auto [key, value] : map) {
+            keys.push_back(key);
+        }
+        return keys;
+    }
+}
+
+TEST(BranchlessSearchTest, MatchesStdLowerBound) {
+    std::mt19937 random(11);
+    std::less<int> less;
+
+    for (size_t n = 0; n < 70; ++n) {
+        std::vector<int> values(n);
+        for (int& value : values) {
+            value = static_cast<int>(random() % 40); // Plenty of duplicates.
+        }
+        std::sort(values.begin(), values.end());
+
+        for (int key = -1; key <= 41; ++key) {
+            size_t expected = std::lower_bound(values.begin(), values.end(), key) - values.begin();
+            EXPECT_EQ(branchlessLowerBound(values.data(), n, key, less), expected) << n << " " << key;
+        }
+    }
+}
+
+TEST(BranchlessSearchTest, HeterogeneousKey) {
+    std::vector<std::string> words = { "ant", "bee", "cat", "dog" };
+    std::string_view key = "cow";
+    EXPECT_EQ(branchlessLowerBound(words.data(), words.size(), key, std::less<>()), 3);
+}
+
+TEST(FlatMapTest, EmptyMap) {
+    FlatMap<int, int> map;
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.find(1), map.end());
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_FALSE(map.erase(1));
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_EQ(map.lowerBound(1), map.end());
+}
+
+TEST(FlatMapTest, BulkBuildSortsOnce) {
+    std::vector<std::pair<int, std::string>> input = { { 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "again" }, { 3, "again" } };
+    FlatMap<int, std::string> map(input.begin(), input.end());
+
+    // Sorted, and of the duplicates the first one in the input won.
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.find(1)->second, "a");
+    EXPECT_EQ(map.find(2)->second, "b");
+    EXPECT_EQ(map.find(3)->second, "c");
+    EXPECT_TRUE(std::is_sorted(map.keys().begin(), map.keys().end()));
+}
+
+TEST(FlatMapTest, InitializerList) {
+    FlatMap<int, int> map = { { 5, 50 }, { 1, 10 }, { 3, 30 } };
+    EXPECT_EQ(KeysOf(map), (std::vector<int>{ 1, 3, 5 }));
+    EXPECT_EQ(map.values()[1], 30);
+}
+
+TEST(FlatMapTest, TryEmplaceKeepsOrder) {
+    FlatMap<int, std::string> map;
+    EXPECT_TRUE(map.tryEmplace(5, "five").second);
+    EXPECT_TRUE(map.tryEmplace(1, "one").second);
+
+    auto [it, bInserted] = map.tryEmplace(3, "three");
+    EXPECT_TRUE(bInserted);
+    EXPECT_EQ(it.index(), 1);
+    EXPECT_EQ(it->second, "three");
+
+    std::string value = "other";
+    auto [existing, bAgain] = map.tryEmplace(3, std::move(value));
+    EXPECT_FALSE(bAgain);
+    EXPECT_EQ(existing->second, "three");
+    EXPECT_EQ(value, "other"); // Not moved from.
+
+    EXPECT_EQ(map.find(1)->second, "one");
+    EXPECT_EQ(map.find(5)->second, "five");
+}
+
+TEST(FlatMapTest, InsertOrAssignAndSubscript) {
+    FlatMap<std::string, int> map;
+    EXPECT_TRUE(map.insertOrAssign("a", 1).second);
+    EXPECT_FALSE(map.insertOrAssign("a", 2).second);
+    EXPECT_EQ(map.find("a")->second, 2);
+
+    ++map["b"];
+    map["a"] += 10;
+    EXPECT_EQ(map["a"], 12);
+    EXPECT_EQ(map["b"], 1);
+    EXPECT_EQ(map.size(), 2);
+}
+
+TEST(FlatMapTest, InsertRangeMerges) {
+    FlatMap<int, int> map = { { 10, 1 }, { 20, 1 }, { 30, 1 } };
+
+    // Interleaved with what's there, unsorted, with duplicates inside and against the map.
+    std::vector<std::pair<int, int>> batch = { { 25, 2 }, { 5, 2 }, { 20, 2 }, { 35, 2 }, { 5, 3 }, { 15, 2 } };
+    map.insertRange(batch.begin(), batch.end());
+
+    EXPECT_EQ(KeysOf(map), (std::vector<int>{ 5, 10, 15, 20, 25, 30, 35 }));
+    EXPECT_EQ(map.find(5)->second, 2);
+    EXPECT_EQ(map.find(20)->second, 1); // The map's own element wins.
+}
+
+TEST(FlatMapTest, InsertRangeAppends) {
+    FlatMap<int, int> map = { { 1, 1 }, { 2, 2 } };
+    std::vector<std::pair<int, int>> batch = { { 4, 4 }, { 3, 3 } };
+    map.insertRange(batch.begin(), batch.end());
+    EXPECT_EQ(KeysOf(map), (std::vector<int>{ 1, 2, 3, 4 }));
+
+    map.insertRange(batch.end(), batch.end());
+    EXPECT_EQ(map.size(), 4);
+}
+
+TEST(FlatMapTest, EraseByKeyAndIterator) {
+    FlatMap<int, int> map = { { 1, 10 }, { 2, 20 }, { 3, 30 }, { 4, 40 } };
+    EXPECT_TRUE(map.erase(2));
+    EXPECT_FALSE(map.erase(2));
+    EXPECT_EQ(map.find(3)->second, 30);
+
+    auto next = map.erase(map.find(3));
+    EXPECT_EQ(next->first, 4);
+    EXPECT_EQ(KeysOf(map), (std::vector<int>{ 1, 4 }));
+    EXPECT_EQ(map.values()[1], 40);
+}
+
+TEST(FlatMapTest, LowerBound) {
+    FlatMap<int, int> map = { { 10, 0 }, { 20, 0 }, { 30, 0 } };
+    EXPECT_EQ(map.lowerBound(5)->first, 10);
+    EXPECT_EQ(map.lowerBound(20)->first, 20);
+    EXPECT_EQ(map.lowerBound(21)->first, 30);
+    EXPECT_EQ(map.lowerBound(31), map.end());
+}
+
+TEST(FlatMapTest, HeterogeneousLookup) {
+    FlatMap<std::string, int, std::less<>> map = { { "alpha", 1 }, { "beta", 2 } };
+    std::string_view key = "beta";
+    EXPECT_TRUE(map.contains(key));
+    EXPECT_EQ(map.find(key)->second, 2);
+    EXPECT_EQ(map.lowerBound(std::string_view("b"))->first, "beta");
+    EXPECT_TRUE(map.erase(std::string_view("alpha")));
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatMapTest, IterateAndModifyValues) {
+    FlatMap<int, int> map = { { 2, 0 }, { 1, 0 } };
+    for (auto [key, value] : map) {
+        value = key * 100;
+    }
+    EXPECT_EQ(map.find(1)->second, 100);
+    EXPECT_EQ(map.find(2)->second, 200);
+
+    const FlatMap<int, int>& constMap = map;
+    FlatMap<int, int>::ConstIterator it = map.begin();
+    EXPECT_EQ(it, constMap.begin());
+    EXPECT_EQ((*--constMap.end()).first, 2);
+}
+
+TEST(FlatMapTest, CopyAndMove) {
+    FlatMap<int, std::string> map = { { 1, "one" }, { 2, "two" } };
+    FlatMap<int, std::string> copy = map;
+    copy[3] = "three";
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(copy.size(), 3);
+
+    FlatMap<int, std::string> moved = std::move(copy);
+    EXPECT_EQ(moved.find(3)->second, "three");
+}
+
+TEST(FlatMapTest, ThrowingValueLeavesArraysInStep) {
+    FlatMap<int, ThrowingValue> map;
+    map.reserve(4);
+    map.tryEmplace(1, 10);
+    map.tryEmplace(3, 30);
+
+    ThrowingValue::bThrowOnMove = true;
+    EXPECT_THROW(map.tryEmplace(2, 20), std::runtime_error);
+    ThrowingValue::bThrowOnMove = false;
+
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.keys().size(), map.values().size());
+    EXPECT_FALSE(map.contains(2));
+    EXPECT_EQ(map.find(3)->second.value, 30);
+
+    map.tryEmplace(2, 20);
+    EXPECT_EQ(map.values()[1].value, 20);
+}
+
+TEST(FlatMapTest, ThrowingMoveNeverMispairsKeysAndValues) {
+    // Throw at every move in turn: the map may be cleared, but a key never ends up with another key's value.
+    for (int movesBeforeThrow = 0;; ++movesBeforeThrow) {
+        // Room up front, so only the inserts themselves move values.
+        FlatMap<int, ThrowingValue> map;
+        map.reserve(16);
+        for (int key : { 1, 3, 5, 7 }) {
+            map.tryEmplace(key, key * 10);
+        }
+
+        std::pair<int, ThrowingValue> batch[] = { { 6, 60 }, { 0, 0 }, { 4, 40 } };
+
+        bool bThrew = false;
+        ThrowingValue::movesBeforeThrow = movesBeforeThrow;
+        try {
+            map.tryEmplace(2, 20);
+            map.insertRange(std::make_move_iterator(std::begin(batch)), std::make_move_iterator(std::end(batch)));
+        }
+        catch (const std::runtime_error&) {
+            bThrew = true;
+        }
+        ThrowingValue::movesBeforeThrow = -1;
+
+        ASSERT_EQ(map.keys().size(), map.values().size());
+        for (auto [key, value] : map) {
+            EXPECT_EQ(value.value, key * 10);
+        }
+
+        if (!bThrew) {
+            EXPECT_EQ(map.size(), 8);
+            break;
+        }
+    }
+}
+
+TEST(FlatMapTest, MatchesStdMap) {
+    std::mt19937 random(3);
+    FlatMap<int, int> map;
+    std::map<int, int> reference;
+
+    for (int round = 0; round < 200; ++round) {
+        switch (random() % 4) {
+        case 0: {
+            int key = random() % 500;
+            map.tryEmplace(key, round);
+            reference.try_emplace(key, round);
+            break;
+        }
+        case 1: {
+            int key = random() % 500;
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+            break;
+        }
+        default: {
+            std::vector<std::pair<int, int>> batch;
+            for (int i = 0; i < 20; ++i) {
+                batch.emplace_back(static_cast<int>(random() % 500), round);
+            }
+            map.insertRange(batch.begin(), batch.end());
+            reference.insert(batch.begin(), batch.end());
+            break;
+        }
+        }
+
+        ASSERT_EQ(map.size(), reference.size());
+    }
+
+    auto expected = reference.begin();
+    for (auto [key, value] : map) {
+        EXPECT_EQ(key, expected->first);
+        EXPECT_EQ(value, expected->second);
+        ++expected;
+    }
+}
+
+TEST(FlatMapTest, PmrAllocator) {
+    std::pmr::monotonic_buffer_resource resource;
+    PmrFlatMap<int, int> map{ std::pmr::polymorphic_allocator<std::pair<const int, int>>(&resource) };
+    map.tryEmplace(1, 1);
+    map[2] = 2;
+    EXPECT_EQ(map.keys().getAllocator().resource(), &resource);
+    EXPECT_EQ(map.values().getAllocator().resource(), &resource);
+}
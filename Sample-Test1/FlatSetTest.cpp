@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "../Algorithms/FlatSet.h"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    // A key whose moves count down and throw at zero; negative never throws.
+    struct ThrowingKey {
+        static inline int movesBeforeThrow = -1;
+
+        int value = 0;
+
+        ThrowingKey(int value) : value(value) {}
+        ThrowingKey(ThrowingKey&& other) : value(other.value) { countMove(); }
+        ThrowingKey& operator=(ThrowingKey&& other) {
+            countMove();
+            value = other.value;
+            return *this;
+        }
+
+        bool operator<(const ThrowingKey& other) const { return value < other.value; }
+
+        static void countMove() {
+            if (movesBeforeThrow == 0) {
+                throw std::runtime_error("move");
+            }
+            if (movesBeforeThrow > 0) {
+                --movesBeforeThrow;
+            }
+        }
+    };
+
+    std::vector<int> KeysOf(const FlatSet<int>& set) {
+        return std::vector<int>(set.begin(), set.end());
+    }
+}
+
+TEST(FlatSetTest, EmptySet) {
+    FlatSet<int> set;
+    EXPECT_TRUE(set.isEmpty());
+    EXPECT_EQ(set.find(1), set.end());
+    EXPECT_FALSE(set.contains(1));
+    EXPECT_FALSE(set.erase(1));
+    EXPECT_EQ(set.begin(), set.end());
+}
+
+TEST(FlatSetTest, BulkBuildDropsDuplicates) {
+    std::vector<int> input = { 5, 3, 9, 3, 1, 5, 7 };
+    FlatSet<int> set(input.begin(), input.end());
+    EXPECT_EQ(KeysOf(set), (std::vector<int>{ 1, 3, 5, 7, 9 }));
+}
+
+TEST(FlatSetTest, InsertKeepsOrder) {
+    FlatSet<int> set = { 10, 30 };
+    auto [it, bInserted] = set.insert(20);
+    EXPECT_TRUE(bInserted);
+    EXPECT_EQ(*it, 20);
+    EXPECT_EQ(it.index(), 1);
+
+    EXPECT_FALSE(set.insert(20).second);
+    EXPECT_EQ(KeysOf(set), (std::vector<int>{ 10, 20, 30 }));
+}
+
+TEST(FlatSetTest, InsertRangeMerges) {
+    FlatSet<int> set = { 2, 4, 6 };
+    std::vector<int> batch = { 7, 1, 4, 3, 1 };
+    set.insertRange(batch.begin(), batch.end());
+
+    EXPECT_EQ(KeysOf(set), (std::vector<int>{ 1, 2, 3, 4, 6, 7 }));
+}
+
+TEST(FlatSetTest, ThrowingMoveLeavesKeysSorted) {
+    // Throw at every move in turn: the set may be cleared, but never left out of order.
+    for (int movesBeforeThrow = 0;; ++movesBeforeThrow) {
+        // Room up front, so only the inserts and erases themselves move keys.
+        FlatSet<ThrowingKey> set;
+        set.reserve(16);
+        for (int key : { 1, 3, 5, 7 }) {
+            set.insert(ThrowingKey(key));
+        }
+
+        ThrowingKey batch[] = { 6, 0, 4 };
+
+        bool bThrew = false;
+        ThrowingKey::movesBeforeThrow = movesBeforeThrow;
+        try {
+            set.insert(ThrowingKey(2));
+            set.insertRange(std::make_move_iterator(std::begin(batch)), std::make_move_iterator(std::end(batch)));
+            set.erase(ThrowingKey(3));
+        }
+        catch (const std::runtime_error&) {
+            bThrew = true;
+        }
+        ThrowingKey::movesBeforeThrow = -1;
+
+        EXPECT_TRUE(std::adjacent_find(set.begin(), set.end(), [](const ThrowingKey& a, const ThrowingKey& b) { return !(a < b); }) == set.end());
+
+        if (!bThrew) {
+            EXPECT_EQ(set.size(), 7);
+            break;
+        }
+    }
+}
+
+TEST(FlatSetTest, EraseAndLowerBound) {
+    FlatSet<int> set = { 1, 2, 3, 4 };
+    EXPECT_TRUE(set.erase(3));
+    EXPECT_FALSE(set.erase(3));
+    EXPECT_EQ(*set.lowerBound(3), 4);
+    EXPECT_EQ(set.lowerBound(5), set.end());
+    EXPECT_EQ(KeysOf(set), (std::vector<int>{ 1, 2, 4 }));
+}
+
+TEST(FlatSetTest, HeterogeneousLookup) {
+    FlatSet<std::string, std::less<>> set = { "pear", "apple" };
+    EXPECT_TRUE(set.contains(std::string_view("pear")));
+    EXPECT_EQ(*set.find(std::string_view("apple")), "apple");
+    EXPECT_TRUE(set.erase(std::string_view("pear")));
+    EXPECT_EQ(set.size(), 1);
+}
+
+TEST(FlatSetTest, MatchesStdSet) {
+    std::mt19937 random(9);
+    FlatSet<int> set;
+    std::set<int> reference;
+
+    for (int round = 0; round < 300; ++round) {
+        int key = random() % 300;
+        switch (random() % 3) {
+        case 0:
+            EXPECT_EQ(set.insert(key).second, reference.insert(key).second);
+            break;
+        case 1:
+            EXPECT_EQ(set.erase(key), reference.erase(key) == 1);
+            break;
+        default: {
+            std::vector<int> batch = { key, key + 1, key - 7, key };
+            set.insertRange(batch.begin(), batch.end());
+            reference.insert(batch.begin(), batch.end());
+            break;
+        }
+        }
+    }
+
+    EXPECT_EQ(KeysOf(set), std::vector<int>(reference.begin(), reference.end()));
+}
+
+TEST(FlatSetTest, BuildFromVector) {
+    Vector<int> keys{ 3, 1, 2, 1 };
+    FlatSet<int> set(keys.begin(), keys.end());
+    EXPECT_EQ(KeysOf(set), (std::vector<int>{ 1, 2, 3 }));
+
+    // A set's own keys feed straight back in.
+    FlatSet<int> copy;
+    copy.insertRange(set.keys().begin(), set.keys().end());
+    EXPECT_EQ(KeysOf(copy), KeysOf(set));
+}
@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "../Algorithms/LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Histogram = LatencyHistogram<>;
+
+    uint64 ExactPercentile(std::vector<uint64> values, double percentile) {
+        std::sort(values.begin(), values.end());
+        size_t rank = static_cast<size_t>(std::llround(percentile / 100.0 * static_cast<double>(values.size())));
+        return values[std::max<size_t>(rank, 1) - 1];
+    }
+}
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    Histogram histogram;
+    EXPECT_TRUE(histogram.isEmpty());
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.min(), 0);
+    EXPECT_EQ(histogram.max(), 0);
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 0);
+    EXPECT_EQ(histogram.mean(), 0.0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    Histogram histogram;
+    for (uint64 value = 1; value <= 100; ++value) {
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.min(), 1);
+    EXPECT_EQ(histogram.max(), 100);
+    EXPECT_EQ(histogram.valueAtPercentile(0.0), 1);
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 50);
+    EXPECT_EQ(histogram.valueAtPercentile(99.0), 99);
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), 100);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 50.5);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverTheRangeWithoutGaps) {
+    EXPECT_EQ(Histogram::bucketLowest(0), 0);
+    for (size_t i = 0; i + 1 < Histogram::BucketCount; ++i) {
+        ASSERT_EQ(Histogram::bucketHighest(i) + 1, Histogram::bucketLowest(i + 1)) << "bucket " << i;
+    }
+    EXPECT_EQ(Histogram::bucketHighest(Histogram::BucketCount - 1), std::numeric_limits<uint64>::max());
+    EXPECT_EQ(Histogram::bucketOf(std::numeric_limits<uint64>::max()), Histogram::BucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, BucketWidthStaysWithinPrecision) {
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 100000; ++i) {
+        uint64 value = random() >> (random() % 64);
+        size_t bucket = Histogram::bucketOf(value);
+
+        ASSERT_LE(Histogram::bucketLowest(bucket), value);
+        ASSERT_GE(Histogram::bucketHighest(bucket), value);
+        ASSERT_LE(Histogram::bucketHighest(bucket) - Histogram::bucketLowest(bucket), value / Histogram::SubBucketCount);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinPrecision) {
+    std::mt19937_64 random(11);
+    std::lognormal_distribution<double> latency(6.0, 1.5);
+
+    Histogram histogram;
+    std::vector<uint64> values;
+    for (int i = 0; i < 200000; ++i) {
+        uint64 value = static_cast<uint64>(latency(random));
+        values.push_back(value);
+        histogram.record(value);
+    }
+
+    for (double percentile : { 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 }) {
+        uint64 exact = ExactPercentile(values, percentile);
+        uint64 estimate = histogram.valueAtPercentile(percentile);
+        EXPECT_GE(estimate, exact) << percentile;
+        EXPECT_LE(estimate - exact, exact / Histogram::SubBucketCount) << percentile;
+    }
+    EXPECT_EQ(histogram.max(), *std::max_element(values.begin(), values.end()));
+}
+
+TEST(LatencyHistogramTest, SpikeOnlyShowsInTheTail) {
+    Histogram histogram;
+    histogram.recordN(50, 999);
+    histogram.record(4000000);
+
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 50);
+    EXPECT_EQ(histogram.valueAtPercentile(99.9), 50);
+    EXPECT_EQ(histogram.valueAtPercentile(100.0), 4000000);
+    EXPECT_EQ(histogram.max(), 4000000);
+}
+
+TEST(LatencyHistogramTest, MergeEqualsRecordingEverything) {
+    std::mt19937_64 random(3);
+    Histogram all;
+    Histogram low;
+    Histogram high;
+
+    for (int i = 0; i < 50000; ++i) {
+        uint64 value = random() % 1000000;
+        all.record(value);
+        (i % 2 == 0 ? low : high).record(value);
+    }
+    low.merge(high);
+
+    EXPECT_EQ(low.count(), all.count());
+    EXPECT_EQ(low.min(), all.min());
+    EXPECT_EQ(low.max(), all.max());
+    for (double percentile : { 1.0, 50.0, 99.0, 99.9 }) {
+        EXPECT_EQ(low.valueAtPercentile(percentile), all.valueAtPercentile(percentile));
+    }
+}
+
+TEST(LatencyHistogramTest, MergeEmptyChangesNothing) {
+    Histogram histogram;
+    histogram.record(10);
+    histogram.merge(Histogram());
+
+    EXPECT_EQ(histogram.count(), 1);
+    EXPECT_EQ(histogram.min(), 10);
+    EXPECT_EQ(histogram.max(), 10);
+}
+
+TEST(LatencyHistogramTest, PerThreadHistogramsMerge) {
+    constexpr int ThreadCount = 4;
+    constexpr uint64 PerThread = 10000;
+
+    std::vector<Histogram> perThread(ThreadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.emplace_back([&perThread, t] {
+            for (uint64 i = 0; i < PerThread; ++i) {
+                perThread[t].record(t * PerThread + i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Histogram total;
+    for (const auto& histogram : perThread) {
+        total.merge(histogram);
+    }
+
+    EXPECT_EQ(total.count(), ThreadCount * PerThread);
+    EXPECT_EQ(total.min(), 0);
+    EXPECT_EQ(total.max(), ThreadCount * PerThread - 1);
+}
+
+TEST(LatencyHistogramTest, ResetClears) {
+    Histogram histogram;
+    histogram.record(5);
+    histogram.record(500000);
+    histogram.reset();
+
+    EXPECT_TRUE(histogram.isEmpty());
+    EXPECT_EQ(histogram.max(), 0);
+    EXPECT_EQ(histogram.valueAtPercentile(99.0), 0);
+
+    histogram.record(7);
+    EXPECT_EQ(histogram.min(), 7);
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 7);
+}
+
+TEST(LatencyHistogramTest, CoarserPrecision) {
+    LatencyHistogram<2> histogram;
+    histogram.record(1000);
+
+    // Four sub-buckets per power of two: 1000 falls into [896, 1023].
+    EXPECT_EQ(LatencyHistogram<2>::bucketLowest(LatencyHistogram<2>::bucketOf(1000)), 896);
+    EXPECT_EQ(histogram.valueAtPercentile(50.0), 1000);
+}
@@ -2,6 +2,9 @@
 #include "../Algorithms/SingleLinkedList.h"
 #include <vector>
 #include <numeric> // For std::iota
+#include <algorithm>
+#include <iterator>
+#include <ranges>
 
 TEST(SingleLinkedListTest, DefaultConstructor) {
     SingleLinkedList<int> list;
@@ -437,4 +440,26 @@ TEST(SingleLinkedListTest, LargeNumberOfElements) {
     list.clear();
     ASSERT_TRUE(list.isEmpty());
     ASSERT_EQ(list.size(), 0);
-}
\ No newline at end of file
+}
+
+static_assert(std::forward_iterator<SingleLinkedList<int>::Iterator>);
+static_assert(std::forward_iterator<SingleLinkedList<int>::ConstIterator>);
+static_assert(std::ranges::forward_range<const SingleLinkedList<int>>);
+
+TEST(SingleLinkedListTest, StandardAlgorithms) {
+    SingleLinkedList<int> list{ 3, 1, 2 };
+    ASSERT_EQ(*std::ranges::min_element(list), 1);
+    ASSERT_EQ(std::ranges::count_if(list, [](int v) { return v > 1; }), 2);
+
+    std::vector<int> result;
+    std::ranges::copy(list, std::back_inserter(result));
+    ASSERT_EQ(result, (std::vector<int>{ 3, 1, 2 }));
+}
+
+TEST(SingleLinkedListTest, PushBackRange) {
+    std::vector<int> values{ 2, 3 };
+    SingleLinkedList<int> list{ 1 };
+    list.pushBackRange(values.begin(), values.end());
+    EXPECT_EQ(std::vector<int>(list.begin(), list.end()), (std::vector<int>{ 1, 2, 3 }));
+    EXPECT_EQ(list.size(), 3);
+}
@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "../Algorithms/MpmcQueue.h"
+#include <atomic>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MpmcQueueTest, CapacityIsRoundedUpToPowerOfTwo) {
+    EXPECT_EQ(MpmcQueue<int>(5).capacity(), 8);
+    EXPECT_EQ(MpmcQueue<int>(1).capacity(), 2);
+}
+
+TEST(MpmcQueueTest, PushFailsWhenFullAndPopFailsWhenEmpty) {
+    MpmcQueue<int> queue(4);
+    int out = -1;
+    EXPECT_FALSE(queue.tryPop(out));
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.sizeApprox(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPop(out));
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_FALSE(queue.tryPop(out));
+}
+
+TEST(MpmcQueueTest, SlotsAreReusedAcrossLaps) {
+    MpmcQueue<std::string> queue(2);
+    std::string out;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue.tryEmplace(3, static_cast<char>('a' + i)));
+        EXPECT_TRUE(queue.tryPop(out));
+        EXPECT_EQ(out, std::string(3, static_cast<char>('a' + i)));
+    }
+}
+
+TEST(MpmcQueueTest, BatchPushAndPop) {
+    MpmcQueue<int> queue(8);
+    std::vector<int> input{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    EXPECT_EQ(queue.tryPushN(input.begin(), input.size()), 8);
+    EXPECT_EQ(queue.tryPushN(input.begin() + 8, 2), 0);
+
+    std::vector<int> output;
+    EXPECT_EQ(queue.tryPopN(std::back_inserter(output), 3), 3);
+    EXPECT_EQ(output, (std::vector<int>{ 1, 2, 3 }));
+
+    // The free slots wrap around the end of the buffer.
+    EXPECT_EQ(queue.tryPushN(input.begin() + 8, 2), 2);
+    EXPECT_EQ(queue.tryPopN(std::back_inserter(output), 100), 7);
+    EXPECT_EQ(output, (std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+}
+
+TEST(MpmcQueueTest, ThrowingCopyDoesNotWedgeTheQueue) {
+    struct Thrower {
+        int value{ 0 };
+        bool bThrowOnCopy{ false };
+
+        Thrower() = default;
+        Thrower(int value, bool bThrowOnCopy) : value(value), bThrowOnCopy(bThrowOnCopy) {}
+        Thrower(const Thrower& other) : value(other.value), bThrowOnCopy(false) {
+            if (other.bThrowOnCopy) {
+                throw std::runtime_error("copy");
+            }
+        }
+        Thrower(Thrower&&) noexcept = default;
+        Thrower& operator=(const Thrower&) = default;
+        Thrower& operator=(Thrower&&) noexcept = default;
+    };
+
+    MpmcQueue<Thrower> queue(4);
+    const Thrower bad(1, true);
+    EXPECT_THROW(queue.tryPush(bad), std::runtime_error);
+
+    std::vector<Thrower> batch;
+    batch.emplace_back(2, false);
+    batch.emplace_back(3, true);
+    batch.emplace_back(4, false);
+    EXPECT_THROW(queue.tryPushN(batch.begin(), batch.size()), std::runtime_error);
+
+    EXPECT_TRUE(queue.tryPush(Thrower(5, false)));
+
+    Thrower out;
+    EXPECT_TRUE(queue.tryPop(out));
+    EXPECT_EQ(out.value, 2);
+    EXPECT_TRUE(queue.tryPop(out));
+    EXPECT_EQ(out.value, 5);
+    EXPECT_FALSE(queue.tryPop(out));
+}
+
+TEST(MpmcQueueTest, ThrowingOutputDoesNotWedgeTheQueue) {
+    // Writes to `output` until it has `room` elements, then throws.
+    struct ThrowingInserter {
+        std::vector<int>* output;
+        size_t room;
+
+        ThrowingInserter& operator*() { return *this; }
+        ThrowingInserter& operator++() { return *this; }
+        ThrowingInserter operator++(int) { return *this; }
+        ThrowingInserter& operator=(int value) {
+            if (output->size() == room) {
+                throw std::runtime_error("full");
+            }
+            output->push_back(value);
+            return *this;
+        }
+    };
+
+    MpmcQueue<int> queue(4);
+    std::vector<int> input{ 1, 2, 3, 4 };
+    EXPECT_EQ(queue.tryPushN(input.begin(), input.size()), 4);
+
+    std::vector<int> output;
+    EXPECT_THROW(queue.tryPopN(ThrowingInserter{ &output, 1 }, 4), std::runtime_error);
+    EXPECT_EQ(output, (std::vector<int>{ 1 }));
+
+    // All four slots are free again for the next lap.
+    EXPECT_EQ(queue.tryPushN(input.begin(), input.size()), 4);
+    output.clear();
+    EXPECT_EQ(queue.tryPopN(std::back_inserter(output), 4), 4);
+    EXPECT_EQ(output, input);
+}
+
+TEST(MpmcQueueTest, DestroysRemainingElements) {
+    auto tracked = std::make_shared<int>(0);
+    {
+        MpmcQueue<std::shared_ptr<int>> queue(4);
+        queue.tryPush(tracked);
+        queue.tryPush(tracked);
+        EXPECT_EQ(tracked.use_count(), 3);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(MpmcQueueTest, ManyProducersManyConsumers) {
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr int perProducer = 20000;
+
+    MpmcQueue<int> queue(64);
+    std::atomic<long long> sum{ 0 };
+    std::atomic<int> received{ 0 };
+    std::atomic<bool> inOrder{ true };
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                // Producer id in the high bits, sequence number in the low ones.
+                int val = p * perProducer + i;
+                while (!queue.tryPush(val)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::vector<int> last(producers, -1);
+            int batch[8];
+            while (received.load() < producers * perProducer) {
+                size_t n = (c % 2 == 0) ? queue.tryPopN(batch, 8) : (queue.tryPop(batch[0]) ? 1 : 0);
+                for (size_t i = 0; i < n; ++i) {
+                    int producer = batch[i] / perProducer;
+                    int sequence = batch[i] % perProducer;
+                    if (sequence <= last[producer]) {
+                        inOrder = false;
+                    }
+                    last[producer] = sequence;
+                    sum += batch[i];
+                }
+                received += static_cast<int>(n);
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    long long total = producers * perProducer;
+    EXPECT_EQ(received.load(), total);
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+    EXPECT_TRUE(inOrder.load());
+}
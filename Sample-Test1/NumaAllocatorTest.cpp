@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "../Algorithms/NumaAllocator.h"
+#include "../Algorithms/ThreadPool.h"
+#include "../Algorithms/Vector.h"
+#include <cstdint>
+
+TEST(NumaAllocatorTest, LargeAllocationsArePageAligned) {
+    for (NumaPolicy policy : { NumaPolicy::FirstTouch, NumaPolicy::Interleave, NumaPolicy::Bind }) {
+        NumaAllocator<std::int64_t> allocator(policy);
+        const size_t n = NumaAllocator<std::int64_t>::LargeSize;
+
+        std::int64_t* p = allocator.allocate(n);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 4096, 0);
+        for (size_t i = 0; i < n; ++i) {
+            p[i] = static_cast<std::int64_t>(i);
+        }
+        EXPECT_EQ(p[n - 1], static_cast<std::int64_t>(n - 1));
+        allocator.deallocate(p, n);
+    }
+}
+
+TEST(NumaAllocatorTest, SmallAllocationsGoToTheHeap) {
+    NumaAllocator<int> allocator(NumaPolicy::Interleave);
+    int* p = allocator.allocate(4);
+    p[3] = 3;
+    allocator.deallocate(p, 4);
+
+    EXPECT_GE(numaNodeCount(), 1);
+}
+
+TEST(NumaAllocatorTest, BacksAGrowingVector) {
+    Vector<int, NumaAllocator<int>> vec{ NumaAllocator<int>(NumaPolicy::Interleave) };
+    for (int i = 0; i < 100000; ++i) {
+        vec.pushBack(i);
+    }
+    EXPECT_EQ(vec[99999], 99999);
+    EXPECT_EQ(vec.getAllocator().policy(), NumaPolicy::Interleave);
+}
+
+TEST(NumaAllocatorTest, FirstTouchLeavesElementsAlone) {
+    ThreadPool pool(2);
+
+    Vector<int, NumaAllocator<int>> vec;
+    vec.reserve(200000);
+    for (int i = 0; i < 1000; ++i) {
+        vec.pushBack(i);
+    }
+
+    numaFirstTouch(vec, pool);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(vec[i], i);
+    }
+
+    for (int i = 1000; i < 200000; ++i) {
+        vec.pushBack(i);
+    }
+    EXPECT_EQ(vec[199999], 199999);
+
+    // Nothing left to touch.
+    numaFirstTouch(vec, pool);
+    Vector<int, NumaAllocator<int>> empty;
+    numaFirstTouch(empty, pool);
+}
@@ -0,0 +1,245 @@
+#include "pch.h"
+#include "../Algorithms/IndexedPriorityQueue.h"
+#include "../Algorithms/PriorityQueue.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    template <typename Queue>
+    std::vector<int> Drain(Queue& queue) {
+        std::vector<int> result;
+        while (!queue.isEmpty()) {
+            result.push_back(queue.top());
+            queue.pop();
+        }
+        return result;
+    }
+
+    std::vector<int> RandomValues(size_t count, unsigned seed) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> distribution(0, 1000);
+        std::vector<int> values(count);
+        for (auto& value : values) {
+            value = distribution(random);
+        }
+        return values;
+    }
+}
+
+TEST(PriorityQueueTest, TopIsGreatestByDefault) {
+    PriorityQueue<int> queue;
+    EXPECT_TRUE(queue.isEmpty());
+
+    for (int value : { 3, 1, 4, 1, 5, 9, 2, 6 }) {
+        queue.push(value);
+    }
+    EXPECT_EQ(queue.size(), 8);
+    EXPECT_EQ(queue.top(), 9);
+    EXPECT_EQ(Drain(queue), (std::vector<int>{ 9, 6, 5, 4, 3, 2, 1, 1 }));
+}
+
+TEST(PriorityQueueTest, GreaterGivesMinHeap) {
+    PriorityQueue<int, std::greater<int>> queue{ 5, 3, 8 };
+    EXPECT_EQ(queue.top(), 3);
+    EXPECT_EQ(queue.extractTop(), 3);
+    EXPECT_EQ(queue.top(), 5);
+}
+
+TEST(PriorityQueueTest, PopOnEmpty) {
+    PriorityQueue<int> queue;
+    EXPECT_DEATH(queue.pop(), "isEmpty");
+    EXPECT_DEATH((void)queue.top(), "isEmpty");
+}
+
+TEST(PriorityQueueTest, MatchesSortForEveryArity) {
+    const std::vector<int> values = RandomValues(1000, 7);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+    PriorityQueue<int, std::less<int>, 2> binary;
+    PriorityQueue<int, std::less<int>, 4> quaternary;
+    PriorityQueue<int, std::less<int>, 8> octonary;
+    for (int value : values) {
+        binary.push(value);
+        quaternary.push(value);
+        octonary.push(value);
+    }
+
+    EXPECT_EQ(Drain(binary), expected);
+    EXPECT_EQ(Drain(quaternary), expected);
+    EXPECT_EQ(Drain(octonary), expected);
+}
+
+TEST(PriorityQueueTest, PushRangeHeapifiesOrSiftsUp) {
+    const std::vector<int> values = RandomValues(500, 11);
+    std::vector<int> expected = values;
+    expected.insert(expected.end(), values.begin(), values.begin() + 10);
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+    // The first range is all new elements (heapify), the second one is small (sift up).
+    PriorityQueue<int> queue(values.begin(), values.end());
+    queue.pushRange(values.begin(), values.begin() + 10);
+    EXPECT_EQ(queue.size(), 510);
+    EXPECT_EQ(Drain(queue), expected);
+}
+
+TEST(PriorityQueueTest, MoveOnlyAndEmplace) {
+    PriorityQueue<std::string> queue;
+    queue.emplace(3, 'b');
+    queue.emplace("a");
+    queue.push(std::string("c"));
+    EXPECT_EQ(queue.extractTop(), "c");
+    EXPECT_EQ(queue.extractTop(), "bbb");
+
+    queue.clear();
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(PriorityQueueTest, PushOwnTopWhileGrowing) {
+    // top() lives in the heap's Vector, which these pushes regrow.
+    PriorityQueue<std::string> queue{ "top, and too long for the small-string buffer" };
+    for (int i = 0; i < 20; ++i) {
+        queue.push(queue.top());
+    }
+    EXPECT_EQ(queue.size(), 21);
+    EXPECT_EQ(queue.top(), "top, and too long for the small-string buffer");
+}
+
+TEST(IndexedPriorityQueueTest, HandlesFollowTheirElements) {
+    IndexedPriorityQueue<int, std::greater<int>> queue;
+    auto five = queue.push(5);
+    auto three = queue.push(3);
+    auto eight = queue.push(8);
+
+    EXPECT_EQ(queue.top(), 3);
+    EXPECT_EQ(queue.topHandle(), three);
+    EXPECT_EQ(queue.value(five), 5);
+    EXPECT_EQ(queue.value(eight), 8);
+
+    queue.decreaseKey(eight, 1);
+    EXPECT_EQ(queue.topHandle(), eight);
+    EXPECT_EQ(queue.value(eight), 1);
+
+    queue.pop();
+    EXPECT_FALSE(queue.contains(eight));
+    EXPECT_TRUE(queue.contains(five));
+    EXPECT_EQ(queue.top(), 3);
+}
+
+TEST(IndexedPriorityQueueTest, UpdateMovesBothWays) {
+    IndexedPriorityQueue<int> queue;
+    auto a = queue.push(10);
+    auto b = queue.push(20);
+    queue.push(15);
+
+    queue.update(b, 0);
+    EXPECT_EQ(queue.top(), 15);
+
+    queue.update(a, 100);
+    EXPECT_EQ(queue.topHandle(), a);
+}
+
+TEST(IndexedPriorityQueueTest, EraseFromMiddle) {
+    IndexedPriorityQueue<int, std::greater<int>> queue;
+    std::vector<IndexedPriorityQueue<int, std::greater<int>>::Handle> handles;
+    for (int i = 0; i < 20; ++i) {
+        handles.push_back(queue.push(i));
+    }
+
+    for (int i = 1; i < 20; i += 2) {
+        queue.erase(handles[i]);
+    }
+    EXPECT_EQ(queue.size(), 10);
+    EXPECT_EQ(Drain(queue), (std::vector<int>{ 0, 2, 4, 6, 8, 10, 12, 14, 16, 18 }));
+}
+
+TEST(IndexedPriorityQueueTest, HandlesAreRecycled) {
+    IndexedPriorityQueue<int> queue;
+    auto first = queue.push(1);
+    queue.erase(first);
+    EXPECT_FALSE(queue.contains(first));
+    EXPECT_FALSE(queue.contains(IndexedPriorityQueue<int>::InvalidHandle));
+
+    auto second = queue.push(2);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(queue.value(second), 2);
+}
+
+TEST(IndexedPriorityQueueTest, ThrowingPushLeavesHandleFree) {
+    struct Thrower {
+        int value;
+        bool bThrowOnCopy;
+
+        Thrower(int value, bool bThrowOnCopy) : value(value), bThrowOnCopy(bThrowOnCopy) {}
+        Thrower(const Thrower& other) : value(other.value), bThrowOnCopy(false) {
+            if (other.bThrowOnCopy) {
+                throw std::runtime_error("copy");
+            }
+        }
+        Thrower(Thrower&&) = default;
+        Thrower& operator=(const Thrower&) = default;
+        Thrower& operator=(Thrower&&) = default;
+        bool operator<(const Thrower& other) const { return value < other.value; }
+    };
+
+    IndexedPriorityQueue<Thrower> queue;
+    const Thrower bad(1, true);
+    EXPECT_THROW(queue.push(bad), std::runtime_error);
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_FALSE(queue.contains(0));
+
+    const auto handle = queue.push(Thrower(2, false));
+    EXPECT_EQ(handle, 0u);
+    EXPECT_TRUE(queue.contains(handle));
+    EXPECT_EQ(queue.top().value, 2);
+
+    // A recycled handle must go back on the free list too.
+    const auto second = queue.push(Thrower(3, false));
+    queue.erase(second);
+    EXPECT_THROW(queue.push(bad), std::runtime_error);
+    EXPECT_EQ(queue.size(), 1u);
+
+    const auto reused = queue.push(Thrower(4, false));
+    EXPECT_EQ(reused, second);
+    EXPECT_EQ(queue.value(reused).value, 4);
+}
+
+TEST(IndexedPriorityQueueTest, RandomOperationsMatchSortedVector) {
+    std::mt19937 random(3);
+    IndexedPriorityQueue<int, std::greater<int>, 4> queue;
+    std::vector<std::pair<IndexedPriorityQueue<int, std::greater<int>, 4>::Handle, int>> live;
+
+    for (int step = 0; step < 5000; ++step) {
+        const int action = static_cast<int>(random() % 4);
+        if (action == 0 || live.empty()) {
+            int value = static_cast<int>(random() % 1000);
+            live.emplace_back(queue.push(value), value);
+        } else if (action == 1) {
+            size_t i = random() % live.size();
+            int value = static_cast<int>(random() % 1000);
+            queue.update(live[i].first, value);
+            live[i].second = value;
+        } else if (action == 2) {
+            size_t i = random() % live.size();
+            queue.erase(live[i].first);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            auto smallest = std::min_element(live.begin(), live.end(),
+                [](const auto& left, const auto& right) { return left.second < right.second; });
+            ASSERT_EQ(queue.top(), smallest->second);
+        }
+        ASSERT_EQ(queue.size(), live.size());
+    }
+
+    std::vector<int> expected;
+    for (const auto& [handle, value] : live) {
+        ASSERT_EQ(queue.value(handle), value);
+        expected.push_back(value);
+    }
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(Drain(queue), expected);
+}
@@ -1,5 +1,11 @@
 #include "pch.h"
 #include "../Algorithms/Queue.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Vector.h"
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
 
 // Simple fixture for reuse
 class QueueTest : public ::testing::Test {
@@ -74,3 +80,72 @@ TEST_F(QueueTest, ChainedOperations) {
     EXPECT_EQ(q.front(), 20);
     EXPECT_EQ(q.size(), 2);
 }
+
+TEST_F(QueueTest, WrapsAroundContiguousStorage) {
+    for (int i = 0; i < 100; ++i) {
+        q.push(i);
+        q.push(i);
+        q.pop();
+    }
+    EXPECT_EQ(q.size(), 100);
+    EXPECT_EQ(q.front(), 50);
+}
+
+TEST(QueueStringTest, PushOwnFrontWhenFull) {
+    // The default RingBuffer grows on these pushes and frees the block front() points into.
+    Queue<std::string> queue{ "front, and too long for the small-string buffer" };
+    for (int i = 0; i < 20; ++i) {
+        queue.push(queue.front());
+    }
+    EXPECT_EQ(queue.size(), 21);
+    while (!queue.isEmpty()) {
+        EXPECT_EQ(queue.front(), "front, and too long for the small-string buffer");
+        queue.pop();
+    }
+}
+
+TEST(QueueLinkedListTest, LinkedListBackend) {
+    Queue<int, SingleLinkedList> q;
+    q.push(1);
+    q.push(2);
+    q.pop();
+    EXPECT_EQ(q.front(), 2);
+    EXPECT_EQ(q.size(), 1);
+    q.clear();
+    EXPECT_TRUE(q.isEmpty());
+}
+
+TEST(QueueRangeTest, InitializerListKeepsOrder) {
+    Queue<int> queue{ 1, 2, 3 };
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.front(), 1);
+}
+
+TEST(QueueRangeTest, RangeConstructorAndPushRange) {
+    std::vector<std::string> words{ "a", "b", "c" };
+    Queue<std::string> queue(words.begin(), words.end());
+    queue.pushRange(words.begin(), words.begin() + 2);
+    EXPECT_EQ(queue.size(), 5);
+
+    std::string order;
+    while (!queue.isEmpty()) {
+        order += queue.front();
+        queue.pop();
+    }
+    EXPECT_EQ(order, "abcab");
+}
+
+TEST(QueueRangeTest, InputIteratorRange) {
+    std::istringstream input("4 5 6");
+    Queue<int, SingleLinkedList> queue(std::istream_iterator<int>(input), std::istream_iterator<int>{});
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.front(), 4);
+}
+
+TEST(QueueRangeTest, RangeConstructorFromVector) {
+    Vector<int> values{ 1, 2, 3 };
+    Queue<int> queue(values.begin(), values.end());
+    queue.pushRange(values.begin(), values.end());
+    EXPECT_EQ(queue.size(), 6);
+    EXPECT_EQ(queue.front(), 1);
+}
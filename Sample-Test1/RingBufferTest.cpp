@@ -0,0 +1,193 @@
+#include "pch.h"
+#include "../Algorithms/RingBuffer.h"
+#include <string>
+#include <vector>
+
+template <typename T>
+std::vector<T> ToVector(const RingBuffer<T>& buffer) {
+    return std::vector<T>(buffer.begin(), buffer.end());
+}
+
+TEST(RingBufferTest, DefaultConstructor) {
+    RingBuffer<int> buffer;
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_EQ(buffer.size(), 0);
+    EXPECT_EQ(buffer.capacity(), 0);
+}
+
+TEST(RingBufferTest, InitializerListConstructor) {
+    RingBuffer<int> buffer{ 1, 2, 3 };
+    EXPECT_EQ(buffer.size(), 3);
+    EXPECT_EQ(buffer.front(), 1);
+    EXPECT_EQ(buffer.back(), 3);
+    EXPECT_EQ(ToVector(buffer), (std::vector<int>{ 1, 2, 3 }));
+}
+
+TEST(RingBufferTest, CapacityIsPowerOfTwo) {
+    RingBuffer<int> buffer;
+    buffer.reserve(100);
+    EXPECT_EQ(buffer.capacity(), 128);
+
+    for (int i = 0; i < 129; ++i) {
+        buffer.pushBack(i);
+    }
+    EXPECT_EQ(buffer.capacity(), 256);
+}
+
+TEST(RingBufferTest, FifoOrder) {
+    RingBuffer<int> buffer;
+    for (int i = 0; i < 5; ++i) {
+        buffer.pushBack(i);
+    }
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(buffer.front(), i);
+        buffer.popFront();
+    }
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(RingBufferTest, WrapsAroundWithoutGrowing) {
+    RingBuffer<int> buffer;
+    buffer.reserve(8);
+    for (int i = 0; i < 6; ++i) {
+        buffer.pushBack(i);
+    }
+
+    for (int i = 6; i < 100; ++i) {
+        buffer.popFront();
+        buffer.pushBack(i);
+    }
+
+    EXPECT_EQ(buffer.capacity(), 8);
+    EXPECT_EQ(ToVector(buffer), (std::vector<int>{ 94, 95, 96, 97, 98, 99 }));
+}
+
+TEST(RingBufferTest, GrowsWhileWrapped) {
+    RingBuffer<std::string> buffer;
+    buffer.reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        buffer.pushBack(std::to_string(i));
+    }
+    buffer.popFront();
+    buffer.popFront();
+    buffer.pushBack("8");
+    buffer.pushBack("9");
+
+    // Full and wrapped: the next push relocates.
+    buffer.pushBack("10");
+    EXPECT_EQ(buffer.capacity(), 16);
+    EXPECT_EQ(buffer.size(), 9);
+
+    std::vector<std::string> expected;
+    for (int i = 2; i <= 10; ++i) {
+        expected.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(ToVector(buffer), expected);
+}
+
+TEST(RingBufferTest, BothEnds) {
+    RingBuffer<int> buffer;
+    buffer.pushBack(2);
+    buffer.pushFront(1);
+    buffer.pushBack(3);
+    buffer.pushFront(0);
+    EXPECT_EQ(ToVector(buffer), (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_EQ(buffer[2], 2);
+
+    buffer.popBack();
+    buffer.popFront();
+    EXPECT_EQ(buffer.front(), 1);
+    EXPECT_EQ(buffer.back(), 2);
+}
+
+TEST(RingBufferTest, PopOnEmpty) {
+    RingBuffer<int> buffer;
+    EXPECT_DEATH(buffer.popFront(), ".*");
+    EXPECT_DEATH(buffer.popBack(), ".*");
+}
+
+TEST(RingBufferTest, ClearKeepsStorage) {
+    RingBuffer<std::string> buffer{ "a", "b" };
+    size_t capacity = buffer.capacity();
+    buffer.clear();
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_EQ(buffer.capacity(), capacity);
+
+    buffer.pushBack("c");
+    EXPECT_EQ(buffer.front(), "c");
+}
+
+TEST(RingBufferTest, CopyIsDeepAndUnwrapped) {
+    RingBuffer<int> original;
+    for (int i = 0; i < 8; ++i) {
+        original.pushBack(i);
+    }
+    original.popFront();
+    original.pushBack(8);
+
+    RingBuffer<int> copy = original;
+    original.front() = 100;
+
+    EXPECT_EQ(copy.front(), 1);
+    EXPECT_EQ(ToVector(copy), (std::vector<int>{ 1, 2, 3, 4, 5, 6, 7, 8 }));
+
+    copy = copy;
+    EXPECT_EQ(copy.size(), 8);
+}
+
+TEST(RingBufferTest, Move) {
+    RingBuffer<int> original{ 1, 2 };
+    RingBuffer<int> moved = std::move(original);
+    EXPECT_TRUE(original.isEmpty());
+    EXPECT_EQ(original.capacity(), 0);
+    EXPECT_EQ(moved.size(), 2);
+
+    RingBuffer<int> assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.back(), 2);
+}
+
+TEST(RingBufferTest, MoveOnlyType) {
+    RingBuffer<std::unique_ptr<int>> buffer;
+    for (int i = 0; i < 20; ++i) {
+        buffer.pushBack(std::make_unique<int>(i));
+    }
+    buffer.popFront();
+    EXPECT_EQ(*buffer.front(), 1);
+    EXPECT_EQ(*buffer.back(), 19);
+}
+
+TEST(RingBufferTest, PushBackRangeWhileWrapped) {
+    RingBuffer<int> buffer;
+    buffer.reserve(8);
+    for (int i = 0; i < 6; ++i) {
+        buffer.pushBack(i);
+    }
+    for (int i = 0; i < 4; ++i) {
+        buffer.popFront();
+    }
+
+    std::vector<int> more{ 6, 7, 8, 9, 10, 11, 12 };
+    buffer.pushBackRange(more.begin(), more.end());
+    EXPECT_EQ(buffer.capacity(), 16);
+    EXPECT_EQ(ToVector(buffer), (std::vector<int>{ 4, 5, 6, 7, 8, 9, 10, 11, 12 }));
+}
+
+TEST(RingBufferTest, PushOwnElementWhenFull) {
+    // Each push grows the buffer, and the argument lives in the block being freed.
+    RingBuffer<std::string> buffer;
+    buffer.reserve(8);
+    buffer.pushBack("first, and too long for the small-string buffer");
+    while (buffer.size() < buffer.capacity()) {
+        buffer.pushBack("filler");
+    }
+    buffer.pushBack(buffer.front());
+    EXPECT_EQ(buffer.back(), "first, and too long for the small-string buffer");
+
+    while (buffer.size() < buffer.capacity()) {
+        buffer.pushBack("last, and also too long for the small-string buffer");
+    }
+    buffer.pushFront(buffer.back());
+    EXPECT_EQ(buffer.front(), "last, and also too long for the small-string buffer");
+    EXPECT_EQ(buffer.size(), 17);
+}
@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "../Algorithms/CompactList.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/SlabAllocator.h"
+#include "../Algorithms/Vector.h"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SlabHeapTest, SizeClassesCoverEverySmallSize) {
+    for (size_t bytes = 1; bytes <= SlabHeap::MaxSmallSize; ++bytes) {
+        const size_t sizeClass = SlabHeap::classOf(bytes);
+        ASSERT_LT(sizeClass, SlabHeap::ClassCount) << bytes;
+        EXPECT_GE(SlabHeap::classSize(sizeClass), bytes);
+        if (sizeClass > 0) {
+            EXPECT_LT(SlabHeap::classSize(sizeClass - 1), bytes);
+        }
+    }
+}
+
+TEST(SlabHeapTest, ReusesFreedBlocksOnTheSameThread) {
+    SlabHeap& heap = SlabHeap::instance();
+
+    void* a = heap.allocate(24);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % SlabHeap::BlockAlignment, 0);
+    heap.deallocate(a, 24);
+
+    // Same class, served from the thread's list newest first.
+    void* b = heap.allocate(32);
+    EXPECT_EQ(a, b);
+    heap.deallocate(b, 32);
+}
+
+TEST(SlabAllocatorTest, BacksEveryContainer) {
+    DoubleLinkedList<std::string, SlabAllocator<std::string>> doubled;
+    SingleLinkedList<int, SlabAllocator<int>> single;
+    CompactList<int, SlabAllocator<int>> compact;
+    Vector<int, SlabAllocator<int>> vec;
+
+    for (int i = 0; i < 1000; ++i) {
+        doubled.pushBack(std::to_string(i));
+        single.pushFront(i);
+        compact.pushBack(i);
+        vec.pushBack(i);
+    }
+    EXPECT_EQ(doubled.back(), "999");
+    EXPECT_EQ(single.front(), 999);
+    EXPECT_EQ(compact.size(), 1000);
+    EXPECT_EQ(vec[999], 999);
+
+    while (!doubled.isEmpty()) {
+        doubled.popFront();
+    }
+    single.clear();
+}
+
+TEST(SlabAllocatorTest, FallsBackForLargeAndOverAlignedRequests) {
+    struct alignas(64) Wide {
+        char bytes[64];
+    };
+
+    SlabAllocator<Wide> wide;
+    Wide* w = wide.allocate(1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(w) % 64, 0);
+    wide.deallocate(w, 1);
+
+    SlabAllocator<int> ints;
+    int* many = ints.allocate(1000);
+    many[999] = 1;
+    ints.deallocate(many, 1000);
+}
+
+TEST(SlabAllocatorTest, BlocksCanBeFreedOnAnotherThread) {
+    constexpr int Rounds = 20;
+    constexpr int PerRound = 500;
+
+    SlabAllocator<int> allocator;
+
+    for (int round = 0; round < Rounds; ++round) {
+        std::vector<int*> blocks(PerRound);
+
+        std::thread producer([&] {
+            for (int i = 0; i < PerRound; ++i) {
+                blocks[i] = allocator.allocate(1);
+                *blocks[i] = i;
+            }
+        });
+        producer.join();
+
+        std::thread consumer([&] {
+            for (int i = 0; i < PerRound; ++i) {
+                EXPECT_EQ(*blocks[i], i);
+                allocator.deallocate(blocks[i], 1);
+            }
+        });
+        consumer.join();
+    }
+
+    // Everything came back to the shared lists when the threads exited, so the spans got reused.
+    const size_t spans = SlabHeap::instance().spanCount();
+    std::thread again([&] {
+        std::vector<int*> blocks(PerRound);
+        for (auto& block : blocks) {
+            block = allocator.allocate(1);
+        }
+        for (auto* block : blocks) {
+            allocator.deallocate(block, 1);
+        }
+    });
+    again.join();
+    EXPECT_EQ(SlabHeap::instance().spanCount(), spans);
+}
+
+TEST(SlabAllocatorTest, ConcurrentChurnKeepsBlocksDistinct) {
+    constexpr int Threads = 4;
+    constexpr int Live = 200;
+    constexpr int Steps = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.emplace_back([t] {
+            SlabAllocator<std::uint64_t> allocator;
+            std::vector<std::uint64_t*> live(Live, nullptr);
+            for (int step = 0; step < Steps; ++step) {
+                auto*& slot = live[step % Live];
+                if (slot) {
+                    ASSERT_EQ(*slot, static_cast<std::uint64_t>(t) << 32 | (step - Live));
+                    allocator.deallocate(slot, 1);
+                }
+                slot = allocator.allocate(1);
+                *slot = static_cast<std::uint64_t>(t) << 32 | step;
+            }
+            for (auto* block : live) {
+                allocator.deallocate(block, 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "../Algorithms/SpscQueue.h"
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Counts live instances; a copy can be made to throw.
+    struct CountedThrower {
+        static inline int live = 0;
+
+        int value{ 0 };
+        bool bThrowOnCopy{ false };
+
+        CountedThrower() { ++live; }
+        CountedThrower(int value, bool bThrowOnCopy) : value(value), bThrowOnCopy(bThrowOnCopy) { ++live; }
+        CountedThrower(const CountedThrower& other) : value(other.value), bThrowOnCopy(false) {
+            if (other.bThrowOnCopy) {
+                throw std::runtime_error("copy");
+            }
+            ++live;
+        }
+        CountedThrower& operator=(CountedThrower&&) = default;
+        ~CountedThrower() { --live; }
+    };
+}
+
+TEST(SpscQueueTest, CapacityIsRoundedUpToPowerOfTwo) {
+    SpscQueue<int> queue(5);
+    EXPECT_EQ(queue.capacity(), 8);
+    EXPECT_TRUE(queue.isEmptyApprox());
+}
+
+TEST(SpscQueueTest, PushFailsWhenFull) {
+    SpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.sizeApprox(), 4);
+
+    int out = -1;
+    EXPECT_TRUE(queue.tryPop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(queue.tryPush(4));
+}
+
+TEST(SpscQueueTest, PopFailsWhenEmpty) {
+    SpscQueue<int> queue(4);
+    int out = 42;
+    EXPECT_FALSE(queue.tryPop(out));
+    EXPECT_EQ(out, 42);
+}
+
+TEST(SpscQueueTest, FifoOrderAcrossWrapAround) {
+    SpscQueue<std::string> queue(4);
+    int next = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_TRUE(queue.tryEmplace(std::to_string(round * 3 + i)));
+        }
+        std::string out;
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_TRUE(queue.tryPop(out));
+            EXPECT_EQ(out, std::to_string(next++));
+        }
+    }
+}
+
+TEST(SpscQueueTest, BatchPushAndPop) {
+    SpscQueue<int> queue(8);
+    std::vector<int> input{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+    EXPECT_EQ(queue.tryPushN(input.begin(), input.size()), 8);
+    EXPECT_EQ(queue.tryPushN(input.begin() + 8, 2), 0);
+
+    std::vector<int> output(5);
+    EXPECT_EQ(queue.tryPopN(output.begin(), 5), 5);
+    EXPECT_EQ(output, (std::vector<int>{ 1, 2, 3, 4, 5 }));
+
+    EXPECT_EQ(queue.tryPushN(input.begin() + 8, 2), 2);
+
+    std::vector<int> rest;
+    EXPECT_EQ(queue.tryPopN(std::back_inserter(rest), 100), 5);
+    EXPECT_EQ(rest, (std::vector<int>{ 6, 7, 8, 9, 10 }));
+}
+
+TEST(SpscQueueTest, ThrowingBatchesKeepEveryElementAccountedFor) {
+    // Takes `room` elements, then throws.
+    struct ThrowingInserter {
+        std::vector<int>* output;
+        size_t room;
+
+        ThrowingInserter& operator*() { return *this; }
+        ThrowingInserter& operator++() { return *this; }
+        ThrowingInserter operator++(int) { return *this; }
+        ThrowingInserter& operator=(CountedThrower&& element) {
+            if (output->size() == room) {
+                throw std::runtime_error("full");
+            }
+            output->push_back(element.value);
+            return *this;
+        }
+    };
+
+    {
+        std::vector<CountedThrower> input;
+        input.reserve(4);
+        input.emplace_back(1, false);
+        input.emplace_back(2, false);
+        input.emplace_back(3, true);
+        input.emplace_back(4, false);
+
+        SpscQueue<CountedThrower> queue(8);
+        EXPECT_THROW(queue.tryPushN(input.begin(), input.size()), std::runtime_error);
+        EXPECT_EQ(queue.sizeApprox(), 2);
+
+        std::vector<int> output;
+        EXPECT_THROW(queue.tryPopN(ThrowingInserter{ &output, 1 }, 2), std::runtime_error);
+        EXPECT_EQ(output, (std::vector<int>{ 1 }));
+        EXPECT_EQ(queue.sizeApprox(), 1);
+
+        EXPECT_EQ(queue.tryPopN(ThrowingInserter{ &output, 2 }, 2), 1);
+        EXPECT_EQ(output, (std::vector<int>{ 1, 2 }));
+        EXPECT_TRUE(queue.isEmptyApprox());
+
+        EXPECT_EQ(queue.tryPushN(input.begin(), 2), 2);
+    }
+
+    // Nothing leaked or destroyed twice.
+    EXPECT_EQ(CountedThrower::live, 0);
+}
+
+TEST(SpscQueueTest, DestroysRemainingElements) {
+    auto tracked = std::make_shared<int>(0);
+    {
+        SpscQueue<std::shared_ptr<int>> queue(4);
+        queue.tryPush(tracked);
+        queue.tryPush(tracked);
+        EXPECT_EQ(tracked.use_count(), 3);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(SpscQueueTest, ProducerAndConsumerThreads) {
+    constexpr int count = 200000;
+    SpscQueue<int> queue(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            while (!queue.tryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool inOrder = true;
+    int expected = 0;
+    int buffer[16];
+    while (expected < count) {
+        size_t n = queue.tryPopN(buffer, 16);
+        for (size_t i = 0; i < n; ++i) {
+            inOrder = inOrder && buffer[i] == expected;
+            ++expected;
+        }
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    EXPECT_TRUE(inOrder);
+    EXPECT_TRUE(queue.isEmptyApprox());
+}
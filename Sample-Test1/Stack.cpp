@@ -1,6 +1,12 @@
 #include "pch.h"
 #include "../Algorithms/Stack.h"
+#include "../Algorithms/DoubleLinkedList.h"
 #include <stdexcept> // For std::underflow_error (if you decide to test exceptions later)
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 TEST(StackTest, DefaultConstructor) {
     Stack<int> stack;
@@ -154,6 +160,22 @@ TEST(StackTest, AssignmentOperatorMove) {
     ASSERT_EQ(assigned.peek(), 10);
 }
 
+TEST(StackTest, MoveAssignmentIsNoexceptOnlyWhenTheContainerIs) {
+    static_assert(std::is_nothrow_move_assignable_v<Stack<int>>);
+
+    // A pmr Vector with another resource moves element by element, which may throw.
+    static_assert(!std::is_nothrow_move_assignable_v<Stack<int, PmrVector>>);
+
+    Stack<int, PmrVector> original;
+    original.push(1);
+    original.push(2);
+
+    Stack<int, PmrVector> assigned;
+    assigned = std::move(original);
+    ASSERT_EQ(assigned.size(), 2);
+    ASSERT_EQ(assigned.peek(), 2);
+}
+
 struct MoveOnly {
     int value;
     MoveOnly(int v) : value(v) {}
@@ -168,4 +190,94 @@ TEST(StackTest, MoveOnlyType) {
     Stack<MoveOnly> stack;
     stack.push(MoveOnly(42));
     ASSERT_EQ(stack.size(), 1);
-}
\ No newline at end of file
+}
+
+TEST(StackTest, ReserveKeepsContents) {
+    Stack<int> stack{ 1, 2 };
+    stack.reserve(100);
+    ASSERT_EQ(stack.size(), 2);
+    ASSERT_EQ(stack.peek(), 2);
+
+    for (int i = 3; i <= 100; ++i) {
+        stack.push(i);
+    }
+    ASSERT_EQ(stack.peek(), 100);
+}
+
+TEST(StackTest, PushOwnTopWhenFull) {
+    // The default Vector grows on these pushes and frees the block peek() points into.
+    Stack<std::string> stack{ "top, and too long for the small-string buffer" };
+    for (int i = 0; i < 20; ++i) {
+        stack.push(stack.peek());
+    }
+    ASSERT_EQ(stack.size(), 21);
+    while (!stack.isEmpty()) {
+        ASSERT_EQ(stack.peek(), "top, and too long for the small-string buffer");
+        stack.pop();
+    }
+}
+
+TEST(StackTest, LinkedListBackend) {
+    Stack<std::string, DoubleLinkedList> stack{ "a", "b" };
+    stack.reserve(10); // No-op, lists have nothing to reserve.
+    stack.push("c");
+    ASSERT_EQ(stack.size(), 3);
+    ASSERT_EQ(stack.peek(), "c");
+
+    Stack<std::string, DoubleLinkedList> copy = stack;
+    stack.pop();
+    ASSERT_EQ(stack.peek(), "b");
+    ASSERT_EQ(copy.peek(), "c");
+
+    copy.pop();
+    copy.pop();
+    copy.pop();
+    ASSERT_TRUE(copy.isEmpty());
+    ASSERT_DEATH(copy.peek(), "isEmpty");
+}
+
+TEST(StackTest, RangeConstructorPutsLastOnTop) {
+    std::vector<int> values{ 1, 2, 3 };
+    Stack<int> stack(values.begin(), values.end());
+    ASSERT_EQ(stack.size(), 3);
+    ASSERT_EQ(stack.peek(), 3);
+
+    stack.pushRange(values.begin(), values.begin() + 2);
+    ASSERT_EQ(stack.size(), 5);
+    ASSERT_EQ(stack.peek(), 2);
+    stack.pop();
+    ASSERT_EQ(stack.peek(), 1);
+    stack.pop();
+    ASSERT_EQ(stack.peek(), 3);
+}
+
+TEST(StackTest, PushRangeOnListBackend) {
+    std::vector<std::string> words{ "x", "y" };
+    Stack<std::string, DoubleLinkedList> stack(words.begin(), words.end());
+    ASSERT_EQ(stack.peek(), "y");
+    stack.pop();
+    ASSERT_EQ(stack.peek(), "x");
+}
+
+TEST(StackTest, PushRangeMovesFromMoveIterators) {
+    std::vector<std::unique_ptr<int>> pointers;
+    pointers.push_back(std::make_unique<int>(1));
+    pointers.push_back(std::make_unique<int>(2));
+
+    Stack<std::unique_ptr<int>> stack;
+    stack.pushRange(std::make_move_iterator(pointers.begin()), std::make_move_iterator(pointers.end()));
+    ASSERT_EQ(*stack.peek(), 2);
+    ASSERT_EQ(pointers[0], nullptr);
+}
+
+TEST(StackTest, RangeConstructorFromVector) {
+    Vector<int> values{ 1, 2, 3 };
+    Stack<int> stack(values.begin(), values.end());
+    ASSERT_EQ(stack.size(), 3);
+    ASSERT_EQ(stack.peek(), 3);
+
+    const Vector<int>& constValues = values;
+    stack.pushRange(constValues.begin(), constValues.end());
+    ASSERT_EQ(stack.size(), 6);
+    ASSERT_EQ(stack.peek(), 3);
+}
@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "../Algorithms/ThreadPool.h"
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    int64 Fib(ThreadPool& pool, int n) {
+        if (n < 2) {
+            return n;
+        }
+
+        int64 left = 0;
+        TaskGroup group(pool);
+        group.run([&] { left = Fib(pool, n - 1); });
+        int64 right = Fib(pool, n - 2);
+        group.wait();
+
+        return left + right;
+    }
+}
+
+TEST(ThreadPoolTest, DefaultsToHardwareThreads) {
+    ThreadPool pool;
+    EXPECT_GE(pool.threadCount(), 1);
+    EXPECT_EQ(pool.currentWorker(), ThreadPool::NotAWorker);
+}
+
+TEST(ThreadPoolTest, SubmitReturnsFuture) {
+    ThreadPool pool(2);
+    auto answer = pool.submit([] { return 42; });
+    auto text = pool.submit([] { return std::string("pool"); });
+    EXPECT_EQ(answer.get(), 42);
+    EXPECT_EQ(text.get(), "pool");
+}
+
+TEST(ThreadPoolTest, SubmitPropagatesException) {
+    ThreadPool pool(1);
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, TasksRunOnWorkers) {
+    ThreadPool pool(3);
+    auto index = pool.submit([&pool] { return pool.currentWorker(); });
+    EXPECT_LT(index.get(), 3);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(10007);
+
+    pool.parallelFor(size_t{ 0 }, visits.size(), [&](size_t i) { ++visits[i]; });
+    for (auto& count : visits) {
+        ASSERT_EQ(count, 1);
+    }
+
+    pool.parallelFor(5, 5, [](int) { FAIL(); });
+}
+
+TEST(ThreadPoolTest, ParallelForWithGrain) {
+    ThreadPool pool(2);
+    std::vector<int> values(1000);
+    pool.parallelFor(0, 1000, [&](int i) { values[i] = i; }, 7);
+
+    std::vector<int> expected(1000);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(ThreadPoolTest, ForEachWorkerRunsOnThatWorker) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(4);
+
+    for (int round = 0; round < 50; ++round) {
+        pool.forEachWorker([&](size_t worker) {
+            EXPECT_EQ(pool.currentWorker(), worker);
+            ++visits[worker];
+        });
+    }
+    for (auto& count : visits) {
+        EXPECT_EQ(count, 50);
+    }
+
+    // From inside the pool too: the caller runs its own part while it waits.
+    auto nested = pool.submit([&] {
+        std::atomic<int> seen{ 0 };
+        pool.forEachWorker([&](size_t worker) { seen += pool.currentWorker() == worker; });
+        return seen.load();
+    });
+    EXPECT_EQ(nested.get(), 4);
+}
+
+TEST(ThreadPoolTest, NestedForkJoin) {
+    ThreadPool pool(4);
+    auto result = pool.submit([&pool] { return Fib(pool, 20); });
+    EXPECT_EQ(result.get(), 6765);
+
+    // Joining from outside the pool works too, the caller helps.
+    EXPECT_EQ(Fib(pool, 15), 610);
+}
+
+TEST(ThreadPoolTest, TaskGroupRethrowsFirstException) {
+    ThreadPool pool(2);
+    TaskGroup group(pool);
+    std::atomic<int> finished{ 0 };
+
+    group.run([] { throw std::logic_error("first"); });
+    for (int i = 0; i < 10; ++i) {
+        group.run([&] { ++finished; });
+    }
+
+    EXPECT_THROW(group.wait(), std::logic_error);
+    EXPECT_EQ(finished, 10);
+
+    group.run([&] { ++finished; });
+    EXPECT_NO_THROW(group.wait());
+}
+
+TEST(ThreadPoolTest, DestructorRunsQueuedWork) {
+    std::atomic<int> done{ 0 };
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 100; ++i) {
+            (void)pool.submit([&] { ++done; });
+        }
+    }
+    EXPECT_EQ(done, 100);
+}
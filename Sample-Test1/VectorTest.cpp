@@ -4,6 +4,11 @@
 #include <initializer_list>
 #include <algorithm>
 #include <stdexcept> // For std::out_of_range
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
 
 // Helper function to compare vectors (since direct comparison might not work for custom classes)
 template <typename T>
@@ -163,6 +168,21 @@ TEST(VectorTest, PopFrontSingleElement) {
     EXPECT_TRUE(vec.isEmpty());
 }
 
+// Test Pop Front with elements that own memory
+TEST(VectorTest, PopFrontStrings) {
+    Vector<std::string> vec;
+    vec.pushBack(std::string(100, 'a'));
+    vec.pushBack(std::string(100, 'b'));
+    vec.pushBack(std::string(100, 'c'));
+    vec.popFront();
+    EXPECT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec[0], std::string(100, 'b'));
+    EXPECT_EQ(vec[1], std::string(100, 'c'));
+    vec.popFront();
+    vec.popFront();
+    EXPECT_TRUE(vec.isEmpty());
+}
+
 // Test Pop Front on empty list - Should cause an assert
 TEST(VectorTest, PopFrontEmpty) {
     Vector<int> vec;
@@ -352,4 +372,90 @@ TEST(VectorTest, SelfAssignmentMove) {
     vec = std::move(vec); // Self-assignment
     EXPECT_EQ(vec.size(), 3);
     EXPECT_GE(vec.capacity(), 3);
-}
\ No newline at end of file
+}
+
+TEST(VectorTest, FrontAndBack) {
+    Vector<int> vec{ 1, 2, 3 };
+    EXPECT_EQ(vec.front(), 1);
+    EXPECT_EQ(vec.back(), 3);
+
+    vec.back() = 30;
+    EXPECT_EQ(vec[2], 30);
+
+    const Vector<int>& constVec = vec;
+    EXPECT_EQ(constVec.front(), 1);
+    EXPECT_EQ(constVec.back(), 30);
+}
+
+TEST(VectorTest, FrontAndBackOnEmptyVector) {
+    Vector<int> vec;
+    EXPECT_DEATH(vec.front(), "isEmpty");
+    EXPECT_DEATH(vec.back(), "isEmpty");
+}
+
+TEST(VectorTest, PushBackRangeGrowsOnce) {
+    std::vector<int> source(100);
+    std::iota(source.begin(), source.end(), 0);
+
+    Vector<int> vec{ -1 };
+    vec.pushBackRange(source.begin(), source.end());
+    EXPECT_EQ(vec.size(), 101);
+    EXPECT_EQ(vec.capacity(), 101);
+    EXPECT_EQ(vec[0], -1);
+    EXPECT_EQ(vec[100], 99);
+
+    // Small ranges after that still grow geometrically.
+    vec.pushBackRange(source.begin(), source.begin() + 1);
+    EXPECT_EQ(vec.capacity(), 202);
+}
+
+TEST(VectorTest, PushBackRangeFromInputIterator) {
+    std::istringstream input("7 8 9");
+    Vector<int> vec;
+    vec.pushBackRange(std::istream_iterator<int>(input), std::istream_iterator<int>{});
+    EXPECT_EQ(vec.size(), 3);
+    EXPECT_EQ(vec.back(), 9);
+}
+
+TEST(VectorTest, IteratorsWorkWithStdAlgorithms) {
+    Vector<int> vec{ 3, 1, 2 };
+    std::sort(vec.begin(), vec.end());
+    EXPECT_EQ(vec[0], 1);
+    EXPECT_EQ(vec.end() - vec.begin(), 3);
+    EXPECT_EQ(vec.begin()[2], 3);
+
+    const Vector<int>& constVec = vec;
+    Vector<int>::ConstIterator it = vec.begin();
+    EXPECT_EQ(it, constVec.begin());
+    EXPECT_EQ(*std::lower_bound(constVec.begin(), constVec.end(), 2), 2);
+
+    Vector<int> copy;
+    copy.pushBackRange(vec.begin(), vec.end());
+    EXPECT_EQ(copy.size(), 3);
+    EXPECT_EQ(copy.back(), 3);
+}
+
+TEST(VectorTest, PushOwnElementWhenFull) {
+    // The argument lives in the block that growing frees.
+    Vector<std::string> vec{ "first, and too long for the small-string buffer" };
+    ASSERT_EQ(vec.size(), vec.capacity());
+    vec.pushBack(vec.front());
+    EXPECT_EQ(vec.back(), "first, and too long for the small-string buffer");
+
+    do {
+        vec.pushBack("last, and also too long for the small-string buffer");
+    } while (vec.size() < vec.capacity());
+    vec.pushFront(vec.back());
+    EXPECT_EQ(vec.front(), "last, and also too long for the small-string buffer");
+    EXPECT_EQ(vec.size(), 5);
+
+    // Without growing, the shift still moves the argument away.
+    vec.reserve(10);
+    vec.pushFront(vec.back());
+    EXPECT_EQ(vec.front(), "last, and also too long for the small-string buffer");
+    EXPECT_EQ(vec.back(), "last, and also too long for the small-string buffer");
+}
+
+static_assert(std::random_access_iterator<Vector<int>::Iterator>);
+static_assert(std::random_access_iterator<Vector<int>::ConstIterator>);
+static_assert(std::ranges::random_access_range<const Vector<int>>);
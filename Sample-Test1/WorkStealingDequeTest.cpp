@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "../Algorithms/WorkStealingDeque.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingDequeTest, OwnerPopsNewestFirst) {
+    WorkStealingDeque<int> deque;
+    EXPECT_FALSE(deque.pop().has_value());
+
+    for (int i = 0; i < 3; ++i) {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.sizeApprox(), 3);
+    EXPECT_EQ(deque.pop(), 2);
+    EXPECT_EQ(deque.pop(), 1);
+    EXPECT_EQ(deque.pop(), 0);
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_TRUE(deque.isEmptyApprox());
+}
+
+TEST(WorkStealingDequeTest, ThiefStealsOldestFirst) {
+    WorkStealingDeque<int> deque;
+    for (int i = 0; i < 3; ++i) {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.steal(), 0);
+    EXPECT_EQ(deque.pop(), 2);
+    EXPECT_EQ(deque.steal(), 1);
+    EXPECT_FALSE(deque.steal().has_value());
+}
+
+TEST(WorkStealingDequeTest, GrowsAndKeepsOrder) {
+    WorkStealingDeque<int> deque(2);
+    EXPECT_EQ(deque.capacity(), 2);
+
+    deque.push(-1);
+    EXPECT_EQ(deque.steal(), -1);
+    for (int i = 0; i < 100; ++i) {
+        deque.push(i);
+    }
+    EXPECT_GE(deque.capacity(), 100);
+
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(deque.steal(), i);
+    }
+    for (int i = 99; i >= 50; --i) {
+        EXPECT_EQ(deque.pop(), i);
+    }
+}
+
+TEST(WorkStealingDequeTest, EveryItemIsTakenExactlyOnce) {
+    constexpr int Count = 20000;
+    constexpr int Thieves = 3;
+
+    WorkStealingDeque<int> deque(4);
+    std::vector<std::atomic<int>> taken(Count);
+    std::atomic<bool> bDone{ false };
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < Thieves; ++t) {
+        thieves.emplace_back([&] {
+            while (!bDone || !deque.isEmptyApprox()) {
+                if (auto item = deque.steal()) {
+                    ++taken[*item];
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // The owner keeps the deque short so it often races the thieves for the last item.
+    for (int i = 0; i < Count; ++i) {
+        deque.push(i);
+        if (i % 3 == 0) {
+            if (auto item = deque.pop()) {
+                ++taken[*item];
+            }
+        }
+    }
+    while (auto item = deque.pop()) {
+        ++taken[*item];
+    }
+    bDone = true;
+
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    for (int i = 0; i < Count; ++i) {
+        ASSERT_EQ(taken[i], 1) << i;
+    }
+}
@@ -0,0 +1,290 @@
+#include "pch.h"
+#include "../Algorithms/DoubleLinkedList.h"
+#include "../Algorithms/Queue.h"
+#include "../Algorithms/SingleLinkedList.h"
+#include "../Algorithms/Stack.h"
+#include "../Algorithms/Vector.h"
+#include "../Algorithms/WorkloadTrace.h"
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <forward_list>
+#include <limits>
+#include <list>
+#include <stack>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string TempPath(const char* name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::vector<TraceEvent> Events(const WorkloadTrace& trace) {
+        std::vector<TraceEvent> events;
+        trace.forEach([&events](const TraceEvent& event) { events.push_back(event); });
+        return events;
+    }
+
+    std::string MakeString(uint64 size) {
+        return std::string(static_cast<size_t>(size), 'x');
+    }
+
+    /** A mixed workload over strings of different lengths, returning the lengths it read. */
+    std::vector<size_t> RecordWorkload(WorkloadTrace& trace) {
+        std::vector<size_t> reads;
+        TracedContainer<Vector<std::string>> traced(trace);
+
+        for (size_t i = 1; i <= 20; ++i) {
+            traced.pushBack(MakeString(i));
+        }
+        traced.pushFront(MakeString(100));
+        traced.popBack();
+        traced.popFront();
+        reads.push_back(traced.get(3).size());
+        traced.forEach([&reads](const std::string& val) { reads.push_back(val.size()); });
+        traced.clear();
+        traced.pushBack(MakeString(7));
+        reads.push_back(traced.get(0).size());
+
+        return reads;
+    }
+
+    template<typename Container>
+    void ExpectReplayMatches(const WorkloadTrace& trace, const std::vector<size_t>& expectedReads) {
+        Container container;
+        std::vector<size_t> reads;
+        TraceReplayResult result = replayTrace(trace.events(), container, MakeString,
+            [&reads](const std::string& val) { reads.push_back(val.size()); });
+
+        EXPECT_EQ(result.applied, trace.size());
+        EXPECT_EQ(result.skipped, 0);
+        EXPECT_EQ(reads, expectedReads);
+        EXPECT_EQ(container.size(), 1);
+    }
+}
+
+TEST(WorkloadTraceTest, EmptyTrace) {
+    WorkloadTrace trace;
+    EXPECT_TRUE(trace.isEmpty());
+    EXPECT_EQ(trace.size(), 0);
+    EXPECT_EQ(trace.byteSize(), 0);
+    EXPECT_TRUE(trace.events().isEmpty());
+}
+
+TEST(WorkloadTraceTest, EncodingIsCompact) {
+    WorkloadTrace trace;
+    trace.record(TraceOp::PopBack);
+    EXPECT_EQ(trace.byteSize(), 1);
+
+    trace.record(TraceOp::PushBack, 4);
+    EXPECT_EQ(trace.byteSize(), 3);
+
+    // 300 needs two 7-bit groups.
+    trace.record(TraceOp::Get, 300);
+    EXPECT_EQ(trace.byteSize(), 6);
+
+    // An argument is dropped for operations that don't take one.
+    trace.record(TraceOp::Clear, 12345);
+    EXPECT_EQ(trace.byteSize(), 7);
+    EXPECT_EQ(trace.size(), 4);
+}
+
+TEST(WorkloadTraceTest, EventsRoundTrip) {
+    const std::vector<TraceEvent> recorded = {
+        { TraceOp::PushBack, 0 },
+        { TraceOp::PushFront, 127 },
+        { TraceOp::Get, 128 },
+        { TraceOp::Iterate, 1ull << 40 },
+        { TraceOp::Get, std::numeric_limits<uint64>::max() },
+        { TraceOp::PopFront, 0 },
+        { TraceOp::PopBack, 0 },
+        { TraceOp::Clear, 0 },
+    };
+
+    WorkloadTrace trace;
+    for (const TraceEvent& event : recorded) {
+        trace.record(event.op, event.argument);
+    }
+
+    EXPECT_EQ(Events(trace), recorded);
+
+    Vector<TraceEvent> decoded = trace.events();
+    ASSERT_EQ(decoded.size(), recorded.size());
+    for (size_t i = 0; i < recorded.size(); ++i) {
+        EXPECT_EQ(decoded[i], recorded[i]);
+    }
+}
+
+TEST(WorkloadTraceTest, SaveAndLoad) {
+    WorkloadTrace trace;
+    RecordWorkload(trace);
+
+    const std::string path = TempPath("workload_trace_test.trace");
+    ASSERT_TRUE(trace.save(path.c_str()));
+
+    WorkloadTrace loaded;
+    ASSERT_TRUE(loaded.load(path.c_str()));
+    EXPECT_EQ(loaded.size(), trace.size());
+    EXPECT_EQ(loaded.byteSize(), trace.byteSize());
+    EXPECT_EQ(Events(loaded), Events(trace));
+
+    std::filesystem::remove(path);
+}
+
+TEST(WorkloadTraceTest, LoadRejectsBadFiles) {
+    WorkloadTrace trace;
+    EXPECT_FALSE(trace.load(TempPath("workload_trace_test_missing.trace").c_str()));
+
+    const std::string path = TempPath("workload_trace_test_bad.trace");
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs("not a trace at all, just some text", file);
+        std::fclose(file);
+    }
+    EXPECT_FALSE(trace.load(path.c_str()));
+
+    // A good trace cut short.
+    WorkloadTrace good;
+    RecordWorkload(good);
+    ASSERT_TRUE(good.save(path.c_str()));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+    trace.record(TraceOp::PopBack);
+    EXPECT_FALSE(trace.load(path.c_str()));
+    EXPECT_TRUE(trace.isEmpty());
+    EXPECT_EQ(trace.byteSize(), 0);
+
+    std::filesystem::remove(path);
+}
+
+TEST(WorkloadTraceTest, TracedContainerRecordsOperations) {
+    WorkloadTrace trace;
+    TracedContainer<Vector<std::string>> traced(trace);
+
+    traced.pushBack(std::string("abc"));
+    traced.pushFront(std::string("hello"));
+    EXPECT_EQ(traced.get(1), "abc");
+    traced.forEach([](const std::string&) {});
+    traced.popFront();
+    traced.popBack();
+    traced.clear();
+
+    const std::vector<TraceEvent> expected = {
+        { TraceOp::PushBack, 3 },
+        { TraceOp::PushFront, 5 },
+        { TraceOp::Get, 1 },
+        { TraceOp::Iterate, 2 },
+        { TraceOp::PopFront, 0 },
+        { TraceOp::PopBack, 0 },
+        { TraceOp::Clear, 0 },
+    };
+    EXPECT_EQ(Events(trace), expected);
+    EXPECT_TRUE(traced.isEmpty());
+}
+
+TEST(WorkloadTraceTest, TracedContainerPassesThrough) {
+    WorkloadTrace trace;
+    TracedContainer<DoubleLinkedList<int>> traced(trace);
+
+    for (int i = 0; i < 5; ++i) {
+        traced.pushBack(i);
+    }
+    traced.get(3) = 30;
+
+    EXPECT_EQ(traced.size(), 5);
+    EXPECT_EQ(traced.container().back(), 4);
+    EXPECT_EQ(traced.get(3), 30);
+
+    // Fixed-size elements record their sizeof.
+    EXPECT_EQ(trace.events()[0], (TraceEvent{ TraceOp::PushBack, sizeof(int) }));
+}
+
+TEST(WorkloadTraceTest, AdaptorsRecordTheirEnd) {
+    WorkloadTrace stackTrace;
+    TracedContainer<Stack<int>> stack(stackTrace);
+    stack.push(1);
+    stack.pop();
+    EXPECT_EQ(Events(stackTrace).back().op, TraceOp::PopBack);
+
+    WorkloadTrace queueTrace;
+    TracedContainer<Queue<int>> queue(queueTrace);
+    queue.push(1);
+    queue.pop();
+    EXPECT_EQ(Events(queueTrace).back().op, TraceOp::PopFront);
+}
+
+TEST(WorkloadTraceTest, ReplayReproducesTheWorkload) {
+    WorkloadTrace trace;
+    const std::vector<size_t> reads = RecordWorkload(trace);
+
+    ExpectReplayMatches<Vector<std::string>>(trace, reads);
+    ExpectReplayMatches<DoubleLinkedList<std::string>>(trace, reads);
+    ExpectReplayMatches<SingleLinkedList<std::string>>(trace, reads);
+    ExpectReplayMatches<std::vector<std::string>>(trace, reads);
+    ExpectReplayMatches<std::deque<std::string>>(trace, reads);
+    ExpectReplayMatches<std::list<std::string>>(trace, reads);
+}
+
+TEST(WorkloadTraceTest, ReplaySkipsWhatTheContainerCannotDo) {
+    WorkloadTrace trace;
+    trace.record(TraceOp::PushBack, 1);
+    trace.record(TraceOp::PushFront, 2);
+    trace.record(TraceOp::Get, 0);
+    trace.record(TraceOp::PopBack);
+    trace.record(TraceOp::PopBack);
+
+    // No pushFront and no indexing: the second pop then finds the stack empty.
+    Stack<int> stack;
+    TraceReplayResult result = replayTrace(trace.events(), stack, [](uint64 size) { return static_cast<int>(size); }, [](const int&) {});
+    EXPECT_EQ(result.applied, 2);
+    EXPECT_EQ(result.skipped, 3);
+    EXPECT_TRUE(stack.isEmpty());
+
+    std::stack<int> stdStack;
+    result = replayTrace(trace.events(), stdStack, [](uint64 size) { return static_cast<int>(size); }, [](const int&) {});
+    EXPECT_EQ(result.applied, 2);
+    EXPECT_EQ(result.skipped, 3);
+}
+
+TEST(WorkloadTraceTest, ReplayToForwardList) {
+    WorkloadTrace trace;
+    TracedContainer<std::forward_list<int>> traced(trace);
+    for (int i = 0; i < 4; ++i) {
+        traced.pushFront(i);
+    }
+    traced.popFront();
+    EXPECT_EQ(traced.size(), 3);
+    EXPECT_EQ(traced.get(2), 0);
+    traced.forEach([](int) {});
+    trace.record(TraceOp::Get, 5);
+
+    std::forward_list<int> list;
+    std::vector<int> visited;
+    TraceReplayResult result = replayTrace(trace.events(), list, [](uint64 size) { return static_cast<int>(size); },
+        [&visited](int val) { visited.push_back(val); });
+
+    // Every element is sizeof(int), so the list ends up with three of those; the last Get is past the end.
+    EXPECT_EQ(result.applied, trace.size() - 1);
+    EXPECT_EQ(result.skipped, 1);
+    EXPECT_EQ(visited, (std::vector<int>{ 4, 4, 4, 4 }));
+    EXPECT_EQ(std::distance(list.begin(), list.end()), 3);
+    EXPECT_EQ(Events(trace)[6], (TraceEvent{ TraceOp::Iterate, 3 }));
+}
+
+TEST(WorkloadTraceTest, ReplayIgnoresLookupsPastTheEnd) {
+    WorkloadTrace trace;
+    trace.record(TraceOp::PushBack, 1);
+    trace.record(TraceOp::Get, 1);
+    trace.record(TraceOp::Iterate, 10);
+
+    Vector<int> vec;
+    int visited = 0;
+    TraceReplayResult result = replayTrace(trace.events(), vec, [](uint64 size) { return static_cast<int>(size); },
+        [&visited](const int&) { ++visited; });
+
+    EXPECT_EQ(result.applied, 2);
+    EXPECT_EQ(result.skipped, 1);
+    EXPECT_EQ(visited, 1);
+}